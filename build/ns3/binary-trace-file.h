@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief A binary, columnar alternative to ascii trace files
+ *
+ * The default ascii trace sinks print every event through Packet::Print,
+ * which dominates the run time of heavily traced simulations and produces
+ * files that have to be parsed again afterwards.  This class stores the
+ * same events with a fixed schema instead:
+ *
+ * - time (int64_t, nanoseconds)
+ * - node id (uint32_t)
+ * - device index (uint32_t)
+ * - event type (uint8_t, see EventType)
+ * - packet uid (uint64_t)
+ * - packet size (uint32_t)
+ * - optionally, the first HeaderBytes bytes of the packet
+ *
+ * Records are accumulated in memory one column at a time and written out
+ * as blocks.  Each block is a uint32_t record count followed by every
+ * column stored contiguously, so that tracing an event is a handful of
+ * stores and readers can skip the columns they do not need.  All values
+ * are stored in the byte order of the writing host; the magic number
+ * allows a reader to detect a mismatch.
+ *
+ * The same class is used to read a file back; see ToText and ToCsv for
+ * conversion to the usual text formats.
+ *
+ * This class uses a basic ns-3 reference counting base class so that it
+ * can be bound into trace sink callbacks, in the same way as
+ * OutputStreamWrapper.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /**
+   * \brief Event types, matching the ascii trace operations
+   */
+  enum EventType
+  {
+    ENQUEUE = 0,  /**< '+' operation */
+    DEQUEUE = 1,  /**< '-' operation */
+    DROP = 2,     /**< 'd' operation */
+    RECEIVE = 3   /**< 'r' operation */
+  };
+
+  static const uint32_t BLOCK_RECORDS_DEFAULT = 4096; /**< Default number of records per block */
+
+  /**
+   * \brief A single decoded trace record
+   */
+  struct Record
+  {
+    int64_t  time;                 //!< event time, in nanoseconds
+    uint32_t node;                 //!< node id
+    uint32_t device;               //!< device index on the node
+    uint8_t  event;                //!< event type
+    uint64_t uid;                  //!< packet uid
+    uint32_t size;                 //!< packet size, in bytes
+    std::vector<uint8_t> header;   //!< leading packet bytes (empty unless HeaderBytes is non-zero)
+  };
+
+  BinaryTraceFile ();
+  ~BinaryTraceFile ();
+
+  /**
+   * Create a new binary trace file or open an existing one for reading.
+   * The file is always opened in binary mode.
+   *
+   * \param filename the name of the file
+   * \param mode either std::ios::out or std::ios::in
+   */
+  void Open (std::string const &filename, std::ios::openmode mode);
+
+  /**
+   * Flush any buffered records and close the underlying file.
+   */
+  void Close (void);
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \return true if the 'eof' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Eof (void) const;
+
+  /**
+   * Write the file header.  The file must have been opened for writing.
+   *
+   * \param headerBytes number of leading packet bytes stored with each
+   * record; packets shorter than this are zero-padded.
+   * \param blockRecords number of records buffered before a block is
+   * written to disk.
+   */
+  void Init (uint32_t headerBytes = 0, uint32_t blockRecords = BLOCK_RECORDS_DEFAULT);
+
+  /**
+   * \brief Append one event
+   *
+   * \param time event time, in nanoseconds
+   * \param node node id
+   * \param device device index
+   * \param event event type
+   * \param p the traced packet
+   */
+  void Write (int64_t time, uint32_t node, uint32_t device, EventType event, Ptr<const Packet> p);
+
+  /**
+   * \brief Append one event
+   *
+   * \param time event time, in nanoseconds
+   * \param node node id
+   * \param device device index
+   * \param event event type
+   * \param uid packet uid
+   * \param size packet size
+   * \param data leading packet bytes, at least HeaderBytes long (may be 0 if HeaderBytes is 0)
+   */
+  void Write (int64_t time, uint32_t node, uint32_t device, EventType event,
+              uint64_t uid, uint32_t size, uint8_t const *data);
+
+  /**
+   * \brief Write buffered records out as one block.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Read the next record
+   *
+   * \param record [out] the decoded record
+   * \returns false once the end of the file has been reached or the file is corrupt
+   */
+  bool Read (Record &record);
+
+  /**
+   * \returns the number of leading packet bytes stored per record
+   */
+  uint32_t GetHeaderBytes (void) const;
+
+  /**
+   * \brief Format a record the same way the default ascii sinks do
+   *
+   * \param os the output stream
+   * \param record the record
+   */
+  static void PrintText (std::ostream &os, Record const &record);
+
+  /**
+   * \brief Format a record as one CSV line
+   *
+   * \param os the output stream
+   * \param record the record
+   */
+  static void PrintCsv (std::ostream &os, Record const &record);
+
+  /**
+   * \brief Convert a binary trace file to text
+   *
+   * \param filename the binary trace file
+   * \param os the output stream
+   * \returns false if the file could not be read
+   */
+  static bool ToText (std::string const &filename, std::ostream &os);
+
+  /**
+   * \brief Convert a binary trace file to CSV, including a header line
+   *
+   * \param filename the binary trace file
+   * \param os the output stream
+   * \returns false if the file could not be read
+   */
+  static bool ToCsv (std::string const &filename, std::ostream &os);
+
+private:
+  /**
+   * \brief Binary trace file header
+   */
+  typedef struct {
+    uint32_t m_magicNumber;   /**< Magic number identifying this as a binary trace file */
+    uint16_t m_versionMajor;  /**< Major version of the format */
+    uint16_t m_versionMinor;  /**< Minor version of the format */
+    uint32_t m_headerBytes;   /**< Leading packet bytes stored per record */
+    uint32_t m_blockRecords;  /**< Maximum number of records per block */
+  } BinaryTraceFileHeader;
+
+  /**
+   * \brief Read and verify the file header
+   */
+  void ReadAndVerifyFileHeader (void);
+
+  /**
+   * \brief Read the next block into the column buffers
+   *
+   * A block which does not fit in the rest of the file puts the file
+   * in the failed state, as a bad file header does.
+   *
+   * \returns false if no further block could be read
+   */
+  bool ReadBlock (void);
+
+  std::string m_filename;               //!< file name
+  std::fstream m_file;                  //!< file stream
+  BinaryTraceFileHeader m_fileHeader;   //!< file header
+  bool m_writing;                       //!< true if opened for writing
+  uint64_t m_fileSize;                  //!< size of the file when opened for reading
+
+  uint32_t m_count;                     //!< number of records in the column buffers
+  uint32_t m_next;                      //!< next record to return when reading
+  std::vector<int64_t> m_time;          //!< time column
+  std::vector<uint32_t> m_node;         //!< node column
+  std::vector<uint32_t> m_device;       //!< device column
+  std::vector<uint8_t> m_event;         //!< event type column
+  std::vector<uint64_t> m_uid;          //!< packet uid column
+  std::vector<uint32_t> m_size;         //!< packet size column
+  std::vector<uint8_t> m_header;        //!< packet header bytes column
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ECN_TAG_H
+#define ECN_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Carry the ECN codepoint of a packet below the network layer
+ *
+ * Queues sit below the link layer headers, where they cannot rewrite the
+ * ECN field of the network header.  The network layer mirrors that field
+ * in this packet tag when it sends a packet; an active queue management
+ * discipline marks the tag (see Queue::Mark) and the receiving network
+ * layer copies the mark back into its header.
+ */
+class EcnTag : public Tag
+{
+public:
+  /**
+   * \brief ECN codepoints, as defined in \RFC{3168}
+   */
+  enum EcnCodepoint
+  {
+    NOT_ECT = 0x00, //!< Not ECN-capable transport
+    ECT1 = 0x01,    //!< ECN-capable transport, ECT(1)
+    ECT0 = 0x02,    //!< ECN-capable transport, ECT(0)
+    CE = 0x03       //!< Congestion experienced
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  EcnTag ();
+
+  /**
+   * \param ecn the ECN codepoint
+   */
+  EcnTag (uint8_t ecn);
+
+  /**
+   * \param ecn the ECN codepoint
+   */
+  void SetEcn (uint8_t ecn);
+  /**
+   * \returns the ECN codepoint
+   */
+  uint8_t GetEcn (void) const;
+  /**
+   * \returns true if the packet belongs to an ECN-capable transport
+   */
+  bool IsEcnCapable (void) const;
+  /**
+   * \returns true if the packet has been marked by a congested queue
+   */
+  bool IsCongestionExperienced (void) const;
+private:
+  uint8_t m_ecn; //!< The ECN codepoint
+};
+
+} // namespace ns3
+
+#endif /* ECN_TAG_H */
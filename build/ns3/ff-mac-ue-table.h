@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_UE_TABLE_H
+#define FF_MAC_UE_TABLE_H
+
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/lte-common.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ *
+ * \brief Per-UE state looked up by a downlink scheduler for every RBG of
+ * a TTI, stored in a flat table
+ *
+ * The schedulers keep the state of the UEs in maps indexed by RNTI, which
+ * are updated by the primitives of the SAPs.  The frequency domain
+ * allocation looks up several of these maps for each pair of RBG and UE.
+ * Instead, the scheduler fills this table once per TTI, each map being
+ * walked once in RNTI order, and the allocation loops address the UEs by
+ * their index in the table.  The UEs are stored in increasing RNTI order,
+ * so that walking the table visits them in the order of the maps.
+ *
+ * The table is only a read-only snapshot of the maps, valid for the TTI
+ * in which it was filled: the maps remain the storage of the per-UE
+ * state, and are the only place where the SAP primitives update it.  It
+ * is used by the downlink RBG allocation of the PF, FDMT and TTA
+ * schedulers, whose inner loop visits every pair of RBG and UE.  The
+ * time domain part of those schedulers, their uplink allocation and the
+ * other schedulers look up the maps directly.
+ */
+class FfMacUeTable
+{
+public:
+  /// Map of the RLC buffer status of the logical channels
+  typedef std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> RlcBufferReqMap;
+
+  /// State of a UE
+  struct Ue
+  {
+    uint16_t rnti;                ///< RNTI of the UE
+    uint8_t nLayers;              ///< number of layers of its transmission mode, 0 if unknown
+    const uint8_t *wbCqi;         ///< last wideband CQI, 0 if none
+    const SbMeasResult_s *sbCqi;  ///< last subband CQI, 0 if none
+    int lcActives;                ///< number of logical channels with data to transmit
+    bool schedulable;             ///< false if the UE cannot be allocated new data
+  };
+
+  /**
+   * \brief Remove all the UEs, keeping the storage.
+   */
+  void Clear (void);
+  /**
+   * \brief Add a UE, with no state yet and schedulable.
+   * \param rnti the RNTI of the UE, greater than the RNTIs already added
+   */
+  void AddUe (uint16_t rnti);
+
+  /**
+   * \returns the number of UEs
+   */
+  uint32_t GetNUes (void) const
+  {
+    return m_ues.size ();
+  }
+  /**
+   * \param i the index of the UE
+   * \returns the state of the UE
+   */
+  Ue & Get (uint32_t i)
+  {
+    return m_ues[i];
+  }
+  /**
+   * \param i the index of the UE
+   * \returns the state of the UE
+   */
+  const Ue & Get (uint32_t i) const
+  {
+    return m_ues[i];
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the index of the UE, GetNUes () if it is not in the table
+   */
+  uint32_t Find (uint16_t rnti) const;
+
+  /**
+   * \brief Set the number of layers of the UEs from their transmission
+   * mode.
+   * \param uesTxMode the transmission mode of the UEs
+   */
+  void SetTxModes (const std::map <uint16_t, uint8_t> &uesTxMode);
+  /**
+   * \brief Point the UEs to their wideband CQI, which must not be
+   * modified while the table is in use.
+   * \param p10CqiRxed the last wideband CQI of the UEs
+   */
+  void SetWidebandCqis (const std::map <uint16_t, uint8_t> &p10CqiRxed);
+  /**
+   * \brief Point the UEs to their subband CQI, which must not be modified
+   * while the table is in use.
+   * \param a30CqiRxed the last subband CQI of the UEs
+   */
+  void SetSubbandCqis (const std::map <uint16_t, SbMeasResult_s> &a30CqiRxed);
+  /**
+   * \brief Set the number of active logical channels of the UEs.
+   * \param rlcBufferReq the RLC buffer status of the logical channels
+   */
+  void SetLcActives (const RlcBufferReqMap &rlcBufferReq);
+  /**
+   * \brief Mark the UEs of a set as not schedulable.
+   * \param rntis the RNTIs of the UEs
+   */
+  void SetNotSchedulable (const std::set <uint16_t> &rntis);
+
+  /**
+   * \param rlcBufferReq the RLC buffer status of the logical channels
+   * \param rnti the RNTI of a UE
+   * \returns the number of logical channels of the UE with data to transmit
+   */
+  static int CountLcActives (const RlcBufferReqMap &rlcBufferReq, uint16_t rnti);
+
+private:
+  std::vector<Ue> m_ues;  ///< UEs, in increasing RNTI order
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_UE_TABLE_H */
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_CODEL_QUEUE_DISC_H
+#define FQ_CODEL_QUEUE_DISC_H
+
+#include <deque>
+#include <list>
+#include <vector>
+#include "queue-disc.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The FlowQueue-CoDel queueing discipline (\RFC{8290})
+ *
+ * Packets are hashed by flow (addresses, protocol and ports) into one of
+ * a fixed number of queues, each managed by its own instance of the CoDel
+ * algorithm.  The queues are served by deficit round robin, giving
+ * precedence to queues which have just become active ("new" flows), so
+ * that sparse flows see little queueing delay whatever the load of the
+ * bulk flows.  When the total number of packets exceeds the limit, the
+ * packet at the head of the queue holding the most bytes is dropped.
+ */
+class FqCoDelQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FqCoDelQueueDisc ();
+  virtual ~FqCoDelQueueDisc ();
+
+  /**
+   * \param item a packet
+   * \returns the index of the queue of the flow of the packet
+   */
+  uint32_t Classify (Ptr<const QueueDiscItem> item) const;
+
+  /**
+   * \param flow the index of a queue
+   * \returns the number of packets held in the queue
+   */
+  uint32_t GetNPacketsInFlow (uint32_t flow) const;
+
+private:
+  /// Status of a flow queue
+  enum FlowStatus
+  {
+    INACTIVE,   //!< Empty, in no list
+    NEW_FLOW,   //!< In the list of new flows
+    OLD_FLOW    //!< In the list of old flows
+  };
+
+  /// A flow queue and its CoDel state
+  struct Flow
+  {
+    std::deque<Ptr<QueueDiscItem> > packets; //!< Packets of the flow
+    uint32_t bytes;          //!< Bytes held
+    int32_t deficit;         //!< DRR deficit
+    FlowStatus status;       //!< Status of the flow
+    bool dropping;           //!< CoDel dropping state
+    uint32_t count;          //!< Packets dropped since entering the dropping state
+    uint32_t lastCount;      //!< Count when the dropping state was last left
+    Time firstAboveTime;     //!< Time the sojourn time is above target for one interval, 0 if below
+    Time dropNext;           //!< Time of the next drop in the dropping state
+
+    Flow ();
+  };
+
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+
+  /**
+   * \brief Dequeue the packet at the head of a flow and check its sojourn
+   * time against the target.
+   * \param flow the flow
+   * \param okToDrop set to true if the sojourn time has been above target
+   * for at least one interval
+   * \returns the packet, 0 if the flow is empty
+   */
+  Ptr<QueueDiscItem> FlowDequeue (Flow &flow, bool &okToDrop);
+
+  /**
+   * \brief Dequeue a packet from a flow, according to CoDel.
+   * \param flow the flow
+   * \returns the packet, 0 if the flow is empty
+   */
+  Ptr<QueueDiscItem> CoDelDequeue (Flow &flow);
+
+  /**
+   * \param t the time of the last drop
+   * \param count the number of drops in the dropping state
+   * \returns the time of the next drop
+   */
+  Time ControlLaw (Time t, uint32_t count) const;
+
+  /**
+   * \brief Drop the packet at the head of the flow holding the most bytes.
+   */
+  void DropFromFattestFlow (void);
+
+  Time m_interval;          //!< CoDel interval
+  Time m_target;            //!< CoDel target queue delay
+  uint32_t m_limit;         //!< Maximum number of packets held
+  uint32_t m_nFlows;        //!< Number of flow queues
+  uint32_t m_quantum;       //!< Bytes served per round of deficit round robin
+  uint32_t m_perturbation;  //!< Value mixed in the flow hash
+  bool m_useEcn;            //!< True to mark ECN-capable packets instead of dropping them
+
+  std::vector<Flow> m_flows;        //!< Flow queues
+  std::list<uint32_t> m_newFlows;   //!< Indices of the new flows
+  std::list<uint32_t> m_oldFlows;   //!< Indices of the old flows
+};
+
+} // namespace ns3
+
+#endif /* FQ_CODEL_QUEUE_DISC_H */
@@ -0,0 +1,306 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef IPV4_END_POINT_DEMUX_H
+#define IPV4_END_POINT_DEMUX_H
+
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <vector>
+#include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
+#include "ipv4-interface.h"
+
+namespace ns3 {
+
+class Ipv4EndPoint;
+
+/**
+ * \brief Demultiplexes packets to various transport layer endpoints
+ *
+ * This class serves as a lookup table to match partial or full information
+ * about a four-tuple to an ns3::Ipv4EndPoint.  It internally contains a list
+ * of endpoints, and has APIs to add and find endpoints in this demux.  This
+ * code is shared in common to TCP and UDP protocols in ns3.  This demux
+ * sits between ns3's layer four and the socket layer
+ *
+ * Endpoints are indexed by their peer (address, port) and local port in
+ * a hash table, and endpoints with a wildcard peer ("listeners") by
+ * their local port, so that Lookup does not depend on the number of
+ * connections of a node.  A bitmap of the local ports in use speeds up
+ * ephemeral port allocation.  Endpoints notify their demux when their
+ * peer changes so that the tables stay up to date.
+ */
+
+class Ipv4EndPointDemux {
+public:
+  /**
+   * \brief Container of the IPv4 endpoints.
+   */
+  typedef std::list<Ipv4EndPoint *> EndPoints;
+
+  /**
+   * \brief Iterator to the container of the IPv4 endpoints.
+   */
+  typedef std::list<Ipv4EndPoint *>::iterator EndPointsI;
+
+  Ipv4EndPointDemux ();
+  ~Ipv4EndPointDemux ();
+
+  /**
+   * \brief Get the entire list of end points registered.
+   * \return list of Ipv4EndPoint
+   */
+  EndPoints GetAllEndPoints (void);
+
+  /**
+   * \brief Lookup for port local.
+   * \param port port to test
+   * \return true if a port local is in EndPoints, false otherwise
+   */
+  bool LookupPortLocal (uint16_t port);
+
+  /**
+   * \brief Lookup for address and port.
+   * \param addr address to test
+   * \param port port to test
+   * \return true if there is a match in EndPoints, false otherwise
+   */
+  bool LookupLocal (Ipv4Address addr, uint16_t port);
+
+  /**
+   * \brief lookup for a match with all the parameters.
+   * \param daddr destination address to test
+   * \param dport destination port to test
+   * \param saddr source address to test
+   * \param sport source port to test
+   * \param incomingInterface the incoming interface
+   * \return list of IPv4EndPoints (could be 0 element)
+   */
+  EndPoints Lookup (Ipv4Address daddr, 
+                    uint16_t dport, 
+                    Ipv4Address saddr, 
+                    uint16_t sport,
+                    Ptr<Ipv4Interface> incomingInterface);
+
+  /**
+   * \brief simple lookup for a match with all the parameters.
+   * \param daddr destination address to test
+   * \param dport destination port to test
+   * \param saddr source address to test
+   * \param sport source port to test
+   * \return IPv4EndPoint (0 if not found)
+   */
+  Ipv4EndPoint *SimpleLookup (Ipv4Address daddr, 
+                              uint16_t dport, 
+                              Ipv4Address saddr, 
+                              uint16_t sport);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \return an empty Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (void);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param address IPv4 address
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ipv4Address address);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param port local port
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param address local address
+   * \param port local port
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ipv4Address address, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ipv4Address localAddress, 
+                          uint16_t localPort,
+                          Ipv4Address peerAddress, 
+                          uint16_t peerPort);
+
+  /**
+   * \brief Remove a end point.
+   * \param endPoint the end point to remove
+   */
+  void DeAllocate (Ipv4EndPoint *endPoint);
+
+private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief End points ordered by allocation.
+   *
+   * The key is the allocation sequence number of the end point so
+   * that lookups return end points in the same order as a single
+   * list of all end points would.
+   */
+  typedef std::map<uint64_t, Ipv4EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief Hash function for the connection table keys.
+   */
+  class KeyHash : public std::unary_function<uint64_t, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a connection key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (uint64_t key) const;
+  };
+
+  /**
+   * \brief Container of end points indexed by local port and peer.
+   */
+  typedef sgi::hash_map<uint64_t, OrderedEndPoints, KeyHash> Connections;
+
+  /**
+   * \brief Build a connection table key.
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the key
+   */
+  static uint64_t GetKey (uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Register a new end point.
+   * \param endPoint the end point
+   */
+  void Register (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the lookup tables.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the lookup tables.
+   * \param endPoint the end point
+   * \param localPort local port the end point was indexed with
+   * \param peerAddress peer address the end point was indexed with
+   * \param peerPort peer port the end point was indexed with
+   */
+  void Remove (Ipv4EndPoint *endPoint, uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Re-index an end point whose local port or peer changed.
+   * \param endPoint the end point
+   * \param localPort previous local port
+   * \param peerAddress previous peer address
+   * \param peerPort previous peer port
+   */
+  void NotifyChanged (Ipv4EndPoint *endPoint, uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Match the local address of an end point against a packet.
+   * \param endP the end point
+   * \param daddr destination address of the packet
+   * \param isBroadcast true if daddr is a broadcast address
+   * \param incomingInterfaceAddr local address of the incoming interface, for broadcasts
+   * \param incomingInterface the incoming interface
+   * \param localAddressMatchesWildCard [out] true if the end point has a wildcard local address
+   * \param localAddressMatchesExact [out] true if the end point local address matches exactly
+   * \return false if the end point cannot receive the packet
+   */
+  bool MatchLocal (Ipv4EndPoint *endP, Ipv4Address daddr, bool isBroadcast,
+                   Ipv4Address incomingInterfaceAddr,
+                   Ptr<Ipv4Interface> incomingInterface,
+                   bool &localAddressMatchesWildCard,
+                   bool &localAddressMatchesExact);
+
+
+  /**
+   * \brief Allocate an ephemeral port.
+   * \returns the ephemeral port
+   */
+  uint16_t AllocateEphemeralPort (void);
+
+  /**
+   * \brief The ephemeral port.
+   */
+  uint16_t m_ephemeral;
+
+  /**
+   * \brief The last ephemeral port.
+   */
+  uint16_t m_portLast;
+
+  /**
+   * \brief The first ephemeral port.
+   */
+  uint16_t m_portFirst;
+
+  /**
+   * \brief All the IPv4 end points.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The IPv4 end points, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_ports;
+
+  /**
+   * \brief The IPv4 end points with a wildcard peer, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_listeners;
+
+  /**
+   * \brief The IPv4 end points, by local port and peer.
+   */
+  Connections m_connections;
+
+  /**
+   * \brief One bit per local port, set if some end point uses it.
+   */
+  std::vector<bool> m_portsInUse;
+
+  /**
+   * \brief The sequence number of the next allocated end point.
+   */
+  uint64_t m_nextSequence;
+};
+
+} // namespace ns3
+
+#endif /* IPV4_END_POINTS_H */
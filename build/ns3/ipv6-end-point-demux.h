@@ -0,0 +1,292 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2007-2009 Strasbourg University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
+ */
+
+#ifndef IPV6_END_POINT_DEMUX_H
+#define IPV6_END_POINT_DEMUX_H
+
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <vector>
+#include "ns3/ipv6-address.h"
+#include "ns3/sgi-hashmap.h"
+#include "ipv6-interface.h"
+
+namespace ns3 {
+
+class Ipv6EndPoint;
+
+/**
+ * \class Ipv6EndPointDemux
+ * \brief Demultiplexor for end points.
+ *
+ * End points are indexed by local port and peer (address, port) in a
+ * hash table, and end points with a wildcard peer by local port, so
+ * that Lookup does not scan every end point of the node.
+ */
+class Ipv6EndPointDemux
+{
+public:
+  /**
+   * \brief Container of the IPv6 endpoints.
+   */
+  typedef std::list<Ipv6EndPoint *>EndPoints;
+
+  /**
+   * \brief Iterator to the container of the IPv6 endpoints.
+   */
+  typedef std::list<Ipv6EndPoint *>::iterator EndPointsI;
+
+  Ipv6EndPointDemux ();
+  ~Ipv6EndPointDemux ();
+
+  /**
+   * \brief Lookup for port local.
+   * \param port port to test
+   * \return true if a port local is in EndPoints, false otherwise
+   */
+  bool LookupPortLocal (uint16_t port);
+
+  /**
+   * \brief Lookup for address and port.
+   * \param addr address to test
+   * \param port port to test
+   * \return true if there is a match in EndPoints, false otherwise
+   */
+  bool LookupLocal (Ipv6Address addr, uint16_t port);
+
+  /**
+   * \brief lookup for a match with all the parameters.
+   * \param dst destination address to test
+   * \param dport destination port to test
+   * \param src source address to test
+   * \param sport source port to test
+   * \param incomingInterface the incoming interface
+   * \return list of IPv6EndPoints (could be 0 element)
+   */
+  EndPoints Lookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport, Ptr<Ipv6Interface> incomingInterface);
+
+  /**
+   * \brief Simple lookup for a four-tuple match.
+   * \param dst destination address to test
+   * \param dport destination port to test
+   * \param src source address to test
+   * \param sport source port to test
+   * \return match or 0 if not found
+   */
+  Ipv6EndPoint* SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \return an empty Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (void);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param address IPv6 address
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address address);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param port local port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param address local address
+   * \param port local port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address address, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address localAddress, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Remove a end point.
+   * \param endPoint the end point to remove
+   */
+  void DeAllocate (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the entire list of end points registered.
+   * \return list of Ipv6EndPoint
+   */
+  EndPoints GetEndPoints () const;
+
+private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief End points ordered by allocation sequence number.
+   */
+  typedef std::map<uint64_t, Ipv6EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief Key of the connection table.
+   */
+  struct Key
+  {
+    Ipv6Address peerAddress; //!< peer address
+    uint16_t localPort;      //!< local port
+    uint16_t peerPort;       //!< peer port
+
+    /**
+     * \brief Equality operator.
+     * \param other key to compare
+     * \return true if the keys are equal
+     */
+    bool operator== (const Key &other) const;
+  };
+
+  /**
+   * \brief Hash function for the connection table keys.
+   */
+  class KeyHash : public std::unary_function<Key, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (const Key &key) const;
+  };
+
+  /**
+   * \brief Container of end points indexed by local port and peer.
+   */
+  typedef sgi::hash_map<Key, OrderedEndPoints, KeyHash> Connections;
+
+  /**
+   * \brief Build a connection table key.
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the key
+   */
+  static Key GetKey (uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Add an end point to the lookup tables.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the lookup tables.
+   * \param endPoint the end point
+   * \param localPort local port the end point was indexed with
+   * \param peerAddress peer address the end point was indexed with
+   * \param peerPort peer port the end point was indexed with
+   */
+  void Remove (Ipv6EndPoint *endPoint, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Re-index an end point whose local port or peer changed.
+   * \param endPoint the end point
+   * \param localPort previous local port
+   * \param peerAddress previous peer address
+   * \param peerPort previous peer port
+   */
+  void NotifyChanged (Ipv6EndPoint *endPoint, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Register a new end point.
+   * \param endPoint the end point
+   */
+  void Register (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Check if an end point bound to a device can receive from an interface.
+   * \param endP the end point
+   * \param incomingInterface the incoming interface
+   * \return true if the end point is not bound or bound to the interface device
+   */
+  bool MatchDevice (Ipv6EndPoint *endP, Ptr<Ipv6Interface> incomingInterface);
+
+  /**
+   * \brief Allocate a ephemeral port.
+   * \return a port
+   */
+  uint16_t AllocateEphemeralPort ();
+
+  /**
+   * \brief The ephemeral port.
+   */
+  uint16_t m_ephemeral;
+
+  /**
+   * \brief The first ephemeral port.
+   */
+  uint16_t m_portFirst;
+
+  /**
+   * \brief The last ephemeral port.
+   */
+  uint16_t m_portLast;
+
+  /**
+   * \brief All the IPv6 end points.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The IPv6 end points, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_ports;
+
+  /**
+   * \brief The IPv6 end points with a wildcard peer, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_listeners;
+
+  /**
+   * \brief The IPv6 end points, by local port and peer.
+   */
+  Connections m_connections;
+
+  /**
+   * \brief One bit per local port, set if some end point uses it.
+   */
+  std::vector<bool> m_portsInUse;
+
+  /**
+   * \brief The sequence number of the next registered end point.
+   */
+  uint64_t m_nextSequence;
+};
+
+} /* namespace ns3 */
+
+#endif /* IPV6_END_POINT_DEMUX_H */
+
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NET_DEVICE_QUEUE_H
+#define NET_DEVICE_QUEUE_H
+
+#include "ns3/object.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Flow control state of the transmission queue of a NetDevice
+ *
+ * A queueing discipline installed above a device aggregates a
+ * NetDeviceQueue to it.  A device which supports flow control looks for
+ * it (see PointToPointNetDevice): it stops the queue when it cannot take
+ * more packets without queueing them itself, and wakes it when it can
+ * again.  Waking the queue invokes the callback of the queueing
+ * discipline, which then sends the packets it holds until the queue is
+ * stopped again.  Devices which ignore the NetDeviceQueue never stop it.
+ */
+class NetDeviceQueue : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  NetDeviceQueue ();
+  virtual ~NetDeviceQueue ();
+
+  /**
+   * \brief Allow packets to be sent to the device.
+   */
+  void Start (void);
+
+  /**
+   * \brief Prevent packets from being sent to the device.
+   */
+  void Stop (void);
+
+  /**
+   * \brief Allow packets to be sent to the device and invoke the wake
+   * callback if the queue was stopped.
+   */
+  void Wake (void);
+
+  /**
+   * \returns true if packets must not be sent to the device
+   */
+  bool IsStopped (void) const;
+
+  /**
+   * \param cb the callback invoked when the queue is woken
+   */
+  void SetWakeCallback (Callback<void> cb);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  bool m_stopped;           //!< True if the device cannot take more packets
+  Callback<void> m_wakeCb;  //!< Callback invoked when the queue is woken
+};
+
+} // namespace ns3
+
+#endif /* NET_DEVICE_QUEUE_H */
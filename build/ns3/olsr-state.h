@@ -0,0 +1,260 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2004 Francisco J. Ros 
+ * Copyright (c) 2007 INESC Porto
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Francisco J. Ros  <fjrm@dif.um.es>
+ *          Gustavo J. A. M. Carneiro <gjc@inescporto.pt>
+ */
+
+/// \brief	This header file declares and defines internal state of an OLSR node.
+
+#ifndef OLSR_STATE_H
+#define OLSR_STATE_H
+
+#include "olsr-repositories.h"
+#include "ns3/sgi-hashmap.h"
+
+namespace ns3 {
+namespace olsr {
+
+/**
+ * This class encapsulates all data structures needed for maintaining internal state of an OLSR node.
+ *
+ * The Link, Neighbor, 2-hop Neighbor, Topology, Duplicate and Interface
+ * Association Sets are indexed by an address of their tuples, so that the
+ * Find and Erase methods do not scan the whole set.  The sets keep the
+ * order in which the tuples were inserted, which decides between equal
+ * candidates in the MPR and routing table computations.
+ */
+class OlsrState
+{
+  //  friend class Olsr;
+
+  /**
+   * \brief Index of the tuples of a set by an address.
+   *
+   * Each tuple gets a number when it is inserted, which increases with its
+   * position in the set.  The index maps an address to the numbers of its
+   * tuples, and the position of a number is found by binary search.
+   */
+  class TupleIndex
+  {
+  public:
+    /// Numbers of the tuples of an address, in the order of the set
+    typedef std::vector<uint64_t> Numbers;
+
+    TupleIndex ();
+    /**
+     * \param key address of a tuple appended to the set
+     */
+    void Insert (const Ipv4Address &key);
+    /**
+     * \param key address of the tuple
+     * \param position position of the tuple erased from the set
+     */
+    void Erase (const Ipv4Address &key, uint32_t position);
+    /// Forget all the tuples
+    void Clear ();
+    /**
+     * \param key an address
+     * \returns the numbers of the tuples of the address, NULL if none
+     */
+    const Numbers* Find (const Ipv4Address &key) const;
+    /**
+     * \param number number of a tuple
+     * \returns the position of the tuple in the set
+     */
+    uint32_t GetPosition (uint64_t number) const;
+
+  private:
+    /// Map of the addresses to the numbers of their tuples
+    typedef sgi::hash_map<Ipv4Address, Numbers, Ipv4AddressHash> Map;
+    Map m_map;                  ///< Numbers of the tuples of each address
+    Numbers m_numbers;          ///< Number of the tuple at each position
+    uint64_t m_nextNumber;      ///< Number of the next inserted tuple
+  };
+
+protected:
+  LinkSet m_linkSet;    ///< Link Set (\RFC{3626}, section 4.2.1).
+  NeighborSet m_neighborSet;            ///< Neighbor Set (\RFC{3626}, section 4.3.1).
+  TwoHopNeighborSet m_twoHopNeighborSet;        ///< 2-hop Neighbor Set (\RFC{3626}, section 4.3.2).
+  TopologySet m_topologySet;    ///< Topology Set (\RFC{3626}, section 4.4).
+  MprSet m_mprSet;      ///< MPR Set (\RFC{3626}, section 4.3.3).
+  MprSelectorSet m_mprSelectorSet;      ///< MPR Selector Set (\RFC{3626}, section 4.3.4).
+  DuplicateSet m_duplicateSet;  ///< Duplicate Set (\RFC{3626}, section 3.4).
+  IfaceAssocSet m_ifaceAssocSet;        ///< Interface Association Set (\RFC{3626}, section 4.1).
+  AssociationSet m_associationSet; ///<	Association Set (\RFC{3626}, section12.2). Associations obtained from HNA messages generated by other nodes.
+  Associations m_associations;  ///< The node's local Host Network Associations that will be advertised using HNA messages.
+
+  TupleIndex m_linkIndex;       ///< Link Set by neighbor interface address.
+  TupleIndex m_neighborIndex;   ///< Neighbor Set by neighbor main address.
+  TupleIndex m_twoHopNeighborIndex;     ///< 2-hop Neighbor Set by neighbor main address.
+  TupleIndex m_topologyIndex;   ///< Topology Set by last address.
+  TupleIndex m_duplicateIndex;  ///< Duplicate Set by originator address.
+  TupleIndex m_ifaceAssocIndex; ///< Interface Association Set by interface address.
+  bool m_changed;               ///< True if a tuple the routing table is computed from has changed.
+
+public:
+
+  OlsrState ()
+    : m_changed (false)
+  {}
+
+  /**
+   * \returns true if a tuple of the Link, Neighbor, 2-hop Neighbor,
+   * Topology or Interface Association Sets has been inserted, erased or
+   * changed since the last call to SetChanged (false)
+   */
+  bool IsChanged () const
+  {
+    return m_changed;
+  }
+  /**
+   * \param changed whether the routing table must be computed again, e.g.
+   * after a tuple has been updated through a pointer
+   */
+  void SetChanged (bool changed)
+  {
+    m_changed = changed;
+  }
+
+  // MPR selector
+  const MprSelectorSet & GetMprSelectors () const
+  {
+    return m_mprSelectorSet;
+  }
+  MprSelectorTuple* FindMprSelectorTuple (const Ipv4Address &mainAddr);
+  void EraseMprSelectorTuple (const MprSelectorTuple &tuple);
+  void EraseMprSelectorTuples (const Ipv4Address &mainAddr);
+  void InsertMprSelectorTuple (const MprSelectorTuple &tuple);
+  std::string PrintMprSelectorSet () const;
+
+  // Neighbor
+  const NeighborSet & GetNeighbors () const
+  {
+    return m_neighborSet;
+  }
+  NeighborTuple* FindNeighborTuple (const Ipv4Address &mainAddr);
+  const NeighborTuple* FindSymNeighborTuple (const Ipv4Address &mainAddr) const;
+  NeighborTuple* FindNeighborTuple (const Ipv4Address &mainAddr,
+                                    uint8_t willingness);
+  void EraseNeighborTuple (const NeighborTuple &neighborTuple);
+  void EraseNeighborTuple (const Ipv4Address &mainAddr);
+  void InsertNeighborTuple (const NeighborTuple &tuple);
+
+  // Two-hop neighbor
+  const TwoHopNeighborSet & GetTwoHopNeighbors () const
+  {
+    return m_twoHopNeighborSet;
+  }
+  TwoHopNeighborTuple* FindTwoHopNeighborTuple (const Ipv4Address &neighbor,
+                                                const Ipv4Address &twoHopNeighbor);
+  void EraseTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple);
+  void EraseTwoHopNeighborTuples (const Ipv4Address &neighbor);
+  void EraseTwoHopNeighborTuples (const Ipv4Address &neighbor,
+                                  const Ipv4Address &twoHopNeighbor);
+  void InsertTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple);
+  /// Replace the interface addresses of the Neighbor and 2-hop Neighbor
+  /// Sets by the main addresses of the Interface Association Set.
+  void UpdateNeighborMainAddresses ();
+
+  // MPR
+  bool FindMprAddress (const Ipv4Address &address);
+  /// MprSet is set by routing protocol after MprCompute
+  void SetMprSet (MprSet mprSet);
+  /// Gets an MPR Set needed by tests
+  MprSet GetMprSet () const;
+
+  // Duplicate
+  DuplicateTuple* FindDuplicateTuple (const Ipv4Address &address,
+                                      uint16_t sequenceNumber);
+  void EraseDuplicateTuple (const DuplicateTuple &tuple);
+  void InsertDuplicateTuple (const DuplicateTuple &tuple);
+
+  // Link
+  const LinkSet & GetLinks () const
+  {
+    return m_linkSet;
+  }
+  LinkTuple* FindLinkTuple (const Ipv4Address &ifaceAddr);
+  LinkTuple* FindSymLinkTuple (const Ipv4Address &ifaceAddr, Time time);
+  void EraseLinkTuple (const LinkTuple &tuple);
+  LinkTuple& InsertLinkTuple (const LinkTuple &tuple);
+
+  // Topology
+  const TopologySet & GetTopologySet () const
+  {
+    return m_topologySet;
+  }
+  TopologyTuple* FindTopologyTuple (const Ipv4Address &destAddr,
+                                    const Ipv4Address &lastAddr);
+  TopologyTuple* FindNewerTopologyTuple (const Ipv4Address &lastAddr,
+                                         uint16_t ansn);
+  /**
+   * \brief Find the topology tuples of a last address.
+   * \param lastAddr the last address
+   * \param positions vector the positions of the tuples in the Topology Set
+   * are appended to, in increasing order
+   */
+  void FindTopologyTuples (const Ipv4Address &lastAddr,
+                           std::vector<uint32_t> &positions) const;
+  void EraseTopologyTuple (const TopologyTuple &tuple);
+  void EraseOlderTopologyTuples (const Ipv4Address &lastAddr,
+                                 uint16_t ansn);
+  void InsertTopologyTuple (const TopologyTuple &tuple);
+
+  // Interface association
+  const IfaceAssocSet & GetIfaceAssocSet () const
+  {
+    return m_ifaceAssocSet;
+  }
+  IfaceAssocTuple* FindIfaceAssocTuple (const Ipv4Address &ifaceAddr);
+  const IfaceAssocTuple* FindIfaceAssocTuple (const Ipv4Address &ifaceAddr) const;
+  IfaceAssocTuple* FindIfaceAssocTuple (const Ipv4Address &ifaceAddr,
+                                        const Ipv4Address &mainAddr);
+  void EraseIfaceAssocTuple (const IfaceAssocTuple &tuple);
+  void InsertIfaceAssocTuple (const IfaceAssocTuple &tuple);
+
+  // Host-Network Association
+  const AssociationSet & GetAssociationSet () const  // Associations known to the node
+  {
+    return m_associationSet;
+  }
+
+  const Associations & GetAssociations () const  // Set of associations that the node has
+  {
+    return m_associations;
+  }
+
+  AssociationTuple* FindAssociationTuple (const Ipv4Address &gatewayAddr, \
+                                          const Ipv4Address &networkAddr, \
+                                          const Ipv4Mask &netmask);
+  void EraseAssociationTuple (const AssociationTuple &tuple);
+  void InsertAssociationTuple (const AssociationTuple &tuple);
+  void EraseAssociation (const Association &tuple);
+  void InsertAssociation (const Association &tuple);
+
+  // Returns a vector of all interfaces of a given neighbor, with the
+  // exception of the "main" one.
+  std::vector<Ipv4Address>
+  FindNeighborInterfaces (const Ipv4Address &neighborMainAddr) const;
+
+};
+
+}} // namespace olsr,ns3
+
+#endif /* OLSR_STATE_H */
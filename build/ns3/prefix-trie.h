@@ -0,0 +1,348 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A path-compressed binary trie of address prefixes
+ *
+ * Keys are addresses in network byte order, at most 16 bytes long, and
+ * each stored prefix holds the list of values inserted under it, in
+ * insertion order.  Nodes are only created where prefixes are stored or
+ * where two stored prefixes diverge, so a lookup visits at most one node
+ * per stored prefix length on the path to the key and never depends on
+ * the total number of prefixes.
+ *
+ * This is used by the static routing protocols to find the routes
+ * covering a destination without scanning their whole route list.
+ */
+template <typename T>
+class PrefixTrie
+{
+public:
+  /// Container holding the values stored under one prefix
+  typedef std::vector<T> Values;
+
+  PrefixTrie ();
+  ~PrefixTrie ();
+
+  /**
+   * \brief Store a value under a prefix
+   * \param key the prefix bits, in network byte order
+   * \param length the prefix length, in bits
+   * \param value the value, appended after the values already stored
+   * under the same prefix
+   */
+  void Insert (uint8_t const *key, uint8_t length, T const &value);
+
+  /**
+   * \brief Remove a value stored under a prefix
+   * \param key the prefix bits, in network byte order
+   * \param length the prefix length, in bits
+   * \param value the value to remove
+   * \returns true if the value was found
+   */
+  bool Remove (uint8_t const *key, uint8_t length, T const &value);
+
+  /**
+   * \brief Remove all the stored prefixes
+   */
+  void Clear (void);
+
+  /**
+   * \brief Find the prefixes covering an address
+   * \param key the address, in network byte order
+   * \param keyLength the address length, in bits
+   * \param matches [out] the values of every stored prefix covering the
+   * address, from the shortest prefix to the longest one
+   */
+  void Match (uint8_t const *key, uint8_t keyLength, std::vector<Values const *> &matches) const;
+
+  /**
+   * \param key the prefix bits, in network byte order
+   * \param length the prefix length, in bits
+   * \returns the values stored under exactly this prefix, or 0 if none
+   */
+  Values const * Find (uint8_t const *key, uint8_t length) const;
+
+private:
+  /// A trie node
+  struct Node
+  {
+    uint8_t prefix[16]; //!< prefix bits, zero beyond length
+    uint8_t length;     //!< prefix length, in bits
+    Node *child[2];     //!< children, indexed by the bit following the prefix
+    Values values;      //!< values stored under this prefix
+  };
+
+  /**
+   * \param key the key
+   * \param bit the bit index, 0 being the most significant bit
+   * \returns the value of the bit
+   */
+  static uint8_t GetBit (uint8_t const *key, uint8_t bit);
+  /**
+   * \param a first key
+   * \param b second key
+   * \param max maximum number of bits to compare
+   * \returns the number of leading bits a and b have in common, up to max
+   */
+  static uint8_t CommonLength (uint8_t const *a, uint8_t const *b, uint8_t max);
+  /**
+   * \param key the prefix bits
+   * \param length the prefix length
+   * \returns a new node for this prefix, without children
+   */
+  static Node * NewNode (uint8_t const *key, uint8_t length);
+  /**
+   * \brief Recursively delete the children of a node
+   * \param node the node
+   */
+  static void DeleteChildren (Node *node);
+
+  Node *m_root; //!< node of the zero-length prefix, always present
+};
+
+template <typename T>
+PrefixTrie<T>::PrefixTrie ()
+{
+  uint8_t zero[16] = { 0 };
+  m_root = NewNode (zero, 0);
+}
+
+template <typename T>
+PrefixTrie<T>::~PrefixTrie ()
+{
+  DeleteChildren (m_root);
+  delete m_root;
+}
+
+template <typename T>
+uint8_t
+PrefixTrie<T>::GetBit (uint8_t const *key, uint8_t bit)
+{
+  return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+template <typename T>
+uint8_t
+PrefixTrie<T>::CommonLength (uint8_t const *a, uint8_t const *b, uint8_t max)
+{
+  uint8_t length = 0;
+  uint8_t i = 0;
+  while (length < max)
+    {
+      uint8_t diff = a[i] ^ b[i];
+      if (diff == 0)
+        {
+          length += 8;
+          i++;
+          continue;
+        }
+      while ((diff & 0x80) == 0)
+        {
+          diff <<= 1;
+          length++;
+        }
+      break;
+    }
+  return std::min (length, max);
+}
+
+template <typename T>
+typename PrefixTrie<T>::Node *
+PrefixTrie<T>::NewNode (uint8_t const *key, uint8_t length)
+{
+  Node *node = new Node;
+  std::memset (node->prefix, 0, sizeof (node->prefix));
+  std::memcpy (node->prefix, key, (length + 7) / 8);
+  if (length % 8)
+    {
+      node->prefix[length / 8] &= static_cast<uint8_t> (0xff << (8 - length % 8));
+    }
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+template <typename T>
+void
+PrefixTrie<T>::DeleteChildren (Node *node)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      if (node->child[i] != 0)
+        {
+          DeleteChildren (node->child[i]);
+          delete node->child[i];
+          node->child[i] = 0;
+        }
+    }
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Insert (uint8_t const *key, uint8_t length, T const &value)
+{
+  Node *node = m_root;
+  while (node->length < length)
+    {
+      uint8_t bit = GetBit (key, node->length);
+      Node *child = node->child[bit];
+      if (child == 0)
+        {
+          child = NewNode (key, length);
+          child->values.push_back (value);
+          node->child[bit] = child;
+          return;
+        }
+      uint8_t common = CommonLength (child->prefix, key, std::min (child->length, length));
+      if (common == child->length)
+        {
+          node = child;
+          continue;
+        }
+      // the child diverges from the key before its end: split it
+      Node *split = NewNode (key, common);
+      split->child[GetBit (child->prefix, common)] = child;
+      node->child[bit] = split;
+      if (common == length)
+        {
+          split->values.push_back (value);
+        }
+      else
+        {
+          Node *leaf = NewNode (key, length);
+          leaf->values.push_back (value);
+          split->child[GetBit (key, common)] = leaf;
+        }
+      return;
+    }
+  node->values.push_back (value);
+}
+
+template <typename T>
+bool
+PrefixTrie<T>::Remove (uint8_t const *key, uint8_t length, T const &value)
+{
+  Node *grandParent = 0;
+  Node *parent = 0;
+  Node *node = m_root;
+  while (node->length < length)
+    {
+      Node *child = node->child[GetBit (key, node->length)];
+      if (child == 0 || child->length > length
+          || CommonLength (child->prefix, key, child->length) < child->length)
+        {
+          return false;
+        }
+      grandParent = parent;
+      parent = node;
+      node = child;
+    }
+  typename Values::iterator it = std::find (node->values.begin (), node->values.end (), value);
+  if (it == node->values.end ())
+    {
+      return false;
+    }
+  node->values.erase (it);
+  if (parent == 0 || !node->values.empty ())
+    {
+      return true;
+    }
+  // drop the node if it no longer separates two branches
+  Node **slot = &parent->child[GetBit (node->prefix, parent->length)];
+  if (node->child[0] != 0 && node->child[1] != 0)
+    {
+      return true;
+    }
+  *slot = node->child[0] != 0 ? node->child[0] : node->child[1];
+  delete node;
+  if (*slot == 0 && grandParent != 0 && parent->values.empty ())
+    {
+      // the parent was a split node and is now left with a single child
+      Node *other = parent->child[0] != 0 ? parent->child[0] : parent->child[1];
+      grandParent->child[GetBit (parent->prefix, grandParent->length)] = other;
+      delete parent;
+    }
+  return true;
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Clear (void)
+{
+  DeleteChildren (m_root);
+  m_root->values.clear ();
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Match (uint8_t const *key, uint8_t keyLength, std::vector<Values const *> &matches) const
+{
+  matches.clear ();
+  Node const *node = m_root;
+  while (true)
+    {
+      if (!node->values.empty ())
+        {
+          matches.push_back (&node->values);
+        }
+      if (node->length >= keyLength)
+        {
+          break;
+        }
+      Node const *child = node->child[GetBit (key, node->length)];
+      if (child == 0 || CommonLength (child->prefix, key, child->length) < child->length)
+        {
+          break;
+        }
+      node = child;
+    }
+}
+
+template <typename T>
+typename PrefixTrie<T>::Values const *
+PrefixTrie<T>::Find (uint8_t const *key, uint8_t length) const
+{
+  Node const *node = m_root;
+  while (node->length < length)
+    {
+      Node const *child = node->child[GetBit (key, node->length)];
+      if (child == 0 || child->length > length
+          || CommonLength (child->prefix, key, child->length) < child->length)
+        {
+          return 0;
+        }
+      node = child;
+    }
+  return node->values.empty () ? 0 : &node->values;
+}
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
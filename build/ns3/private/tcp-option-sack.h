@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_OPTION_SACK_H
+#define TCP_OPTION_SACK_H
+
+#include <list>
+#include "ns3/tcp-option.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \brief Defines the TCP option of kind 5 (selective acknowledgment option)
+ * as in \RFC{2018}
+ *
+ * The option lists up to four blocks of data received out of order,
+ * each given by the sequence number of its first byte and the sequence
+ * number immediately following its last byte.  With the timestamp
+ * option also present, only three blocks fit in the TCP option space.
+ */
+class TcpOptionSack : public TcpOption
+{
+public:
+  /// A SACK block: left edge and right edge (one past the last byte)
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /// A list of SACK blocks, in the order they appear in the option
+  typedef std::list<SackBlock> SackList;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionSack ();
+  virtual ~TcpOptionSack ();
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  virtual uint8_t GetKind (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+
+  /**
+   * \brief Append a block to the option
+   * \param block the SACK block
+   */
+  void AddSackBlock (SackBlock block);
+
+  /**
+   * \brief Get the number of blocks in the option
+   * \return the number of SACK blocks
+   */
+  uint32_t GetNumSackBlocks (void) const;
+
+  /**
+   * \brief Remove all the blocks from the option
+   */
+  void ClearSackList (void);
+
+  /**
+   * \brief Get the blocks of the option
+   * \return the SACK blocks
+   */
+  SackList GetSackList (void) const;
+
+  static const uint32_t MAX_SACK_BLOCKS = 4; //!< Maximum number of blocks in the option
+
+protected:
+  SackList m_sackList; //!< the SACK blocks
+};
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_SACK */
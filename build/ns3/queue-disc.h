@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUEUE_DISC_H
+#define QUEUE_DISC_H
+
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/net-device.h"
+#include "ns3/net-device-queue.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A packet held by a queueing discipline, along with what the
+ * device needs to send it.
+ *
+ * The packet starts with its network header (IPv4 or IPv6, according to
+ * the protocol number), which the queueing disciplines inspect to classify
+ * and to mark packets.
+ */
+class QueueDiscItem : public SimpleRefCount<QueueDiscItem>
+{
+public:
+  /**
+   * \param packet the packet, starting with its network header
+   * \param address the destination hardware address
+   * \param protocol the protocol number of the packet
+   */
+  QueueDiscItem (Ptr<Packet> packet, const Address &address, uint16_t protocol);
+
+  /**
+   * \returns the packet
+   */
+  Ptr<Packet> GetPacket (void) const;
+  /**
+   * \returns the size of the packet
+   */
+  uint32_t GetSize (void) const;
+  /**
+   * \returns the destination hardware address
+   */
+  Address GetAddress (void) const;
+  /**
+   * \returns the protocol number of the packet
+   */
+  uint16_t GetProtocol (void) const;
+  /**
+   * \param t the time the packet entered the queueing discipline
+   */
+  void SetTimeStamp (Time t);
+  /**
+   * \returns the time the packet entered the queueing discipline
+   */
+  Time GetTimeStamp (void) const;
+
+  /**
+   * \returns the Type of Service (IPv4) or Traffic Class (IPv6) byte of the
+   * packet, 0 for other protocols
+   */
+  uint8_t GetTos (void) const;
+
+  /**
+   * \brief Hash the flow of the packet: addresses, protocol and, for TCP
+   * and UDP, ports.
+   * \param perturbation a value mixed in the hash
+   * \returns the hash, 0 for a packet which is neither IPv4 nor IPv6
+   */
+  uint32_t Hash (uint32_t perturbation) const;
+
+  /**
+   * \brief Set the ECN field of the network header to Congestion
+   * Experienced, if the packet is ECN-capable.
+   * \returns true if the packet has been marked
+   */
+  bool Mark (void);
+
+private:
+  Ptr<Packet> m_packet;  //!< The packet
+  Address m_address;     //!< Destination hardware address
+  uint16_t m_protocol;   //!< Protocol number
+  Time m_tstamp;         //!< Time the packet entered the queueing discipline
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Base class of the queueing disciplines, which hold the packets
+ * sent by the network layer until the device can take them.
+ *
+ * The queueing discipline installed on a device (see TrafficControlLayer)
+ * receives the packets of the network layer.  It hands them to the device
+ * as long as the NetDeviceQueue of the device is not stopped, and resumes
+ * when the device wakes it.  Subclasses only decide which packet to drop
+ * or mark upon enqueue, and which packet to send next.
+ *
+ * Without flow control from the device, packets go through the queueing
+ * discipline at once and pile up in the queue of the device.
+ */
+class QueueDisc : public Object
+{
+public:
+  /**
+   * \brief Statistics of a queueing discipline
+   */
+  struct Stats
+  {
+    uint32_t nTotalReceivedPackets;  //!< Packets received from the network layer
+    uint64_t nTotalReceivedBytes;    //!< Bytes received from the network layer
+    uint32_t nTotalSentPackets;      //!< Packets handed to the device
+    uint64_t nTotalSentBytes;        //!< Bytes handed to the device
+    uint32_t nTotalDroppedPackets;   //!< Packets dropped
+    uint64_t nTotalDroppedBytes;     //!< Bytes dropped
+    uint32_t nTotalMarkedPackets;    //!< Packets marked Congestion Experienced
+
+    Stats ();
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  QueueDisc ();
+  virtual ~QueueDisc ();
+
+  /**
+   * \brief Enqueue a packet, unless the queueing discipline drops it.
+   * \param item the packet
+   * \returns true if the packet has been enqueued
+   */
+  bool Enqueue (Ptr<QueueDiscItem> item);
+
+  /**
+   * \brief Remove the next packet to send.
+   * \returns the packet, 0 if none
+   */
+  Ptr<QueueDiscItem> Dequeue (void);
+
+  /**
+   * \brief Send packets to the device until the queueing discipline is
+   * empty or the device stops its NetDeviceQueue.
+   */
+  void Run (void);
+
+  /**
+   * \param device the device the packets are sent to
+   */
+  void SetNetDevice (Ptr<NetDevice> device);
+
+  /**
+   * \returns the device the packets are sent to
+   */
+  Ptr<NetDevice> GetNetDevice (void) const;
+
+  /**
+   * \returns the number of packets held
+   */
+  uint32_t GetNPackets (void) const;
+
+  /**
+   * \returns the number of bytes held
+   */
+  uint32_t GetNBytes (void) const;
+
+  /**
+   * \returns the statistics of the queueing discipline
+   */
+  const Stats& GetStats (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+  /**
+   * \brief Drop a packet which has been enqueued.
+   * \param item the packet
+   */
+  void DropAfterEnqueue (Ptr<QueueDiscItem> item);
+
+  /**
+   * \brief Mark a packet Congestion Experienced, if it is ECN-capable.
+   * \param item the packet
+   * \returns true if the packet has been marked
+   */
+  bool Mark (Ptr<QueueDiscItem> item);
+
+private:
+  /**
+   * \param item the packet
+   * \returns true if the packet has been enqueued, false if it has been
+   * dropped
+   */
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item) = 0;
+
+  /**
+   * \returns the next packet to send, 0 if none
+   */
+  virtual Ptr<QueueDiscItem> DoDequeue (void) = 0;
+
+  uint32_t m_nPackets;                 //!< Packets held
+  uint32_t m_nBytes;                   //!< Bytes held
+  Stats m_stats;                       //!< Statistics
+  Ptr<NetDevice> m_device;             //!< Device the packets are sent to
+  Ptr<NetDeviceQueue> m_deviceQueue;   //!< Flow control state of the device
+  bool m_running;                      //!< True while Run () sends packets
+
+  /// Traced callback: fired when a packet is enqueued
+  TracedCallback<Ptr<const Packet> > m_traceEnqueue;
+  /// Traced callback: fired when a packet is dequeued
+  TracedCallback<Ptr<const Packet> > m_traceDequeue;
+  /// Traced callback: fired when a packet is dropped
+  TracedCallback<Ptr<const Packet> > m_traceDrop;
+  /// Traced callback: fired when a packet is marked
+  TracedCallback<Ptr<const Packet> > m_traceMark;
+};
+
+} // namespace ns3
+
+#endif /* QUEUE_DISC_H */
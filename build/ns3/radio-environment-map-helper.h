@@ -0,0 +1,284 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2012 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Nicola Baldo <nbaldo@cttc.es>
+ */
+
+
+#ifndef RADIO_ENVIRONMENT_MAP_HELPER_H
+#define RADIO_ENVIRONMENT_MAP_HELPER_H
+
+
+#include <ns3/object.h>
+#include <ns3/vector.h>
+#include <ns3/core-config.h>
+#include <fstream>
+#include <vector>
+
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-mutex.h>
+#include <ns3/system-condition.h>
+#endif
+
+
+namespace ns3 {
+
+class RemSpectrumPhy;
+class Node;
+class NetDevice;
+class SpectrumChannel;
+//class BuildingsMobilityModel;
+class MobilityModel;
+class SpectrumValue;
+class AntennaModel;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
+class SpectrumSignalParameters;
+
+/** 
+ * \ingroup lte
+ *
+ * Generates a 2D map of the SINR from the strongest transmitter in the
+ * downlink of an LTE FDD system. For instructions on usage, please refer to
+ * the User Documentation.
+ *
+ * By default, the map is obtained by attaching RemSpectrumPhy listeners to
+ * the channel and running the simulation while they receive the signals.
+ * When the DirectEvaluation attribute is set, the signals transmitted on
+ * the channel during one subframe are recorded instead, and the SINR of
+ * every point is computed from them with the propagation models of the
+ * channel, without simulation events. The points are then evaluated by
+ * tiles on several threads, and the tiles are written to the output file
+ * in order as soon as they are complete.
+ */
+class RadioEnvironmentMapHelper : public Object
+{
+public:  
+
+  RadioEnvironmentMapHelper ();
+  virtual ~RadioEnvironmentMapHelper ();
+  
+  // inherited from Object
+  virtual void DoDispose (void);
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** 
+   * \return the bandwidth (in num of RBs) over which SINR is calculated
+   */
+  uint8_t GetBandwidth () const;
+
+  /** 
+   *
+   * \param bw  the bandwidth (in num of RBs) over which SINR is calculated
+   */
+  void SetBandwidth (uint8_t bw);
+
+  /** 
+   * Deploy the RemSpectrumPhy objects that generate the map according to the specified settings.
+   * 
+   */
+  void Install ();
+
+private:
+
+  /**
+   * Scheduled by Install() to perform the actual generation of map.
+   *
+   * If control channel is used for SINR calculation (the default), the delay
+   * is 2.6 milliseconds from the start of simulation. Otherwise, if data
+   * channel is used, the delay is 500.1 milliseconds from the start of
+   * simulation.
+   *
+   * The method will divide the whole map into parts (each contains at most a
+   * certain number of SINR listening points), and then call RunOneIteration()
+   * on each part, one by one.
+   */
+  void DelayedInstall ();
+
+  /**
+   * Mobilize all the listeners to a specified area. Afterwards, schedule a
+   * call to PrintAndReset() in 0.5 milliseconds.
+   *
+   * \param xMin X coordinate of the first SINR listening point to deploy.
+   * \param xMax X coordinate of the last SINR listening point to deploy.
+   * \param yMin Y coordinate of the first SINR listening point to deploy.
+   * \param yMax Y coordinate of the last SINR listening point to deploy.
+   */
+  void RunOneIteration (double xMin, double xMax, double yMin, double yMax);
+
+  /// Go through every listener, write the computed SINR, and then reset it.
+  void PrintAndReset ();
+
+  /// Called when the map generation procedure has been completed.
+  void Finalize ();
+
+  /**
+   * Scheduled by DelayedInstall() with direct evaluation to start recording
+   * the signals transmitted on the channel. Afterwards, schedule a call to
+   * GenerateMap() in 0.5 milliseconds.
+   */
+  void StartRecording ();
+
+  /**
+   * Connected to the `TxSigParams` trace source of the channel while
+   * recording.
+   *
+   * \param params the parameters of the transmitted signal
+   */
+  void RecordTransmission (Ptr<SpectrumSignalParameters> params);
+
+  /// Compute the SINR of every point from the recorded signals and write it.
+  void GenerateMap ();
+
+  /**
+   * Compute the SINR of a point from the recorded signals.
+   *
+   * \param worker the index of the thread computing the point
+   * \param point the index of the point, in output order
+   * \return the SINR in linear units
+   */
+  double EvaluatePoint (uint32_t worker, uint32_t point);
+
+  /**
+   * Compute the SINR of the points of a tile.
+   *
+   * \param worker the index of the thread computing the tile
+   * \param tile the index of the tile
+   */
+  void ComputeTile (uint32_t worker, uint32_t tile);
+
+  /**
+   * Write the SINR of the points of a computed tile to the output file.
+   *
+   * \param tile the index of the tile
+   */
+  void WriteTile (uint32_t tile);
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * Compute the next tile, unless all of them have been started or the
+   * tiles not yet written fill the buffers.
+   *
+   * \param worker the index of the thread computing the tile
+   * \return false if no tile has been computed
+   */
+  bool ComputeNextTile (uint32_t worker);
+
+  /// Body of the threads computing tiles along with the simulator thread.
+  void DoRunThread ();
+#endif
+
+  /// A signal transmitted on the channel while recording.
+  struct RemTransmission
+  {
+    /// Power spectral density, converted to the spectrum model of the map.
+    Ptr<SpectrumValue> psd;
+    /// Power over the bandwidth or the RB of the map, before propagation.
+    double power;
+    /// Position of the transmitter.
+    Vector position;
+    /// Antenna of the transmitter, if any.
+    Ptr<AntennaModel> antenna;
+  };
+
+  /// Signals recorded for direct evaluation.
+  std::vector<RemTransmission> m_transmissions;
+  /// Mobility of the transmitters, one set per thread ([worker][transmission]).
+  std::vector<std::vector<Ptr<MobilityModel> > > m_txMobility;
+  /**
+   * Positions of the points, reused as the map is evaluated: point i is
+   * located with m_pointMobility[i % m_pointMobility.size ()].
+   */
+  std::vector<Ptr<MobilityModel> > m_pointMobility;
+  std::vector<double> m_x;  ///< X coordinates of the points, in output order.
+  std::vector<double> m_y;  ///< Y coordinates of the points, in output order.
+  Ptr<PropagationLossModel> m_propagationLoss;  ///< Loss model of the channel.
+  /// Frequency-dependent loss model of the channel.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  double m_maxLossDb;      ///< The `MaxLossDb` attribute of the channel.
+  uint32_t m_tileSize;     ///< Number of points per tile.
+  uint32_t m_nTiles;       ///< Number of tiles of the map.
+  uint32_t m_maxPendingTiles;  ///< Tiles computed ahead of the output.
+  /// SINR of the points of the pending tiles, tile i in [i % m_maxPendingTiles].
+  std::vector<std::vector<double> > m_tileSinr;
+#ifdef HAVE_PTHREAD_H
+  SystemMutex m_mutex;                ///< Protects the state below.
+  SystemCondition m_tileAvailable;    ///< Signaled when a tile may be started.
+  SystemCondition m_tileComputed;     ///< Signaled when a tile is complete.
+  uint32_t m_nextTile;                ///< Index of the next tile to start.
+  uint32_t m_nextTileToWrite;         ///< Index of the next tile to write.
+  uint32_t m_nextWorker;              ///< Index of the next thread to start.
+  std::vector<bool> m_tileDone;       ///< True if the pending tile is complete.
+#endif
+
+  /// A complete Radio Environment Map is composed of many of this structure.
+  struct RemPoint 
+  {
+    /// Simplified listener which compute SINR over the DL channel.
+    Ptr<RemSpectrumPhy> phy;
+    /// Position of the listener in the environment.
+    Ptr<MobilityModel> bmm;
+  };
+
+  /// List of listeners in the environment.
+  std::list<RemPoint> m_rem;
+
+  double m_xMin;   ///< The `XMin` attribute.
+  double m_xMax;   ///< The `XMax` attribute.
+  uint16_t m_xRes; ///< The `XRes` attribute.
+  double m_xStep;  ///< Distance along X axis between adjacent listening points.
+
+  double m_yMin;   ///< The `YMin` attribute.
+  double m_yMax;   ///< The `YMax` attribute.
+  uint16_t m_yRes; ///< The `YRes` attribute.
+  double m_yStep;  ///< Distance along Y axis between adjacent listening points.
+
+  uint32_t m_maxPointsPerIteration;  ///< The `MaxPointsPerIteration` attribute.
+
+  uint16_t m_earfcn;     ///< The `Earfcn` attribute.
+  uint16_t m_bandwidth;  ///< The `Bandwidth` attribute.
+ 
+  double m_z;  ///< The `Z` attribute.
+
+  std::string m_channelPath;  ///< The `ChannelPath` attribute.
+  std::string m_outputFile;   ///< The `OutputFile` attribute.
+
+  bool m_stopWhenDone;   ///< The `StopWhenDone` attribute.
+  
+  /// The channel object taken from the `ChannelPath` attribute.
+  Ptr<SpectrumChannel> m_channel;
+
+  double m_noisePower;  ///< The `NoisePower` attribute.
+
+  std::ofstream m_outFile;  ///< Stream the output to a file.
+
+  bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
+  int32_t m_rbId;         ///< The `RbId` attribute.
+
+  bool m_directEvaluation;  ///< The `DirectEvaluation` attribute.
+  uint32_t m_nThreads;      ///< The `Threads` attribute.
+
+}; // end of `class RadioEnvironmentMapHelper`
+
+
+} // end of `namespace ns3`
+
+#endif /* RADIO_ENVIRONMENT_MAP_HELPER_H */
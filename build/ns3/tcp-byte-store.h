@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_BYTE_STORE_H
+#define TCP_BYTE_STORE_H
+
+#include <map>
+#include <list>
+#include "ns3/ptr.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+class Packet;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Bytes of a TCP stream, kept as non-overlapping intervals
+ *
+ * Each stored interval [seq, seq + size) is the packet holding its bytes,
+ * indexed by the sequence number of its first byte.  The interval
+ * holding any given byte is thus found in logarithmic time, instead of by
+ * walking every stored packet from the head of the buffer, and packets
+ * are only fragmented at the edges of the byte range that is copied or
+ * discarded.
+ *
+ * The intervals need not be contiguous: TcpRxBuffer stores out-of-order
+ * data in the same way as in-order data, and reports the gaps as SACK
+ * blocks, while TcpTxBuffer only ever appends at the tail.
+ */
+class TcpByteStore
+{
+public:
+  /// A byte interval: sequence number of the first byte and one past the last
+  typedef std::pair<SequenceNumber32, SequenceNumber32> Interval;
+
+  TcpByteStore ();
+
+  /**
+   * \returns the number of bytes stored, not necessarily contiguous
+   */
+  uint32_t Size (void) const;
+
+  /**
+   * \returns true if no byte is stored
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * \returns the sequence number of the first stored byte.  The store
+   * must not be empty.
+   */
+  SequenceNumber32 HeadSequence (void) const;
+
+  /**
+   * \brief Store the bytes [seq, seq + p->GetSize ()) not stored yet
+   *
+   * Bytes already in the store are kept, and only the parts of the
+   * packet which fill gaps are added.
+   *
+   * \param seq sequence number of the first byte of the packet
+   * \param p the packet
+   * \returns the number of bytes added
+   */
+  uint32_t Add (SequenceNumber32 seq, Ptr<Packet> p);
+
+  /**
+   * \param seq a sequence number
+   * \returns the sequence number following the contiguous run of stored
+   * bytes that starts with seq, or seq itself if seq is not stored
+   */
+  SequenceNumber32 ContiguousEnd (SequenceNumber32 seq) const;
+
+  /**
+   * \brief Copy the bytes [seq, seq + size), which must all be stored
+   * \param seq sequence number of the first byte
+   * \param size number of bytes
+   * \returns a packet holding the bytes
+   */
+  Ptr<Packet> Copy (SequenceNumber32 seq, uint32_t size) const;
+
+  /**
+   * \brief Remove all the bytes before seq
+   * \param seq the first sequence number to keep
+   * \returns the number of bytes removed
+   */
+  uint32_t DiscardUpTo (SequenceNumber32 seq);
+
+  /**
+   * \brief Remove all the bytes
+   */
+  void Clear (void);
+
+  /**
+   * \brief Get the contiguous byte ranges stored from a sequence number on
+   *
+   * Adjacent intervals are merged, and a range starting before seq is
+   * clipped to start at seq.
+   *
+   * \param seq the first sequence number to consider
+   * \returns the ranges, in increasing sequence number order
+   */
+  std::list<Interval> GetIntervals (SequenceNumber32 seq) const;
+
+private:
+  /// Stored packets, indexed by the sequence number of their first byte
+  typedef std::map<SequenceNumber32, Ptr<Packet> > Container;
+
+  /**
+   * \param seq a sequence number
+   * \returns the interval holding seq, or m_data.end () if seq is not stored
+   */
+  Container::const_iterator Find (SequenceNumber32 seq) const;
+
+  Container m_data; //!< stored packets
+  uint32_t m_size;  //!< number of bytes stored
+};
+
+} // namespace ns3
+
+#endif /* TCP_BYTE_STORE_H */
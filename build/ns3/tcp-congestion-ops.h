@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_CONGESTION_OPS_H
+#define TCP_CONGESTION_OPS_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ * \brief Congestion state of a TCP sender
+ */
+typedef enum
+{
+  CA_OPEN,      //!< No congestion signal being handled
+  CA_CWR,       //!< Window reduced upon an ECN echo, for one window of data
+  CA_RECOVERY,  //!< Fast retransmit and fast recovery
+  CA_LOSS       //!< Recovery from a retransmission timeout
+} TcpCongState_t;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Snapshot of the state of a TCP sender, as seen by TcpCongestionOps
+ *
+ * The socket owns its congestion window and slow start threshold. It fills
+ * in a TcpSocketState before invoking the congestion control and applies
+ * the values of m_cWnd and m_ssThresh the call has left.
+ */
+class TcpSocketState
+{
+public:
+  TcpSocketState ();
+
+  uint32_t       m_cWnd;          //!< Congestion window (bytes)
+  uint32_t       m_ssThresh;      //!< Slow start threshold (bytes)
+  uint32_t       m_segmentSize;   //!< Segment size (bytes)
+  uint32_t       m_bytesInFlight; //!< Data sent and not acknowledged yet (bytes)
+  TcpCongState_t m_congState;     //!< Congestion state
+  bool           m_ecnEcho;       //!< The ACK being processed carries ECE
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Congestion control algorithm of a TCP sender
+ *
+ * The socket (see TcpNewReno) performs loss detection and recovery, and
+ * asks its congestion control how to size the congestion window: how to
+ * grow it upon new acknowledgments, and where to bring it back upon a loss
+ * or an ECN echo.  The CongestionOps attribute of TcpNewReno selects the
+ * algorithm, each socket owning its own instance.
+ *
+ * This base class implements the NewReno window updates (\RFC{5681}):
+ * slow start, congestion avoidance and halving of the data in flight
+ * upon a congestion event.
+ */
+class TcpCongestionOps : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpCongestionOps ();
+  /**
+   * \brief Copy constructor
+   * \param other the object to copy
+   */
+  TcpCongestionOps (const TcpCongestionOps &other);
+  virtual ~TcpCongestionOps ();
+
+  /**
+   * \brief Get the slow start threshold after a congestion event
+   *
+   * Called upon a fast retransmit, a retransmission timeout and an ECN
+   * echo, before the socket brings its window back.
+   *
+   * \param tcb the state of the socket
+   * \param bytesInFlight the data in flight (bytes)
+   * \returns the new slow start threshold (bytes)
+   */
+  virtual uint32_t GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight);
+
+  /**
+   * \brief Grow the congestion window upon the acknowledgment of new data
+   *
+   * Not called during fast recovery, where the socket manages the window.
+   *
+   * \param tcb the state of the socket, to update
+   * \param bytesAcked the data newly acknowledged (bytes)
+   */
+  virtual void IncreaseWindow (TcpSocketState &tcb, uint32_t bytesAcked);
+
+  /**
+   * \brief Account for an acknowledgment of new data
+   *
+   * Called for every acknowledgment of new data, fast recovery included,
+   * before any window update.
+   *
+   * \param tcb the state of the socket
+   * \param bytesAcked the data newly acknowledged (bytes)
+   * \param rtt the round trip time measured by the acknowledgment, zero if none
+   */
+  virtual void PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt);
+
+  /**
+   * \brief Notify a change of the congestion state of the socket
+   *
+   * \param tcb the state of the socket, before the change
+   * \param newState the new congestion state
+   */
+  virtual void CongestionStateSet (const TcpSocketState &tcb, TcpCongState_t newState);
+
+  /**
+   * \brief Whether the receiver echoes the CE mark of every data segment
+   *
+   * By default, the receiver sets ECE on all its ACKs from a segment marked
+   * CE until a segment with CWR arrives (\RFC{3168}, sec. 6.1.3).
+   * Algorithms estimating the extent of congestion need the mark of each
+   * segment to be echoed instead.
+   *
+   * \returns true if the ACKs echo the CE mark of each data segment
+   */
+  virtual bool EchoEachCeMark (void) const;
+
+  /**
+   * \brief Copy the congestion control of a listening socket for a new connection
+   *
+   * \returns a copy of this object
+   */
+  virtual Ptr<TcpCongestionOps> Fork (void);
+
+protected:
+  /**
+   * \brief Slow start: grow the window by one segment (\RFC{5681}, sec. 3.1)
+   * \param tcb the state of the socket, to update
+   */
+  void SlowStart (TcpSocketState &tcb);
+  /**
+   * \brief Congestion avoidance: grow the window by about one segment
+   * per round trip time (\RFC{5681}, sec. 3.1)
+   * \param tcb the state of the socket, to update
+   */
+  void CongestionAvoidance (TcpSocketState &tcb);
+};
+
+} // namespace ns3
+
+#endif /* TCP_CONGESTION_OPS_H */
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_DCTCP_H
+#define TCP_DCTCP_H
+
+#include "tcp-congestion-ops.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The Data Center TCP congestion control (\RFC{8257})
+ *
+ * DCTCP estimates the fraction F of the data marked with ECN Congestion
+ * Experienced over each window, and keeps a moving average of it:
+ *
+ *   alpha = (1 - g) alpha + g F
+ *
+ * Upon an ECN echo, the window is reduced by alpha / 2 instead of being
+ * halved, so that it matches the extent of the congestion.  The window
+ * grows as the NewReno one.
+ *
+ * DCTCP needs ECN (see the UseEcn attribute of TcpNewReno) on both ends,
+ * and queues which mark packets as soon as the instantaneous queue
+ * exceeds a threshold, e.g., a RedQueue with UseEcn enabled, MinTh equal
+ * to MaxTh and a queue weight QW of 1.
+ */
+class TcpDctcp : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpDctcp ();
+  /**
+   * \brief Copy constructor
+   * \param other the object to copy
+   */
+  TcpDctcp (const TcpDctcp &other);
+  virtual ~TcpDctcp ();
+
+  virtual uint32_t GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight);
+  virtual void PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt);
+  virtual bool EchoEachCeMark (void) const;
+  virtual Ptr<TcpCongestionOps> Fork (void);
+
+  /**
+   * \returns the current estimate of the fraction of marked data
+   */
+  double GetAlpha (void) const;
+
+private:
+  double   m_g;                //!< Weight of a new observation in alpha
+  double   m_alpha;            //!< Moving average of the fraction of marked data
+  uint32_t m_ackedBytes;       //!< Data acknowledged in the current window
+  uint32_t m_ackedBytesEcn;    //!< Data acknowledged with ECE in the current window
+  uint32_t m_windowBytes;      //!< Data to be acknowledged before the window ends
+};
+
+} // namespace ns3
+
+#endif /* TCP_DCTCP_H */
@@ -0,0 +1,617 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005,2006,2007 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef TRACED_CALLBACK_H
+#define TRACED_CALLBACK_H
+
+#include <vector>
+#include "callback.h"
+#include "fatal-error.h"
+#include "ns3/core-config.h"
+
+/**
+ * \file
+ * \ingroup tracing
+ * ns3::TracedCallback declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup tracing
+ * \brief Forward calls to a chain of Callback
+ *
+ * An TracedCallback has almost exactly the same API as a normal
+ * Callback but instead of forwarding calls to a single function
+ * (as a Callback normally does), it forwards calls to a chain
+ * of Callback.  Connect adds a Callback at the end of the chain
+ * of callbacks.  Disconnect removes a Callback from the chain of callbacks.
+ *
+ * This is a functor: the chain of Callbacks is invoked by
+ * calling one of the \c operator() forms with the appropriate
+ * number of arguments.
+ *
+ * The first few Callbacks of the chain are stored inline in the
+ * TracedCallback itself, and only longer chains spill over to the
+ * heap.  Invoking a TracedCallback with nothing connected reduces to
+ * an inlined emptiness check, so unconnected trace sources are nearly
+ * free on hot paths.
+ * Callers which have to do extra work just to compute the
+ * arguments of a trace can test IsEmpty() first.
+ *
+ * \tparam T1 Type of the first argument to the functor.
+ * \tparam T2 Type of the second argument to the functor.
+ * \tparam T3 Type of the third argument to the functor.
+ * \tparam T4 Type of the fourth argument to the functor.
+ * \tparam T5 Type of the fifth argument to the functor.
+ * \tparam T6 Type of the sixth argument to the functor.
+ * \tparam T7 Type of the seventh argument to the functor.
+ * \tparam T8 Type of the eighth argument to the functor.
+ */
+template<typename T1 = empty, typename T2 = empty, 
+         typename T3 = empty, typename T4 = empty,
+         typename T5 = empty, typename T6 = empty,
+         typename T7 = empty, typename T8 = empty>
+class TracedCallback 
+{
+public:
+  /** Constructor. */
+  TracedCallback ();
+  /**
+   * Append a Callback to the chain (without a context).
+   *
+   * \param callback Callback to add to chain.
+   */
+  void ConnectWithoutContext (const CallbackBase & callback);
+  /**
+   * Append a Callback to the chain with a context.
+   *
+   * The context string will be provided as the first argument
+   * to the Callback.
+   *
+   * \param callback Callback to add to chain.
+   * \param path Context string to provide when invoking the Callback.
+   */
+  void Connect (const CallbackBase & callback, std::string path);
+  /**
+   * Remove from the chain a Callback which was connected without a context.
+   *
+   * \param callback Callback to remove from the chain.
+   */
+  void DisconnectWithoutContext (const CallbackBase & callback);
+  /**
+   * Remove from the chain a Callback which was connected with a context.
+   *
+   * \param callback Callback to remove from the chain.
+   * \param path Context path which was used to connect the Callback.
+   */
+  void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check whether any Callback is connected.
+   *
+   * \returns true if the chain of Callbacks is empty.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \name Functors taking various numbers of arguments.
+   *
+   * The version selected is determined by the number of arguments
+   * at the point where the Callback is invoked in the class
+   * which fires the Callback.
+   */
+  /**@{*/
+  /** Functor which invokes the chain of Callbacks. */
+  void operator() (void) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \param a1 The first argument to the functor.
+   */
+  void operator() (T1 a1) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \tparam T3 Type of the third argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   * \param a3 The third argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2, T3 a3) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \tparam T3 Type of the third argument to the functor.
+   * \tparam T4 Type of the fourth argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   * \param a3 The third argument to the functor.
+   * \param a4 The fourth argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \tparam T3 Type of the third argument to the functor.
+   * \tparam T4 Type of the fourth argument to the functor.
+   * \tparam T5 Type of the fifth argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   * \param a3 The third argument to the functor.
+   * \param a4 The fourth argument to the functor.
+   * \param a5 The fifth argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \tparam T3 Type of the third argument to the functor.
+   * \tparam T4 Type of the fourth argument to the functor.
+   * \tparam T5 Type of the fifth argument to the functor.
+   * \tparam T6 Type of the sixth argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   * \param a3 The third argument to the functor.
+   * \param a4 The fourth argument to the functor.
+   * \param a5 The fifth argument to the functor.
+   * \param a6 The sixth argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \tparam T3 Type of the third argument to the functor.
+   * \tparam T4 Type of the fourth argument to the functor.
+   * \tparam T5 Type of the fifth argument to the functor.
+   * \tparam T6 Type of the sixth argument to the functor.
+   * \tparam T7 Type of the seventh argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   * \param a3 The third argument to the functor.
+   * \param a4 The fourth argument to the functor.
+   * \param a5 The fifth argument to the functor.
+   * \param a6 The sixth argument to the functor.
+   * \param a7 The seventh argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const;
+  /**
+   * \copybrief operator()()
+   * \tparam T1 Type of the first argument to the functor.
+   * \tparam T2 Type of the second argument to the functor.
+   * \tparam T3 Type of the third argument to the functor.
+   * \tparam T4 Type of the fourth argument to the functor.
+   * \tparam T5 Type of the fifth argument to the functor.
+   * \tparam T6 Type of the sixth argument to the functor.
+   * \tparam T7 Type of the seventh argument to the functor.
+   * \tparam T8 Type of the eighth argument to the functor.
+   * \param a1 The first argument to the functor.
+   * \param a2 The second argument to the functor.
+   * \param a3 The third argument to the functor.
+   * \param a4 The fourth argument to the functor.
+   * \param a5 The fifth argument to the functor.
+   * \param a6 The sixth argument to the functor.
+   * \param a7 The seventh argument to the functor.
+   * \param a8 The eighth argument to the functor.
+   */
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const;
+  /**@}*/
+
+  /**
+   *  TracedCallback signature for POD.
+   *
+   * \param [in] value Value of the traced variable.
+   * @{
+   */
+  // Uint32Callback appears to be the only one used at the moment.
+  // Feel free to add typedef's for any other POD you need.
+  typedef void (* Uint32Callback)(const uint32_t value);
+  /**@}*/
+
+  
+private:
+  /** The Callback type stored in the chain. */
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> CallbackType;
+  /**
+   * Container type for holding the Callbacks which do not fit in
+   * the inline storage.
+   */
+  typedef std::vector<CallbackType> CallbackList;
+  /**
+   * Number of Callbacks stored inline.  Almost every trace source
+   * has no more sinks than this, so connecting and invoking them
+   * never touches the heap-allocated overflow list.
+   */
+  static const uint32_t INLINE_CALLBACKS = 2;
+
+  /**
+   * Get a Callback of the chain.
+   *
+   * \param [in] i The index of the Callback, less than m_nCallbacks.
+   * \returns The Callback.
+   */
+  const CallbackType & GetCallback (uint32_t i) const;
+  /** \copydoc GetCallback */
+  CallbackType & GetCallback (uint32_t i);
+
+  /** The number of Callbacks in the chain. */
+  uint32_t m_nCallbacks;
+  /** The first Callbacks of the chain. */
+  CallbackType m_inlineCallbacks[INLINE_CALLBACKS];
+  /** The remaining Callbacks of the chain, if any. */
+  CallbackList m_callbackList;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
+  : m_nCallbacks (0),
+    m_callbackList ()
+{
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+const typename TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::CallbackType &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::GetCallback (uint32_t i) const
+{
+  if (i < INLINE_CALLBACKS)
+    {
+      return m_inlineCallbacks[i];
+    }
+  return m_callbackList[i - INLINE_CALLBACKS];
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+typename TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::CallbackType &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::GetCallback (uint32_t i)
+{
+  if (i < INLINE_CALLBACKS)
+    {
+      return m_inlineCallbacks[i];
+    }
+  return m_callbackList[i - INLINE_CALLBACKS];
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBase & callback)
+{
+  CallbackType cb;
+  cb.Assign (callback);
+  if (m_nCallbacks < INLINE_CALLBACKS)
+    {
+      m_inlineCallbacks[m_nCallbacks] = cb;
+    }
+  else
+    {
+      m_callbackList.push_back (cb);
+    }
+  m_nCallbacks++;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback, std::string path)
+{
+  Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+  cb.Assign (callback);
+  CallbackType realCb = cb.Bind (path);
+  ConnectWithoutContext (realCb);
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
+{
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      if (!GetCallback (i).IsEqual (callback))
+        {
+          if (j != i)
+            {
+              GetCallback (j) = GetCallback (i);
+            }
+          j++;
+        }
+    }
+  for (uint32_t i = j; i < m_nCallbacks && i < INLINE_CALLBACKS; i++)
+    {
+      // Release the Callbacks left behind in the inline storage.
+      m_inlineCallbacks[i] = CallbackType ();
+    }
+  m_callbackList.resize (j > INLINE_CALLBACKS ? j - INLINE_CALLBACKS : 0);
+  m_nCallbacks = j;
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callback, std::string path)
+{
+  Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+  cb.Assign (callback);
+  CallbackType realCb = cb.Bind (path);
+  DisconnectWithoutContext (realCb);
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_nCallbacks == 0;
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  // Index rather than iterate: a Callback may connect further
+  // Callbacks to this chain while it runs.
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)();
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2, a3);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2, a3, a4);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2, a3, a4, a5);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2, a3, a4, a5, a6);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2, a3, a4, a5, a6, a7);
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void 
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
+{
+  if (m_nCallbacks == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
+    {
+      GetCallback (i)(a1, a2, a3, a4, a5, a6, a7, a8);
+    }
+}
+
+
+/**
+ * \ingroup tracing
+ * \brief A TracedCallback which can be compiled out of the build
+ *
+ * Trace sources on the hottest paths of a model may be declared as
+ * OptionalTracedCallback rather than TracedCallback.  In a normal
+ * build the two are identical.  When ns-3 is configured with
+ * \c --disable-optional-traces, an OptionalTracedCallback keeps the
+ * same API but stores and invokes nothing, so firing it costs nothing
+ * at all.  Connecting a sink to a compiled out trace source is a
+ * fatal error rather than a silent no-op, since the sink would never
+ * be called.  Hence trace sources connected by helpers, such as the
+ * ascii and binary trace helpers or FlowMonitor, must remain
+ * TracedCallback.
+ *
+ * \tparam T1 Type of the first argument to the functor.
+ * \tparam T2 Type of the second argument to the functor.
+ * \tparam T3 Type of the third argument to the functor.
+ * \tparam T4 Type of the fourth argument to the functor.
+ * \tparam T5 Type of the fifth argument to the functor.
+ * \tparam T6 Type of the sixth argument to the functor.
+ * \tparam T7 Type of the seventh argument to the functor.
+ * \tparam T8 Type of the eighth argument to the functor.
+ */
+#ifdef NS3_OPTIONAL_TRACES_DISABLE
+template<typename T1 = empty, typename T2 = empty, 
+         typename T3 = empty, typename T4 = empty,
+         typename T5 = empty, typename T6 = empty,
+         typename T7 = empty, typename T8 = empty>
+class OptionalTracedCallback
+{
+public:
+  /** \copydoc TracedCallback::ConnectWithoutContext */
+  void ConnectWithoutContext (const CallbackBase & callback)
+  {
+    NS_FATAL_ERROR ("This trace source was compiled out by --disable-optional-traces");
+  }
+  /** \copydoc TracedCallback::Connect */
+  void Connect (const CallbackBase & callback, std::string path)
+  {
+    NS_FATAL_ERROR ("Trace source " << path << " was compiled out by --disable-optional-traces");
+  }
+  /** \copydoc TracedCallback::DisconnectWithoutContext */
+  void DisconnectWithoutContext (const CallbackBase & callback) {}
+  /** \copydoc TracedCallback::Disconnect */
+  void Disconnect (const CallbackBase & callback, std::string path) {}
+  /** \copydoc TracedCallback::IsEmpty */
+  bool IsEmpty (void) const { return true; }
+  /**@{*/
+  /** Functors which do nothing. */
+  void operator() (void) const {}
+  void operator() (T1 a1) const {}
+  void operator() (T1 a1, T2 a2) const {}
+  void operator() (T1 a1, T2 a2, T3 a3) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const {}
+  /**@}*/
+};
+#else /* NS3_OPTIONAL_TRACES_DISABLE */
+template<typename T1 = empty, typename T2 = empty, 
+         typename T3 = empty, typename T4 = empty,
+         typename T5 = empty, typename T6 = empty,
+         typename T7 = empty, typename T8 = empty>
+class OptionalTracedCallback : public TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>
+{
+};
+#endif /* NS3_OPTIONAL_TRACES_DISABLE */
+
+} // namespace ns3
+
+#endif /* TRACED_CALLBACK_H */
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRAFFIC_CONTROL_LAYER_H
+#define TRAFFIC_CONTROL_LAYER_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/net-device.h"
+#include "queue-disc.h"
+
+namespace ns3 {
+
+/**
+ * \defgroup traffic-control Traffic control
+ * \ingroup internet
+ *
+ * Queueing disciplines between the network layer and the devices.
+ */
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The layer between the network layer interfaces (Ipv4Interface,
+ * Ipv6Interface) and the devices of a node.
+ *
+ * When aggregated to a node, it receives the packets the network layer
+ * sends to the devices, and passes them through the root queueing
+ * discipline installed on the device, if any (see TrafficControlHelper).
+ * Without it, or without a queueing discipline on the device, packets go
+ * straight to the device.
+ */
+class TrafficControlLayer : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TrafficControlLayer ();
+  virtual ~TrafficControlLayer ();
+
+  /**
+   * \brief Install a queueing discipline on a device.
+   *
+   * A NetDeviceQueue is aggregated to the device if it has none, and the
+   * queueing discipline runs whenever the device wakes it.
+   *
+   * \param device the device
+   * \param qDisc the queueing discipline
+   */
+  void SetRootQueueDiscOnDevice (Ptr<NetDevice> device, Ptr<QueueDisc> qDisc);
+
+  /**
+   * \param device a device
+   * \returns the queueing discipline installed on the device, 0 if none
+   */
+  Ptr<QueueDisc> GetRootQueueDiscOnDevice (Ptr<NetDevice> device) const;
+
+  /**
+   * \brief Send a packet to a device, through its queueing discipline if
+   * it has one.
+   * \param device the device
+   * \param item the packet
+   */
+  void Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  std::vector<Ptr<QueueDisc> > m_rootQueueDiscs;  //!< Queueing disciplines, indexed by device ifIndex
+};
+
+} // namespace ns3
+
+#endif /* TRAFFIC_CONTROL_LAYER_H */
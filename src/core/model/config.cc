@@ -27,6 +27,7 @@
 #include "log.h"
 
 #include <sstream>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -147,80 +148,118 @@ class ArrayMatcher
 public:
   ArrayMatcher (std::string element);
   bool Matches (uint32_t i) const;
+  bool IsExplicit (void) const;
+  bool GetIndices (uint32_t n, std::vector<uint32_t> *indices) const;
 private:
+  void Compile (std::string element);
   bool StringToUint32 (std::string str, uint32_t *value) const;
   std::string m_element;
+  bool m_all;
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Compile (element);
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+void
+ArrayMatcher::Compile (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  //
+  // Parse the element once into a list of index ranges, so that matching
+  // a container with many elements does not parse the string every time.
+  //
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      std::string left = element.substr (0, tmp-0);
+      std::string right = element.substr (tmp+1, element.size () - (tmp + 1));
+      Compile (left);
+      Compile (right);
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      NS_LOG_DEBUG ("Array "<<i<<" matches *");
       return true;
     }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); ++j)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
+bool
+ArrayMatcher::IsExplicit (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return !m_all;
+}
+bool
+ArrayMatcher::GetIndices (uint32_t n, std::vector<uint32_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << n << indices);
+  NS_ASSERT (!m_all);
+  indices->clear ();
+  bool inRange = true;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); ++j)
+    {
+      for (uint32_t i = j->first; i < n && i <= j->second; i++)
+        {
+          indices->push_back (i);
+        }
+      inRange = inRange && j->second < n;
+    }
+  std::sort (indices->begin (), indices->end ());
+  indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
+  return inRange;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -233,29 +272,136 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 }
 
 
+/**
+ * The attributes of a TypeId, including those of its parents, which
+ * a Config path item can traverse, cached so that resolving the same
+ * item on many objects of the same type does not search the TypeId
+ * and dynamic_cast its attribute checkers every time.
+ */
+class AttributeMatchCache
+{
+public:
+  struct Match
+  {
+    std::string name;
+    uint32_t flags;
+    Ptr<const AttributeAccessor> accessor;
+    bool isContainer;
+  };
+  typedef std::vector<Match> Matches;
+
+  const Matches &Lookup (TypeId tid, const std::string &item);
+private:
+  uint32_t CountAttributes (TypeId tid) const;
+  struct Entry
+  {
+    uint32_t nAttributes;
+    Matches matches;
+  };
+  typedef std::map<std::pair<uint16_t, std::string>, Entry> EntryMap;
+  EntryMap m_entries;
+};
+
+uint32_t
+AttributeMatchCache::CountAttributes (TypeId tid) const
+{
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t n = 0;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      n += tid.GetAttributeN ();
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  return n;
+}
+
+const AttributeMatchCache::Matches &
+AttributeMatchCache::Lookup (TypeId tid, const std::string &item)
+{
+  NS_LOG_FUNCTION (this << tid << item);
+  //
+  // Attributes may still be added to a TypeId after it has been used, so
+  // check that the entry was built from the same number of attributes.
+  //
+  uint32_t nAttributes = CountAttributes (tid);
+  std::pair<EntryMap::iterator, bool> result = 
+    m_entries.insert (std::make_pair (std::make_pair (tid.GetUid (), item), Entry ()));
+  Entry &entry = result.first->second;
+  if (!result.second && entry.nAttributes == nAttributes)
+    {
+      return entry.matches;
+    }
+
+  entry.nAttributes = nAttributes;
+  entry.matches.clear ();
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = tid.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          Match match;
+          match.name = info.name;
+          match.flags = info.flags;
+          match.accessor = info.accessor;
+          // attempt to cast to a pointer checker.
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              match.isContainer = false;
+              entry.matches.push_back (match);
+            }
+          // attempt to cast to an object vector.
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              match.isContainer = true;
+              entry.matches.push_back (match);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  return entry.matches;
+}
+
+
 class Resolver
 {
 public:
-  Resolver (std::string path);
+  Resolver (std::string path, AttributeMatchCache *cache);
   virtual ~Resolver ();
 
   void Resolve (Ptr<Object> root);
 private:
   void Canonicalize (void);
-  void DoResolve (std::string path, Ptr<Object> root);
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void Tokenize (void);
+  void DoResolve (uint32_t item, Ptr<Object> root);
+  void DoArrayResolve (uint32_t item, Ptr<Object> root, const AttributeMatchCache::Match &match);
   void DoResolveOne (Ptr<Object> object);
   std::string GetResolvedPath (void) const;
   virtual void DoOne (Ptr<Object> object, std::string path) = 0;
   std::vector<std::string> m_workStack;
   std::string m_path;
+  std::vector<std::string> m_items;
+  std::vector<ArrayMatcher> m_matchers;
+  AttributeMatchCache *m_cache;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (std::string path, AttributeMatchCache *cache)
+  : m_path (path),
+    m_cache (cache)
 {
-  NS_LOG_FUNCTION (this << path);
+  NS_LOG_FUNCTION (this << path << cache);
   Canonicalize ();
+  Tokenize ();
 }
 Resolver::~Resolver ()
 {
@@ -280,13 +426,33 @@ Resolver::Canonicalize (void)
       m_path = m_path + "/";
     }
 }
+void
+Resolver::Tokenize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  //
+  // Split the canonical path into its items once, and compile each of them
+  // as an array index matcher, rather than re-parsing the remaining path at
+  // every level of the recursion.
+  //
+  std::string::size_type cur = 0;
+  std::string::size_type next;
+  while ((next = m_path.find ("/", cur + 1)) != std::string::npos)
+    {
+      std::string item = m_path.substr (cur + 1, next - (cur + 1));
+      m_items.push_back (item);
+      m_matchers.push_back (ArrayMatcher (item));
+      cur = next;
+    }
+}
 
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -312,13 +478,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t index, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << index << root);
 
-  if (next == std::string::npos)
+  if (index == m_items.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -334,8 +498,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const std::string &item = m_items[index];
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -346,11 +509,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.find ("Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (index + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -367,7 +529,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (index + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -397,68 +559,52 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (index + 1, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const AttributeMatchCache::Matches &matches = m_cache->Lookup (root->GetInstanceTypeId (), item);
       bool foundMatch = false;
-      
-      do
+
+      for (AttributeMatchCache::Matches::const_iterator i = matches.begin (); i != matches.end (); ++i)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (!i->isContainer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              if ((i->flags & TypeId::ATTR_GET) && i->accessor->HasGetter ())
                 {
-                  continue;
+                  i->accessor->Get (PeekPointer (root), ptr);
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
+              else
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  root->GetAttribute (i->name, ptr);
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoResolve (index + 1, object);
+              m_workStack.pop_back ();
             }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoArrayResolve (index + 1, root, *i);
+              m_workStack.pop_back ();
+            }
+        }
 
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
       if (!foundMatch)
         {
           NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
@@ -468,20 +614,58 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t index, Ptr<Object> root, const AttributeMatchCache::Match &match)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << index << root);
+  if (index == m_items.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const ArrayMatcher &matcher = m_matchers[index];
+
+  //
+  // When the path names explicit indices (as in "/NodeList/3/..."), fetch
+  // just those elements from the container instead of building an
+  // ObjectPtrContainerValue holding every one of them, provided that
+  // the container indexes its elements by position.  Containers keyed
+  // otherwise (such as maps) may hold indices beyond their size, so
+  // those requests take the slow path.
+  //
+  const ObjectPtrContainerAccessor *accessor = 
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (match.accessor));
+  uint32_t n;
+  std::vector<uint32_t> indices;
+  if (matcher.IsExplicit () && accessor != 0 && (match.flags & TypeId::ATTR_GET) &&
+      accessor->GetN (PeekPointer (root), &n) && matcher.GetIndices (n, &indices))
+    {
+      std::vector<Ptr<Object> > objects;
+      bool positional = true;
+      for (std::vector<uint32_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+        {
+          uint32_t elementIndex;
+          objects.push_back (accessor->GetAt (PeekPointer (root), *i, &elementIndex));
+          if (elementIndex != *i)
+            {
+              positional = false;
+              break;
+            }
+        }
+      if (positional)
+        {
+          for (uint32_t i = 0; i < indices.size (); i++)
+            {
+              std::ostringstream oss;
+              oss << indices[i];
+              m_workStack.push_back (oss.str ());
+              DoResolve (index + 1, objects[i]);
+              m_workStack.pop_back ();
+            }
+          return;
+        }
+    }
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ObjectPtrContainerValue container;
+  root->GetAttribute (match.name, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -490,7 +674,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (index + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -517,6 +701,7 @@ private:
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
   typedef std::vector<Ptr<Object> > Roots;
   Roots m_roots;
+  AttributeMatchCache m_attributeCache;
 };
 
 void 
@@ -587,8 +772,8 @@ ConfigImpl::LookupMatches (std::string path)
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (std::string path, AttributeMatchCache *cache)
+      : Resolver (path, cache)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path) {
       m_objects.push_back (object);
@@ -596,7 +781,7 @@ ConfigImpl::LookupMatches (std::string path)
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (path, &m_attributeCache);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
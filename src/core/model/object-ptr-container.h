@@ -220,6 +220,26 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the number of instances in the container, without
+   * building a full ObjectPtrContainerValue.
+   *
+   * \param [in] object The container object.
+   * \param [out] n The number of instances in the container.
+   * \returns true if the value could be obtained successfully.
+   */
+  bool GetN (const ObjectBase * object, uint32_t *n) const;
+  /**
+   * Get a single instance from the container, without building
+   * a full ObjectPtrContainerValue.
+   *
+   * \param [in] object The container object.
+   * \param [in] i The position of the instance, less than GetN().
+   * \param [out] index The index under which the instance would
+   *              appear in an ObjectPtrContainerValue.
+   * \returns The instance.
+   */
+  Ptr<Object> GetAt (const ObjectBase * object, uint32_t i, uint32_t *index) const;
 private:
   /**
    * Get the number of instances in the container.
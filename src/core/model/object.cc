@@ -97,11 +97,12 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->indexSize = 0;
+  m_aggregates->index = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -120,6 +121,8 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the lookup table may still point to this object
+  ClearIndex (m_aggregates);
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -132,10 +135,11 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   m_aggregates->n = 1;
+  m_aggregates->indexSize = 0;
+  m_aggregates->index = 0;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -151,33 +155,82 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
-  uint32_t n = m_aggregates->n;
+  struct Aggregates *aggregates = m_aggregates;
+  if (aggregates->index == 0)
+    {
+      BuildIndex (aggregates);
+    }
+  uint16_t uid = tid.GetUid ();
+  uint32_t mask = aggregates->indexSize - 1;
+  for (uint32_t i = uid & mask; ; i = (i + 1) & mask)
+    {
+      const struct IndexEntry &entry = aggregates->index[i];
+      if (entry.uid == uid)
+        {
+          return entry.object;
+        }
+      if (entry.uid == 0)
+        {
+          return 0;
+        }
+    }
+}
+void
+Object::BuildIndex (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  // Collect the TypeId of every aggregate and of its parents, in
+  // buffer order, so that the first aggregate of a given type wins.
   TypeId objectTid = Object::GetTypeId ();
-  for (uint32_t i = 0; i < n; i++)
+  std::vector<std::pair<uint16_t, Object *> > entries;
+  for (uint32_t i = 0; i < aggregates->n; i++)
     {
-      Object *current = m_aggregates->buffer[i];
+      Object *current = aggregates->buffer[i];
       TypeId cur = current->GetInstanceTypeId ();
-      while (cur != tid && cur != objectTid)
+      while (true)
         {
+          entries.push_back (std::make_pair (cur.GetUid (), current));
+          if (cur == objectTid || !cur.HasParent ())
+            {
+              break;
+            }
           cur = cur.GetParent ();
         }
-      if (cur == tid)
+    }
+
+  // Keep the table at most half full so that probe sequences stay short.
+  uint32_t size = 8;
+  while (size < 2 * entries.size ())
+    {
+      size *= 2;
+    }
+  struct IndexEntry *index =
+    (struct IndexEntry *)std::calloc (size, sizeof (struct IndexEntry));
+  uint32_t mask = size - 1;
+  for (std::vector<std::pair<uint16_t, Object *> >::const_iterator j = entries.begin ();
+       j != entries.end (); j++)
+    {
+      uint32_t i = j->first & mask;
+      while (index[i].uid != 0 && index[i].uid != j->first)
+        {
+          i = (i + 1) & mask;
+        }
+      if (index[i].uid == 0)
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          index[i].uid = j->first;
+          index[i].object = j->second;
         }
     }
-  return 0;
+  aggregates->indexSize = size;
+  aggregates->index = index;
+}
+void
+Object::ClearIndex (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  std::free (aggregates->index);
+  aggregates->index = 0;
+  aggregates->indexSize = 0;
 }
 void
 Object::Initialize (void)
@@ -210,8 +263,8 @@ Object::Dispose (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoDispose is called. The user's
-   * DoDispose implementation could call GetObject (which could reorder the array) 
-   * and it could call AggregateObject which would add an object at the end of the array.
+   * DoDispose implementation could call AggregateObject which would add an object
+   * at the end of the array.
    * So, to be safe, we restart the iteration over the array whenever we call some
    * user code.
    */
@@ -229,19 +282,6 @@ restart:
         }
     }
 }
-void
-Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
-{
-  NS_LOG_FUNCTION (this << aggregates << j);
-  while (j > 0 && 
-         aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j-1]->m_getObjectCount)
-    {
-      Object *tmp = aggregates->buffer[j-1];
-      aggregates->buffer[j-1] = aggregates->buffer[j];
-      aggregates->buffer[j] = tmp;
-      j--;
-    }
-}
 void 
 Object::AggregateObject (Ptr<Object> o)
 {
@@ -264,6 +304,8 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  aggregates->indexSize = 0;
+  aggregates->index = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -274,7 +316,6 @@ Object::AggregateObject (Ptr<Object> o)
   for (uint32_t i = 0; i < other->m_aggregates->n; i++)
     {
       aggregates->buffer[m_aggregates->n+i] = other->m_aggregates->buffer[i];
-      UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
 
   // keep track of the old aggregate buffers for the iteration
@@ -307,6 +348,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  ClearIndex (a);
+  ClearIndex (b);
   std::free (a);
   std::free (b);
 }
@@ -333,6 +376,7 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  ClearIndex (m_aggregates);
 }
 
 void
@@ -316,6 +316,21 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * One slot of the open-addressed Aggregates::index table.
+   *
+   * The table holds one entry for the TypeId of each aggregated
+   * Object and for each of its parents up to Object, so that
+   * DoGetObject() needs a single hashed probe instead of walking
+   * every aggregate and its TypeId hierarchy.
+   */
+  struct IndexEntry {
+    /** The TypeId uid, or zero for an empty slot. */
+    uint16_t uid;
+    /** The first aggregated Object which is a \c uid. */
+    Object *object;
+  };
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -331,10 +346,30 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /** The number of slots in \c index, a power of two. */
+    uint32_t indexSize;
+    /**
+     * Lookup table from TypeId uid to aggregated Object, built on
+     * the first DoGetObject() and discarded whenever \c buffer changes.
+     */
+    struct IndexEntry *index;
     /** The array of Objects. */
     Object *buffer[1];
   };
 
+  /**
+   * Build the TypeId lookup table of a list of aggregates.
+   *
+   * \param aggregates The list of aggregated Objects.
+   */
+  static void BuildIndex (struct Aggregates *aggregates);
+  /**
+   * Discard the TypeId lookup table of a list of aggregates.
+   *
+   * \param aggregates The list of aggregated Objects.
+   */
+  static void ClearIndex (struct Aggregates *aggregates);
+
   /**
    * Find an Object of TypeId tid in the aggregates of this Object.
    *
@@ -382,13 +417,6 @@ private:
   */
   void Construct (const AttributeConstructionList &attributes);
 
-  /**
-   * Keep the list of aggregates in most-recently-used order
-   *
-   * \param aggregates The list of aggregated Objects.
-   * \param i The most recently used entry in the list.
-   */
-  void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
   /**
    * Attempt to delete this Object.
    *
@@ -420,14 +448,6 @@ private:
    * so the size of the array is indirectly a reference count.
    */
   struct Aggregates * m_aggregates;
-  /**
-   * The number of times the Object was accessed with a
-   * call to GetObject().
-   *
-   * This integer is used to implement a heuristic to sort
-   * the array of aggregates in most-frequently accessed order.
-   */
-  uint32_t m_getObjectCount;
 };
 
 template <typename T>
@@ -27,15 +27,19 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
+#include "ns3/system-wall-clock-ms.h"
 
 
 #include <sstream>
 
 using namespace ns3;
 
+NS_LOG_COMPONENT_DEFINE ("ConfigTestSuite");
+
 // ===========================================================================
 // An object with some attributes that we can play with using config.
 // ===========================================================================
@@ -46,6 +50,7 @@ public:
 
   void AddNodeA (Ptr<ConfigTestObject> a);
   void AddNodeB (Ptr<ConfigTestObject> b);
+  void AddNodeMap (uint32_t key, Ptr<ConfigTestObject> node);
 
   void SetNodeA (Ptr<ConfigTestObject> a);
   void SetNodeB (Ptr<ConfigTestObject> b);
@@ -56,6 +61,7 @@ public:
 private:
   std::vector<Ptr<ConfigTestObject> > m_nodesA;
   std::vector<Ptr<ConfigTestObject> > m_nodesB;
+  std::map<uint32_t, Ptr<ConfigTestObject> > m_nodesMap;
   Ptr<ConfigTestObject> m_nodeA;
   Ptr<ConfigTestObject> m_nodeB;
   int8_t m_a;
@@ -76,6 +82,10 @@ ConfigTestObject::GetTypeId (void)
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&ConfigTestObject::m_nodesB),
                    MakeObjectVectorChecker<ConfigTestObject> ())
+    .AddAttribute ("NodesMap", "",
+                   ObjectMapValue (),
+                   MakeObjectMapAccessor (&ConfigTestObject::m_nodesMap),
+                   MakeObjectMapChecker<ConfigTestObject> ())
     .AddAttribute ("NodeA", "",
                    PointerValue (),
                    MakePointerAccessor (&ConfigTestObject::m_nodeA),
@@ -127,6 +137,12 @@ ConfigTestObject::AddNodeB (Ptr<ConfigTestObject> b)
   m_nodesB.push_back (b);
 }
 
+void 
+ConfigTestObject::AddNodeMap (uint32_t key, Ptr<ConfigTestObject> node)
+{
+  m_nodesMap[key] = node;
+}
+
 int8_t 
 ConfigTestObject::GetA (void) const
 {
@@ -721,6 +737,200 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// ===========================================================================
+// Test for the ability to match explicit indices against an ObjectMap,
+// whose keys need not be the positions of its elements.
+// ===========================================================================
+class ObjectMapConfigTestCase : public TestCase
+{
+public:
+  ObjectMapConfigTestCase ();
+  virtual ~ObjectMapConfigTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+ObjectMapConfigTestCase::ObjectMapConfigTestCase ()
+  : TestCase ("Check that explicit indices match the keys of an ObjectMap")
+{
+}
+
+void
+ObjectMapConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> three = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> seven = CreateObject<ConfigTestObject> ();
+  a->AddNodeMap (3, three);
+  a->AddNodeMap (7, seven);
+
+  Config::MatchContainer matches = Config::LookupMatches ("/NodeA/NodesMap/7");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Key beyond the size of the map not matched");
+  NS_TEST_EXPECT_MSG_EQ (matches.Get (0), seven, "Wrong object for key 7");
+
+  matches = Config::LookupMatches ("/NodeA/NodesMap/1");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetN (), 0, "Matched the position of an element instead of its key");
+
+  matches = Config::LookupMatches ("/NodeA/NodesMap/[3-7]");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetN (), 2, "Range did not match both keys");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
+// ===========================================================================
+// Test for the resolution of wildcard, explicit, range and alternative
+// paths over a vector of objects: each path must reach exactly the
+// objects it names, and indices past the end of the vector match nothing.
+// ===========================================================================
+class ConfigResolutionTestCase : public TestCase
+{
+public:
+  ConfigResolutionTestCase ();
+  virtual ~ConfigResolutionTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_count++; }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_count;
+};
+
+ConfigResolutionTestCase::ConfigResolutionTestCase ()
+  : TestCase ("Check resolution of wildcard, explicit, range and alternative paths over a vector of Objects")
+{
+}
+
+void
+ConfigResolutionTestCase::DoRun (void)
+{
+  const uint32_t nObjects = 20;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < nObjects; ++i)
+    {
+      Ptr<ConfigTestObject> obj = CreateObject<ConfigTestObject> ();
+      obj->SetNodeB (CreateObject<ConfigTestObject> ());
+      a->AddNodeA (obj);
+      objects.push_back (obj);
+    }
+
+  Config::ConnectWithoutContext ("/NodeA/NodesA/*/Source",
+                                 MakeCallback (&ConfigResolutionTestCase::Trace, this));
+  for (uint32_t i = 0; i < nObjects; ++i)
+    {
+      std::ostringstream oss;
+      oss << "/NodeA/NodesA/" << i << "/Source";
+      Config::ConnectWithoutContext (oss.str (),
+                                     MakeCallback (&ConfigResolutionTestCase::Trace, this));
+    }
+
+  //
+  // Each object should now have two sinks connected.
+  //
+  m_count = 0;
+  for (uint32_t i = 0; i < nObjects; ++i)
+    {
+      objects[i]->SetAttribute ("Source", IntegerValue (i % 100));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2 * nObjects, "Not every trace source was connected");
+
+  //
+  // Ranges and alternatives of explicit indices, including indices past
+  // the end of the vector, resolve to the same objects as before.
+  //
+  std::ostringstream oss;
+  oss << "/NodeA/NodesA/[10-12]|4|" << nObjects << "/NodeB";
+  Config::MatchContainer matches = Config::LookupMatches (oss.str ());
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 4, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/NodesA/4/NodeB/", "Unexpected match order");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (3), "/NodeA/NodesA/12/NodeB/", "Unexpected match order");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
+// ===========================================================================
+// Benchmark of path resolution over a large object vector, the way
+// helpers connect traces on every device of a large topology: one
+// wildcard path covering all of the objects, and one explicit path per
+// object.  The timings are reported with NS_LOG_INFO.
+// ===========================================================================
+class ConfigResolutionBenchmarkTestCase : public TestCase
+{
+public:
+  ConfigResolutionBenchmarkTestCase ();
+  virtual ~ConfigResolutionBenchmarkTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_count++; }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_count;
+};
+
+ConfigResolutionBenchmarkTestCase::ConfigResolutionBenchmarkTestCase ()
+  : TestCase ("Benchmark resolution of wildcard and explicit paths over a large vector of Objects")
+{
+}
+
+void
+ConfigResolutionBenchmarkTestCase::DoRun (void)
+{
+  const uint32_t nObjects = 5000;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < nObjects; ++i)
+    {
+      Ptr<ConfigTestObject> obj = CreateObject<ConfigTestObject> ();
+      a->AddNodeA (obj);
+      objects.push_back (obj);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Config::ConnectWithoutContext ("/NodeA/NodesA/*/Source",
+                                 MakeCallback (&ConfigResolutionBenchmarkTestCase::Trace, this));
+  int64_t wildcard = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 0; i < nObjects; ++i)
+    {
+      std::ostringstream oss;
+      oss << "/NodeA/NodesA/" << i << "/Source";
+      Config::ConnectWithoutContext (oss.str (),
+                                     MakeCallback (&ConfigResolutionBenchmarkTestCase::Trace, this));
+    }
+  int64_t explicitPaths = clock.End ();
+
+  NS_LOG_INFO ("Wildcard connection to " << nObjects << " objects: " << wildcard << " ms");
+  NS_LOG_INFO (nObjects << " explicit connections: " << explicitPaths << " ms");
+
+  m_count = 0;
+  for (uint32_t i = 0; i < nObjects; ++i)
+    {
+      objects[i]->SetAttribute ("Source", IntegerValue (i % 100));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2 * nObjects, "Not every trace source was connected");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -736,7 +946,23 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new RootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
+  AddTestCase (new ObjectMapConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new ConfigResolutionTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
+
+class ConfigBenchmarkTestSuite : public TestSuite
+{
+public:
+  ConfigBenchmarkTestSuite ();
+};
+
+ConfigBenchmarkTestSuite::ConfigBenchmarkTestSuite ()
+  : TestSuite ("config-benchmark", PERFORMANCE)
+{
+  AddTestCase (new ConfigResolutionBenchmarkTestCase, TestCase::QUICK);
+}
+
+static ConfigBenchmarkTestSuite configBenchmarkTestSuite;
@@ -22,6 +22,8 @@
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
 #include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/system-wall-clock-ms.h"
 
 namespace {
 
@@ -98,6 +100,8 @@ NS_OBJECT_ENSURE_REGISTERED (DerivedB);
 
 using namespace ns3;
 
+NS_LOG_COMPONENT_DEFINE ("ObjectTestSuite");
+
 // ===========================================================================
 // Test case to make sure that we can make Objects using CreateObject.
 // ===========================================================================
@@ -407,6 +411,113 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+// ===========================================================================
+// Test case to make sure that the lookup table of an aggregate follows
+// changes to the aggregate and resolves the parents of the aggregated
+// types.
+// ===========================================================================
+class GetObjectIndexTestCase : public TestCase
+{
+public:
+  GetObjectIndexTestCase ();
+  virtual ~GetObjectIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectIndexTestCase::GetObjectIndexTestCase ()
+  : TestCase ("Check GetObject through the lookup table of an aggregate")
+{
+}
+
+GetObjectIndexTestCase::~GetObjectIndexTestCase ()
+{
+}
+
+void
+GetObjectIndexTestCase::DoRun (void)
+{
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB before aggregation");
+
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  derivedA->AggregateObject (derivedB);
+
+  //
+  // The lookup table built above must not hide the new aggregate, and
+  // must resolve parents of the aggregated types.
+  //
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (), derivedB, "Unable to find BaseB through its DerivedB");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedB> (), derivedB, "Unable to find DerivedB");
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), derivedA, "Unable to find BaseA through its DerivedA");
+  NS_TEST_ASSERT_MSG_NE (derivedB->GetObject<Object> (), 0, "Unable to find Object");
+}
+
+// ===========================================================================
+// Test case to time successful and failed GetObject lookups on an
+// aggregate.  The timings are reported with NS_LOG_INFO.
+// ===========================================================================
+class GetObjectBenchmarkTestCase : public TestCase
+{
+public:
+  GetObjectBenchmarkTestCase ();
+  virtual ~GetObjectBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Look up an aggregated type many times.
+   * \param object The object to look up from.
+   * \param description The description of the lookups to log.
+   * \returns The number of successful lookups.
+   */
+  template <typename T>
+  uint32_t TimeGetObject (Ptr<Object> object, std::string description);
+};
+
+GetObjectBenchmarkTestCase::GetObjectBenchmarkTestCase ()
+  : TestCase ("Benchmark GetObject on aggregated Objects")
+{
+}
+
+GetObjectBenchmarkTestCase::~GetObjectBenchmarkTestCase ()
+{
+}
+
+/// Number of lookups timed at once
+static const uint32_t N_LOOKUPS = 1000000;
+
+template <typename T>
+uint32_t
+GetObjectBenchmarkTestCase::TimeGetObject (Ptr<Object> object, std::string description)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < N_LOOKUPS; i++)
+    {
+      found += (object->GetObject<T> () != 0);
+    }
+  int64_t elapsed = clock.End ();
+  NS_LOG_INFO (N_LOOKUPS << " " << description << " GetObject lookups: " << elapsed << " ms");
+  return found;
+}
+
+void
+GetObjectBenchmarkTestCase::DoRun (void)
+{
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  derivedA->AggregateObject (derivedB);
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+
+  NS_TEST_EXPECT_MSG_EQ (TimeGetObject<DerivedB> (derivedA, "successful"), N_LOOKUPS, "Lookups failed");
+  NS_TEST_EXPECT_MSG_EQ (TimeGetObject<BaseA> (derivedB, "successful parent"), N_LOOKUPS, "Lookups failed");
+  NS_TEST_EXPECT_MSG_EQ (TimeGetObject<BaseB> (baseA, "failed"), 0, "Unexpectedly found a BaseB");
+}
+
 // ===========================================================================
 // The Test Suite that glues the Test Cases together.
 // ===========================================================================
@@ -422,6 +533,21 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
+  AddTestCase (new GetObjectIndexTestCase, TestCase::QUICK);
 }
 
 static ObjectTestSuite objectTestSuite;
+
+class ObjectBenchmarkTestSuite : public TestSuite
+{
+public:
+  ObjectBenchmarkTestSuite ();
+};
+
+ObjectBenchmarkTestSuite::ObjectBenchmarkTestSuite ()
+  : TestSuite ("object-benchmark", PERFORMANCE)
+{
+  AddTestCase (new GetObjectBenchmarkTestCase, TestCase::QUICK);
+}
+
+static ObjectBenchmarkTestSuite objectBenchmarkTestSuite;
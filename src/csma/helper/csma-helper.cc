@@ -211,6 +211,30 @@ CsmaHelper::EnableAsciiInternal (
   Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
 }
 
+void
+CsmaHelper::EnableBinaryInternal (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  Ptr<CsmaNetDevice> device = nd->GetObject<CsmaNetDevice> ();
+  if (device == 0)
+    {
+      NS_LOG_INFO ("CsmaHelper::EnableBinaryInternal(): Device " << device << 
+                   " not of type ns3::CsmaNetDevice");
+      return;
+    }
+
+  //
+  // The binary sinks record the same events as the ascii ones, but they do
+  // not print packets, so there is no need to enable packet printing.
+  //
+  AsciiTraceHelper asciiTraceHelper;
+  asciiTraceHelper.HookDefaultBinarySink<CsmaNetDevice> (device, "MacRx", file, device, BinaryTraceFile::RECEIVE);
+
+  Ptr<Queue> queue = device->GetQueue ();
+  asciiTraceHelper.HookDefaultBinarySink<Queue> (queue, "Enqueue", file, device, BinaryTraceFile::ENQUEUE);
+  asciiTraceHelper.HookDefaultBinarySink<Queue> (queue, "Drop", file, device, BinaryTraceFile::DROP);
+  asciiTraceHelper.HookDefaultBinarySink<Queue> (queue, "Dequeue", file, device, BinaryTraceFile::DEQUEUE);
+}
+
 NetDeviceContainer
 CsmaHelper::Install (Ptr<Node> node) const
 {
@@ -237,6 +237,17 @@ private:
                                     Ptr<NetDevice> nd,
                                     bool explicitFilename);
 
+  /**
+   * \brief Enable binary trace output on the indicated net device.
+   *
+   * NetDevice-specific implementation mechanism for binary tracing; hooks
+   * the same trace sources as EnableAsciiInternal to the default binary sink.
+   *
+   * \param file The binary trace file to append events to.
+   * \param nd Net device for which you want to enable tracing.
+   */
+  virtual void EnableBinaryInternal (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd);
+
   ObjectFactory m_queueFactory;
   ObjectFactory m_deviceFactory;
   ObjectFactory m_channelFactory;
@@ -174,5 +174,15 @@ FlowMonitorHelper::SerializeToXmlFile (std::string fileName, bool enableHistogra
     }
 }
 
+void
+FlowMonitorHelper::EnablePeriodicExport (std::string fileName, Time interval)
+{
+  if (m_flowMonitor)
+    {
+      Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (fileName, std::ios::out);
+      m_flowMonitor->StartPeriodicExport (stream, interval);
+    }
+}
+
 
 } // namespace ns3
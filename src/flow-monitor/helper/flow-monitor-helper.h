@@ -112,6 +112,15 @@ public:
    */
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /**
+   * Export the flow statistics of the monitor created by the Install*
+   * methods to a CSV file every interval, see
+   * FlowMonitor::StartPeriodicExport
+   * \param fileName name or path of the output file that will be created
+   * \param interval the time between two exports
+   */
+  void EnablePeriodicExport (std::string fileName, Time interval);
+
 private:
   /**
    * \brief Copy constructor
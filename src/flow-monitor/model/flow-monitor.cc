@@ -22,13 +22,17 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 #define INDENT(level) for (int __xpto = 0; __xpto < level; __xpto++) os << ' ';
 
 #define PERIODIC_CHECK_INTERVAL (Seconds (1))
 
+#define EXPIRY_SLOT_WIDTH (MilliSeconds (100))
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FlowMonitor");
@@ -72,6 +76,12 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("SamplingRate", ("Monitor only one in every N packets of each flow (those whose "
+                                    "packet identifier is a multiple of N).  All the statistics, "
+                                    "including those of the probes, then describe this sample."),
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FlowMonitor::m_samplingRate),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -88,6 +98,14 @@ FlowMonitor::FlowMonitor ()
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
 
+size_t
+FlowMonitor::TrackedPacketKeyHash::operator() (TrackedPacketKey const &key) const
+{
+  uint64_t h = (static_cast<uint64_t> (key.first) << 32) | key.second;
+  h *= 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
 void
 FlowMonitor::DoDispose (void)
 {
@@ -102,6 +120,10 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  m_trackedPackets.clear ();
+  m_expirySlots.clear ();
+  Simulator::Cancel (m_exportEvent);
+  m_exportStream = 0;
   Object::DoDispose ();
 }
 
@@ -134,19 +156,43 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
     }
 }
 
+inline bool
+FlowMonitor::IsSampled (FlowPacketId packetId) const
+{
+  return m_samplingRate == 1 || packetId % m_samplingRate == 0;
+}
+
+void
+FlowMonitor::FileForExpiry (const TrackedPacketKey &key, Time lastSeenTime)
+{
+  int64_t width = EXPIRY_SLOT_WIDTH.GetTimeStep ();
+  if (m_expirySlots.empty ())
+    {
+      m_expirySlotsStart = TimeStep (lastSeenTime.GetTimeStep () - lastSeenTime.GetTimeStep () % width);
+    }
+  int64_t slot = std::max<int64_t> (0, (lastSeenTime - m_expirySlotsStart).GetTimeStep () / width);
+  if (static_cast<uint64_t> (slot) >= m_expirySlots.size ())
+    {
+      m_expirySlots.resize (slot + 1);
+    }
+  m_expirySlots[slot].push_back (key);
+}
+
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (packetId))
     {
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  TrackedPacketKey key (flowId, packetId);
+  TrackedPacket &tracked = m_trackedPackets[key];
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
+  FileForExpiry (key, now);
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
@@ -166,11 +212,11 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
 void
 FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (packetId))
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
+  TrackedPacketKey key (flowId, packetId);
   TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
   if (tracked == m_trackedPackets.end ())
     {
@@ -190,7 +236,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 void
 FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (packetId))
     {
       return;
     }
@@ -254,7 +300,7 @@ void
 FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize,
                          uint32_t reasonCode)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (packetId))
     {
       return;
     }
@@ -294,23 +340,47 @@ void
 FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
+  Time deadline = now - maxDelay;
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // Only the slots starting before the deadline may hold lost packets.
+  // A packet filed there may have been received since, or forwarded
+  // and thus seen later, in which case it is moved to a later slot.
+  while (!m_expirySlots.empty () && m_expirySlotsStart <= deadline)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
+      std::vector<TrackedPacketKey> keys;
+      keys.swap (m_expirySlots.front ());
+      bool expired = (m_expirySlotsStart + EXPIRY_SLOT_WIDTH <= deadline);
+      if (expired)
         {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+          m_expirySlots.pop_front ();
+          m_expirySlotsStart += EXPIRY_SLOT_WIDTH;
+        }
 
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
+      for (std::vector<TrackedPacketKey>::const_iterator key = keys.begin (); key != keys.end (); key++)
+        {
+          TrackedPacketMap::iterator iter = m_trackedPackets.find (*key);
+          if (iter == m_trackedPackets.end ())
+            {
+              continue;
+            }
+          if (now - iter->second.lastSeenTime >= maxDelay)
+            {
+              // packet is considered lost, add it to the loss statistics
+              // (of the current interval, when exporting periodically)
+              GetStatsForFlow (iter->first.first).lostPackets++;
+
+              // we won't track it anymore
+              m_trackedPackets.erase (iter);
+            }
+          else
+            {
+              FileForExpiry (*key, iter->second.lastSeenTime);
+            }
         }
-      else
+
+      if (!expired)
         {
-          iter++;
+          break;
         }
     }
 }
@@ -328,6 +398,69 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::StartPeriodicExport (Ptr<OutputStreamWrapper> stream, Time interval)
+{
+  NS_ASSERT_MSG (interval.IsStrictlyPositive (), "The export interval must be positive");
+  Simulator::Cancel (m_exportEvent);
+  m_exportStream = stream;
+  m_exportInterval = interval;
+  *m_exportStream->GetStream () << "time_ns,flowId,txPackets,txBytes,rxPackets,rxBytes,"
+                                << "lostPackets,timesForwarded,delaySum_ns,jitterSum_ns\n";
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+void
+FlowMonitor::StopPeriodicExport ()
+{
+  if (m_exportStream == 0)
+    {
+      return;
+    }
+  Simulator::Cancel (m_exportEvent);
+  ExportFlowStats ();
+  m_exportStream->GetStream ()->flush ();
+  m_exportStream = 0;
+}
+
+void
+FlowMonitor::PeriodicExport ()
+{
+  ExportFlowStats ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+void
+FlowMonitor::ExportFlowStats ()
+{
+  CheckForLostPackets ();
+
+  std::ostream &os = *m_exportStream->GetStream ();
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  for (FlowStatsContainerCI flowI = m_flowStats.begin ();
+       flowI != m_flowStats.end (); flowI++)
+    {
+      const FlowStats &stats = flowI->second;
+      os << now << ','
+         << flowI->first << ','
+         << stats.txPackets << ','
+         << stats.txBytes << ','
+         << stats.rxPackets << ','
+         << stats.rxBytes << ','
+         << stats.lostPackets << ','
+         << stats.timesForwarded << ','
+         << stats.delaySum.GetNanoSeconds () << ','
+         << stats.jitterSum.GetNanoSeconds () << '\n';
+    }
+
+  // start the next interval anew
+  m_flowStats.clear ();
+  for (uint32_t i = 0; i < m_flowProbes.size (); i++)
+    {
+      m_flowProbes[i]->ClearStats ();
+    }
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
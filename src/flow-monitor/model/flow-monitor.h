@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <map>
+#include <deque>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -31,6 +32,8 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/sgi-hashmap.h"
+#include "ns3/output-stream-wrapper.h"
 
 namespace ns3 {
 
@@ -46,6 +49,16 @@ namespace ns3 {
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * Packets in flight are kept in a hash table, and are also filed in
+ * time slots according to when they were last seen, so that the
+ * periodic search for lost packets only visits the slots old enough to
+ * hold them.  For very large simulations, the SamplingRate attribute
+ * restricts monitoring to one in every N packets of each flow.
+ *
+ * Long simulations can also export the statistics periodically
+ * instead of serializing them once at the end; see
+ * StartPeriodicExport.
+ *
  */
 class FlowMonitor : public Object
 {
@@ -256,6 +269,30 @@ public:
   /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  // --- periodic export ---
+
+  /// Write the flow statistics to a stream every interval, as CSV
+  /// records, and start over with empty statistics after each write.
+  ///
+  /// The stream begins with the header line
+  /// "time_ns,flowId,txPackets,txBytes,rxPackets,rxBytes,lostPackets,timesForwarded,delaySum_ns,jitterSum_ns"
+  /// followed, at the end of each interval, by one line per flow that
+  /// saw any event during that interval.  All the counters of a line
+  /// refer to that interval only, so that the memory used by the
+  /// statistics, including those of the probes, does not grow with
+  /// the length of the simulation.  As a consequence, the statistics
+  /// returned by GetFlowStats and serialized to XML only cover the
+  /// current interval, and the jitter of the first packet received in
+  /// each interval is not measured.
+  ///
+  /// \param stream the output stream
+  /// \param interval the time between two exports
+  void StartPeriodicExport (Ptr<OutputStreamWrapper> stream, Time interval);
+
+  /// Write the records of the current, partial, interval and stop
+  /// exporting
+  void StopPeriodicExport ();
+
 
 protected:
 
@@ -272,13 +309,37 @@ private:
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
   };
 
+  /// (FlowId,PacketId) identifying a tracked packet
+  typedef std::pair<FlowId, FlowPacketId> TrackedPacketKey;
+
+  /// Hash function for tracked packet keys
+  class TrackedPacketKeyHash : public std::unary_function<TrackedPacketKey, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a tracked packet key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (TrackedPacketKey const &key) const;
+  };
+
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
 
   /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  typedef sgi::hash_map<TrackedPacketKey, TrackedPacket, TrackedPacketKeyHash> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
+
+  /// Tracked packets filed by the time they were last seen, one
+  /// container per EXPIRY_SLOT_WIDTH.  Packets are not moved when
+  /// forwarded or removed when received; CheckForLostPackets skips or
+  /// refiles them when it visits their slot.
+  std::deque<std::vector<TrackedPacketKey> > m_expirySlots;
+  Time m_expirySlotsStart; //!< start time of the first slot in m_expirySlots
+
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
+  uint32_t m_samplingRate; //!< Monitor one in every m_samplingRate packets of each flow
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
   // note: this is needed only for serialization
@@ -298,8 +359,28 @@ private:
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// \param packetId the packet identification
+  /// \returns true if the packet belongs to the monitored sample
+  bool IsSampled (FlowPacketId packetId) const;
+
+  /// File a tracked packet in the expiry slot of the time it was last seen
+  /// \param key the tracked packet
+  /// \param lastSeenTime the time the packet was last seen
+  void FileForExpiry (const TrackedPacketKey &key, Time lastSeenTime);
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Write one CSV record per flow to m_exportStream and clear the
+  /// flow statistics
+  void ExportFlowStats ();
+
+  /// Periodic function to export the flow statistics
+  void PeriodicExport ();
+
+  Ptr<OutputStreamWrapper> m_exportStream; //!< periodic export stream, if any
+  Time m_exportInterval;    //!< periodic export interval
+  EventId m_exportEvent;    //!< next periodic export event
 };
 
 
@@ -71,6 +71,12 @@ FlowProbe::GetStats () const
   return m_stats;
 }
 
+void
+FlowProbe::ClearStats ()
+{
+  m_stats.clear ();
+}
+
 void
 FlowProbe::SerializeToXmlStream (std::ostream &os, int indent, uint32_t index) const
 {
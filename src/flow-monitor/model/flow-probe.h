@@ -92,6 +92,11 @@ public:
   /// \returns the partial flow statistics
   Stats GetStats () const;
 
+  /// Discard the partial flow statistics stored in this probe.  This
+  /// is used by the FlowMonitor periodic export to start each
+  /// interval anew.
+  void ClearStats ();
+
   /// Serializes the results to an std::ostream in XML format
   /// \param os the output stream
   /// \param indent number of spaces to use as base indentation level
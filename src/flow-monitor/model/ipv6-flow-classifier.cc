@@ -96,6 +96,18 @@ bool operator == (const Ipv6FlowClassifier::FiveTuple &t1,
 
 
 
+size_t
+Ipv6FlowClassifier::FiveTupleHash::operator() (FiveTuple const &tuple) const
+{
+  // Fibonacci hashing of each field in turn
+  Ipv6AddressHash addressHash;
+  uint64_t h = addressHash (tuple.sourceAddress);
+  h = h * 0x9e3779b97f4a7c15ULL + addressHash (tuple.destinationAddress);
+  h = h * 0x9e3779b97f4a7c15ULL + ((tuple.sourcePort << 16) | tuple.destinationPort);
+  h = h * 0x9e3779b97f4a7c15ULL + tuple.protocol;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
 Ipv6FlowClassifier::Ipv6FlowClassifier ()
 {
 }
@@ -148,7 +160,7 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
+  std::pair<FlowMap::iterator, bool> insert
     = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
@@ -156,15 +168,16 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
     {
       FlowId newFlowId = GetNewFlowId ();
       insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      NS_ASSERT (newFlowId == m_flows.size () + 1);
+      m_flows.push_back (std::make_pair (tuple, 0));
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      m_flows[insert.first->second - 1].second ++;
     }
 
   *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_packetId = m_flows[*out_flowId - 1].second;
 
   return true;
 }
@@ -173,13 +186,9 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  if (flowId >= 1 && flowId <= m_flows.size ())
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return m_flows[flowId - 1].first;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv6Address::GetZero (), Ipv6Address::GetZero (), 0, 0, 0 };
@@ -194,16 +203,15 @@ Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
   INDENT (indent); os << "<Ipv6FlowClassifier>\n";
 
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (uint32_t i = 0; i < m_flows.size (); i++)
     {
       INDENT (indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\""
+      os << "<Flow flowId=\"" << i + 1 << "\""
+         << " sourceAddress=\"" << m_flows[i].first.sourceAddress << "\""
+         << " destinationAddress=\"" << m_flows[i].first.destinationAddress << "\""
+         << " protocol=\"" << int(m_flows[i].first.protocol) << "\""
+         << " sourcePort=\"" << m_flows[i].first.sourcePort << "\""
+         << " destinationPort=\"" << m_flows[i].first.destinationPort << "\""
          << " />\n";
     }
 
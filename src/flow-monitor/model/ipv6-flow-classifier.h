@@ -23,10 +23,11 @@
 #define IPV6_FLOW_CLASSIFIER_H
 
 #include <stdint.h>
-#include <map>
+#include <vector>
 
 #include "ns3/ipv6-header.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -50,6 +51,18 @@ public:
     uint16_t destinationPort;       //!< Destination port
   };
 
+  /// Hash function for five tuples
+  class FiveTupleHash : public std::unary_function<FiveTuple, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a five tuple.
+     * \param tuple the five tuple
+     * \return the hash
+     */
+    size_t operator() (FiveTuple const &tuple) const;
+  };
+
   Ipv6FlowClassifier ();
 
   /// \brief try to classify the packet into flow-id and packet-id
@@ -74,10 +87,13 @@ public:
 
 private:
 
+  /// Container of FlowIds indexed by five tuple
+  typedef sgi::hash_map<FiveTuple, FlowId, FiveTupleHash> FlowMap;
+
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+  FlowMap m_flowMap;
+  /// Five tuple and last FlowPacketId of each flow, indexed by FlowId - 1
+  std::vector<std::pair<FiveTuple, FlowPacketId> > m_flows;
 
 };
 
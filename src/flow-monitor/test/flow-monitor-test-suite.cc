@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/test.h"
+#include <sstream>
+
+using namespace ns3;
+
+/// A probe which only forwards the reports of the test cases
+class FlowMonitorTestProbe : public FlowProbe
+{
+public:
+  FlowMonitorTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+class FlowMonitorLostPacketsTestCase : public TestCase
+{
+public:
+  FlowMonitorLostPacketsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void SendPackets (FlowId flowId, FlowPacketId first, FlowPacketId last);
+  void ReceivePackets (FlowId flowId, FlowPacketId first, FlowPacketId last);
+  void ForwardPacket (FlowId flowId, FlowPacketId packetId);
+  void CheckLost (FlowId flowId, uint32_t lost, uint32_t rx);
+
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<FlowProbe> m_probe;
+};
+
+FlowMonitorLostPacketsTestCase::FlowMonitorLostPacketsTestCase ()
+  : TestCase ("Check lost packet detection and sampling")
+{
+}
+
+void
+FlowMonitorLostPacketsTestCase::SendPackets (FlowId flowId, FlowPacketId first, FlowPacketId last)
+{
+  for (FlowPacketId id = first; id <= last; id++)
+    {
+      m_monitor->ReportFirstTx (m_probe, flowId, id, 100);
+    }
+}
+
+void
+FlowMonitorLostPacketsTestCase::ReceivePackets (FlowId flowId, FlowPacketId first, FlowPacketId last)
+{
+  for (FlowPacketId id = first; id <= last; id++)
+    {
+      m_monitor->ReportLastRx (m_probe, flowId, id, 100);
+    }
+}
+
+void
+FlowMonitorLostPacketsTestCase::ForwardPacket (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportForwarding (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorLostPacketsTestCase::CheckLost (FlowId flowId, uint32_t lost, uint32_t rx)
+{
+  FlowMonitor::FlowStats stats = m_monitor->GetFlowStats ().find (flowId)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, lost, "Unexpected number of lost packets at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, rx, "Unexpected number of received packets at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+FlowMonitorLostPacketsTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_probe = CreateObject<FlowMonitorTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+
+  // flow 1: packets 0-9 sent at 0 s, 0-4 received at 1 s, 5 forwarded
+  // at 5 s and the others never seen again
+  Simulator::Schedule (Seconds (0), &FlowMonitorLostPacketsTestCase::SendPackets, this, 1, 0, 9);
+  Simulator::Schedule (Seconds (1), &FlowMonitorLostPacketsTestCase::ReceivePackets, this, 1, 0, 4);
+  Simulator::Schedule (Seconds (5), &FlowMonitorLostPacketsTestCase::ForwardPacket, this, 1, 5);
+  // flow 2: packets 0-4 sent at 3.05 s and lost
+  Simulator::Schedule (Seconds (3.05), &FlowMonitorLostPacketsTestCase::SendPackets, this, 2, 0, 4);
+
+  // the default maximum per-hop delay is 10 s, checked every second
+  Simulator::Schedule (Seconds (9.5), &FlowMonitorLostPacketsTestCase::CheckLost, this, 1, 0, 5);
+  Simulator::Schedule (Seconds (10.5), &FlowMonitorLostPacketsTestCase::CheckLost, this, 1, 4, 5);
+  Simulator::Schedule (Seconds (13.5), &FlowMonitorLostPacketsTestCase::CheckLost, this, 2, 0, 0);
+  Simulator::Schedule (Seconds (14.5), &FlowMonitorLostPacketsTestCase::CheckLost, this, 2, 5, 0);
+  Simulator::Schedule (Seconds (14.5), &FlowMonitorLostPacketsTestCase::CheckLost, this, 1, 4, 5);
+  Simulator::Schedule (Seconds (15.5), &FlowMonitorLostPacketsTestCase::CheckLost, this, 1, 5, 5);
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // an explicit check with a shorter delay
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_probe = CreateObject<FlowMonitorTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  Simulator::Schedule (Seconds (0), &FlowMonitorLostPacketsTestCase::SendPackets, this, 1, 0, 9);
+  Simulator::Schedule (Seconds (0.5), &FlowMonitorLostPacketsTestCase::ReceivePackets, this, 1, 0, 1);
+  Simulator::Stop (Seconds (0.8));
+  Simulator::Run ();
+  m_monitor->CheckForLostPackets (Seconds (0.5));
+  CheckLost (1, 8, 2);
+  Simulator::Destroy ();
+
+  // sampling: only packets 0, 3 and 6 of each flow are monitored
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("SamplingRate", UintegerValue (3));
+  m_probe = CreateObject<FlowMonitorTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  SendPackets (1, 0, 7);
+  ReceivePackets (1, 0, 5);
+  m_monitor->StopRightNow ();
+  FlowMonitor::FlowStats stats = m_monitor->GetFlowStats ().find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.txPackets, 3, "Unexpected number of sampled packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, 2, "Unexpected number of sampled received packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.txBytes, 300, "Unexpected number of sampled bytes");
+  Simulator::Destroy ();
+
+  m_probe = 0;
+  m_monitor = 0;
+}
+
+class FlowMonitorPeriodicExportTestCase : public TestCase
+{
+public:
+  FlowMonitorPeriodicExportTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void SendPacket (FlowId flowId, FlowPacketId packetId);
+  void ReceivePacket (FlowId flowId, FlowPacketId packetId);
+
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<FlowProbe> m_probe;
+};
+
+FlowMonitorPeriodicExportTestCase::FlowMonitorPeriodicExportTestCase ()
+  : TestCase ("Check the periodic export of interval statistics")
+{
+}
+
+void
+FlowMonitorPeriodicExportTestCase::SendPacket (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorPeriodicExportTestCase::ReceivePacket (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorPeriodicExportTestCase::DoRun (void)
+{
+  std::ostringstream os;
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_probe = CreateObject<FlowMonitorTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  m_monitor->StartPeriodicExport (Create<OutputStreamWrapper> (&os), Seconds (1));
+
+  // first interval: flow 1 sends four packets, two of them are received
+  for (FlowPacketId id = 0; id < 4; id++)
+    {
+      Simulator::Schedule (MilliSeconds (500), &FlowMonitorPeriodicExportTestCase::SendPacket, this, 1, id);
+    }
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorPeriodicExportTestCase::ReceivePacket, this, 1, 0);
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorPeriodicExportTestCase::ReceivePacket, this, 1, 1);
+  // second interval: flow 2 only
+  Simulator::Schedule (MilliSeconds (1500), &FlowMonitorPeriodicExportTestCase::SendPacket, this, 2, 0);
+  Simulator::Schedule (MilliSeconds (1700), &FlowMonitorPeriodicExportTestCase::ReceivePacket, this, 2, 0);
+  // partial third interval: a late packet of flow 1
+  Simulator::Schedule (MilliSeconds (2200), &FlowMonitorPeriodicExportTestCase::ReceivePacket, this, 1, 2);
+  Simulator::Schedule (MilliSeconds (2500), &FlowMonitor::StopPeriodicExport, m_monitor);
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (os.str (),
+                         "time_ns,flowId,txPackets,txBytes,rxPackets,rxBytes,lostPackets,timesForwarded,delaySum_ns,jitterSum_ns\n"
+                         "1000000000,1,4,400,2,200,0,0,200000000,0\n"
+                         "2000000000,2,1,100,1,100,0,0,200000000,0\n"
+                         "2500000000,1,0,0,1,100,0,0,1700000000,0\n",
+                         "Unexpected export");
+  NS_TEST_EXPECT_MSG_EQ (m_monitor->GetFlowStats ().size (), 0, "Flow statistics not cleared");
+  NS_TEST_EXPECT_MSG_EQ (m_probe->GetStats ().size (), 0, "Probe statistics not cleared");
+
+  Simulator::Destroy ();
+  m_probe = 0;
+  m_monitor = 0;
+}
+
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new FlowMonitorLostPacketsTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorPeriodicExportTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TrafficControlHelper");
+
+TrafficControlHelper::TrafficControlHelper ()
+{
+  m_queueDiscFactory.SetTypeId ("ns3::FqCoDelQueueDisc");
+}
+
+void
+TrafficControlHelper::SetRootQueueDisc (std::string type,
+                                        std::string n1, const AttributeValue &v1,
+                                        std::string n2, const AttributeValue &v2,
+                                        std::string n3, const AttributeValue &v3,
+                                        std::string n4, const AttributeValue &v4)
+{
+  m_queueDiscFactory.SetTypeId (type);
+  m_queueDiscFactory.Set (n1, v1);
+  m_queueDiscFactory.Set (n2, v2);
+  m_queueDiscFactory.Set (n3, v3);
+  m_queueDiscFactory.Set (n4, v4);
+}
+
+Ptr<QueueDisc>
+TrafficControlHelper::Install (Ptr<NetDevice> device) const
+{
+  Ptr<Node> node = device->GetNode ();
+  Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+  if (tc == 0)
+    {
+      tc = CreateObject<TrafficControlLayer> ();
+      node->AggregateObject (tc);
+    }
+  Ptr<QueueDisc> qDisc = m_queueDiscFactory.Create<QueueDisc> ();
+  tc->SetRootQueueDiscOnDevice (device, qDisc);
+  return qDisc;
+}
+
+void
+TrafficControlHelper::Install (NetDeviceContainer devices) const
+{
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Install (*i);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRAFFIC_CONTROL_HELPER_H
+#define TRAFFIC_CONTROL_HELPER_H
+
+#include <string>
+#include "ns3/object-factory.h"
+#include "ns3/net-device-container.h"
+#include "ns3/queue-disc.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Install queueing disciplines on devices.
+ *
+ * The traffic control layer is aggregated to the node of a device the
+ * first time a queueing discipline is installed on one of its devices.
+ * The default queueing discipline is ns3::FqCoDelQueueDisc.
+ */
+class TrafficControlHelper
+{
+public:
+  TrafficControlHelper ();
+
+  /**
+   * \param type the type of queueing discipline
+   * \param n1 the name of the attribute to set on the queueing discipline
+   * \param v1 the value of the attribute to set on the queueing discipline
+   * \param n2 the name of the attribute to set on the queueing discipline
+   * \param v2 the value of the attribute to set on the queueing discipline
+   * \param n3 the name of the attribute to set on the queueing discipline
+   * \param v3 the value of the attribute to set on the queueing discipline
+   * \param n4 the name of the attribute to set on the queueing discipline
+   * \param v4 the value of the attribute to set on the queueing discipline
+   *
+   * Set the type of queueing discipline to install on each device.
+   */
+  void SetRootQueueDisc (std::string type,
+                         std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                         std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                         std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue (),
+                         std::string n4 = "", const AttributeValue &v4 = EmptyAttributeValue ());
+
+  /**
+   * \param device the device
+   * \returns the queueing discipline installed on the device
+   */
+  Ptr<QueueDisc> Install (Ptr<NetDevice> device) const;
+
+  /**
+   * \param devices the devices
+   */
+  void Install (NetDeviceContainer devices) const;
+
+private:
+  ObjectFactory m_queueDiscFactory;  //!< Factory of the queueing disciplines
+};
+
+} // namespace ns3
+
+#endif /* TRAFFIC_CONTROL_HELPER_H */
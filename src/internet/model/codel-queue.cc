@@ -28,6 +28,7 @@
 #include "ns3/log.h"
 #include "ns3/enum.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/abort.h"
 #include "codel-queue.h"
 
@@ -181,6 +182,11 @@ TypeId CoDelQueue::GetTypeId (void)
                    StringValue ("5ms"),
                    MakeTimeAccessor (&CoDelQueue::m_target),
                    MakeTimeChecker ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN-capable packets instead of dropping them",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CoDelQueue::m_useEcn),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Count",
                      "CoDel count",
                      MakeTraceSourceAccessor (&CoDelQueue::m_count),
@@ -231,6 +237,7 @@ CoDelQueue::CoDelQueue ()
     m_state3 (0),
     m_states (0),
     m_dropOverLimit (0),
+    m_markCount (0),
     m_sojourn (0)
 {
   NS_LOG_FUNCTION (this);
@@ -280,7 +287,7 @@ CoDelQueue::DoEnqueue (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
 
-  if (m_mode == QUEUE_MODE_PACKETS && (m_packets.size () + 1 > m_maxPackets))
+  if (m_mode == QUEUE_MODE_PACKETS && (m_packets.GetSize () + 1 > m_maxPackets))
     {
       NS_LOG_LOGIC ("Queue full (at max packets) -- droppping pkt");
       Drop (p);
@@ -301,9 +308,9 @@ CoDelQueue::DoEnqueue (Ptr<Packet> p)
   p->AddPacketTag (tag);
 
   m_bytesInQueue += p->GetSize ();
-  m_packets.push (p);
+  m_packets.PushBack (p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
   return true;
@@ -356,7 +363,7 @@ CoDelQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       // Leave dropping state when queue is empty
       m_dropping = false;
@@ -365,12 +372,12 @@ CoDelQueue::DoDequeue (void)
       return 0;
     }
   uint32_t now = CoDelGetTime ();
-  Ptr<Packet> p = m_packets.front ();
-  m_packets.pop ();
+  Ptr<Packet> p = m_packets.Front ();
+  m_packets.PopFront ();
   m_bytesInQueue -= p->GetSize ();
 
   NS_LOG_LOGIC ("Popped " << p);
-  NS_LOG_LOGIC ("Number packets remaining " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets remaining " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
 
   // Determine if p should be dropped
@@ -392,6 +399,17 @@ CoDelQueue::DoDequeue (void)
           m_state2++;
           while (m_dropping && CoDelTimeAfterEq (now, m_dropNext))
             {
+              if (m_useEcn && Mark (p))
+                {
+                  // With ECN, the current packet is marked and delivered,
+                  // and the next mark is scheduled as a drop would be
+                  NS_LOG_LOGIC ("Sojourn time is still above target and it's time for next drop; marking " << p);
+                  ++m_markCount;
+                  ++m_count;
+                  NewtonStep ();
+                  m_dropNext = ControlLaw (m_dropNext);
+                  break;
+                }
               // It's time for the next drop. Drop the current packet and
               // dequeue the next. The dequeue might take us out of dropping
               // state. If not, schedule the next drop.
@@ -409,19 +427,19 @@ CoDelQueue::DoDequeue (void)
               ++m_dropCount;
               ++m_count;
               NewtonStep ();
-              if (m_packets.empty ())
+              if (m_packets.IsEmpty ())
                 {
                   m_dropping = false;
                   NS_LOG_LOGIC ("Queue empty");
                   ++m_states;
                   return 0;
                 }
-              p = m_packets.front ();
-              m_packets.pop ();
+              p = m_packets.Front ();
+              m_packets.PopFront ();
               m_bytesInQueue -= p->GetSize ();
 
               NS_LOG_LOGIC ("Popped " << p);
-              NS_LOG_LOGIC ("Number packets remaining " << m_packets.size ());
+              NS_LOG_LOGIC ("Number packets remaining " << m_packets.GetSize ());
               NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
 
               if (!OkToDrop (p, now))
@@ -447,35 +465,45 @@ CoDelQueue::DoDequeue (void)
       NS_LOG_LOGIC ("Not in dropping state; decide if we have to enter the state and drop the first packet");
       if (okToDrop)
         {
-          // Drop the first packet and enter dropping state unless the queue is empty
-          NS_LOG_LOGIC ("Sojourn time goes above target, dropping the first packet " << p << " and entering the dropping state");
-          ++m_dropCount;
-          Drop (p);
-
-          // p was in queue, trace the dequeue and update stats manually
-          m_traceDequeue (p);
-          m_nBytes -= p->GetSize ();
-          m_nPackets--;
-
-          if (m_packets.empty ())
+          if (m_useEcn && Mark (p))
             {
-              m_dropping = false;
-              okToDrop = false;
-              NS_LOG_LOGIC ("Queue empty");
-              ++m_states;
+              // With ECN, mark the first packet and enter dropping state
+              NS_LOG_LOGIC ("Sojourn time goes above target, marking the first packet " << p << " and entering the dropping state");
+              ++m_markCount;
+              m_dropping = true;
             }
           else
             {
-              p = m_packets.front ();
-              m_packets.pop ();
-              m_bytesInQueue -= p->GetSize ();
+              // Drop the first packet and enter dropping state unless the queue is empty
+              NS_LOG_LOGIC ("Sojourn time goes above target, dropping the first packet " << p << " and entering the dropping state");
+              ++m_dropCount;
+              Drop (p);
 
-              NS_LOG_LOGIC ("Popped " << p);
-              NS_LOG_LOGIC ("Number packets remaining " << m_packets.size ());
-              NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
+              // p was in queue, trace the dequeue and update stats manually
+              m_traceDequeue (p);
+              m_nBytes -= p->GetSize ();
+              m_nPackets--;
 
-              okToDrop = OkToDrop (p, now);
-              m_dropping = true;
+              if (m_packets.IsEmpty ())
+                {
+                  m_dropping = false;
+                  okToDrop = false;
+                  NS_LOG_LOGIC ("Queue empty");
+                  ++m_states;
+                }
+              else
+                {
+                  p = m_packets.Front ();
+                  m_packets.PopFront ();
+                  m_bytesInQueue -= p->GetSize ();
+
+                  NS_LOG_LOGIC ("Popped " << p);
+                  NS_LOG_LOGIC ("Number packets remaining " << m_packets.GetSize ());
+                  NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
+
+                  okToDrop = OkToDrop (p, now);
+                  m_dropping = true;
+                }
             }
           ++m_state3;
           /*
@@ -514,7 +542,7 @@ CoDelQueue::GetQueueSize (void)
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
-      return m_packets.size ();
+      return m_packets.GetSize ();
     }
   else
     {
@@ -534,6 +562,12 @@ CoDelQueue::GetDropCount (void)
   return m_dropCount;
 }
 
+uint32_t
+CoDelQueue::GetMarkCount (void)
+{
+  return m_markCount;
+}
+
 Time
 CoDelQueue::GetTarget (void)
 {
@@ -557,15 +591,15 @@ CoDelQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
   return p;
@@ -28,9 +28,9 @@
 #ifndef CODEL_H
 #define CODEL_H
 
-#include <queue>
 #include "ns3/packet.h"
 #include "ns3/queue.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
@@ -115,6 +115,14 @@ public:
    */
   uint32_t GetDropCount (void);
 
+  /**
+   * \brief Get the number of packets marked instead of dropped, when
+   * the UseEcn attribute is set
+   *
+   * \returns The number of marked packets
+   */
+  uint32_t GetMarkCount (void);
+
   /**
    * \brief Get the target queue delay
    *
@@ -223,7 +231,7 @@ private:
    */
   uint32_t Time2CoDel (Time t);
 
-  std::queue<Ptr<Packet> > m_packets;     //!< The packet queue
+  RingBuffer<Ptr<Packet> > m_packets;     //!< The packet queue
   uint32_t m_maxPackets;                  //!< Max # of packets accepted by the queue
   uint32_t m_maxBytes;                    //!< Max # of bytes accepted by the queue
   TracedValue<uint32_t> m_bytesInQueue;   //!< The total number of bytes in queue
@@ -242,6 +250,8 @@ private:
   uint32_t m_state3;                      //!< Number of times we enter drop state and drop the fist packet
   uint32_t m_states;                      //!< Total number of times we are in state 1, state 2, or state 3
   uint32_t m_dropOverLimit;               //!< The number of packets dropped due to full queue
+  bool m_useEcn;                          //!< True to mark ECN-capable packets instead of dropping them
+  uint32_t m_markCount;                   //!< The number of packets marked instead of dropped
   QueueMode     m_mode;                   //!< The operating mode (Bytes or packets)
   TracedValue<Time> m_sojourn;            //!< Time in queue
 };
@@ -0,0 +1,322 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "fq-codel-queue-disc.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FqCoDelQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (FqCoDelQueueDisc);
+
+FqCoDelQueueDisc::Flow::Flow ()
+  : bytes (0),
+    deficit (0),
+    status (INACTIVE),
+    dropping (false),
+    count (0),
+    lastCount (0)
+{
+}
+
+TypeId
+FqCoDelQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqCoDelQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<FqCoDelQueueDisc> ()
+    .AddAttribute ("Interval",
+                   "The CoDel algorithm interval for each flow queue",
+                   StringValue ("100ms"),
+                   MakeTimeAccessor (&FqCoDelQueueDisc::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Target",
+                   "The CoDel algorithm target queue delay for each flow queue",
+                   StringValue ("5ms"),
+                   MakeTimeAccessor (&FqCoDelQueueDisc::m_target),
+                   MakeTimeChecker ())
+    .AddAttribute ("PacketLimit",
+                   "The maximum number of packets accepted by the queueing discipline",
+                   UintegerValue (10240),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Flows",
+                   "The number of flow queues",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_nFlows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Quantum",
+                   "The number of bytes a flow queue may send in each round",
+                   UintegerValue (1514),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Perturbation",
+                   "The value mixed in the hash of the flows",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_perturbation),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN-capable packets instead of dropping them",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FqCoDelQueueDisc::m_useEcn),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+FqCoDelQueueDisc::FqCoDelQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FqCoDelQueueDisc::~FqCoDelQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+FqCoDelQueueDisc::Classify (Ptr<const QueueDiscItem> item) const
+{
+  return item->Hash (m_perturbation) % m_nFlows;
+}
+
+uint32_t
+FqCoDelQueueDisc::GetNPacketsInFlow (uint32_t flow) const
+{
+  return flow < m_flows.size () ? m_flows[flow].packets.size () : 0;
+}
+
+bool
+FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (m_flows.empty ())
+    { // The number of flows is known once the attributes are set
+      m_flows.resize (m_nFlows);
+    }
+
+  uint32_t h = Classify (item);
+  Flow &flow = m_flows[h];
+  flow.packets.push_back (item);
+  flow.bytes += item->GetSize ();
+  if (flow.status == INACTIVE)
+    {
+      flow.status = NEW_FLOW;
+      flow.deficit = m_quantum;
+      m_newFlows.push_back (h);
+    }
+  NS_LOG_LOGIC ("Enqueued in flow " << h << ", " << flow.packets.size () << " packets in the flow");
+
+  if (GetNPackets () > m_limit)
+    {
+      DropFromFattestFlow ();
+    }
+  return true;
+}
+
+void
+FqCoDelQueueDisc::DropFromFattestFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t fattest = 0;
+  for (uint32_t i = 1; i < m_flows.size (); i++)
+    {
+      if (m_flows[i].bytes > m_flows[fattest].bytes)
+        {
+          fattest = i;
+        }
+    }
+  Flow &flow = m_flows[fattest];
+  NS_ASSERT (!flow.packets.empty ());
+  Ptr<QueueDiscItem> item = flow.packets.front ();
+  flow.packets.pop_front ();
+  flow.bytes -= item->GetSize ();
+  NS_LOG_LOGIC ("Queue full -- dropping the head of flow " << fattest);
+  DropAfterEnqueue (item);
+}
+
+Time
+FqCoDelQueueDisc::ControlLaw (Time t, uint32_t count) const
+{
+  return t + Time::FromDouble (m_interval.GetSeconds () / std::sqrt (static_cast<double> (count)), Time::S);
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::FlowDequeue (Flow &flow, bool &okToDrop)
+{
+  okToDrop = false;
+  if (flow.packets.empty ())
+    {
+      flow.firstAboveTime = Time (0);
+      return 0;
+    }
+  Ptr<QueueDiscItem> item = flow.packets.front ();
+  flow.packets.pop_front ();
+  flow.bytes -= item->GetSize ();
+
+  Time now = Simulator::Now ();
+  Time sojournTime = now - item->GetTimeStamp ();
+  if (sojournTime < m_target || flow.bytes <= m_quantum)
+    {
+      // Went below target, or too few bytes left to build a standing queue
+      flow.firstAboveTime = Time (0);
+    }
+  else if (flow.firstAboveTime.IsZero ())
+    {
+      flow.firstAboveTime = now + m_interval;
+    }
+  else if (now >= flow.firstAboveTime)
+    {
+      okToDrop = true;
+    }
+  return item;
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::CoDelDequeue (Flow &flow)
+{
+  bool okToDrop;
+  Ptr<QueueDiscItem> item = FlowDequeue (flow, okToDrop);
+  if (item == 0)
+    {
+      flow.dropping = false;
+      return 0;
+    }
+
+  Time now = Simulator::Now ();
+  if (flow.dropping)
+    {
+      if (!okToDrop)
+        {
+          flow.dropping = false;
+        }
+      while (flow.dropping && now >= flow.dropNext)
+        {
+          if (m_useEcn && Mark (item))
+            {
+              flow.count++;
+              flow.dropNext = ControlLaw (flow.dropNext, flow.count);
+              break;
+            }
+          DropAfterEnqueue (item);
+          flow.count++;
+          item = FlowDequeue (flow, okToDrop);
+          if (item == 0 || !okToDrop)
+            {
+              flow.dropping = false;
+            }
+          else
+            {
+              flow.dropNext = ControlLaw (flow.dropNext, flow.count);
+            }
+        }
+    }
+  else if (okToDrop)
+    {
+      if (m_useEcn && Mark (item))
+        {
+          NS_LOG_LOGIC ("Sojourn time above target for one interval, marking");
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Sojourn time above target for one interval, dropping");
+          DropAfterEnqueue (item);
+          item = FlowDequeue (flow, okToDrop);
+        }
+      flow.dropping = true;
+      // Resume at the drop rate of the previous dropping state if it was
+      // left recently
+      uint32_t delta = flow.count - flow.lastCount;
+      if (delta > 1 && now - flow.dropNext < 16 * m_interval)
+        {
+          flow.count = delta;
+        }
+      else
+        {
+          flow.count = 1;
+        }
+      flow.lastCount = flow.count;
+      flow.dropNext = ControlLaw (now, flow.count);
+    }
+  return item;
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  while (true)
+    {
+      std::list<uint32_t> *flows;
+      if (!m_newFlows.empty ())
+        {
+          flows = &m_newFlows;
+        }
+      else if (!m_oldFlows.empty ())
+        {
+          flows = &m_oldFlows;
+        }
+      else
+        {
+          return 0;
+        }
+
+      uint32_t h = flows->front ();
+      Flow &flow = m_flows[h];
+      if (flow.deficit <= 0)
+        {
+          // Used up its quantum, moves to the end of the old flows
+          flow.deficit += m_quantum;
+          flow.status = OLD_FLOW;
+          m_oldFlows.splice (m_oldFlows.end (), *flows, flows->begin ());
+          continue;
+        }
+
+      Ptr<QueueDiscItem> item = CoDelDequeue (flow);
+      if (item == 0)
+        {
+          // A new flow which empties moves to the old flows, so that it
+          // cannot get ahead of them by going idle and active again
+          if (flows == &m_newFlows && !m_oldFlows.empty ())
+            {
+              flow.status = OLD_FLOW;
+              m_oldFlows.splice (m_oldFlows.end (), *flows, flows->begin ());
+            }
+          else
+            {
+              flow.status = INACTIVE;
+              flows->pop_front ();
+            }
+          continue;
+        }
+
+      flow.deficit -= item->GetSize ();
+      NS_LOG_LOGIC ("Dequeued from flow " << h);
+      return item;
+    }
+}
+
+} // namespace ns3
@@ -26,8 +26,19 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+size_t
+Ipv4EndPointDemux::KeyHash::operator() (uint64_t key) const
+{
+  // Fibonacci hashing spreads the peer address, which varies the most,
+  // over all the bits of the result.
+  key *= 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (key ^ (key >> 32));
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152),
+    m_portsInUse (65536, false),
+    m_nextSequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -35,36 +46,113 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (OrderedEndPoints::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
-      Ipv4EndPoint *endPoint = *i;
+      Ipv4EndPoint *endPoint = i->second;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_ports.clear ();
+  m_listeners.clear ();
+  m_connections.clear ();
 }
 
-bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+uint64_t
+Ipv4EndPointDemux::GetKey (uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return (static_cast<uint64_t> (peerAddress.Get ()) << 32) |
+         (static_cast<uint64_t> (localPort) << 16) | peerPort;
+}
+
+void
+Ipv4EndPointDemux::Register (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  endPoint->m_sequence = m_nextSequence++;
+  m_endPoints[endPoint->m_sequence] = endPoint;
+  Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+}
+
+void
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t localPort = endPoint->GetLocalPort ();
+  Ipv4Address peerAddress = endPoint->GetPeerAddress ();
+  uint16_t peerPort = endPoint->GetPeerPort ();
+
+  m_ports[localPort][endPoint->m_sequence] = endPoint;
+  m_portsInUse[localPort] = true;
+  m_connections[GetKey (localPort, peerAddress, peerPort)][endPoint->m_sequence] = endPoint;
+  if (peerPort == 0 && peerAddress == Ipv4Address::GetAny ())
+    {
+      m_listeners[localPort][endPoint->m_sequence] = endPoint;
+    }
+}
+
+void
+Ipv4EndPointDemux::Remove (Ipv4EndPoint *endPoint, uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
+{
+  NS_LOG_FUNCTION (this << endPoint << localPort << peerAddress << peerPort);
+  std::map<uint16_t, OrderedEndPoints>::iterator p = m_ports.find (localPort);
+  NS_ASSERT (p != m_ports.end ());
+  p->second.erase (endPoint->m_sequence);
+  if (p->second.empty ())
+    {
+      m_ports.erase (p);
+      m_portsInUse[localPort] = false;
+    }
+
+  Connections::iterator c = m_connections.find (GetKey (localPort, peerAddress, peerPort));
+  NS_ASSERT (c != m_connections.end ());
+  c->second.erase (endPoint->m_sequence);
+  if (c->second.empty ())
+    {
+      m_connections.erase (c);
+    }
+
+  if (peerPort == 0 && peerAddress == Ipv4Address::GetAny ())
     {
-      if ((*i)->GetLocalPort  () == port) 
+      std::map<uint16_t, OrderedEndPoints>::iterator l = m_listeners.find (localPort);
+      NS_ASSERT (l != m_listeners.end ());
+      l->second.erase (endPoint->m_sequence);
+      if (l->second.empty ())
         {
-          return true;
+          m_listeners.erase (l);
         }
     }
-  return false;
+}
+
+void
+Ipv4EndPointDemux::NotifyChanged (Ipv4EndPoint *endPoint, uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
+{
+  NS_LOG_FUNCTION (this << endPoint << localPort << peerAddress << peerPort);
+  Remove (endPoint, localPort, peerAddress, peerPort);
+  Insert (endPoint);
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_portsInUse[port];
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::map<uint16_t, OrderedEndPoints>::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      return false;
+    }
+  for (OrderedEndPoints::iterator i = p->second.begin (); i != p->second.end (); i++) 
+    {
+      if (i->second->GetLocalAddress () == addr) 
         {
           return true;
         }
@@ -83,8 +171,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Register (endPoint);
   return endPoint;
 }
 
@@ -99,8 +186,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Register (endPoint);
   return endPoint;
 }
 
@@ -122,8 +208,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Register (endPoint);
   return endPoint;
 }
 
@@ -132,24 +217,22 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  Connections::iterator c = m_connections.find (GetKey (localPort, peerAddress, peerPort));
+  if (c != m_connections.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
+      for (OrderedEndPoints::iterator i = c->second.begin (); i != c->second.end (); i++) 
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          if (i->second->GetLocalAddress () == localAddress) 
+            {
+              NS_LOG_WARN ("No way we can allocate this end-point.");
+              /* no way we can allocate this end-point. */
+              return 0;
+            }
         }
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
+  Register (endPoint);
   return endPoint;
 }
 
@@ -157,15 +240,15 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  OrderedEndPoints::iterator i = m_endPoints.find (endPoint->m_sequence);
+  if (endPoint->m_demux != this || i == m_endPoints.end () || i->second != endPoint)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Remove (endPoint, endPoint->GetLocalPort (), endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  m_endPoints.erase (i);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -177,9 +260,9 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   NS_LOG_FUNCTION (this);
   EndPoints ret;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPoints::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4EndPoint* endP = i->second;
       ret.push_back (endP);
     }
   return ret;
@@ -190,6 +273,12 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
  * If we have an exact match, we return it.
  * Otherwise, if we find a generic match, we return it.
  * Otherwise, we return 0.
+ *
+ * Only end points whose peer matches the source exactly can be exact
+ * matches (retval3 and retval4): they are all in one bucket of the
+ * connection table.  Only end points with a wildcard peer can be
+ * generic matches (retval1 and retval2): they are all in the listener
+ * table.  End points with a partially wildcard peer never match.
  */
 Ipv4EndPointDemux::EndPoints
 Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport, 
@@ -204,107 +293,115 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; incomingInterface != 0 && i < incomingInterface->GetNAddresses (); i++)
     {
-      Ipv4EndPoint* endP = *i;
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
-      if (endP->GetLocalPort () != dport) 
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
         }
-      if (endP->GetBoundNetDevice ())
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  Connections::iterator c = m_connections.find (GetKey (dport, saddr, sport));
+  if (c != m_connections.end ())
+    {
+      for (OrderedEndPoints::iterator i = c->second.begin (); i != c->second.end (); i++) 
         {
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+          Ipv4EndPoint* endP = i->second;
+          bool localAddressMatchesWildCard;
+          bool localAddressMatchesExact;
+          if (!MatchLocal (endP, daddr, isBroadcast, incomingInterfaceAddr, incomingInterface,
+                           localAddressMatchesWildCard, localAddressMatchesExact))
             {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
               continue;
             }
+          if (localAddressMatchesWildCard)
+            { // All but local address
+              retval3.push_back (endP);
+            }
+          if (localAddressMatchesExact)
+            { // All 4 match
+              retval4.push_back (endP);
+            }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    }
+
+  // Here we find the most exact match
+  if (!retval4.empty ()) return retval4;
+  if (!retval3.empty ()) return retval3;
+
+  std::map<uint16_t, OrderedEndPoints>::iterator l = m_listeners.find (dport);
+  if (l != m_listeners.end ())
+    {
+      for (OrderedEndPoints::iterator i = l->second.begin (); i != l->second.end (); i++) 
         {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+          Ipv4EndPoint* endP = i->second;
+          bool localAddressMatchesWildCard;
+          bool localAddressMatchesExact;
+          if (!MatchLocal (endP, daddr, isBroadcast, incomingInterfaceAddr, incomingInterface,
+                           localAddressMatchesWildCard, localAddressMatchesExact))
             {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
+              continue;
+            }
+          if (localAddressMatchesWildCard)
+            { // Only local port matches exactly
+              retval1.push_back (endP);
+            }
+          if (localAddressMatchesExact || (isBroadcast && localAddressMatchesWildCard))
+            { // Only local port and local address matches exactly
+              retval2.push_back (endP);
             }
         }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
-      bool localAddressMatchesWildCard = 
-        endP->GetLocalAddress () == Ipv4Address::GetAny ();
-      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
+    }
 
-      if (isBroadcast)
-        {
-          NS_LOG_DEBUG ("Found bcast, localaddr " << endP->GetLocalAddress ());
-        }
+  if (!retval2.empty ()) return retval2;
+  return retval1;  // might be empty if no matches
+}
 
-      if (isBroadcast && (endP->GetLocalAddress () != Ipv4Address::GetAny ()))
+bool
+Ipv4EndPointDemux::MatchLocal (Ipv4EndPoint *endP, Ipv4Address daddr, bool isBroadcast,
+                               Ipv4Address incomingInterfaceAddr,
+                               Ptr<Ipv4Interface> incomingInterface,
+                               bool &localAddressMatchesWildCard,
+                               bool &localAddressMatchesExact)
+{
+  NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
+                                             << " daddr=" << endP->GetLocalAddress ()
+                                             << " sport=" << endP->GetPeerPort ()
+                                             << " saddr=" << endP->GetPeerAddress ());
+  if (endP->GetBoundNetDevice ())
+    {
+      if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
         {
-          localAddressMatchesExact = (endP->GetLocalAddress () ==
-                                      incomingInterfaceAddr);
-        }
-      // if no match here, keep looking
-      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        continue; 
-      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () ==
-        Ipv4Address::GetAny ();
-      // If remote does not match either with exact or wildcard,
-      // skip this one
-      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        continue;
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        continue;
-
-      // Now figure out which return list to add this one to
-      if (localAddressMatchesWildCard &&
-          remotePeerMatchesWildCard &&
-          remoteAddressMatchesWildCard)
-        { // Only local port matches exactly
-          retval1.push_back (endP);
-        }
-      if ((localAddressMatchesExact || (isBroadcast && localAddressMatchesWildCard))&&
-          remotePeerMatchesWildCard &&
-          remoteAddressMatchesWildCard)
-        { // Only local port and local address matches exactly
-          retval2.push_back (endP);
-        }
-      if (localAddressMatchesWildCard &&
-          remotePeerMatchesExact &&
-          remoteAddressMatchesExact)
-        { // All but local address
-          retval3.push_back (endP);
-        }
-      if (localAddressMatchesExact &&
-          remotePeerMatchesExact &&
-          remoteAddressMatchesExact)
-        { // All 4 match
-          retval4.push_back (endP);
+          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          return false;
         }
     }
+  localAddressMatchesWildCard = 
+    endP->GetLocalAddress () == Ipv4Address::GetAny ();
+  localAddressMatchesExact = endP->GetLocalAddress () == daddr;
 
-  // Here we find the most exact match
-  if (!retval4.empty ()) return retval4;
-  if (!retval3.empty ()) return retval3;
-  if (!retval2.empty ()) return retval2;
-  return retval1;  // might be empty if no matches
+  if (isBroadcast)
+    {
+      NS_LOG_DEBUG ("Found bcast, localaddr " << endP->GetLocalAddress ());
+    }
+
+  if (isBroadcast && (endP->GetLocalAddress () != Ipv4Address::GetAny ()))
+    {
+      localAddressMatchesExact = (endP->GetLocalAddress () ==
+                                  incomingInterfaceAddr);
+    }
+  // if no match here, keep looking
+  return localAddressMatchesExact || localAddressMatchesWildCard;
 }
 
 Ipv4EndPoint *
@@ -315,35 +412,42 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  Connections::iterator c = m_connections.find (GetKey (dport, saddr, sport));
+  if (c != m_connections.end ())
+    {
+      for (OrderedEndPoints::iterator i = c->second.begin (); i != c->second.end (); i++) 
+        {
+          if (i->second->GetLocalAddress () == daddr) 
+            {
+              /* this is an exact match. */
+              return i->second;
+            }
+        }
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
+  std::map<uint16_t, OrderedEndPoints>::iterator p = m_ports.find (dport);
+  if (p == m_ports.end ())
+    {
+      return 0;
+    }
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (OrderedEndPoints::iterator i = p->second.begin (); i != p->second.end (); i++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
-      if ((*i)->GetLocalAddress () == daddr &&
-          (*i)->GetPeerPort () == sport &&
-          (*i)->GetPeerAddress () == saddr) 
-        {
-          /* this is an exact match. */
-          return *i;
-        }
       uint32_t tmp = 0;
-      if ((*i)->GetLocalAddress () == Ipv4Address::GetAny ()) 
+      if (i->second->GetLocalAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
-      if ((*i)->GetPeerAddress () == Ipv4Address::GetAny ()) 
+      if (i->second->GetPeerAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
       if (tmp < genericity) 
         {
-          generic = (*i);
+          generic = i->second;
           genericity = tmp;
         }
     }
@@ -373,4 +477,3 @@ Ipv4EndPointDemux::AllocateEphemeralPort (void)
 }
 
 } // namespace ns3
-
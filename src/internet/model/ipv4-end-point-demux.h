@@ -23,7 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <vector>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv4-interface.h"
 
 namespace ns3 {
@@ -38,6 +41,13 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * Endpoints are indexed by their peer (address, port) and local port in
+ * a hash table, and endpoints with a wildcard peer ("listeners") by
+ * their local port, so that Lookup does not depend on the number of
+ * connections of a node.  A bitmap of the local ports in use speeds up
+ * ephemeral port allocation.  Endpoints notify their demux when their
+ * peer changes so that the tables stay up to date.
  */
 
 class Ipv4EndPointDemux {
@@ -152,6 +162,92 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief End points ordered by allocation.
+   *
+   * The key is the allocation sequence number of the end point so
+   * that lookups return end points in the same order as a single
+   * list of all end points would.
+   */
+  typedef std::map<uint64_t, Ipv4EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief Hash function for the connection table keys.
+   */
+  class KeyHash : public std::unary_function<uint64_t, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a connection key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (uint64_t key) const;
+  };
+
+  /**
+   * \brief Container of end points indexed by local port and peer.
+   */
+  typedef sgi::hash_map<uint64_t, OrderedEndPoints, KeyHash> Connections;
+
+  /**
+   * \brief Build a connection table key.
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the key
+   */
+  static uint64_t GetKey (uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Register a new end point.
+   * \param endPoint the end point
+   */
+  void Register (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the lookup tables.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the lookup tables.
+   * \param endPoint the end point
+   * \param localPort local port the end point was indexed with
+   * \param peerAddress peer address the end point was indexed with
+   * \param peerPort peer port the end point was indexed with
+   */
+  void Remove (Ipv4EndPoint *endPoint, uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Re-index an end point whose local port or peer changed.
+   * \param endPoint the end point
+   * \param localPort previous local port
+   * \param peerAddress previous peer address
+   * \param peerPort previous peer port
+   */
+  void NotifyChanged (Ipv4EndPoint *endPoint, uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Match the local address of an end point against a packet.
+   * \param endP the end point
+   * \param daddr destination address of the packet
+   * \param isBroadcast true if daddr is a broadcast address
+   * \param incomingInterfaceAddr local address of the incoming interface, for broadcasts
+   * \param incomingInterface the incoming interface
+   * \param localAddressMatchesWildCard [out] true if the end point has a wildcard local address
+   * \param localAddressMatchesExact [out] true if the end point local address matches exactly
+   * \return false if the end point cannot receive the packet
+   */
+  bool MatchLocal (Ipv4EndPoint *endP, Ipv4Address daddr, bool isBroadcast,
+                   Ipv4Address incomingInterfaceAddr,
+                   Ptr<Ipv4Interface> incomingInterface,
+                   bool &localAddressMatchesWildCard,
+                   bool &localAddressMatchesExact);
+
 
   /**
    * \brief Allocate an ephemeral port.
@@ -175,9 +271,34 @@ private:
   uint16_t m_portFirst;
 
   /**
-   * \brief A list of IPv4 end points.
+   * \brief All the IPv4 end points.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The IPv4 end points, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_ports;
+
+  /**
+   * \brief The IPv4 end points with a wildcard peer, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_listeners;
+
+  /**
+   * \brief The IPv4 end points, by local port and peer.
+   */
+  Connections m_connections;
+
+  /**
+   * \brief One bit per local port, set if some end point uses it.
+   */
+  std::vector<bool> m_portsInUse;
+
+  /**
+   * \brief The sequence number of the next allocated end point.
    */
-  EndPoints m_endPoints;
+  uint64_t m_nextSequence;
 };
 
 } // namespace ns3
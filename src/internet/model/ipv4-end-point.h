@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \brief A representation of an internet endpoint/connection
@@ -229,6 +230,18 @@ private:
    * \brief The destroy callback.
    */
   Callback<void> m_destroyCallback;
+
+  friend class Ipv4EndPointDemux;
+
+  /**
+   * \brief The demux indexing this EndPoint (if any), notified of peer changes.
+   */
+  Ipv4EndPointDemux *m_demux;
+
+  /**
+   * \brief The allocation order of this EndPoint in its demux.
+   */
+  uint64_t m_sequence;
 };
 
 } // namespace ns3
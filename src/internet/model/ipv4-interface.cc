@@ -24,6 +24,7 @@
 #include "ipv4-l3-protocol.h"
 #include "arp-l3-protocol.h"
 #include "arp-cache.h"
+#include "traffic-control-layer.h"
 #include "ns3/net-device.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
@@ -272,16 +273,27 @@ Ipv4Interface::Send (Ptr<Packet> p, Ipv4Address dest)
       if (found)
         {
           NS_LOG_LOGIC ("Address Resolved.  Send.");
-          m_device->Send (p, hardwareDestination,
-                          Ipv4L3Protocol::PROT_NUMBER);
+          SendToDevice (p, hardwareDestination);
         }
     }
   else
     {
       NS_LOG_LOGIC ("Doesn't need ARP");
-      m_device->Send (p, m_device->GetBroadcast (), 
-                      Ipv4L3Protocol::PROT_NUMBER);
+      SendToDevice (p, m_device->GetBroadcast ());
+    }
+}
+
+void
+Ipv4Interface::SendToDevice (Ptr<Packet> p, const Address &dest)
+{
+  NS_LOG_FUNCTION (this << p << dest);
+  Ptr<TrafficControlLayer> tc = m_node->GetObject<TrafficControlLayer> ();
+  if (tc != 0)
+    {
+      tc->Send (m_device, Create<QueueDiscItem> (p, dest, Ipv4L3Protocol::PROT_NUMBER));
+      return;
     }
+  m_device->Send (p, dest, Ipv4L3Protocol::PROT_NUMBER);
 }
 
 uint32_t
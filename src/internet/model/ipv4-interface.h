@@ -186,6 +186,13 @@ private:
    */
   void DoSetup (void);
 
+  /**
+   * \brief Send a packet to the device, through the traffic control layer
+   * of the node if it has one.
+   * \param p the packet, starting with its IPv4 header
+   * \param dest the destination hardware address
+   */
+  void SendToDevice (Ptr<Packet> p, const Address &dest);
 
   /**
    * \brief Container for the Ipv4InterfaceAddresses.
@@ -32,6 +32,8 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/segment-offload-tag.h"
+#include "ns3/ecn-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -39,6 +41,8 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-header.h"
+#include "tcp-l4-protocol.h"
 
 namespace ns3 {
 
@@ -235,21 +239,9 @@ Ipv4L3Protocol::DoDispose (void)
   m_node = 0;
   m_routingProtocol = 0;
 
-  for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      it->second = 0;
-    }
-
-  for (MapFragmentsTimers_t::iterator it = m_fragmentsTimers.begin (); it != m_fragmentsTimers.end (); it++)
-    {
-      if (it->second.IsRunning ())
-        {
-          it->second.Cancel ();
-        }
-    }
-
   m_fragments.clear ();
-  m_fragmentsTimers.clear ();
+  m_fragmentsTimeouts.clear ();
+  m_fragmentsTimeoutEvent.Cancel ();
 
   Object::DoDispose ();
 }
@@ -524,6 +516,13 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
       return;
     }
 
+  EcnTag ecnTag;
+  if (packet->RemovePacketTag (ecnTag) && ecnTag.IsCongestionExperienced ()
+      && ipHeader.GetEcn () != Ipv4Header::ECN_NotECT)
+    { // A queue on the previous hop signalled congestion, see SendRealOut ()
+      ipHeader.SetEcn (Ipv4Header::ECN_CE);
+    }
+
   for (SocketList::iterator i = m_sockets.begin (); i != m_sockets.end (); ++i)
     {
       NS_LOG_LOGIC ("Forwarding to raw socket"); 
@@ -695,6 +694,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
     {
       NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 3:  passed in with route");
       ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+      ReserveSegmentIdentifications (packet, ipHeader);
       int32_t interface = GetInterfaceForDevice (route->GetOutputDevice ());
       m_sendOutgoingTrace (ipHeader, packet, interface);
       SendRealOut (route, packet->Copy (), ipHeader);
@@ -714,6 +714,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
   Socket::SocketErrno errno_; 
   Ptr<NetDevice> oif (0); // unused for now
   ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+  ReserveSegmentIdentifications (packet, ipHeader);
   Ptr<Ipv4Route> newRoute;
   if (m_routingProtocol != 0)
     {
@@ -762,12 +763,13 @@ Ipv4L3Protocol::BuildHeader (
   uint64_t dst = destination.Get ();
   uint64_t srcDst = dst | (src << 32);
   std::pair<uint64_t, uint8_t> key = std::make_pair (srcDst, protocol);
+  uint16_t &identification = m_identification[key];
 
   if (mayFragment == true)
     {
       ipHeader.SetMayFragment ();
-      ipHeader.SetIdentification (m_identification[key]);
-      m_identification[key]++;
+      ipHeader.SetIdentification (identification);
+      identification++;
     }
   else
     {
@@ -776,8 +778,8 @@ Ipv4L3Protocol::BuildHeader (
       // identification requirement:
       // >> Originating sources MAY set the IPv4 ID field of atomic datagrams
       //    to any value.
-      ipHeader.SetIdentification (m_identification[key]);
-      m_identification[key]++;
+      ipHeader.SetIdentification (identification);
+      identification++;
     }
   if (Node::ChecksumEnabled ())
     {
@@ -786,6 +788,23 @@ Ipv4L3Protocol::BuildHeader (
   return ipHeader;
 }
 
+void
+Ipv4L3Protocol::ReserveSegmentIdentifications (Ptr<const Packet> packet, Ipv4Header const &ipHeader)
+{
+  NS_LOG_FUNCTION (this << packet << ipHeader);
+  SegmentOffloadTag offloadTag;
+  if (!packet->PeekPacketTag (offloadTag) || offloadTag.GetSegmentCount () < 2)
+    {
+      return;
+    }
+  // BuildHeader has already taken the identification of the first segment
+  uint64_t src = ipHeader.GetSource ().Get ();
+  uint64_t dst = ipHeader.GetDestination ().Get ();
+  uint64_t srcDst = dst | (src << 32);
+  std::pair<uint64_t, uint8_t> key = std::make_pair (srcDst, ipHeader.GetProtocol ());
+  m_identification[key] += offloadTag.GetSegmentCount () - 1;
+}
+
 void
 Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
                              Ptr<Packet> packet,
@@ -798,6 +817,30 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, m_node->GetObject<Ipv4> (), 0);
       return;
     }
+  SegmentOffloadTag offloadTag;
+  if (packet->PeekPacketTag (offloadTag)
+      && packet->GetSize () + ipHeader.GetSerializedSize () > route->GetOutputDevice ()->GetMtu ()
+      && !IsSegmentOffloadEnabled (route->GetOutputDevice ()))
+    { // The device cannot carry the super-segment whole, split it into segments
+      if (ipHeader.GetProtocol () == TcpL4Protocol::PROT_NUMBER)
+        {
+          std::list<std::pair<Ptr<Packet>, Ipv4Header> > listSegments;
+          DoSegmentation (packet, ipHeader, offloadTag, listSegments);
+          for (std::list<std::pair<Ptr<Packet>, Ipv4Header> >::iterator it = listSegments.begin (); it != listSegments.end (); it++)
+            {
+              SendRealOut (route, it->first, it->second);
+            }
+          return;
+        }
+      packet->RemovePacketTag (offloadTag); // Unknown protocol, fragment it
+    }
+  EcnTag ecnTag;
+  packet->RemovePacketTag (ecnTag);
+  if (ipHeader.GetEcn () != Ipv4Header::ECN_NotECT)
+    { // Expose the ECN field to the queues of the output device
+      ecnTag.SetEcn (ipHeader.GetEcn ());
+      packet->AddPacketTag (ecnTag);
+    }
   packet->AddHeader (ipHeader);
   Ptr<NetDevice> outDev = route->GetOutputDevice ();
   int32_t interface = GetInterfaceForDevice (outDev);
@@ -810,7 +853,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () && !packet->PeekPacketTag (offloadTag) )
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -839,7 +882,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () && !packet->PeekPacketTag (offloadTag) )
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -866,6 +909,65 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
     }
 }
 
+void
+Ipv4L3Protocol::DoSegmentation (Ptr<Packet> packet, Ipv4Header const &ipHeader, SegmentOffloadTag const &offloadTag,
+                                std::list<std::pair<Ptr<Packet>, Ipv4Header> >& listSegments)
+{
+  NS_LOG_FUNCTION (this << packet << ipHeader << offloadTag.GetSegmentCount ());
+
+  SegmentOffloadTag tag;
+  packet->RemovePacketTag (tag);
+  TcpHeader tcpHeader;
+  packet->RemoveHeader (tcpHeader);
+  uint32_t payloadSize = packet->GetSize ();
+  uint32_t segmentSize = offloadTag.GetSegmentSize ();
+  uint16_t identification = ipHeader.GetIdentification ();
+
+  for (uint32_t offset = 0; offset < payloadSize; offset += segmentSize)
+    {
+      uint32_t length = std::min (segmentSize, payloadSize - offset);
+      Ptr<Packet> segment = packet->CreateFragment (offset, length);
+
+      TcpHeader segmentTcpHeader = tcpHeader;
+      segmentTcpHeader.SetSequenceNumber (tcpHeader.GetSequenceNumber () + SequenceNumber32 (offset));
+      if (offset + length < payloadSize)
+        {
+          segmentTcpHeader.SetFlags (tcpHeader.GetFlags () & ~(TcpHeader::FIN | TcpHeader::PSH));
+        }
+      if (Node::ChecksumEnabled ())
+        {
+          segmentTcpHeader.EnableChecksums ();
+          segmentTcpHeader.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (),
+                                               TcpL4Protocol::PROT_NUMBER);
+        }
+      segment->AddHeader (segmentTcpHeader);
+
+      Ipv4Header segmentIpHeader = ipHeader;
+      segmentIpHeader.SetPayloadSize (segment->GetSize ());
+      // the identifications of the segments were reserved when the header
+      // of the super-segment was built, so that the ones of the following
+      // datagrams do not collide with them wherever the super-segment is split
+      segmentIpHeader.SetIdentification (identification++);
+      listSegments.push_back (std::make_pair (segment, segmentIpHeader));
+    }
+  NS_LOG_LOGIC ("Split " << payloadSize << " bytes into " << listSegments.size () << " segments");
+}
+
+bool
+Ipv4L3Protocol::IsSegmentOffloadEnabled (Ptr<NetDevice> device)
+{
+  // Devices supporting segmentation offload advertise it with a boolean
+  // "SegmentOffload" attribute
+  struct TypeId::AttributeInformation info;
+  if (!device->GetInstanceTypeId ().LookupAttributeByName ("SegmentOffload", &info))
+    {
+      return false;
+    }
+  BooleanValue enabled;
+  device->GetAttribute ("SegmentOffload", enabled);
+  return enabled.Get ();
+}
+
 // This function analogous to Linux ip_mr_forward()
 void
 Ipv4L3Protocol::IpMulticastForward (Ptr<Ipv4MulticastRoute> mrtentry, Ptr<const Packet> p, const Ipv4Header &header)
@@ -1349,28 +1451,45 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 
   uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 | uint64_t (ipHeader.GetDestination ().Get ());
   uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 | uint32_t (ipHeader.GetProtocol ());
-  std::pair<uint64_t, uint32_t> key;
+  FragmentsKey_t key;
   bool ret = false;
   Ptr<Packet> p = packet->Copy ();
 
   key.first = addressCombination;
   key.second = idProto;
 
-  Ptr<Fragments> fragments;
-
   MapFragments_t::iterator it = m_fragments.find (key);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
-      m_fragments.insert (std::make_pair (key, fragments));
-      m_fragmentsTimers[key] = Simulator::Schedule (m_fragmentExpirationTimeout,
-                                                    &Ipv4L3Protocol::HandleFragmentsTimeout, this,
-                                                    key, ipHeader, iif);
-    }
-  else
-    {
-      fragments = it->second;
+      FragmentsTimeout timeout;
+      timeout.expiration = Simulator::Now () + m_fragmentExpirationTimeout;
+      timeout.key = key;
+      timeout.ipHeader = ipHeader;
+      timeout.iif = iif;
+
+      // Keep the list sorted, should the timeout have been changed
+      FragmentsTimeoutList_t::iterator pos = m_fragmentsTimeouts.end ();
+      while (pos != m_fragmentsTimeouts.begin ())
+        {
+          FragmentsTimeoutList_t::iterator prev = pos;
+          prev--;
+          if (prev->expiration <= timeout.expiration)
+            {
+              break;
+            }
+          pos = prev;
+        }
+      pos = m_fragmentsTimeouts.insert (pos, timeout);
+      if (pos == m_fragmentsTimeouts.begin ())
+        {
+          m_fragmentsTimeoutEvent.Cancel ();
+          m_fragmentsTimeoutEvent = Simulator::Schedule (m_fragmentExpirationTimeout,
+                                                         &Ipv4L3Protocol::ExpireFragments, this);
+        }
+
+      it = m_fragments.insert (std::make_pair (key, FragmentsEntry_t (Create<Fragments> (), pos))).first;
     }
+  Ptr<Fragments> fragments = it->second.first;
 
   NS_LOG_LOGIC ("Adding fragment - Size: " << packet->GetSize ( ) << " - Offset: " << (ipHeader.GetFragmentOffset ()) );
 
@@ -1379,14 +1498,9 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   if ( fragments->IsEntire () )
     {
       packet = fragments->GetPacket ();
-      fragments = 0;
-      m_fragments.erase (key);
-      if (m_fragmentsTimers[key].IsRunning ())
-        {
-          NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
-          m_fragmentsTimers[key].Cancel ();
-        }
-      m_fragmentsTimers.erase (key);
+      // The expiration event is left running, see m_fragmentsTimeouts
+      m_fragmentsTimeouts.erase (it->second.second);
+      m_fragments.erase (it);
       ret = true;
     }
 
@@ -1394,7 +1508,9 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 }
 
 Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+  : m_moreFragment (0),
+    m_contiguousEnd (0),
+    m_firstGap (m_fragments.end ())
 {
   NS_LOG_FUNCTION (this);
 }
@@ -1409,14 +1525,17 @@ Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentO
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
-
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
+  // Insert after the fragments with a lower or equal offset
+  FragmentsList_t::iterator it = m_fragments.end ();
+  while (it != m_fragments.begin ())
     {
-      if (it->second > fragmentOffset)
+      FragmentsList_t::iterator prev = it;
+      prev--;
+      if (prev->second <= fragmentOffset)
         {
           break;
         }
+      it = prev;
     }
 
   if (it == m_fragments.end ())
@@ -1424,7 +1543,26 @@ Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentO
       m_moreFragment = moreFragment;
     }
 
-  m_fragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  FragmentsList_t::iterator inserted = m_fragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+
+  if (fragmentOffset > m_contiguousEnd)
+    {
+      // There is a gap before the new fragment
+      if (m_firstGap == m_fragments.end () || fragmentOffset < m_firstGap->second)
+        {
+          m_firstGap = inserted;
+        }
+      return;
+    }
+
+  // Overlapping fragments do exist: extend the contiguous data as far as
+  // the fragments after the gap allow
+  m_contiguousEnd = std::max (m_contiguousEnd, fragmentOffset + fragment->GetSize ());
+  while (m_firstGap != m_fragments.end () && m_firstGap->second <= m_contiguousEnd)
+    {
+      m_contiguousEnd = std::max (m_contiguousEnd, m_firstGap->second + m_firstGap->first->GetSize ());
+      m_firstGap++;
+    }
 }
 
 bool
@@ -1432,29 +1570,7 @@ Ipv4L3Protocol::Fragments::IsEntire () const
 {
   NS_LOG_FUNCTION (this);
 
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          // overlapping fragments do exist
-          NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
-
-          if (lastEndOffset < it->second)
-            {
-              ret = false;
-              break;
-            }
-          // fragments might overlap in strange ways
-          uint16_t fragmentEnd = it->first->GetSize () + it->second;
-          lastEndOffset = std::max ( lastEndOffset, fragmentEnd );
-        }
-    }
-
-  return ret;
+  return !m_moreFragment && m_fragments.size () > 0 && m_firstGap == m_fragments.end ();
 }
 
 Ptr<Packet>
@@ -1531,12 +1647,12 @@ Ipv4L3Protocol::Fragments::GetPartialPacket () const
 }
 
 void
-Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif)
+Ipv4L3Protocol::HandleFragmentsTimeout (FragmentsKey_t key, Ipv4Header & ipHeader, uint32_t iif)
 {
   NS_LOG_FUNCTION (this << &key << &ipHeader << iif);
 
   MapFragments_t::iterator it = m_fragments.find (key);
-  Ptr<Packet> packet = it->second->GetPartialPacket ();
+  Ptr<Packet> packet = it->second.first->GetPartialPacket ();
 
   // if we have at least 8 bytes, we can send an ICMP.
   if ( packet->GetSize () > 8 )
@@ -1547,9 +1663,41 @@ Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4H
   m_dropTrace (ipHeader, packet, DROP_FRAGMENT_TIMEOUT, m_node->GetObject<Ipv4> (), iif);
 
   // clear the buffers
-  it->second = 0;
+  m_fragments.erase (it);
+}
 
-  m_fragments.erase (key);
-  m_fragmentsTimers.erase (key);
+void
+Ipv4L3Protocol::ExpireFragments (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  while (!m_fragmentsTimeouts.empty () && m_fragmentsTimeouts.front ().expiration <= Simulator::Now ())
+    {
+      FragmentsTimeout timeout = m_fragmentsTimeouts.front ();
+      m_fragmentsTimeouts.pop_front ();
+      HandleFragmentsTimeout (timeout.key, timeout.ipHeader, timeout.iif);
+    }
+  if (!m_fragmentsTimeouts.empty ())
+    {
+      m_fragmentsTimeoutEvent = Simulator::Schedule (m_fragmentsTimeouts.front ().expiration - Simulator::Now (),
+                                                     &Ipv4L3Protocol::ExpireFragments, this);
+    }
+}
+
+size_t
+Ipv4L3Protocol::IdentificationKeyHash::operator() (std::pair<uint64_t, uint8_t> const &key) const
+{
+  uint64_t h = (key.first ^ (key.first >> 29)) * 0x9e3779b97f4a7c15ULL + key.second;
+  h *= 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+size_t
+Ipv4L3Protocol::FragmentsKeyHash::operator() (FragmentsKey_t const &key) const
+{
+  uint64_t h = (key.first ^ (key.first >> 29)) * 0x9e3779b97f4a7c15ULL + key.second;
+  h *= 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (h ^ (h >> 32));
 }
+
 } // namespace ns3
@@ -34,6 +34,8 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/event-id.h"
+#include "ns3/sgi-hashmap.h"
 
 class Ipv4L3ProtocolTestCase;
 
@@ -51,6 +53,7 @@ class Socket;
 class Ipv4RawSocketImpl;
 class IpL4Protocol;
 class Icmpv4L4Protocol;
+class SegmentOffloadTag;
 
 
 /**
@@ -408,6 +411,41 @@ private:
    */
   void DoFragmentation (Ptr<Packet> packet, uint32_t outIfaceMtu, std::list<Ptr<Packet> >& listFragments);
 
+  /**
+   * \brief Reserve the IPv4 identifications of the segments of a super-segment
+   *
+   * The identifications following the one of the super-segment header are
+   * reserved for its other segments, which take consecutive ones when the
+   * super-segment is split.
+   *
+   * \param packet the packet, without IPv4 header
+   * \param ipHeader the IPv4 header just built for the packet
+   */
+  void ReserveSegmentIdentifications (Ptr<const Packet> packet, Ipv4Header const &ipHeader);
+
+  /**
+   * \brief Split a TCP super-segment into segments
+   *
+   * Each segment gets a copy of the TCP header, with its own sequence
+   * number, and an IPv4 header with its own payload size and identification,
+   * counting from the one of the super-segment.  FIN and PSH are only kept
+   * on the last segment.
+   *
+   * \param packet the super-segment, without IPv4 header
+   * \param ipHeader the IPv4 header of the super-segment
+   * \param offloadTag the tag describing the segments
+   * \param listSegments the list of segments and of their IPv4 headers
+   */
+  void DoSegmentation (Ptr<Packet> packet, Ipv4Header const &ipHeader, SegmentOffloadTag const &offloadTag,
+                       std::list<std::pair<Ptr<Packet>, Ipv4Header> >& listSegments);
+
+  /**
+   * \brief Check whether a device transmits super-segments whole
+   * \param device the device
+   * \returns true if the device has a "SegmentOffload" attribute set to true
+   */
+  static bool IsSegmentOffloadEnabled (Ptr<NetDevice> device);
+
   /**
    * \brief Process a packet fragment
    * \param packet the packet
@@ -417,13 +455,24 @@ private:
    */
   bool ProcessFragment (Ptr<Packet>& packet, Ipv4Header & ipHeader, uint32_t iif);
 
+  /**
+   * \brief Key of the packets being reassembled: (src+dst addr, id+proto)
+   */
+  typedef std::pair<uint64_t, uint32_t> FragmentsKey_t;
+
   /**
    * \brief Process the timeout for packet fragments
    * \param key representing the packet fragments
    * \param ipHeader the IP header of the original packet
    * \param iif Input Interface
    */
-  void HandleFragmentsTimeout ( std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif);
+  void HandleFragmentsTimeout (FragmentsKey_t key, Ipv4Header & ipHeader, uint32_t iif);
+
+  /**
+   * \brief Process the expired entries of the reassembly timeout list
+   * and schedule the next expiration.
+   */
+  void ExpireFragments (void);
   
   /**
    * \brief Container of the IPv4 Interfaces.
@@ -444,7 +493,24 @@ private:
   Ipv4InterfaceList m_interfaces; //!< List of IPv4 interfaces.
   uint8_t m_defaultTos;  //!< Default TOS
   uint8_t m_defaultTtl;  //!< Default TTL
-  std::map<std::pair<uint64_t, uint8_t>, uint16_t> m_identification; //!< Identification (for each {src, dst, proto} tuple)
+  /**
+   * \brief Hash function for the identification table keys.
+   */
+  class IdentificationKeyHash : public std::unary_function<std::pair<uint64_t, uint8_t>, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of an identification key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (std::pair<uint64_t, uint8_t> const &key) const;
+  };
+
+  /// Container of the next identification for each {src, dst, proto} tuple
+  typedef sgi::hash_map<std::pair<uint64_t, uint8_t>, uint16_t, IdentificationKeyHash> MapIdentification_t;
+
+  MapIdentification_t m_identification; //!< Identification (for each {src, dst, proto} tuple)
   Ptr<Node> m_node; //!< Node attached to stack.
 
   /// Trace of sent packets
@@ -470,6 +536,12 @@ private:
   /**
    * \class Fragments
    * \brief A Set of Fragment belonging to the same packet (src, dst, identification and proto)
+   *
+   * The fragments are kept sorted by offset.  Since they usually arrive
+   * in order, the insertion point is searched from the end of the list.
+   * The end of the data received contiguously from offset 0 is updated
+   * upon each insertion, so that checking whether the packet is entire
+   * does not walk the fragments.
    */
   class Fragments : public SimpleRefCount<Fragments>
   {
@@ -511,6 +583,9 @@ public:
     Ptr<Packet> GetPartialPacket () const;
 
 private:
+    /// Container of the fragments and their offsets, sorted by offset
+    typedef std::list<std::pair<Ptr<Packet>, uint16_t> > FragmentsList_t;
+
     /**
      * \brief True if other fragments will be sent.
      */
@@ -519,18 +594,66 @@ private:
     /**
      * \brief The current fragments.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    FragmentsList_t m_fragments;
+
+    /**
+     * \brief End of the data received contiguously from offset 0.
+     */
+    uint32_t m_contiguousEnd;
+
+    /**
+     * \brief First fragment not contiguous with the data from offset 0.
+     */
+    FragmentsList_t::iterator m_firstGap;
 
   };
 
-  /// Container of fragments, stored as pairs(src+dst addr, src+dst port) / fragment
-  typedef std::map< std::pair<uint64_t, uint32_t>, Ptr<Fragments> > MapFragments_t;
-  /// Container of fragment timeout event, stored as pairs(src+dst addr, src+dst port) / EventId
-  typedef std::map< std::pair<uint64_t, uint32_t>, EventId > MapFragmentsTimers_t;
+  /**
+   * \brief Hash function for the keys of the packets being reassembled.
+   */
+  class FragmentsKeyHash : public std::unary_function<FragmentsKey_t, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a reassembly key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (FragmentsKey_t const &key) const;
+  };
+
+  /**
+   * \brief Reassembly timeout of a packet
+   */
+  struct FragmentsTimeout
+  {
+    Time expiration;       //!< Time of the expiration
+    FragmentsKey_t key;    //!< Packet being reassembled
+    Ipv4Header ipHeader;   //!< IP header of the first fragment received
+    uint32_t iif;          //!< Input interface of the first fragment received
+  };
 
-  MapFragments_t       m_fragments; //!< Fragmented packets.
-  Time                 m_fragmentExpirationTimeout; //!< Expiration timeout
-  MapFragmentsTimers_t m_fragmentsTimers; //!< Expiration events.
+  /// Reassembly timeouts, sorted by expiration time
+  typedef std::list<FragmentsTimeout> FragmentsTimeoutList_t;
+
+  /// Fragments of a packet and their entry in the timeout list
+  typedef std::pair<Ptr<Fragments>, FragmentsTimeoutList_t::iterator> FragmentsEntry_t;
+
+  /// Container of fragments, stored as pairs(src+dst addr, id+proto) / fragment
+  typedef sgi::hash_map<FragmentsKey_t, FragmentsEntry_t, FragmentsKeyHash> MapFragments_t;
+
+  MapFragments_t         m_fragments; //!< Fragmented packets.
+  Time                   m_fragmentExpirationTimeout; //!< Expiration timeout
+  /**
+   * \brief Reassembly timeouts of the packets in m_fragments.
+   *
+   * The timeout is the same for every packet, so that new entries are
+   * usually appended.  A single event, m_fragmentsTimeoutEvent, is
+   * scheduled for the earliest expiration.  It is not cancelled when that
+   * packet completes: ExpireFragments then only reschedules itself.
+   */
+  FragmentsTimeoutList_t m_fragmentsTimeouts;
+  EventId                m_fragmentsTimeoutEvent; //!< Expiration of the first entry of m_fragmentsTimeouts
 
 };
 
@@ -54,7 +54,8 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_nonPrefixRoutes (0),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -72,7 +73,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         nextHop,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddNetworkRoute (route, metric);
 }
 
 void 
@@ -86,7 +87,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddNetworkRoute (route, metric);
 }
 
 void 
@@ -143,7 +144,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  AddNetworkRoute (route, 0);
 }
 
 uint32_t 
@@ -240,52 +241,91 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  Ipv4RoutingTableEntry *route = 0;
+  if (m_nonPrefixRoutes == 0)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      uint8_t buf[4];
+      dest.Serialize (buf);
+      std::vector<NetworkRoutesIndex::Values const *> matches;
+      m_networkRoutesIndex.Match (buf, 32, matches);
+      // Longest prefix first; within a prefix, the lowest metric wins and
+      // equal metrics go to the route added last, as in the scan below.
+      for (std::vector<NetworkRoutesIndex::Values const *>::reverse_iterator i = matches.rbegin ();
+           i != matches.rend () && route == 0;
+           i++)
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
-          if (oif != 0)
+          for (NetworkRoutesIndex::Values::const_iterator j = (*i)->begin ();
+               j != (*i)->end ();
+               j++)
             {
-              if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+              NS_LOG_LOGIC ("Found global network route " << j->first << ", mask length " << j->first->GetDestNetworkMask ().GetPrefixLength () << ", metric " << j->second);
+              if (oif != 0 && oif != m_ipv4->GetNetDevice (j->first->GetInterface ()))
                 {
                   NS_LOG_LOGIC ("Not on requested interface, skipping");
                   continue;
                 }
+              if (j->second > shortest_metric)
+                {
+                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                  continue;
+                }
+              shortest_metric = j->second;
+              route = j->first;
             }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
-          if (metric > shortest_metric)
+        }
+    }
+  else
+    {
+      for (NetworkRoutesI i = m_networkRoutes.begin (); 
+           i != m_networkRoutes.end (); 
+           i++) 
+        {
+          Ipv4RoutingTableEntry *j=i->first;
+          uint32_t metric =i->second;
+          Ipv4Mask mask = (j)->GetDestNetworkMask ();
+          uint16_t masklen = mask.GetPrefixLength ();
+          Ipv4Address entry = (j)->GetDestNetwork ();
+          NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
+          if (mask.IsMatch (dest, entry)) 
             {
-              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-              continue;
+              NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
+              if (oif != 0)
+                {
+                  if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+                    {
+                      NS_LOG_LOGIC ("Not on requested interface, skipping");
+                      continue;
+                    }
+                }
+              if (masklen < longest_mask) // Not interested if got shorter mask
+                {
+                  NS_LOG_LOGIC ("Previous match longer, skipping");
+                  continue;
+                }
+              if (masklen > longest_mask) // Reset metric if longer masklen
+                {
+                  shortest_metric = 0xffffffff;
+                }
+              longest_mask = masklen;
+              if (metric > shortest_metric)
+                {
+                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                  continue;
+                }
+              shortest_metric = metric;
+              route = j;
             }
-          shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
         }
     }
+  if (route != 0)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
@@ -361,27 +401,24 @@ Ipv4StaticRouting::GetDefaultRoute ()
 {
   NS_LOG_FUNCTION (this);
   // Basically a repeat of LookupStatic, retained for backward compatibility
-  Ipv4Address dest ("0.0.0.0");
+  uint8_t buf[4] = { 0 };
   uint32_t shortest_metric = 0xffffffff;
   Ipv4RoutingTableEntry *result = 0;
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  // Default routes have an all-zero mask, which is always indexed.
+  NetworkRoutesIndex::Values const *routes = m_networkRoutesIndex.Find (buf, 0);
+  if (routes != 0)
     {
-      Ipv4RoutingTableEntry *j = i->first;
-      uint32_t metric = i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      if (masklen != 0)
-        {
-          continue;
-        }
-      if (metric > shortest_metric)
+      for (NetworkRoutesIndex::Values::const_iterator i = routes->begin (); 
+           i != routes->end (); 
+           i++) 
         {
-          continue;
+          if (i->second > shortest_metric)
+            {
+              continue;
+            }
+          shortest_metric = i->second;
+          result = i->first;
         }
-      shortest_metric = metric;
-      result = j;
     }
   if (result)
     {
@@ -443,8 +480,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete j->first;
-          m_networkRoutes.erase (j);
+          RemoveNetworkRoute (j);
           return;
         }
       tmp++;
@@ -593,6 +629,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkRoutesIndex.Clear ();
+  m_nonPrefixRoutes = 0;
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -631,8 +669,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = RemoveNetworkRoute (it);
         }
       else
         {
@@ -678,8 +715,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = RemoveNetworkRoute (it);
         }
       else
         {
@@ -752,6 +788,37 @@ Ipv4StaticRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
         }
     }
 }
+void
+Ipv4StaticRouting::AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  m_networkRoutes.push_back (make_pair (route, metric));
+  uint32_t inverted = ~route->GetDestNetworkMask ().Get ();
+  if ((inverted & (inverted + 1)) != 0)
+    {
+      NS_LOG_LOGIC ("Mask " << route->GetDestNetworkMask () << " is not a prefix, route not indexed");
+      m_nonPrefixRoutes++;
+      return;
+    }
+  uint8_t buf[4];
+  route->GetDestNetwork ().Serialize (buf);
+  m_networkRoutesIndex.Insert (buf, route->GetDestNetworkMask ().GetPrefixLength (), m_networkRoutes.back ());
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::RemoveNetworkRoute (NetworkRoutesI it)
+{
+  NS_LOG_FUNCTION (this << it->first);
+  uint8_t buf[4];
+  it->first->GetDestNetwork ().Serialize (buf);
+  if (!m_networkRoutesIndex.Remove (buf, it->first->GetDestNetworkMask ().GetPrefixLength (), *it))
+    {
+      m_nonPrefixRoutes--;
+    }
+  delete it->first;
+  return m_networkRoutes.erase (it);
+}
+
 Ipv4Address
 Ipv4StaticRouting::SourceAddressSelection (uint32_t interfaceIdx, Ipv4Address dest)
 {
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -390,6 +391,9 @@ private:
   /// Iterator for container for the network routes
   typedef std::list<std::pair <Ipv4RoutingTableEntry *, uint32_t> >::iterator NetworkRoutesI;
 
+  /// Longest prefix match index of the network routes
+  typedef PrefixTrie<std::pair <Ipv4RoutingTableEntry *, uint32_t> > NetworkRoutesIndex;
+
   /// Container for the multicast routes
   typedef std::list<Ipv4MulticastRoutingTableEntry *> MulticastRoutes;
 
@@ -425,11 +429,38 @@ private:
    */
   Ipv4Address SourceAddressSelection (uint32_t interface, Ipv4Address dest);
 
+  /**
+   * \brief Append a route to the network routes and index it.
+   * \param route the route
+   * \param metric metric of the route
+   */
+  void AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Delete a network route and remove it from the index.
+   * \param it the route
+   * \return the route following the removed one
+   */
+  NetworkRoutesI RemoveNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes indexed by destination prefix.
+   *
+   * Routes whose mask is not a contiguous prefix cannot be indexed;
+   * while any of them exist, lookups scan m_networkRoutes instead.
+   */
+  NetworkRoutesIndex m_networkRoutesIndex;
+
+  /**
+   * \brief number of network routes missing from m_networkRoutesIndex.
+   */
+  uint32_t m_nonPrefixRoutes;
+
   /**
    * \brief the forwarding table for multicast.
    */
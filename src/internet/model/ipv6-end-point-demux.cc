@@ -26,10 +26,24 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 
+bool Ipv6EndPointDemux::Key::operator== (const Key &other) const
+{
+  return localPort == other.localPort && peerPort == other.peerPort
+         && peerAddress == other.peerAddress;
+}
+
+size_t Ipv6EndPointDemux::KeyHash::operator() (const Key &key) const
+{
+  Ipv6AddressHash hash;
+  return hash (key.peerAddress) ^ ((static_cast<size_t> (key.localPort) << 16 | key.peerPort) * 2654435761u);
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_portsInUse (65536, false),
+    m_nextSequence (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -37,34 +51,109 @@ Ipv6EndPointDemux::Ipv6EndPointDemux ()
 Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPoints::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv6EndPoint *endPoint = *i;
+      Ipv6EndPoint *endPoint = i->second;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_ports.clear ();
+  m_listeners.clear ();
+  m_connections.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv6EndPointDemux::Key Ipv6EndPointDemux::GetKey (uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Key key;
+  key.peerAddress = peerAddress;
+  key.localPort = localPort;
+  key.peerPort = peerPort;
+  return key;
+}
+
+void Ipv6EndPointDemux::Register (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  endPoint->m_sequence = m_nextSequence++;
+  m_endPoints[endPoint->m_sequence] = endPoint;
+  Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+}
+
+void Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t localPort = endPoint->GetLocalPort ();
+  Ipv6Address peerAddress = endPoint->GetPeerAddress ();
+  uint16_t peerPort = endPoint->GetPeerPort ();
+
+  m_ports[localPort][endPoint->m_sequence] = endPoint;
+  m_portsInUse[localPort] = true;
+  m_connections[GetKey (localPort, peerAddress, peerPort)][endPoint->m_sequence] = endPoint;
+  if (peerPort == 0 && peerAddress == Ipv6Address::GetAny ())
     {
-      if ((*i)->GetLocalPort  () == port)
+      m_listeners[localPort][endPoint->m_sequence] = endPoint;
+    }
+}
+
+void Ipv6EndPointDemux::Remove (Ipv6EndPoint *endPoint, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort)
+{
+  NS_LOG_FUNCTION (this << endPoint << localPort << peerAddress << peerPort);
+  std::map<uint16_t, OrderedEndPoints>::iterator p = m_ports.find (localPort);
+  NS_ASSERT (p != m_ports.end ());
+  p->second.erase (endPoint->m_sequence);
+  if (p->second.empty ())
+    {
+      m_ports.erase (p);
+      m_portsInUse[localPort] = false;
+    }
+
+  Connections::iterator c = m_connections.find (GetKey (localPort, peerAddress, peerPort));
+  NS_ASSERT (c != m_connections.end ());
+  c->second.erase (endPoint->m_sequence);
+  if (c->second.empty ())
+    {
+      m_connections.erase (c);
+    }
+
+  if (peerPort == 0 && peerAddress == Ipv6Address::GetAny ())
+    {
+      std::map<uint16_t, OrderedEndPoints>::iterator l = m_listeners.find (localPort);
+      NS_ASSERT (l != m_listeners.end ());
+      l->second.erase (endPoint->m_sequence);
+      if (l->second.empty ())
         {
-          return true;
+          m_listeners.erase (l);
         }
     }
-  return false;
+}
+
+void Ipv6EndPointDemux::NotifyChanged (Ipv6EndPoint *endPoint, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort)
+{
+  NS_LOG_FUNCTION (this << endPoint << localPort << peerAddress << peerPort);
+  Remove (endPoint, localPort, peerAddress, peerPort);
+  Insert (endPoint);
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_portsInUse[port];
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::map<uint16_t, OrderedEndPoints>::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
+    {
+      return false;
+    }
+  for (OrderedEndPoints::iterator i = p->second.begin (); i != p->second.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
+      if (i->second->GetLocalAddress () == addr)
         {
           return true;
         }
@@ -82,8 +171,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Register (endPoint);
   return endPoint;
 }
 
@@ -97,14 +185,13 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Register (endPoint);
   return endPoint;
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (uint16_t port)
 {
-  NS_LOG_FUNCTION (this <<  port);
+  NS_LOG_FUNCTION (this << port);
 
   return Allocate (Ipv6Address::GetAny (), port);
 }
@@ -118,8 +205,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Register (endPoint);
   return endPoint;
 }
 
@@ -127,45 +213,77 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Connections::iterator c = m_connections.find (GetKey (localPort, peerAddress, peerPort));
+  if (c != m_connections.end ())
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
+      for (OrderedEndPoints::iterator i = c->second.begin (); i != c->second.end (); i++)
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          if (i->second->GetLocalAddress () == localAddress)
+            {
+              NS_LOG_WARN ("No way we can allocate this end-point.");
+              /* no way we can allocate this end-point. */
+              return 0;
+            }
         }
     }
+
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
+  Register (endPoint);
   return endPoint;
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
+      return;
+    }
+  OrderedEndPoints::iterator i = m_endPoints.find (endPoint->m_sequence);
+  if (i == m_endPoints.end () || i->second != endPoint)
+    {
+      return;
+    }
+  Remove (endPoint, endPoint->GetLocalPort (), endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  m_endPoints.erase (i);
+  endPoint->m_demux = 0;
+  delete endPoint;
+}
+
+bool Ipv6EndPointDemux::MatchDevice (Ipv6EndPoint *endP, Ptr<Ipv6Interface> incomingInterface)
+{
+  NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
+                                             << " daddr=" << endP->GetLocalAddress ()
+                                             << " sport=" << endP->GetPeerPort ()
+                                             << " saddr=" << endP->GetPeerAddress ());
+  if (endP->GetBoundNetDevice ())
+    {
+      if (!incomingInterface)
         {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
+          return false;
+        }
+      if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          return false;
         }
     }
+  return true;
 }
 
 /*
  * If we have an exact match, we return it.
  * Otherwise, if we find a generic match, we return it.
  * Otherwise, we return 0.
+ *
+ * Exact matches (retval3 and retval4) need the peer of the end point to
+ * match the source exactly, so they are all in one bucket of the
+ * connection table.  Generic matches (retval1 and retval2) need a
+ * wildcard peer, so they are all in the listener table.
  */
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint16_t dport,
                                                         Ipv6Address saddr, uint16_t sport,
@@ -179,90 +297,24 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Connections::iterator c = m_connections.find (GetKey (dport, saddr, sport));
+  if (c != m_connections.end ())
     {
-      Ipv6EndPoint* endP = *i;
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
-      if (endP->GetLocalPort () != dport)
+      for (OrderedEndPoints::iterator i = c->second.begin (); i != c->second.end (); i++)
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-
-      if (endP->GetBoundNetDevice ())
-        {
-          if (!incomingInterface)
+          Ipv6EndPoint* endP = i->second;
+          if (!MatchDevice (endP, incomingInterface))
             {
               continue;
             }
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
-            {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
-              continue;
+          if (endP->GetLocalAddress () == Ipv6Address::GetAny ())
+            { /* All but local address */
+              retval3.push_back (endP);
+            }
+          if (endP->GetLocalAddress () == daddr)
+            { /* All 4 match */
+              retval4.push_back (endP);
             }
-        }
-
-      /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-      NS_LOG_DEBUG ("dest addr " << daddr);
-
-      bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
-      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
-      bool localAddressMatchesAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
-
-      /* if no match here, keep looking */
-      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-          continue;
-        }
-      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
-
-      /* If remote does not match either with exact or wildcard,i
-         skip this one */
-      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-          continue;
-        }
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-          continue;
-        }
-
-      /* Now figure out which return list to add this one to */
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-          retval1.push_back (endP);
-        }
-      if ((localAddressMatchesExact || (localAddressMatchesAllRouters))
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-          retval2.push_back (endP);
-        }
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All but local address */
-          retval3.push_back (endP);
-        }
-      if (localAddressMatchesExact
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All 4 match */
-          retval4.push_back (endP);
         }
     }
 
@@ -275,6 +327,42 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
     {
       return retval3;
     }
+
+  std::map<uint16_t, OrderedEndPoints>::iterator l = m_listeners.find (dport);
+  if (l != m_listeners.end ())
+    {
+      for (OrderedEndPoints::iterator i = l->second.begin (); i != l->second.end (); i++)
+        {
+          Ipv6EndPoint* endP = i->second;
+          if (!MatchDevice (endP, incomingInterface))
+            {
+              continue;
+            }
+
+          NS_LOG_DEBUG ("dest addr " << daddr);
+
+          bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
+          bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
+          bool localAddressMatchesAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
+
+          /* if no match here, keep looking */
+          if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+            {
+              continue;
+            }
+
+          /* Now figure out which return list to add this one to */
+          if (localAddressMatchesWildCard)
+            { /* Only local port matches exactly */
+              retval1.push_back (endP);
+            }
+          if (localAddressMatchesExact || (localAddressMatchesAllRouters))
+            { /* Only local port and local address matches exactly */
+              retval2.push_back (endP);
+            }
+        }
+    }
+
   if (!retval2.empty ())
     {
       return retval2;
@@ -284,38 +372,45 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  Connections::iterator c = m_connections.find (GetKey (dport, src, sport));
+  if (c != m_connections.end ())
+    {
+      for (OrderedEndPoints::iterator i = c->second.begin (); i != c->second.end (); i++)
+        {
+          if (i->second->GetLocalAddress () == dst)
+            {
+              /* this is an exact match. */
+              return i->second;
+            }
+        }
+    }
+
+  std::map<uint16_t, OrderedEndPoints>::iterator p = m_ports.find (dport);
+  if (p == m_ports.end ())
+    {
+      return 0;
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPoints::iterator i = p->second.begin (); i != p->second.end (); i++)
     {
       uint32_t tmp = 0;
 
-      if ((*i)->GetLocalPort () != dport)
-        {
-          continue;
-        }
-
-      if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
-          && (*i)->GetPeerAddress () == src)
-        {
-          /* this is an exact match. */
-          return *i;
-        }
-
-      if ((*i)->GetLocalAddress () == Ipv6Address::GetAny ())
+      if (i->second->GetLocalAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
-      if ((*i)->GetPeerAddress () == Ipv6Address::GetAny ())
+      if (i->second->GetPeerAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
       if (tmp < genericity)
         {
-          generic = (*i);
+          generic = i->second;
           genericity = tmp;
         }
     }
@@ -346,8 +441,12 @@ uint16_t Ipv6EndPointDemux::AllocateEphemeralPort ()
 
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
 {
-  return m_endPoints;
+  EndPoints ret;
+  for (OrderedEndPoints::const_iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+    {
+      ret.push_back (i->second);
+    }
+  return ret;
 }
 
 } /* namespace ns3 */
-
@@ -23,7 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <vector>
 #include "ns3/ipv6-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv6-interface.h"
 
 namespace ns3 {
@@ -33,6 +36,10 @@ class Ipv6EndPoint;
 /**
  * \class Ipv6EndPointDemux
  * \brief Demultiplexor for end points.
+ *
+ * End points are indexed by local port and peer (address, port) in a
+ * hash table, and end points with a wildcard peer by local port, so
+ * that Lookup does not scan every end point of the node.
  */
 class Ipv6EndPointDemux
 {
@@ -137,6 +144,96 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief End points ordered by allocation sequence number.
+   */
+  typedef std::map<uint64_t, Ipv6EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief Key of the connection table.
+   */
+  struct Key
+  {
+    Ipv6Address peerAddress; //!< peer address
+    uint16_t localPort;      //!< local port
+    uint16_t peerPort;       //!< peer port
+
+    /**
+     * \brief Equality operator.
+     * \param other key to compare
+     * \return true if the keys are equal
+     */
+    bool operator== (const Key &other) const;
+  };
+
+  /**
+   * \brief Hash function for the connection table keys.
+   */
+  class KeyHash : public std::unary_function<Key, size_t>
+  {
+public:
+    /**
+     * \brief Returns the hash of a key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (const Key &key) const;
+  };
+
+  /**
+   * \brief Container of end points indexed by local port and peer.
+   */
+  typedef sgi::hash_map<Key, OrderedEndPoints, KeyHash> Connections;
+
+  /**
+   * \brief Build a connection table key.
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the key
+   */
+  static Key GetKey (uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Add an end point to the lookup tables.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the lookup tables.
+   * \param endPoint the end point
+   * \param localPort local port the end point was indexed with
+   * \param peerAddress peer address the end point was indexed with
+   * \param peerPort peer port the end point was indexed with
+   */
+  void Remove (Ipv6EndPoint *endPoint, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Re-index an end point whose local port or peer changed.
+   * \param endPoint the end point
+   * \param localPort previous local port
+   * \param peerAddress previous peer address
+   * \param peerPort previous peer port
+   */
+  void NotifyChanged (Ipv6EndPoint *endPoint, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Register a new end point.
+   * \param endPoint the end point
+   */
+  void Register (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Check if an end point bound to a device can receive from an interface.
+   * \param endP the end point
+   * \param incomingInterface the incoming interface
+   * \return true if the end point is not bound or bound to the interface device
+   */
+  bool MatchDevice (Ipv6EndPoint *endP, Ptr<Ipv6Interface> incomingInterface);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -159,9 +256,34 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief All the IPv6 end points.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The IPv6 end points, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_ports;
+
+  /**
+   * \brief The IPv6 end points with a wildcard peer, by local port.
+   */
+  std::map<uint16_t, OrderedEndPoints> m_listeners;
+
+  /**
+   * \brief The IPv6 end points, by local port and peer.
+   */
+  Connections m_connections;
+
+  /**
+   * \brief One bit per local port, set if some end point uses it.
+   */
+  std::vector<bool> m_portsInUse;
+
+  /**
+   * \brief The sequence number of the next registered end point.
    */
-  EndPoints m_endPoints;
+  uint64_t m_nextSequence;
 };
 
 } /* namespace ns3 */
@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \brief A representation of an internet IPv6 endpoint/connection
@@ -237,6 +238,18 @@ private:
    * \brief The destroy callback.
    */
   Callback<void> m_destroyCallback;
+
+  friend class Ipv6EndPointDemux;
+
+  /**
+   * \brief The demux indexing this EndPoint (if any), notified of changes.
+   */
+  Ipv6EndPointDemux *m_demux;
+
+  /**
+   * \brief The allocation order of this EndPoint in its demux.
+   */
+  uint64_t m_sequence;
 };
 
 } /* namespace ns3 */
@@ -30,6 +30,7 @@
 #include "ipv6-l3-protocol.h"
 #include "icmpv6-l4-protocol.h"
 #include "ndisc-cache.h"
+#include "traffic-control-layer.h"
 
 namespace ns3
 {
@@ -418,14 +419,26 @@ void Ipv6Interface::Send (Ptr<Packet> p, Ipv6Address dest)
       if (found)
         {
           NS_LOG_LOGIC ("Address Resolved.  Send.");
-          m_device->Send (p, hardwareDestination, Ipv6L3Protocol::PROT_NUMBER);
+          SendToDevice (p, hardwareDestination);
         }
     }
   else
     {
       NS_LOG_LOGIC ("Doesn't need ARP");
-      m_device->Send (p, m_device->GetBroadcast (), Ipv6L3Protocol::PROT_NUMBER);
+      SendToDevice (p, m_device->GetBroadcast ());
+    }
+}
+
+void Ipv6Interface::SendToDevice (Ptr<Packet> p, const Address &dest)
+{
+  NS_LOG_FUNCTION (this << p << dest);
+  Ptr<TrafficControlLayer> tc = m_node->GetObject<TrafficControlLayer> ();
+  if (tc != 0)
+    {
+      tc->Send (m_device, Create<QueueDiscItem> (p, dest, Ipv6L3Protocol::PROT_NUMBER));
+      return;
     }
+  m_device->Send (p, dest, Ipv6L3Protocol::PROT_NUMBER);
 }
 
 void Ipv6Interface::SetCurHopLimit (uint8_t curHopLimit)
@@ -283,6 +283,14 @@ private:
    */
   void DoSetup ();
 
+  /**
+   * \brief Send a packet to the device, through the traffic control layer
+   * of the node if it has one.
+   * \param p the packet, starting with its IPv6 header
+   * \param dest the destination hardware address
+   */
+  void SendToDevice (Ptr<Packet> p, const Address &dest);
+
   /**
    * \brief The addresses assigned to this interface.
    */
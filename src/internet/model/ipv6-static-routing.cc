@@ -47,7 +47,8 @@ TypeId Ipv6StaticRouting::GetTypeId ()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting ()
-  : m_ipv6 (0)
+  : m_nonPrefixRoutes (0),
+    m_ipv6 (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -149,7 +150,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << nextHop << interface << metric);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  AddNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -162,7 +163,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
 
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface, prefixToUse);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  AddNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface, uint32_t metric)
@@ -170,7 +171,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << interface);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  AddNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::SetDefaultRoute (Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -194,7 +195,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Address network = Ipv6Address ("ff00::"); /* RFC 3513 */
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
-  m_networkRoutes.push_back (std::make_pair (route, 0));
+  AddNetworkRoute (route, 0);
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -298,66 +299,107 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  Ipv6RoutingTableEntry* route = 0;
+  if (m_nonPrefixRoutes == 0)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
+      uint8_t buf[16];
+      dst.GetBytes (buf);
+      std::vector<NetworkRoutesIndex::Values const *> matches;
+      m_networkRoutesIndex.Match (buf, 128, matches);
 
-      if (mask.IsMatch (dst, entry))
+      /* longest prefix first; within a prefix, the lowest metric wins and
+       * equal metrics go to the route added last, as in the scan below
+       */
+      for (std::vector<NetworkRoutesIndex::Values const *>::reverse_iterator i = matches.rbegin (); i != matches.rend () && !route; i++)
         {
-          NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
-
-          /* if interface is given, check the route will output on this interface */
-          if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
+          for (NetworkRoutesIndex::Values::const_iterator it = (*i)->begin (); it != (*i)->end (); it++)
             {
-              if (maskLen < longestMask)
-                {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
-                  continue;
-                }
+              NS_LOG_LOGIC ("Found global network route " << *it->first << ", mask length " << uint16_t (it->first->GetDestNetworkPrefix ().GetPrefixLength ()) << ", metric " << it->second);
 
-              if (maskLen > longestMask)
+              /* if interface is given, check the route will output on this interface */
+              if (interface && interface != m_ipv6->GetNetDevice (it->first->GetInterface ()))
                 {
-                  shortestMetric = 0xffffffff;
+                  continue;
                 }
 
-              longestMask = maskLen;
-              if (metric > shortestMetric)
+              if (it->second > shortestMetric)
                 {
                   NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
                   continue;
                 }
 
-              shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
+              shortestMetric = it->second;
+              route = it->first;
+            }
+        }
+    }
+  else
+    {
+      for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+        {
+          Ipv6RoutingTableEntry* j = it->first;
+          uint32_t metric = it->second;
+          Ipv6Prefix mask = j->GetDestNetworkPrefix ();
+          uint16_t maskLen = mask.GetPrefixLength ();
+          Ipv6Address entry = j->GetDestNetwork ();
 
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
+          NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
+
+          if (mask.IsMatch (dst, entry))
+            {
+              NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
+
+              /* if interface is given, check the route will output on this interface */
+              if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
                 {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
+                  if (maskLen < longestMask)
+                    {
+                      NS_LOG_LOGIC ("Previous match longer, skipping");
+                      continue;
+                    }
 
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+                  if (maskLen > longestMask)
+                    {
+                      shortestMetric = 0xffffffff;
+                    }
+
+                  longestMask = maskLen;
+                  if (metric > shortestMetric)
+                    {
+                      NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                      continue;
+                    }
+
+                  shortestMetric = metric;
+                  route = j;
+                }
             }
         }
     }
 
+  if (route)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv6Route> ();
+
+      if (route->GetGateway ().IsAny ())
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
+        }
+      else if (route->GetDest ().IsAny ()) /* default route */
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
+        }
+      else
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+        }
+
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+    }
+
   if (rtentry)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetDestination () << " (Through " << rtentry->GetGateway () << ") at the end");
@@ -374,6 +416,8 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_networkRoutesIndex.Clear ();
+  m_nonPrefixRoutes = 0;
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -442,29 +486,23 @@ uint32_t Ipv6StaticRouting::GetNRoutes () const
 Ipv6RoutingTableEntry Ipv6StaticRouting::GetDefaultRoute ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Ipv6Address dst ("::");
+  uint8_t buf[16] = { 0 };
   uint32_t shortestMetric = 0xffffffff;
   Ipv6RoutingTableEntry* result = 0;
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  /* default routes have a zero-length prefix, which is always indexed */
+  NetworkRoutesIndex::Values const *routes = m_networkRoutesIndex.Find (buf, 0);
+  if (routes)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      if (maskLen)
+      for (NetworkRoutesIndex::Values::const_iterator it = routes->begin (); it != routes->end (); it++)
         {
-          continue;
-        }
-
-      if (metric > shortestMetric)
-        {
-          continue;
+          if (it->second > shortestMetric)
+            {
+              continue;
+            }
+          shortestMetric = it->second;
+          result = it->first;
         }
-      shortestMetric = metric;
-      result = j;
     }
 
   if (result)
@@ -522,8 +560,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          RemoveNetworkRoute (it);
           return;
         }
       tmp++;
@@ -541,13 +578,51 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
       if (network == rtentry->GetDest () && rtentry->GetInterface () == ifIndex
           && rtentry->GetPrefixToUse () == prefixToUse)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          RemoveNetworkRoute (it);
           return;
         }
     }
 }
 
+void Ipv6StaticRouting::AddNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+
+  uint8_t prefix[16];
+  route->GetDestNetworkPrefix ().GetBytes (prefix);
+  uint8_t length = route->GetDestNetworkPrefix ().GetPrefixLength ();
+  bool contiguous = true;
+  for (uint8_t i = 0; i < 16 && contiguous; i++)
+    {
+      uint8_t expected = i < length / 8 ? 0xff : (i == length / 8 ? static_cast<uint8_t> (0xff00 >> (length % 8)) : 0);
+      contiguous = (prefix[i] == expected);
+    }
+  if (!contiguous)
+    {
+      NS_LOG_LOGIC ("Prefix " << route->GetDestNetworkPrefix () << " is not contiguous, route not indexed");
+      m_nonPrefixRoutes++;
+      return;
+    }
+
+  uint8_t buf[16];
+  route->GetDestNetwork ().GetBytes (buf);
+  m_networkRoutesIndex.Insert (buf, length, m_networkRoutes.back ());
+}
+
+Ipv6StaticRouting::NetworkRoutesI Ipv6StaticRouting::RemoveNetworkRoute (NetworkRoutesI it)
+{
+  NS_LOG_FUNCTION (this << it->first);
+  uint8_t buf[16];
+  it->first->GetDestNetwork ().GetBytes (buf);
+  if (!m_networkRoutesIndex.Remove (buf, it->first->GetDestNetworkPrefix ().GetPrefixLength (), *it))
+    {
+      m_nonPrefixRoutes--;
+    }
+  delete it->first;
+  return m_networkRoutes.erase (it);
+}
+
 Ptr<Ipv6Route> Ipv6StaticRouting::RouteOutput (Ptr<Packet> p, const Ipv6Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
   NS_LOG_FUNCTION (this << header << oif);
@@ -689,8 +764,7 @@ void Ipv6StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = RemoveNetworkRoute (it);
         }
       else
         {
@@ -734,8 +808,7 @@ void Ipv6StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAd
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkPrefix () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = RemoveNetworkRoute (it);
         }
       else
         {
@@ -778,8 +851,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
 
           if (dst == entry && prefix == mask && rtentry->GetInterface () == interface)
             {
-              delete j->first;
-              j = m_networkRoutes.erase (j);
+              j = RemoveNetworkRoute (j);
             }
           else
             {
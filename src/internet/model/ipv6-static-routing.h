@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -266,6 +267,9 @@ private:
   /// Iterator for container for the network routes
   typedef std::list<std::pair <Ipv6RoutingTableEntry *, uint32_t> >::iterator NetworkRoutesI;
 
+  /// Longest prefix match index of the network routes
+  typedef PrefixTrie<std::pair <Ipv6RoutingTableEntry *, uint32_t> > NetworkRoutesIndex;
+
   /// Container for the multicast routes
   typedef std::list<Ipv6MulticastRoutingTableEntry *> MulticastRoutes;
 
@@ -292,11 +296,38 @@ private:
    */
   Ptr<Ipv6MulticastRoute> LookupStatic (Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+  /**
+   * \brief Append a route to the network routes and index it.
+   * \param route the route
+   * \param metric metric of the route
+   */
+  void AddNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric);
+
+  /**
+   * \brief Delete a network route and remove it from the index.
+   * \param it the route
+   * \return the route following the removed one
+   */
+  NetworkRoutesI RemoveNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes indexed by destination prefix.
+   *
+   * Routes whose prefix mask is not contiguous cannot be indexed;
+   * while any of them exist, lookups scan m_networkRoutes instead.
+   */
+  NetworkRoutesIndex m_networkRoutesIndex;
+
+  /**
+   * \brief number of network routes missing from m_networkRoutesIndex.
+   */
+  uint32_t m_nonPrefixRoutes;
+
   /**
    * \brief the forwarding table for multicast.
    */
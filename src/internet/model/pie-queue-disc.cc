@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pie-queue-disc.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PieQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (PieQueueDisc);
+
+TypeId
+PieQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PieQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<PieQueueDisc> ()
+    .AddAttribute ("Target",
+                   "The PIE algorithm target queueing delay",
+                   StringValue ("15ms"),
+                   MakeTimeAccessor (&PieQueueDisc::m_target),
+                   MakeTimeChecker ())
+    .AddAttribute ("Tupdate",
+                   "The period of the update of the drop probability",
+                   StringValue ("15ms"),
+                   MakeTimeAccessor (&PieQueueDisc::m_tUpdate),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxBurstAllowance",
+                   "The duration of the bursts going through without early drops",
+                   StringValue ("150ms"),
+                   MakeTimeAccessor (&PieQueueDisc::m_maxBurst),
+                   MakeTimeChecker ())
+    .AddAttribute ("A",
+                   "The weight of the deviation of the queueing delay from the target, in 1/s",
+                   DoubleValue (0.125),
+                   MakeDoubleAccessor (&PieQueueDisc::m_a),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("B",
+                   "The weight of the trend of the queueing delay, in 1/s",
+                   DoubleValue (1.25),
+                   MakeDoubleAccessor (&PieQueueDisc::m_b),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Limit",
+                   "The maximum number of packets accepted by the queueing discipline",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&PieQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MeanPktSize",
+                   "Average of packet size; no early drop below two of them in the queue",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&PieQueueDisc::m_meanPktSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN-capable packets instead of dropping them while the drop probability is at most 10%",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PieQueueDisc::m_useEcn),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+PieQueueDisc::PieQueueDisc ()
+  : m_dropProb (0),
+    m_qDelay (Time (0)),
+    m_qDelayOld (Time (0)),
+    m_burstAllowance (Time (0))
+{
+  NS_LOG_FUNCTION (this);
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+PieQueueDisc::~PieQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PieQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rtrsEvent.Cancel ();
+  m_packets.Clear ();
+  m_uv = 0;
+  QueueDisc::DoDispose ();
+}
+
+double
+PieQueueDisc::GetDropProbability (void) const
+{
+  return m_dropProb;
+}
+
+int64_t
+PieQueueDisc::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uv->SetStream (stream);
+  return 1;
+}
+
+bool
+PieQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (!m_rtrsEvent.IsRunning ())
+    {
+      // Idle until now; bursts are allowed again once the probability
+      // has decayed to zero
+      if (m_dropProb == 0)
+        {
+          m_burstAllowance = m_maxBurst;
+        }
+      m_rtrsEvent = Simulator::Schedule (m_tUpdate, &PieQueueDisc::CalculateP, this);
+    }
+
+  // GetNPackets () counts the packet being enqueued
+  if (GetNPackets () > m_limit)
+    {
+      NS_LOG_LOGIC ("Queue full -- dropping pkt");
+      return false;
+    }
+  if (DropEarly (item))
+    {
+      if (!m_useEcn || m_dropProb > 0.1 || !Mark (item))
+        {
+          NS_LOG_LOGIC ("Early drop, probability " << m_dropProb);
+          return false;
+        }
+      NS_LOG_LOGIC ("Early mark, probability " << m_dropProb);
+    }
+  m_packets.PushBack (item);
+  return true;
+}
+
+bool
+PieQueueDisc::DropEarly (Ptr<QueueDiscItem> item)
+{
+  if (m_burstAllowance.IsStrictlyPositive ())
+    {
+      return false;
+    }
+  if (m_qDelayOld < m_target / 2 && m_dropProb < 0.2)
+    {
+      return false;
+    }
+  // Do not drop while the queue holds less than two packets
+  if (GetNBytes () - item->GetSize () <= 2 * m_meanPktSize)
+    {
+      return false;
+    }
+  return m_uv->GetValue () < m_dropProb;
+}
+
+void
+PieQueueDisc::CalculateP (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time qDelay = m_packets.IsEmpty () ? Time (0) : m_qDelay;
+  double p = m_a * (qDelay - m_target).GetSeconds ()
+    + m_b * (qDelay - m_qDelayOld).GetSeconds ();
+
+  // Adjust in smaller steps while the probability is low
+  if (m_dropProb < 0.000001)
+    {
+      p /= 2048;
+    }
+  else if (m_dropProb < 0.00001)
+    {
+      p /= 512;
+    }
+  else if (m_dropProb < 0.0001)
+    {
+      p /= 128;
+    }
+  else if (m_dropProb < 0.001)
+    {
+      p /= 32;
+    }
+  else if (m_dropProb < 0.01)
+    {
+      p /= 8;
+    }
+  else if (m_dropProb < 0.1)
+    {
+      p /= 2;
+    }
+  m_dropProb += p;
+
+  // Decay while the queue stays empty
+  if (qDelay.IsZero () && m_qDelayOld.IsZero ())
+    {
+      m_dropProb *= 0.98;
+    }
+  m_dropProb = std::max (0.0, std::min (1.0, m_dropProb));
+
+  m_burstAllowance = std::max (Time (0), m_burstAllowance - m_tUpdate);
+  if (m_dropProb == 0 && qDelay < m_target / 2 && m_qDelayOld < m_target / 2)
+    {
+      m_burstAllowance = m_maxBurst;
+    }
+  m_qDelayOld = qDelay;
+  NS_LOG_LOGIC ("Queueing delay " << qDelay << ", drop probability " << m_dropProb);
+
+  if (!m_packets.IsEmpty () || m_dropProb > 0 || !m_qDelayOld.IsZero ())
+    {
+      m_rtrsEvent = Simulator::Schedule (m_tUpdate, &PieQueueDisc::CalculateP, this);
+    }
+}
+
+Ptr<QueueDiscItem>
+PieQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_packets.IsEmpty ())
+    {
+      return 0;
+    }
+  Ptr<QueueDiscItem> item = m_packets.Front ();
+  m_packets.PopFront ();
+  m_qDelay = Simulator::Now () - item->GetTimeStamp ();
+  return item;
+}
+
+} // namespace ns3
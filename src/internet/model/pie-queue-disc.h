@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PIE_QUEUE_DISC_H
+#define PIE_QUEUE_DISC_H
+
+#include "queue-disc.h"
+#include "ns3/ring-buffer.h"
+#include "ns3/event-id.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The Proportional Integral controller Enhanced queueing discipline
+ * (\RFC{8033})
+ *
+ * Packets are dropped (or marked) randomly upon enqueue, with a
+ * probability updated every Tupdate from the deviation of the queueing
+ * delay from its target and from its trend.  The queueing delay is the
+ * sojourn time of the last packet dequeued.  Bursts shorter than
+ * MaxBurstAllowance go through without early drops.
+ *
+ * The probability is only updated while the queue is busy or the
+ * probability is not yet back to zero, so that an idle queue schedules no
+ * event.
+ */
+class PieQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PieQueueDisc ();
+  virtual ~PieQueueDisc ();
+
+  /**
+   * \returns the current drop probability
+   */
+  double GetDropProbability (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+
+  /**
+   * \param item the packet to enqueue
+   * \returns true if the packet must be dropped or marked early
+   */
+  bool DropEarly (Ptr<QueueDiscItem> item);
+
+  /**
+   * \brief Update the drop probability, every Tupdate.
+   */
+  void CalculateP (void);
+
+  Time m_target;                  //!< Target queueing delay
+  Time m_tUpdate;                 //!< Period of the update of the drop probability
+  Time m_maxBurst;                //!< Maximum burst allowance
+  double m_a;                     //!< Weight of the deviation from the target
+  double m_b;                     //!< Weight of the trend of the queueing delay
+  uint32_t m_limit;               //!< Maximum number of packets held
+  uint32_t m_meanPktSize;         //!< Average packet size in bytes
+  bool m_useEcn;                  //!< True to mark ECN-capable packets instead of dropping them
+
+  RingBuffer<Ptr<QueueDiscItem> > m_packets;  //!< Packets held
+  double m_dropProb;              //!< Drop probability
+  Time m_qDelay;                  //!< Sojourn time of the last packet dequeued
+  Time m_qDelayOld;               //!< Queueing delay at the previous update
+  Time m_burstAllowance;          //!< Remaining burst allowance
+  EventId m_rtrsEvent;            //!< Next update of the drop probability
+  Ptr<UniformRandomVariable> m_uv;  //!< Rng stream
+};
+
+} // namespace ns3
+
+#endif /* PIE_QUEUE_DISC_H */
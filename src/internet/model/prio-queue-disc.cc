@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "prio-queue-disc.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PrioQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (PrioQueueDisc);
+
+namespace {
+
+/// Priority of each value of the TOS field (rt_tos2priority in Linux)
+const uint8_t g_tos2Priority[16] = { 0, 0, 0, 0, 2, 2, 2, 2, 6, 6, 6, 6, 4, 4, 4, 4 };
+
+/// Band of each priority (default priority map of Linux)
+const uint8_t g_priority2Band[16] = { 1, 2, 2, 2, 1, 2, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+} // anonymous namespace
+
+TypeId
+PrioQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PrioQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<PrioQueueDisc> ()
+    .AddAttribute ("Bands",
+                   "The number of bands; packets mapped to a band beyond the last one go to the last one.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&PrioQueueDisc::m_nBands),
+                   MakeUintegerChecker<uint32_t> (1, 16))
+    .AddAttribute ("Limit",
+                   "The maximum number of packets accepted by each band.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&PrioQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+PrioQueueDisc::PrioQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PrioQueueDisc::~PrioQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+PrioQueueDisc::Classify (uint8_t tos) const
+{
+  uint32_t band = g_priority2Band[g_tos2Priority[(tos & 0x1e) >> 1]];
+  return std::min (band, m_nBands - 1);
+}
+
+uint32_t
+PrioQueueDisc::GetNPacketsInBand (uint32_t band) const
+{
+  return band < m_bands.size () ? m_bands[band].GetSize () : 0;
+}
+
+bool
+PrioQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (m_bands.empty ())
+    { // The number of bands is known once the attributes are set
+      m_bands.resize (m_nBands);
+    }
+
+  uint32_t band = Classify (item->GetTos ());
+  if (m_bands[band].GetSize () >= m_limit)
+    {
+      NS_LOG_LOGIC ("Band " << band << " full -- dropping pkt");
+      return false;
+    }
+  m_bands[band].PushBack (item);
+  NS_LOG_LOGIC ("Enqueued in band " << band);
+  return true;
+}
+
+Ptr<QueueDiscItem>
+PrioQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (uint32_t band = 0; band < m_bands.size (); band++)
+    {
+      if (!m_bands[band].IsEmpty ())
+        {
+          Ptr<QueueDiscItem> item = m_bands[band].Front ();
+          m_bands[band].PopFront ();
+          NS_LOG_LOGIC ("Dequeued from band " << band);
+          return item;
+        }
+    }
+  return 0;
+}
+
+} // namespace ns3
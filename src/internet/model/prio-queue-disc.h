@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PRIO_QUEUE_DISC_H
+#define PRIO_QUEUE_DISC_H
+
+#include <vector>
+#include "queue-disc.h"
+#include "ns3/ring-buffer.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A multi-band strict priority queueing discipline
+ *
+ * Like the pfifo_fast and prio queueing disciplines of Linux, packets are
+ * classified into a band according to the Type of Service byte of their
+ * network header, through the default Linux priority map, and each band
+ * is a drop-tail FIFO.  A band is served only when the bands of higher
+ * priority (lower index) are empty.  With the default 3 bands, packets
+ * requesting low delay go to band 0, best-effort packets to band 1 and
+ * packets requesting high throughput to band 2.
+ */
+class PrioQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PrioQueueDisc ();
+  virtual ~PrioQueueDisc ();
+
+  /**
+   * \param tos the Type of Service byte of a packet
+   * \returns the band of the packet
+   */
+  uint32_t Classify (uint8_t tos) const;
+
+  /**
+   * \param band a band
+   * \returns the number of packets held in the band
+   */
+  uint32_t GetNPacketsInBand (uint32_t band) const;
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+
+  uint32_t m_nBands;   //!< Number of bands
+  uint32_t m_limit;    //!< Maximum number of packets of each band
+  std::vector<RingBuffer<Ptr<QueueDiscItem> > > m_bands;  //!< FIFO of each band
+};
+
+} // namespace ns3
+
+#endif /* PRIO_QUEUE_DISC_H */
@@ -0,0 +1,349 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "queue-disc.h"
+#include "ipv4-header.h"
+#include "ipv6-header.h"
+#include "ipv4-l3-protocol.h"
+#include "ipv6-l3-protocol.h"
+#include "ns3/ecn-tag.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QueueDisc");
+
+QueueDiscItem::QueueDiscItem (Ptr<Packet> packet, const Address &address, uint16_t protocol)
+  : m_packet (packet),
+    m_address (address),
+    m_protocol (protocol)
+{
+}
+
+Ptr<Packet>
+QueueDiscItem::GetPacket (void) const
+{
+  return m_packet;
+}
+
+uint32_t
+QueueDiscItem::GetSize (void) const
+{
+  return m_packet->GetSize ();
+}
+
+Address
+QueueDiscItem::GetAddress (void) const
+{
+  return m_address;
+}
+
+uint16_t
+QueueDiscItem::GetProtocol (void) const
+{
+  return m_protocol;
+}
+
+void
+QueueDiscItem::SetTimeStamp (Time t)
+{
+  m_tstamp = t;
+}
+
+Time
+QueueDiscItem::GetTimeStamp (void) const
+{
+  return m_tstamp;
+}
+
+uint8_t
+QueueDiscItem::GetTos (void) const
+{
+  if (m_protocol == Ipv4L3Protocol::PROT_NUMBER)
+    {
+      Ipv4Header header;
+      m_packet->PeekHeader (header);
+      return header.GetTos ();
+    }
+  if (m_protocol == Ipv6L3Protocol::PROT_NUMBER)
+    {
+      Ipv6Header header;
+      m_packet->PeekHeader (header);
+      return header.GetTrafficClass ();
+    }
+  return 0;
+}
+
+uint32_t
+QueueDiscItem::Hash (uint32_t perturbation) const
+{
+  // Network header followed by the ports of the transport header
+  uint8_t buf[64];
+  uint32_t headerSize;
+  uint8_t l4Protocol;
+  bool hasPorts;
+  uint64_t h = perturbation;
+
+  if (m_protocol == Ipv4L3Protocol::PROT_NUMBER)
+    {
+      Ipv4Header header;
+      m_packet->PeekHeader (header);
+      headerSize = header.GetSerializedSize ();
+      l4Protocol = header.GetProtocol ();
+      hasPorts = header.GetFragmentOffset () == 0;
+      h = (h << 32) ^ header.GetSource ().Get ();
+      h = (h * 0x9e3779b97f4a7c15ULL) ^ header.GetDestination ().Get ();
+    }
+  else if (m_protocol == Ipv6L3Protocol::PROT_NUMBER)
+    {
+      Ipv6Header header;
+      m_packet->PeekHeader (header);
+      headerSize = header.GetSerializedSize ();
+      l4Protocol = header.GetNextHeader ();
+      hasPorts = true;
+      uint8_t addr[16];
+      header.GetSourceAddress ().GetBytes (addr);
+      for (uint32_t i = 0; i < 16; i++)
+        {
+          h = (h * 0x9e3779b97f4a7c15ULL) ^ addr[i];
+        }
+      header.GetDestinationAddress ().GetBytes (addr);
+      for (uint32_t i = 0; i < 16; i++)
+        {
+          h = (h * 0x9e3779b97f4a7c15ULL) ^ addr[i];
+        }
+    }
+  else
+    {
+      return 0;
+    }
+
+  h = (h * 0x9e3779b97f4a7c15ULL) ^ l4Protocol;
+  // TCP and UDP
+  if (hasPorts && (l4Protocol == 6 || l4Protocol == 17)
+      && headerSize + 4 <= sizeof (buf) && m_packet->GetSize () >= headerSize + 4)
+    {
+      m_packet->CopyData (buf, headerSize + 4);
+      uint32_t ports = (buf[headerSize] << 24) | (buf[headerSize + 1] << 16)
+        | (buf[headerSize + 2] << 8) | buf[headerSize + 3];
+      h = (h * 0x9e3779b97f4a7c15ULL) ^ ports;
+    }
+  h *= 0x9e3779b97f4a7c15ULL;
+  return static_cast<uint32_t> (h ^ (h >> 32));
+}
+
+bool
+QueueDiscItem::Mark (void)
+{
+  // The network layer mirrors the ECN field of its header in the tag, and
+  // the receiving network layer copies the mark back, see EcnTag
+  EcnTag tag;
+  if (!m_packet->PeekPacketTag (tag) || !tag.IsEcnCapable ())
+    {
+      return false;
+    }
+  m_packet->RemovePacketTag (tag);
+  tag.SetEcn (EcnTag::CE);
+  m_packet->AddPacketTag (tag);
+  return true;
+}
+
+QueueDisc::Stats::Stats ()
+  : nTotalReceivedPackets (0),
+    nTotalReceivedBytes (0),
+    nTotalSentPackets (0),
+    nTotalSentBytes (0),
+    nTotalDroppedPackets (0),
+    nTotalDroppedBytes (0),
+    nTotalMarkedPackets (0)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED (QueueDisc);
+
+TypeId
+QueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::QueueDisc")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddTraceSource ("Enqueue", "Enqueue a packet in the queueing discipline",
+                     MakeTraceSourceAccessor (&QueueDisc::m_traceEnqueue),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Dequeue", "Dequeue a packet from the queueing discipline",
+                     MakeTraceSourceAccessor (&QueueDisc::m_traceDequeue),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Drop", "Drop a packet stored in the queueing discipline",
+                     MakeTraceSourceAccessor (&QueueDisc::m_traceDrop),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Mark", "Mark a packet stored in the queueing discipline",
+                     MakeTraceSourceAccessor (&QueueDisc::m_traceMark),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+QueueDisc::QueueDisc ()
+  : m_nPackets (0),
+    m_nBytes (0),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QueueDisc::~QueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+QueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_device = 0;
+  m_deviceQueue = 0;
+  Object::DoDispose ();
+}
+
+bool
+QueueDisc::Enqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  m_stats.nTotalReceivedPackets++;
+  m_stats.nTotalReceivedBytes += item->GetSize ();
+  item->SetTimeStamp (Simulator::Now ());
+
+  // Account for the packet before DoEnqueue, which may drop it or another
+  // packet through DropAfterEnqueue
+  m_nPackets++;
+  m_nBytes += item->GetSize ();
+
+  bool enqueued = DoEnqueue (item);
+  if (!enqueued)
+    {
+      DropAfterEnqueue (item);
+      return false;
+    }
+  m_traceEnqueue (item->GetPacket ());
+  return true;
+}
+
+Ptr<QueueDiscItem>
+QueueDisc::Dequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<QueueDiscItem> item = DoDequeue ();
+  if (item != 0)
+    {
+      NS_ASSERT (m_nPackets > 0 && m_nBytes >= item->GetSize ());
+      m_nPackets--;
+      m_nBytes -= item->GetSize ();
+      m_traceDequeue (item->GetPacket ());
+    }
+  return item;
+}
+
+void
+QueueDisc::DropAfterEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  NS_ASSERT (m_nPackets > 0 && m_nBytes >= item->GetSize ());
+  m_nPackets--;
+  m_nBytes -= item->GetSize ();
+  m_stats.nTotalDroppedPackets++;
+  m_stats.nTotalDroppedBytes += item->GetSize ();
+
+  NS_LOG_LOGIC ("m_traceDrop (p)");
+  m_traceDrop (item->GetPacket ());
+}
+
+bool
+QueueDisc::Mark (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (!item->Mark ())
+    {
+      return false;
+    }
+  m_stats.nTotalMarkedPackets++;
+  m_traceMark (item->GetPacket ());
+  return true;
+}
+
+void
+QueueDisc::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // A device which wakes its queue while it sends a packet would call us
+  // back from within the loop
+  if (m_running)
+    {
+      return;
+    }
+  m_running = true;
+  while (m_deviceQueue == 0 || !m_deviceQueue->IsStopped ())
+    {
+      Ptr<QueueDiscItem> item = Dequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      m_stats.nTotalSentPackets++;
+      m_stats.nTotalSentBytes += item->GetSize ();
+      m_device->Send (item->GetPacket (), item->GetAddress (), item->GetProtocol ());
+    }
+  m_running = false;
+}
+
+void
+QueueDisc::SetNetDevice (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_device = device;
+  m_deviceQueue = device->GetObject<NetDeviceQueue> ();
+}
+
+Ptr<NetDevice>
+QueueDisc::GetNetDevice (void) const
+{
+  return m_device;
+}
+
+uint32_t
+QueueDisc::GetNPackets (void) const
+{
+  return m_nPackets;
+}
+
+uint32_t
+QueueDisc::GetNBytes (void) const
+{
+  return m_nBytes;
+}
+
+const QueueDisc::Stats&
+QueueDisc::GetStats (void) const
+{
+  return m_stats;
+}
+
+} // namespace ns3
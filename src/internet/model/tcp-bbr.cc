@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-bbr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbr");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpBbr);
+
+/// Gains of the PROBE_BW phase, one round trip each
+static const double g_probeBwGains[] = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+/// Number of positions in the PROBE_BW gain cycle
+static const uint32_t PROBE_BW_CYCLE_LENGTH = 8;
+
+TypeId
+TcpBbr::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpBbr")
+    .SetParent<TcpCongestionOps> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpBbr> ()
+    .AddAttribute ("HighGain", "Gain applied to the bandwidth-delay product in STARTUP",
+                   DoubleValue (2.89),
+                   MakeDoubleAccessor (&TcpBbr::m_highGain),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("BandwidthWindow", "Length of the bottleneck bandwidth filter, in round trips",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&TcpBbr::m_bandwidthWindow),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MinRttWindow", "Length of the round trip propagation delay filter",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TcpBbr::m_minRttWindow),
+                   MakeTimeChecker ())
+    .AddAttribute ("ProbeRttDuration", "Time spent in PROBE_RTT",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&TcpBbr::m_probeRttDuration),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TcpBbr::TcpBbr ()
+  : TcpCongestionOps (),
+    m_highGain (2.89), // mute valgrind, actual value set by the attribute system
+    m_bandwidthWindow (10),
+    m_mode (STARTUP),
+    m_delivered (0),
+    m_roundEnd (0),
+    m_roundCount (0),
+    m_roundStart (false),
+    m_sampleDelivered (0),
+    m_minRttExpired (false),
+    m_fullBandwidth (0),
+    m_fullBandwidthCount (0),
+    m_fullPipe (false),
+    m_cycleIndex (0),
+    m_priorCWnd (0)
+{
+}
+
+TcpBbr::TcpBbr (const TcpBbr &other)
+  : TcpCongestionOps (other),
+    m_highGain (other.m_highGain),
+    m_bandwidthWindow (other.m_bandwidthWindow),
+    m_minRttWindow (other.m_minRttWindow),
+    m_probeRttDuration (other.m_probeRttDuration),
+    m_mode (STARTUP),
+    m_delivered (0),
+    m_roundEnd (0),
+    m_roundCount (0),
+    m_roundStart (false),
+    m_sampleDelivered (0),
+    m_minRttExpired (false),
+    m_fullBandwidth (0),
+    m_fullBandwidthCount (0),
+    m_fullPipe (false),
+    m_cycleIndex (0),
+    m_priorCWnd (0)
+{
+}
+
+TcpBbr::~TcpBbr ()
+{
+}
+
+uint32_t
+TcpBbr::GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight)
+{
+  // Losses are not a congestion signal: recover with the data in flight and
+  // restore the window once done
+  m_priorCWnd = std::max (m_priorCWnd, tcb.m_cWnd);
+  return std::max (2 * tcb.m_segmentSize, bytesInFlight);
+}
+
+void
+TcpBbr::IncreaseWindow (TcpSocketState &tcb, uint32_t bytesAcked)
+{
+  uint32_t minCWnd = 4 * tcb.m_segmentSize;
+  if (m_mode == PROBE_RTT)
+    {
+      tcb.m_cWnd = std::min (tcb.m_cWnd, minCWnd);
+      return;
+    }
+  if (m_priorCWnd > 0)
+    { // Back from a recovery or PROBE_RTT
+      tcb.m_cWnd = std::max (tcb.m_cWnd, m_priorCWnd);
+      m_priorCWnd = 0;
+    }
+
+  double bdp = GetBdp ();
+  uint32_t target = static_cast<uint32_t> (bdp * GetGain ()) + 3 * tcb.m_segmentSize;
+  if (bdp == 0)
+    { // No model yet, grow as in slow start
+      tcb.m_cWnd += bytesAcked;
+    }
+  else if (m_fullPipe)
+    {
+      tcb.m_cWnd = std::min (tcb.m_cWnd + bytesAcked, target);
+    }
+  else if (tcb.m_cWnd < target)
+    {
+      tcb.m_cWnd += bytesAcked;
+    }
+  tcb.m_cWnd = std::max (tcb.m_cWnd, minCWnd);
+  NS_LOG_INFO ("Mode " << m_mode << ", BDP " << bdp << " bytes, cwnd " << tcb.m_cWnd);
+}
+
+void
+TcpBbr::PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt)
+{
+  Time now = Simulator::Now ();
+  bool firstAck = m_delivered == 0;
+  m_delivered += bytesAcked;
+
+  // A round trip ends when the data in flight at its beginning is delivered
+  m_roundStart = false;
+  if (m_delivered >= m_roundEnd)
+    {
+      m_roundStart = true;
+      m_roundCount++;
+      m_roundEnd = m_delivered + tcb.m_bytesInFlight;
+    }
+
+  m_minRttExpired = !m_minRtt.IsZero () && now > m_minRttStamp + m_minRttWindow;
+  if (!rtt.IsZero () && (m_minRtt.IsZero () || rtt <= m_minRtt || m_minRttExpired))
+    {
+      m_minRtt = rtt;
+      m_minRttStamp = now;
+    }
+
+  // Delivery rate, measured over at least a round trip propagation delay
+  if (firstAck)
+    {
+      m_sampleStart = now;
+      m_sampleDelivered = m_delivered;
+    }
+  else if (!m_minRtt.IsZero () && now - m_sampleStart >= m_minRtt)
+    {
+      UpdateBandwidth ((m_delivered - m_sampleDelivered) / (now - m_sampleStart).GetSeconds ());
+      m_sampleStart = now;
+      m_sampleDelivered = m_delivered;
+    }
+
+  UpdateMode (tcb);
+}
+
+void
+TcpBbr::UpdateBandwidth (double rate)
+{
+  // Windowed maximum: only keep the samples which may become the maximum
+  while (!m_bandwidthSamples.empty () && m_bandwidthSamples.back ().second <= rate)
+    {
+      m_bandwidthSamples.pop_back ();
+    }
+  m_bandwidthSamples.push_back (std::make_pair (m_roundCount, rate));
+  while (m_bandwidthSamples.front ().first + m_bandwidthWindow <= m_roundCount)
+    {
+      m_bandwidthSamples.pop_front ();
+    }
+  NS_LOG_LOGIC ("Delivery rate " << rate << " bytes/s, bandwidth " << GetBandwidth () << " bytes/s");
+}
+
+void
+TcpBbr::UpdateMode (const TcpSocketState &tcb)
+{
+  Time now = Simulator::Now ();
+  if (m_mode == STARTUP && m_roundStart && !m_bandwidthSamples.empty ())
+    {
+      if (GetBandwidth () >= m_fullBandwidth * 1.25)
+        {
+          m_fullBandwidth = GetBandwidth ();
+          m_fullBandwidthCount = 0;
+        }
+      else if (++m_fullBandwidthCount >= 3)
+        {
+          NS_LOG_INFO ("Pipe full at " << m_fullBandwidth << " bytes/s, STARTUP -> DRAIN");
+          m_fullPipe = true;
+          m_mode = DRAIN;
+        }
+    }
+  if (m_mode == DRAIN && tcb.m_bytesInFlight <= GetBdp ())
+    {
+      NS_LOG_INFO ("DRAIN -> PROBE_BW");
+      m_mode = PROBE_BW;
+      m_cycleIndex = 2;
+      m_cycleStamp = now;
+    }
+  else if (m_mode == PROBE_BW && now - m_cycleStamp > m_minRtt)
+    {
+      m_cycleIndex = (m_cycleIndex + 1) % PROBE_BW_CYCLE_LENGTH;
+      m_cycleStamp = now;
+    }
+
+  if (m_mode != PROBE_RTT && m_minRttExpired)
+    {
+      NS_LOG_INFO ("Minimum RTT expired, entering PROBE_RTT");
+      m_mode = PROBE_RTT;
+      m_probeRttDone = now + m_probeRttDuration;
+      m_priorCWnd = std::max (m_priorCWnd, tcb.m_cWnd);
+    }
+  else if (m_mode == PROBE_RTT && now >= m_probeRttDone)
+    {
+      m_minRttStamp = now;
+      m_mode = m_fullPipe ? PROBE_BW : STARTUP;
+      m_cycleStamp = now;
+      NS_LOG_INFO ("Leaving PROBE_RTT with minimum RTT " << m_minRtt.GetSeconds ());
+    }
+}
+
+double
+TcpBbr::GetBdp (void) const
+{
+  return GetBandwidth () * m_minRtt.GetSeconds ();
+}
+
+double
+TcpBbr::GetGain (void) const
+{
+  switch (m_mode)
+    {
+    case STARTUP:
+      return m_highGain;
+    case DRAIN:
+      return 1 / m_highGain;
+    case PROBE_BW:
+      return g_probeBwGains[m_cycleIndex];
+    default:
+      return 1;
+    }
+}
+
+Ptr<TcpCongestionOps>
+TcpBbr::Fork (void)
+{
+  return CopyObject<TcpBbr> (this);
+}
+
+TcpBbr::BbrMode
+TcpBbr::GetMode (void) const
+{
+  return m_mode;
+}
+
+double
+TcpBbr::GetBandwidth (void) const
+{
+  return m_bandwidthSamples.empty () ? 0 : m_bandwidthSamples.front ().second;
+}
+
+Time
+TcpBbr::GetMinRtt (void) const
+{
+  return m_minRtt;
+}
+
+} // namespace ns3
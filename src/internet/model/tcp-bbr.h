@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_BBR_H
+#define TCP_BBR_H
+
+#include "tcp-congestion-ops.h"
+#include <deque>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The BBR congestion control, window-based
+ *
+ * BBR builds a model of the path from the acknowledgments: the bottleneck
+ * bandwidth, maximum of the delivery rate over the last BandwidthWindow
+ * round trips, and the round trip propagation delay, minimum of the round
+ * trip time over the last MinRttWindow.  Their product, the bandwidth-delay
+ * product (BDP), is the amount of data in flight which fills the pipe
+ * without queueing; losses are not taken as congestion signals.
+ *
+ * The window is a multiple of the BDP, the gain depending on the phase:
+ *
+ * - STARTUP: gain 2/ln(2), until the bandwidth stops growing by 25% over
+ *   three round trips;
+ * - DRAIN: inverse gain, until the data in flight falls down to the BDP;
+ * - PROBE_BW: gain cycling through 5/4, 3/4 and six times 1, one round
+ *   trip each, to probe for more bandwidth and drain the queue it built;
+ * - PROBE_RTT: four segments during ProbeRttDuration, when the minimum
+ *   round trip time has not been refreshed for MinRttWindow.
+ *
+ * TcpSocketBase has no pacing: the gains which BBR applies to its pacing
+ * rate are applied to the window instead, which then keeps the queue close
+ * to empty in PROBE_BW.
+ */
+class TcpBbr : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Phases of BBR
+   */
+  enum BbrMode
+  {
+    STARTUP,    //!< Exponential search of the bandwidth
+    DRAIN,      //!< Drain the queue built during STARTUP
+    PROBE_BW,   //!< Steady state, probing for bandwidth
+    PROBE_RTT   //!< Drain the queue to measure the propagation delay
+  };
+
+  TcpBbr ();
+  /**
+   * \brief Copy constructor
+   * \param other the object to copy
+   */
+  TcpBbr (const TcpBbr &other);
+  virtual ~TcpBbr ();
+
+  virtual uint32_t GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight);
+  virtual void IncreaseWindow (TcpSocketState &tcb, uint32_t bytesAcked);
+  virtual void PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt);
+  virtual Ptr<TcpCongestionOps> Fork (void);
+
+  /**
+   * \returns the current phase
+   */
+  BbrMode GetMode (void) const;
+  /**
+   * \returns the estimate of the bottleneck bandwidth (bytes/s)
+   */
+  double GetBandwidth (void) const;
+  /**
+   * \returns the estimate of the round trip propagation delay
+   */
+  Time GetMinRtt (void) const;
+
+private:
+  /**
+   * \returns the bandwidth-delay product (bytes)
+   */
+  double GetBdp (void) const;
+  /**
+   * \returns the gain applied to the bandwidth-delay product
+   */
+  double GetGain (void) const;
+  /**
+   * \brief Update the bandwidth estimate with a delivery rate sample
+   * \param rate the delivery rate (bytes/s)
+   */
+  void UpdateBandwidth (double rate);
+  /**
+   * \brief Move between phases
+   * \param tcb the state of the socket
+   */
+  void UpdateMode (const TcpSocketState &tcb);
+
+  double   m_highGain;          //!< Gain of STARTUP
+  uint32_t m_bandwidthWindow;   //!< Length of the bandwidth filter (round trips)
+  Time     m_minRttWindow;      //!< Length of the minimum RTT filter
+  Time     m_probeRttDuration;  //!< Time spent in PROBE_RTT
+
+  BbrMode  m_mode;              //!< Current phase
+  uint64_t m_delivered;         //!< Data acknowledged so far (bytes)
+  uint64_t m_roundEnd;          //!< Value of m_delivered ending the current round trip
+  uint32_t m_roundCount;        //!< Number of round trips so far
+  bool     m_roundStart;        //!< The last acknowledgment started a round trip
+  Time     m_sampleStart;       //!< Beginning of the delivery rate sample
+  uint64_t m_sampleDelivered;   //!< Value of m_delivered when the sample began
+  std::deque<std::pair<uint32_t, double> > m_bandwidthSamples; //!< Decreasing maximum rate per round trip
+  Time     m_minRtt;            //!< Minimum RTT over the filter
+  Time     m_minRttStamp;       //!< When m_minRtt was measured
+  bool     m_minRttExpired;     //!< m_minRtt is older than the filter
+  double   m_fullBandwidth;     //!< Bandwidth STARTUP compares to
+  uint32_t m_fullBandwidthCount; //!< Round trips without 25% bandwidth growth
+  bool     m_fullPipe;          //!< STARTUP has filled the pipe
+  uint32_t m_cycleIndex;        //!< Position in the PROBE_BW gain cycle
+  Time     m_cycleStamp;        //!< Beginning of the current cycle position
+  Time     m_probeRttDone;      //!< End of PROBE_RTT
+  uint32_t m_priorCWnd;         //!< Window to restore after PROBE_RTT (bytes)
+};
+
+} // namespace ns3
+
+#endif /* TCP_BBR_H */
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/packet.h"
+#include "ns3/log.h"
+#include "tcp-byte-store.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpByteStore");
+
+TcpByteStore::TcpByteStore ()
+  : m_size (0)
+{
+}
+
+uint32_t
+TcpByteStore::Size (void) const
+{
+  return m_size;
+}
+
+bool
+TcpByteStore::IsEmpty (void) const
+{
+  return m_data.empty ();
+}
+
+SequenceNumber32
+TcpByteStore::HeadSequence (void) const
+{
+  NS_ASSERT (!m_data.empty ());
+  return m_data.begin ()->first;
+}
+
+TcpByteStore::Container::const_iterator
+TcpByteStore::Find (SequenceNumber32 seq) const
+{
+  Container::const_iterator i = m_data.upper_bound (seq);
+  if (i == m_data.begin ())
+    {
+      return m_data.end ();
+    }
+  --i;
+  if (i->first + SequenceNumber32 (i->second->GetSize ()) > seq)
+    {
+      return i;
+    }
+  return m_data.end ();
+}
+
+uint32_t
+TcpByteStore::Add (SequenceNumber32 seq, Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << seq << p);
+  SequenceNumber32 headSeq = seq;
+  SequenceNumber32 tailSeq = seq + SequenceNumber32 (p->GetSize ());
+  uint32_t added = 0;
+
+  // Skip the bytes held by the interval which overlaps the head, if any
+  Container::iterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      Container::iterator prev = i;
+      --prev;
+      SequenceNumber32 prevEnd = prev->first + SequenceNumber32 (prev->second->GetSize ());
+      if (prevEnd > headSeq)
+        {
+          headSeq = prevEnd;
+        }
+    }
+  // Fill each gap up to the tail
+  while (headSeq < tailSeq)
+    {
+      SequenceNumber32 gapEnd = tailSeq;
+      if (i != m_data.end () && i->first < tailSeq)
+        {
+          gapEnd = i->first;
+        }
+      if (headSeq < gapEnd)
+        {
+          uint32_t length = gapEnd - headSeq;
+          Ptr<Packet> fragment = p;
+          if (length != p->GetSize ())
+            {
+              fragment = p->CreateFragment (headSeq - seq, length);
+            }
+          m_data.insert (i, std::make_pair (headSeq, fragment));
+          added += length;
+        }
+      if (i == m_data.end () || !(i->first < tailSeq))
+        {
+          break;
+        }
+      headSeq = i->first + SequenceNumber32 (i->second->GetSize ());
+      ++i;
+    }
+  m_size += added;
+  NS_LOG_LOGIC ("Added " << added << " bytes, size=" << m_size << " intervals=" << m_data.size ());
+  return added;
+}
+
+SequenceNumber32
+TcpByteStore::ContiguousEnd (SequenceNumber32 seq) const
+{
+  Container::const_iterator i = Find (seq);
+  if (i == m_data.end ())
+    {
+      return seq;
+    }
+  SequenceNumber32 end = i->first + SequenceNumber32 (i->second->GetSize ());
+  for (++i; i != m_data.end () && i->first == end; ++i)
+    {
+      end += i->second->GetSize ();
+    }
+  return end;
+}
+
+Ptr<Packet>
+TcpByteStore::Copy (SequenceNumber32 seq, uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << seq << size);
+  Container::const_iterator i = Find (seq);
+  NS_ASSERT_MSG (i != m_data.end (), "Byte " << seq << " not stored");
+
+  uint32_t offset = seq - i->first;
+  uint32_t pktSize = i->second->GetSize ();
+  if (offset == 0 && pktSize == size)
+    {
+      return i->second->Copy ();
+    }
+  if (pktSize - offset >= size)
+    { // Data to be copied falls entirely in this packet
+      return i->second->CreateFragment (offset, size);
+    }
+  Ptr<Packet> outPacket = i->second->CreateFragment (offset, pktSize - offset);
+  uint32_t left = size - (pktSize - offset);
+  for (++i; left > 0; ++i)
+    {
+      NS_ASSERT_MSG (i != m_data.end () && i->first == seq + SequenceNumber32 (size - left),
+                     "Bytes from " << seq + SequenceNumber32 (size - left) << " not stored");
+      pktSize = i->second->GetSize ();
+      if (pktSize <= left)
+        {
+          outPacket->AddAtEnd (i->second);
+          left -= pktSize;
+        }
+      else
+        {
+          outPacket->AddAtEnd (i->second->CreateFragment (0, left));
+          left = 0;
+        }
+    }
+  NS_ASSERT (outPacket->GetSize () == size);
+  return outPacket;
+}
+
+uint32_t
+TcpByteStore::DiscardUpTo (SequenceNumber32 seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  uint32_t removed = 0;
+  while (!m_data.empty () && m_data.begin ()->first < seq)
+    {
+      Container::iterator i = m_data.begin ();
+      uint32_t pktSize = i->second->GetSize ();
+      SequenceNumber32 end = i->first + SequenceNumber32 (pktSize);
+      if (end <= seq)
+        { // This packet is behind the seqnum. Remove it
+          removed += pktSize;
+          m_data.erase (i);
+        }
+      else
+        { // Part of the packet is behind the seqnum. Fragment
+          uint32_t offset = seq - i->first;
+          Ptr<Packet> fragment = i->second->CreateFragment (offset, pktSize - offset);
+          m_data.erase (i);
+          m_data.insert (m_data.begin (), std::make_pair (seq, fragment));
+          removed += offset;
+          break;
+        }
+    }
+  m_size -= removed;
+  NS_LOG_LOGIC ("Removed " << removed << " bytes, size=" << m_size << " intervals=" << m_data.size ());
+  return removed;
+}
+
+void
+TcpByteStore::Clear (void)
+{
+  m_data.clear ();
+  m_size = 0;
+}
+
+std::list<TcpByteStore::Interval>
+TcpByteStore::GetIntervals (SequenceNumber32 seq) const
+{
+  std::list<Interval> intervals;
+  Container::const_iterator i = Find (seq);
+  if (i == m_data.end ())
+    {
+      i = m_data.upper_bound (seq);
+    }
+  for (; i != m_data.end (); ++i)
+    {
+      SequenceNumber32 start = i->first < seq ? seq : i->first;
+      SequenceNumber32 end = i->first + SequenceNumber32 (i->second->GetSize ());
+      if (!intervals.empty () && intervals.back ().second == start)
+        {
+          intervals.back ().second = end;
+        }
+      else
+        {
+          intervals.push_back (Interval (start, end));
+        }
+    }
+  return intervals;
+}
+
+} // namespace ns3
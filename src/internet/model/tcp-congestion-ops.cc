@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-congestion-ops.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpCongestionOps");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpCongestionOps);
+
+TcpSocketState::TcpSocketState ()
+  : m_cWnd (0),
+    m_ssThresh (0),
+    m_segmentSize (0),
+    m_bytesInFlight (0),
+    m_congState (CA_OPEN),
+    m_ecnEcho (false)
+{
+}
+
+TypeId
+TcpCongestionOps::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpCongestionOps")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpCongestionOps> ()
+  ;
+  return tid;
+}
+
+TcpCongestionOps::TcpCongestionOps ()
+  : Object ()
+{
+}
+
+TcpCongestionOps::TcpCongestionOps (const TcpCongestionOps &other)
+  : Object (other)
+{
+}
+
+TcpCongestionOps::~TcpCongestionOps ()
+{
+}
+
+uint32_t
+TcpCongestionOps::GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight)
+{
+  return std::max (2 * tcb.m_segmentSize, bytesInFlight / 2);
+}
+
+void
+TcpCongestionOps::IncreaseWindow (TcpSocketState &tcb, uint32_t bytesAcked)
+{
+  if (tcb.m_cWnd < tcb.m_ssThresh)
+    {
+      SlowStart (tcb);
+    }
+  else
+    {
+      CongestionAvoidance (tcb);
+    }
+}
+
+void
+TcpCongestionOps::PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt)
+{
+}
+
+void
+TcpCongestionOps::CongestionStateSet (const TcpSocketState &tcb, TcpCongState_t newState)
+{
+}
+
+bool
+TcpCongestionOps::EchoEachCeMark (void) const
+{
+  return false;
+}
+
+Ptr<TcpCongestionOps>
+TcpCongestionOps::Fork (void)
+{
+  return CopyObject<TcpCongestionOps> (this);
+}
+
+void
+TcpCongestionOps::SlowStart (TcpSocketState &tcb)
+{
+  // Add one segSize to cWnd. Default m_ssThresh is 65535. (RFC2001, sec.1)
+  tcb.m_cWnd += tcb.m_segmentSize;
+  NS_LOG_INFO ("In SlowStart, updated to cwnd " << tcb.m_cWnd << " ssthresh " << tcb.m_ssThresh);
+}
+
+void
+TcpCongestionOps::CongestionAvoidance (TcpSocketState &tcb)
+{
+  // Increase by (segSize*segSize)/cwnd. (RFC2581, sec.3.1)
+  // To increase cwnd for one segSize per RTT, it should be (ackBytes*segSize)/cwnd
+  double adder = static_cast<double> (tcb.m_segmentSize * tcb.m_segmentSize) / tcb.m_cWnd;
+  adder = std::max (1.0, adder);
+  tcb.m_cWnd += static_cast<uint32_t> (adder);
+  NS_LOG_INFO ("In CongAvoid, updated to cwnd " << tcb.m_cWnd << " ssthresh " << tcb.m_ssThresh);
+}
+
+} // namespace ns3
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-cubic.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpCubic");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpCubic);
+
+TypeId
+TcpCubic::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpCubic")
+    .SetParent<TcpCongestionOps> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpCubic> ()
+    .AddAttribute ("Beta", "Multiplicative window decrease factor",
+                   DoubleValue (0.7),
+                   MakeDoubleAccessor (&TcpCubic::m_beta),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("C", "Cubic scaling factor, in segments per cubic second",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&TcpCubic::m_c),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FastConvergence", "Enable fast convergence",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_fastConvergence),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+TcpCubic::TcpCubic ()
+  : TcpCongestionOps (),
+    m_beta (0.7), // mute valgrind, actual value set by the attribute system
+    m_c (0.4),
+    m_fastConvergence (true),
+    m_epochStarted (false),
+    m_wMax (0),
+    m_k (0),
+    m_wEst (0),
+    m_cWndFraction (0)
+{
+}
+
+TcpCubic::TcpCubic (const TcpCubic &other)
+  : TcpCongestionOps (other),
+    m_beta (other.m_beta),
+    m_c (other.m_c),
+    m_fastConvergence (other.m_fastConvergence),
+    m_epochStarted (false),
+    m_wMax (0),
+    m_k (0),
+    m_wEst (0),
+    m_cWndFraction (0)
+{
+}
+
+TcpCubic::~TcpCubic ()
+{
+}
+
+uint32_t
+TcpCubic::GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight)
+{
+  double cWnd = static_cast<double> (tcb.m_cWnd) / tcb.m_segmentSize;
+  if (m_fastConvergence && cWnd < m_wMax)
+    { // Still below the previous plateau: leave room to the other flows (RFC 8312, sec. 4.6)
+      m_wMax = cWnd * (1 + m_beta) / 2;
+    }
+  else
+    {
+      m_wMax = cWnd;
+    }
+  m_epochStarted = false;
+  uint32_t ssThresh = static_cast<uint32_t> (tcb.m_cWnd * m_beta);
+  NS_LOG_INFO ("Congestion event at cwnd " << tcb.m_cWnd << ": W_max " << m_wMax << " segments, ssthresh " << ssThresh);
+  return std::max (2 * tcb.m_segmentSize, ssThresh);
+}
+
+void
+TcpCubic::IncreaseWindow (TcpSocketState &tcb, uint32_t bytesAcked)
+{
+  if (tcb.m_cWnd < tcb.m_ssThresh)
+    {
+      SlowStart (tcb);
+      return;
+    }
+
+  double segmentSize = tcb.m_segmentSize;
+  double cWnd = tcb.m_cWnd / segmentSize;
+  Time now = Simulator::Now ();
+  if (!m_epochStarted)
+    { // First acknowledgment since the last congestion event (RFC 8312, sec. 4.1)
+      m_epochStarted = true;
+      m_epochStart = now;
+      if (m_wMax <= cWnd)
+        {
+          m_wMax = cWnd;
+          m_k = 0;
+        }
+      else
+        {
+          m_k = std::pow ((m_wMax - cWnd) / m_c, 1.0 / 3.0);
+        }
+      m_wEst = cWnd;
+    }
+
+  // Window the cubic function reaches one round trip time from now
+  double t = (now - m_epochStart + m_minRtt).GetSeconds ();
+  double target = m_c * std::pow (t - m_k, 3) + m_wMax;
+  target = std::min (target, 1.5 * cWnd);
+
+  // Window of a standard TCP flow sharing the bottleneck (RFC 8312, sec. 4.2)
+  double segmentsAcked = std::max (1.0, bytesAcked / segmentSize);
+  m_wEst += 3 * (1 - m_beta) / (1 + m_beta) * segmentsAcked / cWnd;
+  target = std::max (target, m_wEst);
+
+  double increment;
+  if (target > cWnd)
+    { // Concave or convex region (RFC 8312, sec. 4.3 and 4.4)
+      increment = (target - cWnd) / cWnd * segmentsAcked;
+    }
+  else
+    { // Plateau: grow very slowly
+      increment = 0.01 / cWnd * segmentsAcked;
+    }
+  m_cWndFraction += increment * segmentSize;
+  uint32_t adder = static_cast<uint32_t> (m_cWndFraction);
+  m_cWndFraction -= adder;
+  tcb.m_cWnd += adder;
+  NS_LOG_INFO ("In CongAvoid, target " << target << " segments, updated to cwnd " << tcb.m_cWnd);
+}
+
+void
+TcpCubic::PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt)
+{
+  if (!rtt.IsZero () && (m_minRtt.IsZero () || rtt < m_minRtt))
+    {
+      m_minRtt = rtt;
+    }
+}
+
+void
+TcpCubic::CongestionStateSet (const TcpSocketState &tcb, TcpCongState_t newState)
+{
+  if (newState == CA_LOSS)
+    { // Start from scratch after a timeout
+      m_epochStarted = false;
+      m_cWndFraction = 0;
+    }
+}
+
+Ptr<TcpCongestionOps>
+TcpCubic::Fork (void)
+{
+  return CopyObject<TcpCubic> (this);
+}
+
+} // namespace ns3
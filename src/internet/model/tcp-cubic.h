@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_CUBIC_H
+#define TCP_CUBIC_H
+
+#include "tcp-congestion-ops.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The CUBIC congestion control (\RFC{8312})
+ *
+ * In congestion avoidance, the window follows a cubic function of the
+ * time elapsed since the last congestion event, whose plateau is the
+ * window at which that event happened:
+ *
+ *   W(t) = C (t - K)^3 + W_max,  with K = cbrt (W_max (1 - beta) / C)
+ *
+ * so that the growth does not depend on the round trip time, and is fast
+ * far from W_max and cautious close to it.  The window never grows slower
+ * than the one of a standard TCP flow would (TCP-friendly region), and
+ * is reduced by the factor beta upon a congestion event.  Slow start is
+ * the standard one; HyStart is not implemented.
+ */
+class TcpCubic : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpCubic ();
+  /**
+   * \brief Copy constructor
+   * \param other the object to copy
+   */
+  TcpCubic (const TcpCubic &other);
+  virtual ~TcpCubic ();
+
+  virtual uint32_t GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight);
+  virtual void IncreaseWindow (TcpSocketState &tcb, uint32_t bytesAcked);
+  virtual void PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt);
+  virtual void CongestionStateSet (const TcpSocketState &tcb, TcpCongState_t newState);
+  virtual Ptr<TcpCongestionOps> Fork (void);
+
+private:
+  double m_beta;              //!< Multiplicative window decrease factor
+  double m_c;                 //!< Cubic scaling factor (segments / s^3)
+  bool   m_fastConvergence;   //!< Release bandwidth faster to new flows
+
+  bool   m_epochStarted;      //!< A congestion avoidance epoch is running
+  Time   m_epochStart;        //!< Beginning of the current epoch
+  double m_wMax;              //!< Window before the last reduction (segments)
+  double m_k;                 //!< Time for the cubic function to reach W_max (s)
+  double m_wEst;              //!< Window of an equivalent standard TCP flow (segments)
+  double m_cWndFraction;      //!< Growth not applied yet to the window (bytes)
+  Time   m_minRtt;            //!< Minimum round trip time observed
+};
+
+} // namespace ns3
+
+#endif /* TCP_CUBIC_H */
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-dctcp.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpDctcp");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpDctcp);
+
+TypeId
+TcpDctcp::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpDctcp")
+    .SetParent<TcpCongestionOps> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpDctcp> ()
+    .AddAttribute ("G", "Weight of a new observation in the moving average of the marked fraction",
+                   DoubleValue (1.0 / 16),
+                   MakeDoubleAccessor (&TcpDctcp::m_g),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("AlphaOnInit", "Initial value of the marked fraction estimate",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&TcpDctcp::m_alpha),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+  ;
+  return tid;
+}
+
+TcpDctcp::TcpDctcp ()
+  : TcpCongestionOps (),
+    m_g (1.0 / 16), // mute valgrind, actual value set by the attribute system
+    m_alpha (1.0),
+    m_ackedBytes (0),
+    m_ackedBytesEcn (0),
+    m_windowBytes (0)
+{
+}
+
+TcpDctcp::TcpDctcp (const TcpDctcp &other)
+  : TcpCongestionOps (other),
+    m_g (other.m_g),
+    m_alpha (other.m_alpha),
+    m_ackedBytes (0),
+    m_ackedBytesEcn (0),
+    m_windowBytes (0)
+{
+}
+
+TcpDctcp::~TcpDctcp ()
+{
+}
+
+uint32_t
+TcpDctcp::GetSsThresh (const TcpSocketState &tcb, uint32_t bytesInFlight)
+{
+  uint32_t ssThresh = static_cast<uint32_t> (tcb.m_cWnd * (1 - m_alpha / 2));
+  NS_LOG_INFO ("Congestion event at cwnd " << tcb.m_cWnd << " with alpha " << m_alpha << ": ssthresh " << ssThresh);
+  return std::max (2 * tcb.m_segmentSize, ssThresh);
+}
+
+void
+TcpDctcp::PktsAcked (const TcpSocketState &tcb, uint32_t bytesAcked, const Time &rtt)
+{
+  m_ackedBytes += bytesAcked;
+  if (tcb.m_ecnEcho)
+    {
+      m_ackedBytesEcn += bytesAcked;
+    }
+  if (m_ackedBytes >= m_windowBytes)
+    { // A window of data has been acknowledged, update alpha (RFC 8257, sec. 3.3)
+      if (m_ackedBytes > 0)
+        {
+          double fraction = static_cast<double> (m_ackedBytesEcn) / m_ackedBytes;
+          m_alpha = (1 - m_g) * m_alpha + m_g * fraction;
+          NS_LOG_INFO ("Marked fraction " << fraction << ", alpha " << m_alpha);
+        }
+      m_ackedBytes = 0;
+      m_ackedBytesEcn = 0;
+      // The data in flight includes the data just acknowledged
+      m_windowBytes = tcb.m_bytesInFlight > bytesAcked ? tcb.m_bytesInFlight - bytesAcked : 0;
+    }
+}
+
+bool
+TcpDctcp::EchoEachCeMark (void) const
+{
+  // The fraction of marked data is estimated from the echoes (RFC 8257, sec. 3.2)
+  return true;
+}
+
+Ptr<TcpCongestionOps>
+TcpDctcp::Fork (void)
+{
+  return CopyObject<TcpDctcp> (this);
+}
+
+double
+TcpDctcp::GetAlpha (void) const
+{
+  return m_alpha;
+}
+
+} // namespace ns3
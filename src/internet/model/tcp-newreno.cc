@@ -27,6 +27,8 @@
 #include "ns3/simulator.h"
 #include "ns3/abort.h"
 #include "ns3/node.h"
+#include "ns3/boolean.h"
+#include "ns3/object-factory.h"
 
 namespace ns3 {
 
@@ -49,6 +51,14 @@ TcpNewReno::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&TcpNewReno::m_limitedTx),
                    MakeBooleanChecker ())
+    .AddAttribute ("CongestionOps", "Type of the congestion control (a subclass of ns3::TcpCongestionOps)",
+                   TypeIdValue (TcpCongestionOps::GetTypeId ()),
+                   MakeTypeIdAccessor (&TcpNewReno::m_congestionTypeId),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("UseEcn", "Negotiate Explicit Congestion Notification (RFC 3168)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpNewReno::m_ecnEnabled),
+                   MakeBooleanChecker ())
     .AddTraceSource ("CongestionWindow",
                      "The TCP connection's congestion window",
                      MakeTraceSourceAccessor (&TcpNewReno::m_cWnd),
@@ -64,7 +74,8 @@ TcpNewReno::GetTypeId (void)
 TcpNewReno::TcpNewReno (void)
   : m_retxThresh (3), // mute valgrind, actual value set by the attribute system
     m_inFastRec (false),
-    m_limitedTx (false) // mute valgrind, actual value set by the attribute system
+    m_limitedTx (false), // mute valgrind, actual value set by the attribute system
+    m_congState (CA_OPEN)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -77,10 +88,16 @@ TcpNewReno::TcpNewReno (const TcpNewReno& sock)
     m_initialSsThresh (sock.m_initialSsThresh),
     m_retxThresh (sock.m_retxThresh),
     m_inFastRec (false),
-    m_limitedTx (sock.m_limitedTx)
+    m_limitedTx (sock.m_limitedTx),
+    m_congestionTypeId (sock.m_congestionTypeId),
+    m_congState (CA_OPEN)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
+  if (sock.m_congestionOps != 0)
+    {
+      m_congestionOps = sock.m_congestionOps->Fork ();
+    }
 }
 
 TcpNewReno::~TcpNewReno (void)
@@ -113,6 +130,12 @@ TcpNewReno::Window (void)
   return std::min (m_rWnd.Get (), m_cWnd.Get ());
 }
 
+Ptr<TcpCongestionOps>
+TcpNewReno::GetCongestionOps (void) const
+{
+  return m_congestionOps;
+}
+
 Ptr<TcpSocketBase>
 TcpNewReno::Fork (void)
 {
@@ -128,6 +151,8 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
                 " cwnd " << m_cWnd <<
                 " ssthresh " << m_ssThresh);
 
+  m_congestionOps->PktsAcked (GetSocketState (), seq - m_txBuffer->HeadSequence (), m_rttSample);
+
   // Check for exit condition of fast recovery
   if (m_inFastRec && seq < m_recover)
     { // Partial ACK, partial window deflation (RFC2582 sec.3 bullet #5 paragraph 3)
@@ -135,6 +160,10 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
       NS_LOG_INFO ("Partial ACK for seq " << seq << " in fast recovery: cwnd set to " << m_cWnd);
       m_txBuffer->DiscardUpTo(seq);  //Bug 1850:  retransmit before newack
       DoRetransmit (); // Assume the next seq is lost. Retransmit lost packet
+      if (m_sackRetxSeq < seq + SequenceNumber32 (m_segmentSize))
+        {
+          m_sackRetxSeq = seq + SequenceNumber32 (m_segmentSize);
+        }
       TcpSocketBase::NewAck (seq); // update m_nextTxSequence and send new data if allowed by window
       return;
     }
@@ -143,21 +172,27 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
       m_cWnd = std::min (m_ssThresh.Get (), BytesInFlight () + m_segmentSize);
       m_inFastRec = false;
       NS_LOG_INFO ("Received full ACK for seq " << seq <<". Leaving fast recovery with cwnd set to " << m_cWnd);
+      SetCongState (CA_OPEN);
+    }
+  else if ((m_congState == CA_LOSS && seq >= m_recover)
+           || (m_congState == CA_CWR && seq >= m_ecnRecover))
+    {
+      SetCongState (CA_OPEN);
     }
 
-  // Increase of cwnd based on current phase (slow start or congestion avoidance)
-  if (m_cWnd < m_ssThresh)
-    { // Slow start mode, add one segSize to cWnd. Default m_ssThresh is 65535. (RFC2001, sec.1)
-      m_cWnd += m_segmentSize;
-      NS_LOG_INFO ("In SlowStart, ACK of seq " << seq << "; update cwnd to " << m_cWnd << "; ssthresh " << m_ssThresh);
+  if (m_ecnEchoReceived && m_congState == CA_OPEN)
+    { // Congestion signalled with ECN: reduce the window without retransmission,
+      // once per window of data (RFC 3168, sec. 6.1.2)
+      m_ssThresh = m_congestionOps->GetSsThresh (GetSocketState (), BytesInFlight ());
+      m_cWnd = m_ssThresh;
+      m_ecnRecover = m_highTxMark;
+      m_ecnCwrPending = true;
+      NS_LOG_INFO ("ECN echo. Reduce cwnd to " << m_cWnd << " until seqnum " << m_ecnRecover);
+      SetCongState (CA_CWR);
     }
   else
-    { // Congestion avoidance mode, increase by (segSize*segSize)/cwnd. (RFC2581, sec.3.1)
-      // To increase cwnd for one segSize per RTT, it should be (ackBytes*segSize)/cwnd
-      double adder = static_cast<double> (m_segmentSize * m_segmentSize) / m_cWnd.Get ();
-      adder = std::max (1.0, adder);
-      m_cWnd += static_cast<uint32_t> (adder);
-      NS_LOG_INFO ("In CongAvoid, updated to cwnd " << m_cWnd << " ssthresh " << m_ssThresh);
+    { // Increase of cwnd based on current phase (slow start or congestion avoidance)
+      IncreaseWindow (seq - m_txBuffer->HeadSequence ());
     }
 
   // Complete newAck processing
@@ -171,19 +206,26 @@ TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
   NS_LOG_FUNCTION (this << count);
   if (count == m_retxThresh && !m_inFastRec)
     { // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
-      m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
+      m_ssThresh = m_congestionOps->GetSsThresh (GetSocketState (), BytesInFlight ());
       m_cWnd = m_ssThresh + 3 * m_segmentSize;
       m_recover = m_highTxMark;
       m_inFastRec = true;
+      SetCongState (CA_RECOVERY);
       NS_LOG_INFO ("Triple dupack. Enter fast recovery mode. Reset cwnd to " << m_cWnd <<
                    ", ssthresh to " << m_ssThresh << " at fast recovery seqnum " << m_recover);
       DoRetransmit ();
+      m_sackRetxSeq = m_txBuffer->HeadSequence () + SequenceNumber32 (m_segmentSize);
     }
   else if (m_inFastRec)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
       m_cWnd += m_segmentSize;
       NS_LOG_INFO ("Dupack in fast recovery mode. Increase cwnd to " << m_cWnd);
-      SendPendingData (m_connected);
+      // With SACK, the segment which left the network is replaced by the
+      // next hole known to be missing at the receiver, if any (RFC 6675)
+      if (!RetransmitSackHole ())
+        {
+          SendPendingData (m_connected);
+        }
     }
   else if (!m_inFastRec && m_limitedTx && m_txBuffer->SizeFromSequence (m_nextTxSequence) > 0)
     { // RFC3042 Limited transmit: Send a new packet for each duplicated ACK before fast retransmit
@@ -209,8 +251,10 @@ TcpNewReno::Retransmit (void)
   // According to RFC2581 sec.3.1, upon RTO, ssthresh is set to half of flight
   // size and cwnd is set to 1*MSS, then the lost packet is retransmitted and
   // TCP back to slow start
-  m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
+  m_ssThresh = m_congestionOps->GetSsThresh (GetSocketState (), BytesInFlight ());
   m_cWnd = m_segmentSize;
+  m_recover = m_highTxMark;
+  SetCongState (CA_LOSS);
   m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
   NS_LOG_INFO ("RTO. Reset cwnd to " << m_cWnd <<
                ", ssthresh to " << m_ssThresh << ", restart from seqnum " << m_nextTxSequence);
@@ -260,6 +304,45 @@ TcpNewReno::InitializeCwnd (void)
    */
   m_cWnd = m_initialCWnd * m_segmentSize;
   m_ssThresh = m_initialSsThresh;
+  if (m_congestionOps == 0)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (m_congestionTypeId);
+      m_congestionOps = factory.Create<TcpCongestionOps> ();
+    }
+  m_ecnEchoEachCe = m_congestionOps->EchoEachCeMark ();
+}
+
+TcpSocketState
+TcpNewReno::GetSocketState (void)
+{
+  TcpSocketState tcb;
+  tcb.m_cWnd = m_cWnd;
+  tcb.m_ssThresh = m_ssThresh;
+  tcb.m_segmentSize = m_segmentSize;
+  tcb.m_bytesInFlight = BytesInFlight ();
+  tcb.m_congState = m_congState;
+  tcb.m_ecnEcho = m_ecnEchoReceived;
+  return tcb;
+}
+
+void
+TcpNewReno::IncreaseWindow (uint32_t bytesAcked)
+{
+  TcpSocketState tcb = GetSocketState ();
+  m_congestionOps->IncreaseWindow (tcb, bytesAcked);
+  m_cWnd = tcb.m_cWnd;
+  m_ssThresh = tcb.m_ssThresh;
+}
+
+void
+TcpNewReno::SetCongState (TcpCongState_t state)
+{
+  if (state != m_congState)
+    {
+      m_congestionOps->CongestionStateSet (GetSocketState (), state);
+      m_congState = state;
+    }
 }
 
 } // namespace ns3
@@ -22,6 +22,7 @@
 #define TCP_NEWRENO_H
 
 #include "tcp-socket-base.h"
+#include "tcp-congestion-ops.h"
 
 namespace ns3 {
 
@@ -32,6 +33,12 @@ namespace ns3 {
  * \brief An implementation of a stream socket using TCP.
  *
  * This class contains the NewReno implementation of TCP, as of \RFC{2582}.
+ *
+ * The loss recovery is the one of NewReno, while the window updates are
+ * delegated to the congestion control selected by the CongestionOps
+ * attribute (see TcpCongestionOps), NewReno by default.  With the UseEcn
+ * attribute, the socket negotiates ECN (\RFC{3168}) and reduces its window
+ * once per window of data acknowledged with ECN echoes.
  */
 class TcpNewReno : public TcpSocketBase
 {
@@ -56,6 +63,11 @@ public:
   virtual int Connect (const Address &address);
   virtual int Listen (void);
 
+  /**
+   * \returns the congestion control of the socket, once connecting or listening
+   */
+  Ptr<TcpCongestionOps> GetCongestionOps (void) const;
+
 protected:
   virtual uint32_t Window (void); // Return the max possible number of unacked bytes
   virtual Ptr<TcpSocketBase> Fork (void); // Call CopyObject<TcpNewReno> to clone me
@@ -63,6 +75,7 @@ protected:
   virtual void DupAck (const TcpHeader& t, uint32_t count);  // Halving cwnd and reset nextTxSequence
   virtual void Retransmit (void); // Exit fast recovery upon retransmit timeout
 
+
   // Implementing ns3::TcpSocket -- Attribute get/set
   virtual void     SetSegSize (uint32_t size);
   virtual void     SetInitialSSThresh (uint32_t threshold);
@@ -74,6 +87,20 @@ private:
    * \brief Set the congestion window when connection starts
    */
   void InitializeCwnd (void);
+  /**
+   * \returns a snapshot of the state of the socket for the congestion control
+   */
+  TcpSocketState GetSocketState (void);
+  /**
+   * \brief Let the congestion control grow the window
+   * \param bytesAcked the data newly acknowledged
+   */
+  void IncreaseWindow (uint32_t bytesAcked);
+  /**
+   * \brief Change the congestion state and notify the congestion control
+   * \param state the new congestion state
+   */
+  void SetCongState (TcpCongState_t state);
 
 protected:
   TracedValue<uint32_t>  m_cWnd;         //!< Congestion window
@@ -84,6 +111,10 @@ protected:
   uint32_t               m_retxThresh;   //!< Fast Retransmit threshold
   bool                   m_inFastRec;    //!< currently in fast recovery
   bool                   m_limitedTx;    //!< perform limited transmit
+  TypeId                 m_congestionTypeId; //!< Type of the congestion control
+  Ptr<TcpCongestionOps>  m_congestionOps;    //!< Congestion control
+  TcpCongState_t         m_congState;    //!< Congestion state
+  SequenceNumber32       m_ecnRecover;   //!< Highest Tx seqnum when the window was reduced upon ECN
 };
 
 } // namespace ns3
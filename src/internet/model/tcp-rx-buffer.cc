@@ -114,9 +114,9 @@ TcpRxBuffer::MaxRxSequence (void) const
     { // No data allowed beyond FIN
       return m_finSeq;
     }
-  else if (m_data.size ())
+  else if (!m_data.IsEmpty ())
     { // No data allowed beyond Rx window allowed
-      return m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      return m_data.HeadSequence () + SequenceNumber32 (m_maxBuffer);
     }
   return m_nextRxSeq + SequenceNumber32 (m_maxBuffer);
 }
@@ -150,68 +150,36 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
 
   // Trim packet to fit Rx window specification
   if (headSeq < m_nextRxSeq) headSeq = m_nextRxSeq;
-  if (m_data.size ())
+  if (!m_data.IsEmpty ())
     {
-      SequenceNumber32 maxSeq = m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      SequenceNumber32 maxSeq = m_data.HeadSequence () + SequenceNumber32 (m_maxBuffer);
       if (maxSeq < tailSeq) tailSeq = maxSeq;
-      if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
-    {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
-        {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
-        }
-      ++i;
-    }
-  // We now know how much we are going to store, trim the packet
   if (headSeq >= tailSeq)
     {
       NS_LOG_LOGIC ("Nothing to buffer");
       return false; // Nothing to buffer anyway
     }
-  else
+  uint32_t start = headSeq - tcph.GetSequenceNumber ();
+  uint32_t length = tailSeq - headSeq;
+  if (length != pktSize)
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
       p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  // Insert the bytes not buffered yet; the overlapped ones are kept as they are
+  uint32_t added = m_data.Add (headSeq, p);
+  if (added == 0)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false;
     }
+  NS_LOG_LOGIC ("Buffered " << added << " bytes of packet of seqno=" << headSeq << " len=" << length);
+  m_lastRxSeq = headSeq;
+  // Update variables
+  m_size += added;      // Occupancy
+  SequenceNumber32 nextRxSeq = m_data.ContiguousEnd (m_nextRxSeq);
+  m_availBytes += nextRxSeq - m_nextRxSeq.Get ();
+  m_nextRxSeq = nextRxSeq;
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
     { // Account for the FIN packet
@@ -228,41 +196,30 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   uint32_t extractSize = std::min (maxSize, m_availBytes);
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
-  NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
-  while (extractSize)
-    { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
-      // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
-        { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
-        }
-      else
-        { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
-        }
-    }
-  if (outPkt->GetSize () == 0)
+  NS_ASSERT (!m_data.IsEmpty ()); // At least we have something to extract
+  SequenceNumber32 headSeq = m_data.HeadSequence ();
+  NS_ASSERT (headSeq <= m_nextRxSeq); // in-sequence data expected
+  Ptr<Packet> outPkt = m_data.Copy (headSeq, extractSize);
+  m_data.DiscardUpTo (headSeq + SequenceNumber32 (extractSize));
+  m_size -= extractSize;
+  m_availBytes -= extractSize;
+  NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size);
+  return outPkt;
+}
+
+std::list<TcpByteStore::Interval>
+TcpRxBuffer::GetSackList (void) const
+{
+  std::list<TcpByteStore::Interval> blocks = m_data.GetIntervals (m_nextRxSeq);
+  for (std::list<TcpByteStore::Interval>::iterator i = blocks.begin (); i != blocks.end (); ++i)
     {
-      NS_LOG_LOGIC ("Nothing extracted.");
-      return 0;
+      if (i->first <= m_lastRxSeq && m_lastRxSeq < i->second)
+        { // Report the most recently received block first
+          blocks.splice (blocks.begin (), blocks, i);
+          break;
+        }
     }
-  NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
-  return outPkt;
+  return blocks;
 }
 
 } //namepsace ns3
@@ -21,12 +21,13 @@
 #ifndef TCP_RX_BUFFER_H
 #define TCP_RX_BUFFER_H
 
-#include <map>
+#include <list>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-byte-store.h"
 
 namespace ns3 {
 class Packet;
@@ -124,16 +125,25 @@ public:
    * \returns a packet
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * \brief Get the out-of-order data held in the buffer, as SACK blocks
+   *
+   * As required by RFC 2018, the block holding the most recently received
+   * segment comes first, followed by the other blocks in sequence order.
+   *
+   * \returns the byte ranges received beyond NextRxSequence
+   */
+  std::list<TcpByteStore::Interval> GetSackList (void) const;
 public:
-  /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  SequenceNumber32 m_lastRxSeq;              //!< Seqnum of the most recently buffered byte
+  TcpByteStore m_data;                       //!< Corresponding data
 };
 
 } //namepsace ns3
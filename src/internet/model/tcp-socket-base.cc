@@ -41,6 +41,7 @@
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/segment-offload-tag.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
 #include "ipv4-end-point.h"
@@ -49,6 +50,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 
 #include <math.h>
@@ -96,6 +99,16 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable Selective Acknowledgment option (RFC 2018)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SegmentOffloadSize",
+                   "Maximum payload handed to IPv4 in a single super-segment "
+                   "(0 disables segmentation offload)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpSocketBase::m_offloadSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms. See http://www.postel.org/pipermail/end2end-interest/2004-November/004402.html
@@ -172,7 +185,16 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndScaleFactor (0),
     m_rcvScaleFactor (0),
     m_timestampEnabled (true),
-    m_timestampToEcho (0)
+    m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_sackRetxSeq (0),
+    m_offloadSize (0),
+    m_ecnEnabled (false),
+    m_ecnNegotiated (false),
+    m_ecnEchoEachCe (false),
+    m_ecnCeReceived (false),
+    m_ecnEchoReceived (false),
+    m_ecnCwrPending (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -213,7 +235,16 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndScaleFactor (sock.m_sndScaleFactor),
     m_rcvScaleFactor (sock.m_rcvScaleFactor),
     m_timestampEnabled (sock.m_timestampEnabled),
-    m_timestampToEcho (sock.m_timestampToEcho)
+    m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_sackRetxSeq (sock.m_sackRetxSeq),
+    m_offloadSize (sock.m_offloadSize),
+    m_ecnEnabled (sock.m_ecnEnabled),
+    m_ecnNegotiated (sock.m_ecnNegotiated),
+    m_ecnEchoEachCe (sock.m_ecnEchoEachCe),
+    m_ecnCeReceived (false),
+    m_ecnEchoReceived (false),
+    m_ecnCwrPending (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -937,6 +968,30 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port
 
   ReadOptions (tcpHeader);
 
+  if (m_ecnNegotiated)
+    {
+      m_ecnEchoReceived = tcpHeader.GetFlags () & TcpHeader::ECE;
+      bool ce = packet->GetSize () > 0 && header.GetEcn () == Ipv4Header::ECN_CE;
+      if (!m_ecnEchoEachCe)
+        { // The ACKs echo ECE from a CE mark until the sender answers
+          // with CWR (RFC 3168, sec. 6.1.3)
+          if (tcpHeader.GetFlags () & TcpHeader::CWR)
+            {
+              m_ecnCeReceived = false;
+            }
+          m_ecnCeReceived = m_ecnCeReceived || ce;
+        }
+      else if (packet->GetSize () > 0)
+        { // The ACKs echo the CE mark of the last data segment received
+          if (ce != m_ecnCeReceived && m_delAckCount > 0)
+            { // Acknowledge the data received so far with the previous
+              // state, so that the echo stays accurate (RFC 8257, sec. 3.2)
+              SendEmptyPacket (TcpHeader::ACK);
+            }
+          m_ecnCeReceived = ce;
+        }
+    }
+
   if (tcpHeader.GetFlags () & TcpHeader::ACK)
     {
       EstimateRtt (tcpHeader);
@@ -983,7 +1038,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port
       break;
     case CLOSED:
       // Send RST if the incoming packet is not a RST
-      if ((tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG)) != TcpHeader::RST)
+      if ((tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE)) != TcpHeader::RST)
         { // Since m_endPoint is not configured yet, we cannot use SendRST here
           TcpHeader h;
           h.SetFlags (TcpHeader::RST);
@@ -1041,6 +1096,11 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv6Header header, uint16_t port
 
   ReadOptions (tcpHeader);
 
+  if (m_ecnNegotiated)
+    { // CE marks are not carried over IPv6
+      m_ecnEchoReceived = tcpHeader.GetFlags () & TcpHeader::ECE;
+    }
+
   if (tcpHeader.GetFlags () & TcpHeader::ACK)
     {
       EstimateRtt (tcpHeader);
@@ -1087,7 +1147,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv6Header header, uint16_t port
       break;
     case CLOSED:
       // Send RST if the incoming packet is not a RST
-      if ((tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG)) != TcpHeader::RST)
+      if ((tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE)) != TcpHeader::RST)
         { // Since m_endPoint is not configured yet, we cannot use SendRST here
           TcpHeader h;
           h.SetFlags (TcpHeader::RST);
@@ -1129,8 +1189,9 @@ TcpSocketBase::ProcessEstablished (Ptr<Packet> packet, const TcpHeader& tcpHeade
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   // Different flags are different events
   if (tcpflags == TcpHeader::ACK)
@@ -1212,8 +1273,9 @@ TcpSocketBase::ProcessListen (Ptr<Packet> packet, const TcpHeader& tcpHeader,
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   // Fork a socket if received a SYN. Do nothing otherwise.
   // C.f.: the LISTEN part in tcp_v4_do_rcv() in tcp_ipv4.c in Linux kernel
@@ -1241,8 +1303,9 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   if (tcpflags == 0)
     { // Bare data, accept it and move to ESTABLISHED state. This is not a normal behaviour. Remove this?
@@ -1271,6 +1334,9 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
+      // The peer agrees on ECN with an ECE-setup SYN+ACK (RFC 3168, sec. 6.1.1)
+      m_ecnNegotiated = m_ecnEnabled
+        && (tcpHeader.GetFlags () & (TcpHeader::ECE | TcpHeader::CWR)) == TcpHeader::ECE;
       m_retxEvent.Cancel ();
       m_rxBuffer->SetNextRxSequence (tcpHeader.GetSequenceNumber () + SequenceNumber32 (1));
       m_highTxMark = ++m_nextTxSequence;
@@ -1300,8 +1366,9 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   if (tcpflags == 0
       || (tcpflags == TcpHeader::ACK
@@ -1389,8 +1456,9 @@ TcpSocketBase::ProcessWait (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   if (packet->GetSize () > 0 && tcpflags != TcpHeader::ACK)
     { // Bare data, accept it
@@ -1460,8 +1528,9 @@ TcpSocketBase::ProcessClosing (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   if (tcpflags == TcpHeader::ACK)
     {
@@ -1492,8 +1561,9 @@ TcpSocketBase::ProcessLastAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
-  // Extract the flags. PSH and URG are not honoured.
-  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG);
+  // Extract the flags. PSH and URG are not honoured, CWR and ECE are
+  // handled by DoForwardUp ().
+  uint8_t tcpflags = tcpHeader.GetFlags () & ~(TcpHeader::PSH | TcpHeader::URG | TcpHeader::CWR | TcpHeader::ECE);
 
   if (tcpflags == 0)
     {
@@ -1696,7 +1766,21 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
       ++s;
     }
 
-  header.SetFlags (flags);
+  uint8_t ecnFlags = 0;
+  if (flags == TcpHeader::SYN && m_ecnEnabled)
+    { // ECN-setup SYN
+      ecnFlags = TcpHeader::ECE | TcpHeader::CWR;
+    }
+  else if (flags == (TcpHeader::SYN | TcpHeader::ACK) && m_ecnNegotiated)
+    { // ECN-setup SYN+ACK
+      ecnFlags = TcpHeader::ECE;
+    }
+  else if ((flags & TcpHeader::ACK) && m_ecnNegotiated && m_ecnCeReceived)
+    {
+      ecnFlags = TcpHeader::ECE;
+    }
+
+  header.SetFlags (flags | ecnFlags);
   header.SetSequenceNumber (s);
   header.SetAckNumber (m_rxBuffer->NextRxSequence ());
   if (m_endPoint != 0)
@@ -1894,6 +1978,9 @@ TcpSocketBase::CompleteFork (Ptr<Packet> p, const TcpHeader& h,
   SetupCallback ();
   // Set the sequence number and send SYN+ACK
   m_rxBuffer->SetNextRxSequence (h.GetSequenceNumber () + SequenceNumber32 (1));
+  // The peer asks for ECN with an ECN-setup SYN (RFC 3168, sec. 6.1.1)
+  m_ecnNegotiated = m_ecnEnabled
+    && (h.GetFlags () & (TcpHeader::ECE | TcpHeader::CWR)) == (TcpHeader::ECE | TcpHeader::CWR);
 
   SendEmptyPacket (TcpHeader::SYN | TcpHeader::ACK);
 }
@@ -1924,10 +2011,20 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     {
       isRetransmission = true;
     }
+  else if (m_sackEnabled && seq < m_highTxMark)
+    { // SACK hole retransmission
+      isRetransmission = true;
+    }
 
   Ptr<Packet> p = m_txBuffer->CopyFromSequence (maxSize, seq);
   uint32_t sz = p->GetSize (); // Size of packet
   uint8_t flags = withAck ? TcpHeader::ACK : 0;
+  SegmentOffloadTag offloadTag;
+  p->RemovePacketTag (offloadTag); // Might come along with application data
+  if (sz > m_segmentSize)
+    { // Super-segment, see SendPendingData
+      p->AddPacketTag (SegmentOffloadTag (m_segmentSize, sz));
+    }
   uint32_t remainingData = m_txBuffer->SizeFromSequence (seq + SequenceNumber32 (sz));
 
   if (withAck)
@@ -1942,10 +2039,13 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
    * if both options are set. Once the packet got to layer three, only
    * the corresponding tags will be read.
    */
-  if (IsManualIpTos ())
+  // New data of an ECN connection is ECN-capable, retransmissions are not
+  // (RFC 3168, sec. 6.1.5)
+  bool isEcnCapable = m_ecnNegotiated && seq >= m_highTxMark;
+  if (IsManualIpTos () || isEcnCapable)
     {
       SocketIpTosTag ipTosTag;
-      ipTosTag.SetTos (GetIpTos ());
+      ipTosTag.SetTos (isEcnCapable ? (GetIpTos () & 0xfc) | Ipv4Header::ECN_ECT0 : GetIpTos ());
       p->AddPacketTag (ipTosTag);
     }
 
@@ -1970,6 +2070,16 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->AddPacketTag (ipHopLimitTag);
     }
 
+  if (isEcnCapable && m_ecnCwrPending)
+    { // Tell the receiver that the window has been reduced
+      flags |= TcpHeader::CWR;
+      m_ecnCwrPending = false;
+    }
+  if (withAck && m_ecnNegotiated && m_ecnCeReceived)
+    {
+      flags |= TcpHeader::ECE;
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -2097,6 +2207,18 @@ TcpSocketBase::SendPendingData (bool withAck)
           break;
         }
       uint32_t s = std::min (w, m_segmentSize);  // Send no more than window
+      if (m_offloadSize > m_segmentSize && m_endPoint != 0)
+        { // Segmentation offload: hand as many segments as allowed to IPv4 at once
+          s = std::min (w, m_offloadSize - m_offloadSize % m_segmentSize);
+          // As Linux does, defer a super-segment smaller than a third of the
+          // window while data is in flight: the next ACKs will enlarge it
+          if (s < m_offloadSize - m_offloadSize % m_segmentSize && s < Window () / 3
+              && UnAckDataCount () > 0 && m_txBuffer->SizeFromSequence (m_nextTxSequence) > s)
+            {
+              NS_LOG_LOGIC ("Deferring a super-segment of " << s << " bytes");
+              break;
+            }
+        }
       uint32_t sz = SendDataPacket (m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_nextTxSequence += sz;                     // Advance next tx sequence
@@ -2161,6 +2283,14 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
                 " ack " << tcpHeader.GetAckNumber () <<
                 " pkt size " << p->GetSize () );
 
+  // A super-segment received whole counts as all of its segments
+  uint32_t segments = 1;
+  SegmentOffloadTag offloadTag;
+  if (p->RemovePacketTag (offloadTag))
+    {
+      segments = offloadTag.GetSegmentCount ();
+    }
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer->NextRxSequence ();
   if (!m_rxBuffer->Add (p, tcpHeader))
@@ -2175,7 +2305,8 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      m_delAckCount += segments;
+      if (m_delAckCount >= m_delAckMaxCount)
         {
           m_delAckEvent.Cancel ();
           m_delAckCount = 0;
@@ -2251,6 +2382,7 @@ TcpSocketBase::EstimateRtt (const TcpHeader& tcpHeader)
       m_history.pop_front (); // Remove
     }
 
+  m_rttSample = m;
   if (!m.IsZero ())
     {
       m_rtt->Measurement (m);                // Log the measurement
@@ -2334,6 +2466,10 @@ TcpSocketBase::ReTxTimeout ()
       return;
     }
 
+  // The receiver may have discarded the SACKed data (RFC 2018, sec. 8)
+  m_txBuffer->ClearSackBlocks ();
+  m_sackRetxSeq = m_txBuffer->HeadSequence ();
+
   Retransmit ();
 }
 
@@ -2607,6 +2743,12 @@ TcpSocketBase::ReadOptions (const TcpHeader& header)
               ProcessOptionWScale (header.GetOption (TcpOption::WINSCALE));
             }
         }
+
+      m_sackEnabled = m_sackEnabled && header.HasOption (TcpOption::SACKPERMITTED);
+    }
+  else if (m_sackEnabled && header.HasOption (TcpOption::SACK))
+    {
+      ProcessOptionSack (header.GetOption (TcpOption::SACK));
     }
 
   m_timestampEnabled = false;
@@ -2633,6 +2775,18 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      if (header.GetFlags () & TcpHeader::SYN)
+        {
+          header.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+        }
+      else if (header.GetFlags () & TcpHeader::ACK)
+        {
+          AddOptionSack (header);
+        }
+    }
 }
 
 void
@@ -2727,6 +2881,72 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option)
+{
+  NS_LOG_FUNCTION (this << option);
+
+  Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (option);
+  TcpOptionSack::SackList list = sack->GetSackList ();
+  for (TcpOptionSack::SackList::const_iterator i = list.begin (); i != list.end (); ++i)
+    {
+      NS_LOG_INFO (m_node->GetId () << " Got SACK block [" << i->first << ", " << i->second << ")");
+      m_txBuffer->AddSackBlock (i->first, i->second);
+    }
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  std::list<TcpByteStore::Interval> blocks = m_rxBuffer->GetSackList ();
+  if (blocks.empty ())
+    {
+      return;
+    }
+  // Fit in the option space left by the other options
+  uint32_t optionSpace = 40 - (header.GetLength () * 4 - 20);
+  uint32_t maxBlocks = optionSpace < 10 ? 0 : (optionSpace - 2) / 8;
+  if (maxBlocks > TcpOptionSack::MAX_SACK_BLOCKS)
+    {
+      maxBlocks = TcpOptionSack::MAX_SACK_BLOCKS;
+    }
+  if (maxBlocks == 0)
+    {
+      return;
+    }
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (std::list<TcpByteStore::Interval>::const_iterator i = blocks.begin ();
+       i != blocks.end () && option->GetNumSackBlocks () < maxBlocks; ++i)
+    {
+      option->AddSackBlock (*i);
+    }
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " << option->GetNumSackBlocks () << " blocks");
+}
+
+bool
+TcpSocketBase::RetransmitSackHole (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_sackEnabled)
+    {
+      return false;
+    }
+  SequenceNumber32 holeStart;
+  uint32_t holeLength = m_txBuffer->NextHole (std::max (m_sackRetxSeq, m_txBuffer->HeadSequence ()), holeStart);
+  if (holeLength == 0)
+    {
+      return false;
+    }
+  uint32_t sz = SendDataPacket (holeStart, std::min (holeLength, m_segmentSize), true);
+  NS_LOG_INFO ("Retransmitted " << sz << " bytes of SACK hole at " << holeStart);
+  m_sackRetxSeq = holeStart + SequenceNumber32 (sz);
+  return sz > 0;
+}
+
 void
 TcpSocketBase::SetMinRto (Time minRto)
 {
@@ -675,6 +675,34 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Process the SACK option from the other side
+   *
+   * Record the selectively acknowledged blocks in the Tx buffer scoreboard.
+   *
+   * \param option Option from the packet
+   */
+  void ProcessOptionSack (const Ptr<const TcpOption> option);
+  /**
+   * \brief Add the SACK option to the header
+   *
+   * Report as many of the out-of-order blocks held in the Rx buffer as fit
+   * in the option space left, if any.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
+  /**
+   * \brief Retransmit one segment of the first hole reported by SACK
+   *
+   * Holes are retransmitted in sequence order, starting from m_sackRetxSeq
+   * so that each hole is retransmitted once per recovery episode.
+   *
+   * \returns true if a segment has been retransmitted
+   */
+  bool RetransmitSackHole (void);
+
 
 protected:
   // Counters and events
@@ -693,6 +721,7 @@ protected:
   Time              m_minRto;          //!< minimum value of the Retransmit timeout
   Time              m_clockGranularity; //!< Clock Granularity used in RTO calcs
   TracedValue<Time> m_lastRtt;         //!< Last RTT sample collected
+  Time              m_rttSample;       //!< RTT measured by the last ACK received (zero if none)
   Time              m_delAckTimeout;   //!< Time to delay an ACK
   Time              m_persistTimeout;  //!< Time between sending 1-byte probes
   Time              m_cnTimeout;       //!< Timeout for connection retry
@@ -736,6 +765,18 @@ protected:
 
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
+
+  bool             m_sackEnabled;  //!< SACK option enabled
+  SequenceNumber32 m_sackRetxSeq;  //!< Seqnum from which to look for SACK holes to retransmit
+
+  uint32_t m_offloadSize;          //!< Maximum payload of a super-segment (0 if segmentation offload is disabled)
+
+  bool m_ecnEnabled;       //!< ECN requested at connection setup (RFC 3168)
+  bool m_ecnNegotiated;    //!< ECN agreed upon by both ends
+  bool m_ecnEchoEachCe;    //!< Echo the CE mark of each data segment rather than until CWR
+  bool m_ecnCeReceived;    //!< Echo ECE on the ACKs
+  bool m_ecnEchoReceived;  //!< Segment being processed carries ECE
+  bool m_ecnCwrPending;    //!< Set CWR on the next new data segment
 };
 
 } // namespace ns3
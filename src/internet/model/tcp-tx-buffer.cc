@@ -57,7 +57,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768)
 {
 }
 
@@ -111,7 +111,7 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          m_data.Add (TailSequence (), p);
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -142,61 +142,14 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     {
       return Create<Packet> (); // Empty packet returned
     }
-  if (m_data.size () == 0)
+  if (m_data.IsEmpty ())
     { // No actual data, just return dummy-data packet of correct size
       return Create<Packet> (s);
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
-    {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
-        { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-        }
-      count += pktSize;
-    }
+  NS_LOG_LOGIC ("There are " << m_size << " bytes in buffer");
+  Ptr<Packet> outPacket = m_data.Copy (seq, s);
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
 }
@@ -205,6 +158,12 @@ void
 TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 {
   NS_LOG_FUNCTION (this << seq);
+  if (!m_data.IsEmpty () && m_firstByteSeq != seq)
+    { // Data was buffered before the connection was set up, renumber it
+      Ptr<Packet> p = m_data.Copy (m_firstByteSeq, m_size);
+      m_data.Clear ();
+      m_data.Add (seq, p);
+    }
   m_firstByteSeq = seq;
 }
 
@@ -212,45 +171,103 @@ void
 TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
 {
   NS_LOG_FUNCTION (this << seq);
-  NS_LOG_LOGIC ("current data size=" << m_size << ", headSeq=" << m_firstByteSeq << ", maxBuffer=" << m_maxBuffer
-                                     << ", numPkts=" << m_data.size ());
+  NS_LOG_LOGIC ("current data size=" << m_size << ", headSeq=" << m_firstByteSeq << ", maxBuffer=" << m_maxBuffer);
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
-  NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  m_size -= m_data.DiscardUpTo (seq);
+  // Also catches the case of ACKing a FIN, which is one byte past the data
+  m_firstByteSeq = seq;
+
+  // Drop the SACK blocks covered by the cumulative ACK
+  while (!m_sackedBlocks.empty () && m_sackedBlocks.begin ()->first < seq)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
+      SackScoreboard::iterator i = m_sackedBlocks.begin ();
+      SequenceNumber32 end = i->second;
+      m_sackedBlocks.erase (i);
+      if (end > seq)
+        {
+          m_sackedBlocks[seq] = end;
           break;
         }
     }
-  // Catching the case of ACKing a FIN
-  if (m_size == 0)
+  NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer);
+}
+
+void
+TcpTxBuffer::AddSackBlock (const SequenceNumber32& start, const SequenceNumber32& end)
+{
+  NS_LOG_FUNCTION (this << start << end);
+  SequenceNumber32 head = std::max (start, m_firstByteSeq.Get ());
+  SequenceNumber32 tail = std::min (end, TailSequence ());
+  if (head >= tail)
+    {
+      NS_LOG_LOGIC ("Ignoring SACK block outside of the buffered data");
+      return;
+    }
+  // Merge with the block starting before, if they overlap or touch
+  SackScoreboard::iterator i = m_sackedBlocks.upper_bound (head);
+  if (i != m_sackedBlocks.begin ())
+    {
+      SackScoreboard::iterator prev = i;
+      --prev;
+      if (prev->second >= head)
+        {
+          head = prev->first;
+          tail = std::max (tail, prev->second);
+          m_sackedBlocks.erase (prev);
+        }
+    }
+  // Merge with the blocks starting within
+  while (i != m_sackedBlocks.end () && i->first <= tail)
+    {
+      tail = std::max (tail, i->second);
+      m_sackedBlocks.erase (i++);
+    }
+  m_sackedBlocks[head] = tail;
+}
+
+void
+TcpTxBuffer::ClearSackBlocks (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sackedBlocks.clear ();
+}
+
+bool
+TcpTxBuffer::IsSacked (const SequenceNumber32& seq) const
+{
+  SackScoreboard::const_iterator i = m_sackedBlocks.upper_bound (seq);
+  if (i == m_sackedBlocks.begin ())
+    {
+      return false;
+    }
+  --i;
+  return seq < i->second;
+}
+
+uint32_t
+TcpTxBuffer::NextHole (const SequenceNumber32& seq, SequenceNumber32& holeStart) const
+{
+  NS_LOG_FUNCTION (this << seq);
+  SequenceNumber32 start = std::max (seq, m_firstByteSeq.Get ());
+  SackScoreboard::const_iterator i = m_sackedBlocks.upper_bound (start);
+  if (i != m_sackedBlocks.begin ())
+    {
+      SackScoreboard::const_iterator prev = i;
+      --prev;
+      if (prev->second > start)
+        { // Skip the block holding start
+          start = prev->second;
+        }
+    }
+  if (i == m_sackedBlocks.end ())
     {
-      m_firstByteSeq = seq;
+      return 0; // Nothing beyond start is known to be received
     }
-  NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
-                        <<" numPkts="<< m_data.size ());
-  NS_ASSERT (m_firstByteSeq == seq);
+  holeStart = start;
+  NS_LOG_LOGIC ("Hole [" << start << ", " << i->first << ")");
+  return i->first - start;
 }
 
 } // namepsace ns3
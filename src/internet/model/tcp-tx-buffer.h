@@ -21,12 +21,13 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <map>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
+#include "ns3/tcp-byte-store.h"
 
 namespace ns3 {
 class Packet;
@@ -127,14 +128,51 @@ public:
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  /**
+   * \brief Record a SACK block reported by the receiver (RFC 2018)
+   *
+   * The block is clipped to the buffered data and merged with the blocks
+   * already recorded.
+   *
+   * \param start sequence number of the first byte of the block
+   * \param end sequence number following the last byte of the block
+   */
+  void AddSackBlock (const SequenceNumber32& start, const SequenceNumber32& end);
+
+  /**
+   * \brief Forget all the SACK blocks, e.g., after a retransmission timeout
+   */
+  void ClearSackBlocks (void);
+
+  /**
+   * \brief Check whether a byte has been selectively acknowledged
+   * \param seq the sequence number of the byte
+   * \returns true if seq is in a recorded SACK block
+   */
+  bool IsSacked (const SequenceNumber32& seq) const;
+
+  /**
+   * \brief Find the first hole in the SACK scoreboard
+   *
+   * A hole is a range of bytes not selectively acknowledged which is
+   * followed by a selectively acknowledged one, so the receiver is known
+   * to be missing it.
+   *
+   * \param seq the first sequence number to consider
+   * \param holeStart [out] the sequence number of the first byte of the hole
+   * \returns the length of the hole in bytes, or 0 if there is no hole from seq on
+   */
+  uint32_t NextHole (const SequenceNumber32& seq, SequenceNumber32& holeStart) const;
+
 private:
-  /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  /// SACK scoreboard: start sequence number to end sequence number of each block
+  typedef std::map<SequenceNumber32, SequenceNumber32> SackScoreboard;
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  TcpByteStore m_data;                          //!< Corresponding data
+  SackScoreboard m_sackedBlocks;                //!< Blocks selectively acknowledged by the receiver
 };
 
 } // namepsace ns3
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "traffic-control-layer.h"
+#include "ns3/net-device-queue.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TrafficControlLayer");
+
+NS_OBJECT_ENSURE_REGISTERED (TrafficControlLayer);
+
+TypeId
+TrafficControlLayer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TrafficControlLayer")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TrafficControlLayer> ()
+  ;
+  return tid;
+}
+
+TrafficControlLayer::TrafficControlLayer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TrafficControlLayer::~TrafficControlLayer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TrafficControlLayer::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<QueueDisc> >::iterator i = m_rootQueueDiscs.begin (); i != m_rootQueueDiscs.end (); ++i)
+    {
+      if (*i != 0)
+        {
+          (*i)->Dispose ();
+        }
+    }
+  m_rootQueueDiscs.clear ();
+  Object::DoDispose ();
+}
+
+void
+TrafficControlLayer::SetRootQueueDiscOnDevice (Ptr<NetDevice> device, Ptr<QueueDisc> qDisc)
+{
+  NS_LOG_FUNCTION (this << device << qDisc);
+
+  Ptr<NetDeviceQueue> deviceQueue = device->GetObject<NetDeviceQueue> ();
+  if (deviceQueue == 0)
+    {
+      deviceQueue = CreateObject<NetDeviceQueue> ();
+      device->AggregateObject (deviceQueue);
+    }
+  deviceQueue->SetWakeCallback (MakeCallback (&QueueDisc::Run, qDisc));
+  qDisc->SetNetDevice (device);
+
+  uint32_t index = device->GetIfIndex ();
+  if (index >= m_rootQueueDiscs.size ())
+    {
+      m_rootQueueDiscs.resize (index + 1);
+    }
+  m_rootQueueDiscs[index] = qDisc;
+}
+
+Ptr<QueueDisc>
+TrafficControlLayer::GetRootQueueDiscOnDevice (Ptr<NetDevice> device) const
+{
+  uint32_t index = device->GetIfIndex ();
+  if (index >= m_rootQueueDiscs.size ())
+    {
+      return 0;
+    }
+  return m_rootQueueDiscs[index];
+}
+
+void
+TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << device << item);
+
+  Ptr<QueueDisc> qDisc = GetRootQueueDiscOnDevice (device);
+  if (qDisc == 0)
+    {
+      device->Send (item->GetPacket (), item->GetAddress (), item->GetProtocol ());
+      return;
+    }
+  qDisc->Enqueue (item);
+  qDisc->Run ();
+}
+
+} // namespace ns3
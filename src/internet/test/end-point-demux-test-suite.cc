@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Check the matching rules of Ipv4EndPointDemux::Lookup and the upkeep of
+// its lookup tables when end points change.
+// ===========================================================================
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Check IPv4 end point lookup and allocation")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer ("10.0.0.2");
+  Ipv4Address other ("10.0.0.3");
+  Ipv4EndPointDemux::EndPoints result;
+
+  Ipv4EndPoint *listener = demux.Allocate (80);
+  Ipv4EndPoint *boundListener = demux.Allocate (local, 80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Unable to allocate a listener");
+  NS_TEST_ASSERT_MSG_NE (boundListener, 0, "Unable to allocate a bound listener");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80), 0, "Duplicate local address and port allocated");
+
+  // Without a connection, the bound listener is the most exact match.
+  result = demux.Lookup (local, 80, peer, 1234, interface);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single listener");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), boundListener, "Expected the bound listener");
+  result = demux.Lookup (other, 80, peer, 1234, interface);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single listener");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), listener, "Expected the wildcard listener");
+
+  Ipv4EndPoint *connection = demux.Allocate (local, 80, peer, 1234);
+  NS_TEST_ASSERT_MSG_NE (connection, 0, "Unable to allocate a connection");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1234), 0, "Duplicate four-tuple allocated");
+  result = demux.Lookup (local, 80, peer, 1234, interface);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single connection");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), connection, "Expected the connection");
+  result = demux.Lookup (local, 80, peer, 1235, interface);
+  NS_TEST_EXPECT_MSG_EQ (result.front (), boundListener, "Expected the bound listener for another peer port");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), connection, "SimpleLookup missed the connection");
+
+  // A connected UDP socket changes the peer of an allocated end point.
+  Ipv4EndPoint *udp = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (udp, 0, "Unable to allocate an ephemeral end point");
+  uint16_t port = udp->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), true, "Ephemeral port not marked in use");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, other, 53, interface).size (), 1, "Unconnected end point not found");
+  udp->SetPeer (peer, 53);
+  result = demux.Lookup (local, port, peer, 53, interface);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Connected end point not found");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), udp, "Expected the connected end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, other, 53, interface).size (), 0, "Connected end point matched another peer");
+
+  Ipv4EndPoint *next = demux.Allocate ();
+  NS_TEST_EXPECT_MSG_NE (next->GetLocalPort (), port, "Ephemeral port allocated twice");
+
+  demux.DeAllocate (udp);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "Ephemeral port still marked in use");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, peer, 53, interface).size (), 0, "Deallocated end point found");
+
+  demux.DeAllocate (connection);
+  result = demux.Lookup (local, 80, peer, 1234, interface);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single listener");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), boundListener, "Expected the bound listener once the connection is gone");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, other, 1234), boundListener, "SimpleLookup missed the bound listener");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 3, "Unexpected number of end points");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().front (), listener, "End points not in allocation order");
+}
+
+// ===========================================================================
+// Same checks for Ipv6EndPointDemux.
+// ===========================================================================
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Check IPv6 end point lookup and allocation")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8::2");
+  Ipv6Address other ("2001:db8::3");
+  Ipv6EndPointDemux::EndPoints result;
+
+  Ipv6EndPoint *listener = demux.Allocate (80);
+  Ipv6EndPoint *boundListener = demux.Allocate (local, 80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Unable to allocate a listener");
+  NS_TEST_ASSERT_MSG_NE (boundListener, 0, "Unable to allocate a bound listener");
+
+  result = demux.Lookup (local, 80, peer, 1234, 0);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single listener");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), boundListener, "Expected the bound listener");
+  result = demux.Lookup (other, 80, peer, 1234, 0);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single listener");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), listener, "Expected the wildcard listener");
+
+  Ipv6EndPoint *connection = demux.Allocate (local, 80, peer, 1234);
+  NS_TEST_ASSERT_MSG_NE (connection, 0, "Unable to allocate a connection");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1234), 0, "Duplicate four-tuple allocated");
+  result = demux.Lookup (local, 80, peer, 1234, 0);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single connection");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), connection, "Expected the connection");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), connection, "SimpleLookup missed the connection");
+
+  Ipv6EndPoint *udp = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (udp, 0, "Unable to allocate an ephemeral end point");
+  uint16_t port = udp->GetLocalPort ();
+  udp->SetPeer (peer, 53);
+  result = demux.Lookup (local, port, peer, 53, 0);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Connected end point not found");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), udp, "Expected the connected end point");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, other, 53, 0).size (), 0, "Connected end point matched another peer");
+
+  udp->SetLocalPort (port + 1);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "Old local port still marked in use");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port + 1, peer, 53, 0).size (), 1, "End point not found on its new port");
+
+  demux.DeAllocate (udp);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port + 1), false, "Port still marked in use");
+  demux.DeAllocate (connection);
+  result = demux.Lookup (local, 80, peer, 1234, 0);
+  NS_TEST_ASSERT_MSG_EQ (result.size (), 1, "Expected a single listener");
+  NS_TEST_EXPECT_MSG_EQ (result.front (), boundListener, "Expected the bound listener once the connection is gone");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 2, "Unexpected number of end points");
+}
+
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite ()
+  : TestSuite ("end-point-demux", UNIT)
+{
+  AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+}
+
+static EndPointDemuxTestSuite endPointDemuxTestSuite;
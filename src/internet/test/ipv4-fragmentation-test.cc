@@ -30,6 +30,8 @@
 #include "ns3/simulator.h"
 #include "error-channel.h"
 #include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-interface-address.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/socket.h"
@@ -49,6 +51,7 @@
 #include "ns3/internet-stack-helper.h"
 
 #include <string>
+#include <cstring>
 #include <limits>
 #include <netinet/in.h>
 
@@ -453,11 +456,148 @@ Ipv4FragmentationTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+/**
+ * Feed fragments straight to Ipv4L3Protocol::Receive, out of order,
+ * overlapping and interleaved between packets, and check the reassembled
+ * packets and the reassembly timeout.
+ */
+class Ipv4ReassemblyTest : public TestCase
+{
+public:
+  Ipv4ReassemblyTest ();
+
+private:
+  virtual void DoRun (void);
+  void ReceiveFragment (uint16_t id, uint32_t offset, uint32_t size, bool last);
+  void LocalDeliver (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t iif);
+  void Drop (const Ipv4Header &header, Ptr<const Packet> packet, Ipv4L3Protocol::DropReason reason,
+             Ptr<Ipv4> ipv4, uint32_t iif);
+
+  Ptr<Ipv4L3Protocol> m_ipv4;
+  Ptr<SimpleNetDevice> m_device;
+  uint8_t m_data[3200];
+  std::vector<std::pair<uint16_t, uint32_t> > m_delivered;
+  std::vector<uint16_t> m_timedOut;
+};
+
+Ipv4ReassemblyTest::Ipv4ReassemblyTest ()
+  : TestCase ("Reassemble out of order and overlapping fragments")
+{
+}
+
+void
+Ipv4ReassemblyTest::ReceiveFragment (uint16_t id, uint32_t offset, uint32_t size, bool last)
+{
+  Ptr<Packet> fragment = Create<Packet> (m_data + offset, size);
+  Ipv4Header header;
+  header.SetSource (Ipv4Address ("10.0.0.2"));
+  header.SetDestination (Ipv4Address ("10.0.0.1"));
+  header.SetProtocol (253); // experimentation, no L4 protocol
+  header.SetIdentification (id);
+  header.SetFragmentOffset (offset);
+  if (last)
+    {
+      header.SetLastFragment ();
+    }
+  else
+    {
+      header.SetMoreFragments ();
+    }
+  header.SetPayloadSize (size);
+  header.SetTtl (64);
+  fragment->AddHeader (header);
+  m_ipv4->Receive (m_device, fragment, Ipv4L3Protocol::PROT_NUMBER,
+                   Mac48Address ("00:00:00:00:00:02"), m_device->GetAddress (), NetDevice::PACKET_HOST);
+}
+
+void
+Ipv4ReassemblyTest::LocalDeliver (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t iif)
+{
+  m_delivered.push_back (std::make_pair (header.GetIdentification (), packet->GetSize ()));
+  uint8_t buffer[3200];
+  if (packet->GetSize () <= sizeof (buffer))
+    {
+      packet->CopyData (buffer, packet->GetSize ());
+      NS_TEST_EXPECT_MSG_EQ (memcmp (buffer, m_data, packet->GetSize ()), 0, "Reassembled data is corrupted");
+    }
+}
+
+void
+Ipv4ReassemblyTest::Drop (const Ipv4Header &header, Ptr<const Packet> packet, Ipv4L3Protocol::DropReason reason,
+                          Ptr<Ipv4> ipv4, uint32_t iif)
+{
+  if (reason == Ipv4L3Protocol::DROP_FRAGMENT_TIMEOUT)
+    {
+      m_timedOut.push_back (header.GetIdentification ());
+    }
+}
+
+void
+Ipv4ReassemblyTest::DoRun (void)
+{
+  for (uint32_t i = 0; i < sizeof (m_data); i++)
+    {
+      m_data[i] = i % 251;
+    }
+
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  m_device = CreateObject<SimpleNetDevice> ();
+  m_device->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  node->AddDevice (m_device);
+  m_ipv4 = node->GetObject<Ipv4L3Protocol> ();
+  uint32_t interface = m_ipv4->AddInterface (m_device);
+  m_ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("255.255.255.0")));
+  m_ipv4->SetUp (interface);
+  m_ipv4->TraceConnectWithoutContext ("LocalDeliver", MakeCallback (&Ipv4ReassemblyTest::LocalDeliver, this));
+  m_ipv4->TraceConnectWithoutContext ("Drop", MakeCallback (&Ipv4ReassemblyTest::Drop, this));
+
+  // Packet 1: 4 fragments of 800 bytes, out of order, with a duplicate
+  // and an overlapping fragment, interleaved with packet 2
+  Simulator::Schedule (Seconds (1), &Ipv4ReassemblyTest::ReceiveFragment, this, 1, 1600, 800, false);
+  Simulator::Schedule (Seconds (1.1), &Ipv4ReassemblyTest::ReceiveFragment, this, 2, 800, 800, false);
+  Simulator::Schedule (Seconds (1.2), &Ipv4ReassemblyTest::ReceiveFragment, this, 1, 2400, 800, true);
+  Simulator::Schedule (Seconds (1.3), &Ipv4ReassemblyTest::ReceiveFragment, this, 1, 0, 800, false);
+  Simulator::Schedule (Seconds (1.4), &Ipv4ReassemblyTest::ReceiveFragment, this, 1, 0, 800, false);
+  Simulator::Schedule (Seconds (1.5), &Ipv4ReassemblyTest::ReceiveFragment, this, 1, 400, 800, false);
+  Simulator::Schedule (Seconds (1.6), &Ipv4ReassemblyTest::ReceiveFragment, this, 2, 1600, 400, true);
+  Simulator::Schedule (Seconds (1.7), &Ipv4ReassemblyTest::ReceiveFragment, this, 1, 1200, 400, false);
+  // Packet 2 misses its first fragment and times out 30 s after its
+  // first fragment, packet 3 10 s later
+  Simulator::Schedule (Seconds (11), &Ipv4ReassemblyTest::ReceiveFragment, this, 3, 1600, 800, true);
+  // Packet 4 completes in order, its timeout must not fire
+  Simulator::Schedule (Seconds (12), &Ipv4ReassemblyTest::ReceiveFragment, this, 4, 0, 1000, false);
+  Simulator::Schedule (Seconds (12.1), &Ipv4ReassemblyTest::ReceiveFragment, this, 4, 1000, 1000, false);
+  Simulator::Schedule (Seconds (12.2), &Ipv4ReassemblyTest::ReceiveFragment, this, 4, 2000, 1200, true);
+
+  Simulator::Stop (Seconds (32));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_delivered.size (), 2, "Packets 1 and 4 must be delivered once");
+  NS_TEST_EXPECT_MSG_EQ (m_delivered[0].first, 1, "Packet 1 must complete first");
+  NS_TEST_EXPECT_MSG_EQ (m_delivered[0].second, 3200, "Wrong size of packet 1");
+  NS_TEST_EXPECT_MSG_EQ (m_delivered[1].first, 4, "Packet 4 must complete second");
+  NS_TEST_EXPECT_MSG_EQ (m_delivered[1].second, 3200, "Wrong size of packet 4");
+  NS_TEST_ASSERT_MSG_EQ (m_timedOut.size (), 1, "Packet 2 must time out after 30 s");
+  NS_TEST_EXPECT_MSG_EQ (m_timedOut[0], 2, "Packet 2 must time out after 30 s");
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_delivered.size (), 2, "No other packet must be delivered");
+  NS_TEST_ASSERT_MSG_EQ (m_timedOut.size (), 2, "Packet 3 must time out after 30 s");
+  NS_TEST_EXPECT_MSG_EQ (m_timedOut[1], 3, "Packet 3 must time out after 30 s");
+
+  Simulator::Destroy ();
+  m_ipv4 = 0;
+  m_device = 0;
+}
+//-----------------------------------------------------------------------------
 class Ipv4FragmentationTestSuite : public TestSuite
 {
 public:
   Ipv4FragmentationTestSuite () : TestSuite ("ipv4-fragmentation", UNIT)
   {
     AddTestCase (new Ipv4FragmentationTest, TestCase::QUICK);
+    AddTestCase (new Ipv4ReassemblyTest, TestCase::QUICK);
   }
 } g_ipv4fragmentationTestSuite;
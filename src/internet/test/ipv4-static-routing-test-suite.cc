@@ -16,12 +16,17 @@
 
 // End-to-end tests for Ipv4 static routing
 
+#include <sstream>
+#include <vector>
+
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-route.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
 #include "ns3/packet.h"
@@ -179,6 +184,103 @@ Ipv4StaticRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+// Check longest prefix match, metric and ordering semantics of the
+// route lookup, including routes whose mask is not a prefix.
+class Ipv4StaticRoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLongestPrefixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ipv4Address Lookup (std::string dest, Ptr<NetDevice> oif = 0);
+
+  Ptr<Ipv4StaticRouting> m_routing;
+};
+
+Ipv4StaticRoutingLongestPrefixTestCase::Ipv4StaticRoutingLongestPrefixTestCase ()
+  : TestCase ("Longest prefix match of static routes")
+{
+}
+
+Ipv4Address
+Ipv4StaticRoutingLongestPrefixTestCase::Lookup (std::string dest, Ptr<NetDevice> oif)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (dest.c_str ()));
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = m_routing->RouteOutput (Create<Packet> (), header, oif, sockerr);
+  if (route == 0)
+    {
+      return Ipv4Address::GetAny ();
+    }
+  return route->GetGateway ();
+}
+
+void
+Ipv4StaticRoutingLongestPrefixTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+
+  std::vector<Ptr<NetDevice> > devices;
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      devices.push_back (device);
+      int32_t ifIndex = ipv4->AddInterface (device);
+      std::ostringstream oss;
+      oss << "10.0." << i << ".1";
+      ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address (oss.str ().c_str ()), Ipv4Mask ("/24")));
+      ipv4->SetUp (ifIndex);
+    }
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  m_routing = ipv4RoutingHelper.GetStaticRouting (ipv4);
+  uint32_t base = m_routing->GetNRoutes ();
+
+  m_routing->AddNetworkRouteTo (Ipv4Address ("192.168.0.0"), Ipv4Mask ("/16"), Ipv4Address ("10.0.1.2"), 1, 5);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("192.168.1.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.2.2"), 2, 5);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("192.168.1.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.3.2"), 3, 2);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("192.168.1.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.2.3"), 2, 2);
+  m_routing->SetDefaultRoute (Ipv4Address ("10.0.3.3"), 3);
+
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetNRoutes (), base + 5, "Unexpected number of routes");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetRoute (base + 1).GetGateway (), Ipv4Address ("10.0.2.2"), "Route order changed");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetMetric (base + 2), uint32_t (2), "Route order changed");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetDefaultRoute ().GetGateway (), Ipv4Address ("10.0.3.3"), "Wrong default route");
+
+  // longest prefix, then lowest metric, then the route added last
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.1.7"), Ipv4Address ("10.0.2.3"), "Wrong route for a /24 destination");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.1.7", devices[2]), Ipv4Address ("10.0.3.2"), "Output interface not honoured");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.1.7", devices[0]), Ipv4Address ("10.0.1.2"), "Output interface not honoured");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.2.1"), Ipv4Address ("10.0.1.2"), "Wrong route for a /16 destination");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("8.8.8.8"), Ipv4Address ("10.0.3.3"), "Wrong default route lookup");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.0.2.9"), Ipv4Address ("0.0.0.0"), "Wrong interface route lookup");
+
+  m_routing->RemoveRoute (base + 3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.1.7"), Ipv4Address ("10.0.3.2"), "Removed route still used");
+
+  // a mask which is not a prefix
+  m_routing->AddNetworkRouteTo (Ipv4Address ("172.0.5.0"), Ipv4Mask ("255.0.255.0"), Ipv4Address ("10.0.1.9"), 1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("172.99.5.1"), Ipv4Address ("10.0.1.9"), "Wrong route for a non-prefix mask");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.1.7"), Ipv4Address ("10.0.3.2"), "Wrong route while a non-prefix mask is present");
+  m_routing->RemoveRoute (m_routing->GetNRoutes () - 1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("172.99.5.1"), Ipv4Address ("10.0.3.3"), "Removed non-prefix route still used");
+
+  // bringing an interface down removes its routes
+  ipv4->SetDown (3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.1.7"), Ipv4Address ("10.0.2.2"), "Route through a down interface still used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("8.8.8.8"), Ipv4Address::GetAny (), "Default route through a down interface still used");
+
+  m_routing = 0;
+  Simulator::Destroy ();
+}
+
 class Ipv4StaticRoutingTestSuite : public TestSuite
 {
 public:
@@ -189,6 +291,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite ()
   : TestSuite ("ipv4-static-routing", UNIT)
 {
   AddTestCase (new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4StaticRoutingLongestPrefixTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-routing-table-entry.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6-static-routing-helper.h"
+#include "ns3/internet-stack-helper.h"
+
+using namespace ns3;
+
+/**
+ * \brief Check longest prefix match, metric and ordering semantics of the
+ * route lookup, including routes whose prefix is not contiguous.
+ */
+class Ipv6StaticRoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv6StaticRoutingLongestPrefixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ipv6Address Lookup (std::string dest, Ptr<NetDevice> oif = 0);
+
+  Ptr<Ipv6StaticRouting> m_routing;
+};
+
+Ipv6StaticRoutingLongestPrefixTestCase::Ipv6StaticRoutingLongestPrefixTestCase ()
+  : TestCase ("Longest prefix match of static routes")
+{
+}
+
+Ipv6Address
+Ipv6StaticRoutingLongestPrefixTestCase::Lookup (std::string dest, Ptr<NetDevice> oif)
+{
+  Ipv6Header header;
+  header.SetDestinationAddress (Ipv6Address (dest.c_str ()));
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv6Route> route = m_routing->RouteOutput (Create<Packet> (), header, oif, sockerr);
+  if (route == 0)
+    {
+      return Ipv6Address::GetAny ();
+    }
+  return route->GetGateway ();
+}
+
+void
+Ipv6StaticRoutingLongestPrefixTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+
+  std::vector<Ptr<NetDevice> > devices;
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      devices.push_back (device);
+      int32_t ifIndex = ipv6->AddInterface (device);
+      std::ostringstream oss;
+      oss << "2001:" << i << "::1";
+      ipv6->AddAddress (ifIndex, Ipv6InterfaceAddress (Ipv6Address (oss.str ().c_str ()), Ipv6Prefix (64)));
+      ipv6->SetUp (ifIndex);
+    }
+
+  Ipv6StaticRoutingHelper ipv6RoutingHelper;
+  m_routing = ipv6RoutingHelper.GetStaticRouting (ipv6);
+  uint32_t base = m_routing->GetNRoutes ();
+
+  m_routing->AddNetworkRouteTo (Ipv6Address ("2001:db8::"), Ipv6Prefix (32), Ipv6Address ("fe80::1"), 1, 5);
+  m_routing->AddNetworkRouteTo (Ipv6Address ("2001:db8:1::"), Ipv6Prefix (48), Ipv6Address ("fe80::2"), 2, 5);
+  m_routing->AddNetworkRouteTo (Ipv6Address ("2001:db8:1::"), Ipv6Prefix (48), Ipv6Address ("fe80::3"), 3, 2);
+  m_routing->AddNetworkRouteTo (Ipv6Address ("2001:db8:1::"), Ipv6Prefix (48), Ipv6Address ("fe80::4"), 2, 2);
+  m_routing->SetDefaultRoute (Ipv6Address ("fe80::5"), 3);
+
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetNRoutes (), base + 5, "Unexpected number of routes");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetRoute (base + 1).GetGateway (), Ipv6Address ("fe80::2"), "Route order changed");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetMetric (base + 2), uint32_t (2), "Route order changed");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetDefaultRoute ().GetGateway (), Ipv6Address ("fe80::5"), "Wrong default route");
+
+  // longest prefix, then lowest metric, then the route added last
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:1::7"), Ipv6Address ("fe80::4"), "Wrong route for a /48 destination");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:1::7", devices[2]), Ipv6Address ("fe80::3"), "Output interface not honoured");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:1::7", devices[0]), Ipv6Address ("fe80::1"), "Output interface not honoured");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:2::1"), Ipv6Address ("fe80::1"), "Wrong route for a /32 destination");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2002::1"), Ipv6Address ("fe80::5"), "Wrong default route lookup");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:2::9"), Ipv6Address::GetAny (), "Wrong interface route lookup");
+
+  m_routing->RemoveRoute (base + 3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:1::7"), Ipv6Address ("fe80::3"), "Removed route still used");
+
+  // a prefix which is not contiguous
+  m_routing->AddNetworkRouteTo (Ipv6Address ("2003:0:5::"), Ipv6Prefix ("ffff:0:ffff::"), Ipv6Address ("fe80::9"), 1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2003:99:5::1"), Ipv6Address ("fe80::9"), "Wrong route for a non-contiguous prefix");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:1::7"), Ipv6Address ("fe80::3"), "Wrong route while a non-contiguous prefix is present");
+  m_routing->RemoveRoute (m_routing->GetNRoutes () - 1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2003:99:5::1"), Ipv6Address ("fe80::5"), "Removed non-contiguous route still used");
+
+  // bringing an interface down removes its routes
+  ipv6->SetDown (3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("2001:db8:1::7"), Ipv6Address ("fe80::2"), "Route through a down interface still used");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetDefaultRoute ().GetGateway (), Ipv6Address::GetAny (), "Default route through a down interface still present");
+
+  m_routing = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief IPv6 static routing TestSuite
+ */
+class Ipv6StaticRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv6StaticRoutingTestSuite ();
+};
+
+Ipv6StaticRoutingTestSuite::Ipv6StaticRoutingTestSuite ()
+  : TestSuite ("ipv6-static-routing", UNIT)
+{
+  AddTestCase (new Ipv6StaticRoutingLongestPrefixTestCase, TestCase::QUICK);
+}
+
+static Ipv6StaticRoutingTestSuite g_ipv6StaticRoutingTestSuite;
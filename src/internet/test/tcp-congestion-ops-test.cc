@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-cubic.h"
+#include "ns3/tcp-dctcp.h"
+#include "ns3/tcp-bbr.h"
+
+#include <cmath>
+
+using namespace ns3;
+
+class TcpNewRenoOpsTestCase : public TestCase
+{
+public:
+  TcpNewRenoOpsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpNewRenoOpsTestCase::TcpNewRenoOpsTestCase ()
+  : TestCase ("Check the NewReno window updates of TcpCongestionOps")
+{
+}
+
+void
+TcpNewRenoOpsTestCase::DoRun (void)
+{
+  Ptr<TcpCongestionOps> ops = CreateObject<TcpCongestionOps> ();
+  TcpSocketState tcb;
+  tcb.m_segmentSize = 500;
+  tcb.m_cWnd = 1000;
+  tcb.m_ssThresh = 2000;
+
+  // Slow start: one segment per acknowledgment
+  ops->IncreaseWindow (tcb, 500);
+  NS_TEST_EXPECT_MSG_EQ (tcb.m_cWnd, 1500, "Slow start must add one segment");
+  ops->IncreaseWindow (tcb, 500);
+  NS_TEST_EXPECT_MSG_EQ (tcb.m_cWnd, 2000, "Slow start must add one segment");
+
+  // Congestion avoidance: segSize * segSize / cWnd per acknowledgment
+  ops->IncreaseWindow (tcb, 500);
+  NS_TEST_EXPECT_MSG_EQ (tcb.m_cWnd, 2125, "Congestion avoidance must add segSize^2/cwnd");
+
+  // Halve the data in flight, but never below two segments
+  NS_TEST_EXPECT_MSG_EQ (ops->GetSsThresh (tcb, 5000), 2500, "Unexpected slow start threshold");
+  NS_TEST_EXPECT_MSG_EQ (ops->GetSsThresh (tcb, 1000), 1000, "The threshold must be at least two segments");
+}
+
+class TcpCubicOpsTestCase : public TestCase
+{
+public:
+  TcpCubicOpsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Grow (Ptr<TcpCongestionOps> ops, TcpSocketState *tcb);
+};
+
+TcpCubicOpsTestCase::TcpCubicOpsTestCase ()
+  : TestCase ("Check the window reduction and growth of TcpCubic")
+{
+}
+
+void
+TcpCubicOpsTestCase::Grow (Ptr<TcpCongestionOps> ops, TcpSocketState *tcb)
+{
+  // Acknowledge one window of data over a 100 ms round trip time
+  uint32_t segments = tcb->m_cWnd / tcb->m_segmentSize;
+  for (uint32_t i = 0; i < segments; i++)
+    {
+      ops->PktsAcked (*tcb, tcb->m_segmentSize, MilliSeconds (100));
+      ops->IncreaseWindow (*tcb, tcb->m_segmentSize);
+    }
+}
+
+void
+TcpCubicOpsTestCase::DoRun (void)
+{
+  Ptr<TcpCongestionOps> ops = CreateObject<TcpCubic> ();
+  TcpSocketState tcb;
+  tcb.m_segmentSize = 1000;
+  tcb.m_cWnd = 100000;
+  tcb.m_ssThresh = 50000;
+
+  // Multiplicative decrease by beta = 0.7
+  tcb.m_ssThresh = ops->GetSsThresh (tcb, tcb.m_cWnd);
+  NS_TEST_EXPECT_MSG_EQ (tcb.m_ssThresh, 70000, "CUBIC must reduce the window to 0.7 cwnd");
+  tcb.m_cWnd = tcb.m_ssThresh;
+
+  // The window grows back towards W_max = 100 segments, concave at first
+  // and never beyond it before K = cbrt (100 * 0.3 / 0.4) = 4.2 s
+  uint32_t previous = tcb.m_cWnd;
+  for (uint32_t rtt = 1; rtt <= 20; rtt++)
+    {
+      Simulator::Schedule (MilliSeconds (100 * rtt), &TcpCubicOpsTestCase::Grow, this, ops, &tcb);
+    }
+  Simulator::Stop (MilliSeconds (2050));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_GT (tcb.m_cWnd, previous, "The window must grow after the reduction");
+  NS_TEST_EXPECT_MSG_LT (tcb.m_cWnd, 100000, "The window must stay below W_max before K");
+  NS_TEST_EXPECT_MSG_GT (tcb.m_cWnd, 90000, "The concave region must quickly approach W_max");
+  Simulator::Destroy ();
+
+  // Fast convergence: a loss below the previous W_max releases bandwidth
+  // (W_max = 90 * (1 + 0.7) / 2 = 76.5 segments), the window still being
+  // reduced by beta
+  tcb.m_cWnd = 90000;
+  tcb.m_ssThresh = ops->GetSsThresh (tcb, tcb.m_cWnd);
+  NS_TEST_EXPECT_MSG_EQ (tcb.m_ssThresh, static_cast<uint32_t> (90000 * 0.7), "CUBIC must reduce the window to 0.7 cwnd");
+  tcb.m_cWnd = tcb.m_ssThresh;
+  for (uint32_t rtt = 1; rtt <= 40; rtt++)
+    {
+      Simulator::Schedule (MilliSeconds (100 * rtt), &TcpCubicOpsTestCase::Grow, this, ops, &tcb);
+    }
+  Simulator::Stop (MilliSeconds (1050));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_LT (tcb.m_cWnd, 77000, "The window must plateau around the reduced W_max");
+  Simulator::Destroy ();
+}
+
+class TcpDctcpOpsTestCase : public TestCase
+{
+public:
+  TcpDctcpOpsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpDctcpOpsTestCase::TcpDctcpOpsTestCase ()
+  : TestCase ("Check the marked fraction estimate and window reduction of TcpDctcp")
+{
+}
+
+void
+TcpDctcpOpsTestCase::DoRun (void)
+{
+  Ptr<TcpDctcp> ops = CreateObject<TcpDctcp> ();
+  TcpSocketState tcb;
+  tcb.m_segmentSize = 1000;
+  tcb.m_cWnd = 10000;
+  tcb.m_ssThresh = 5000;
+  tcb.m_bytesInFlight = 10000;
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (ops->GetAlpha (), 1.0, 1e-9, "Alpha must start at AlphaOnInit");
+  NS_TEST_EXPECT_MSG_EQ (ops->GetSsThresh (tcb, tcb.m_bytesInFlight), 5000, "Alpha = 1 must halve the window");
+
+  // The first acknowledgment closes an empty observation window, then
+  // each window lasts the 10 segments in flight
+  tcb.m_ecnEcho = false;
+  ops->PktsAcked (tcb, 1000, MilliSeconds (10));
+  double expected = 15.0 / 16;
+  NS_TEST_EXPECT_MSG_EQ_TOL (ops->GetAlpha (), expected, 1e-9, "Unexpected alpha after an unmarked acknowledgment");
+
+  // A window where half the data is marked
+  for (uint32_t i = 0; i < 9; i++)
+    {
+      tcb.m_ecnEcho = (i % 2 == 0);
+      ops->PktsAcked (tcb, 1000, MilliSeconds (10));
+    }
+  expected = (15.0 / 16) * expected + (1.0 / 16) * (5.0 / 9);
+  NS_TEST_EXPECT_MSG_EQ_TOL (ops->GetAlpha (), expected, 1e-9, "Alpha must follow the marked fraction of the window");
+
+  // Unmarked windows make alpha decay geometrically
+  tcb.m_ecnEcho = false;
+  for (uint32_t window = 0; window < 20; window++)
+    {
+      for (uint32_t i = 0; i < 9; i++)
+        {
+          ops->PktsAcked (tcb, 1000, MilliSeconds (10));
+        }
+      expected *= 15.0 / 16;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (ops->GetAlpha (), expected, 1e-9, "Alpha must decay without marks");
+
+  uint32_t ssThresh = static_cast<uint32_t> (10000 * (1 - expected / 2));
+  NS_TEST_EXPECT_MSG_EQ (ops->GetSsThresh (tcb, tcb.m_bytesInFlight), ssThresh, "The reduction must be proportional to alpha");
+
+  // A forked instance keeps the estimate
+  Ptr<TcpDctcp> fork = DynamicCast<TcpDctcp> (ops->Fork ());
+  NS_TEST_ASSERT_MSG_NE (fork, 0, "Fork must return a TcpDctcp");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fork->GetAlpha (), expected, 1e-9, "The fork must copy alpha");
+}
+
+class TcpBbrOpsTestCase : public TestCase
+{
+public:
+  TcpBbrOpsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Ack (Ptr<TcpBbr> ops, TcpSocketState *tcb);
+};
+
+TcpBbrOpsTestCase::TcpBbrOpsTestCase ()
+  : TestCase ("Check the bandwidth and round trip time model of TcpBbr")
+{
+}
+
+void
+TcpBbrOpsTestCase::Ack (Ptr<TcpBbr> ops, TcpSocketState *tcb)
+{
+  tcb->m_bytesInFlight = tcb->m_cWnd;
+  ops->PktsAcked (*tcb, tcb->m_segmentSize, MilliSeconds (50));
+  ops->IncreaseWindow (*tcb, tcb->m_segmentSize);
+}
+
+void
+TcpBbrOpsTestCase::DoRun (void)
+{
+  Ptr<TcpBbr> ops = CreateObject<TcpBbr> ();
+  TcpSocketState tcb;
+  tcb.m_segmentSize = 1000;
+  tcb.m_cWnd = 10000;
+  tcb.m_ssThresh = 65535;
+
+  NS_TEST_EXPECT_MSG_EQ (ops->GetMode (), TcpBbr::STARTUP, "BBR must start in STARTUP");
+
+  // A 1 Mb/s bottleneck with a 50 ms round trip time: one 1000-byte
+  // segment acknowledged every 8 ms
+  for (uint32_t i = 1; i <= 1000; i++)
+    {
+      Simulator::Schedule (MilliSeconds (8 * i), &TcpBbrOpsTestCase::Ack, this, ops, &tcb);
+    }
+  Simulator::Stop (Seconds (8.5));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (ops->GetMinRtt (), MilliSeconds (50), "Unexpected minimum round trip time");
+  NS_TEST_EXPECT_MSG_EQ_TOL (ops->GetBandwidth (), 125000, 12500, "The bandwidth must match the acknowledgment rate");
+  NS_TEST_EXPECT_MSG_NE (ops->GetMode (), TcpBbr::STARTUP, "BBR must leave STARTUP once the bandwidth plateaus");
+  // The window is about gain * BDP + 3 segments, BDP being 6250 bytes
+  NS_TEST_EXPECT_MSG_LT (tcb.m_cWnd, 20000, "The window must track the bandwidth-delay product");
+  NS_TEST_EXPECT_MSG_GT (tcb.m_cWnd, 4 * tcb.m_segmentSize - 1, "The window must not fall below 4 segments");
+  Simulator::Destroy ();
+}
+
+class TcpCongestionOpsTestSuite : public TestSuite
+{
+public:
+  TcpCongestionOpsTestSuite ();
+};
+
+TcpCongestionOpsTestSuite::TcpCongestionOpsTestSuite ()
+  : TestSuite ("tcp-congestion-ops", UNIT)
+{
+  AddTestCase (new TcpNewRenoOpsTestCase, TestCase::QUICK);
+  AddTestCase (new TcpCubicOpsTestCase, TestCase::QUICK);
+  AddTestCase (new TcpDctcpOpsTestCase, TestCase::QUICK);
+  AddTestCase (new TcpBbrOpsTestCase, TestCase::QUICK);
+}
+
+static TcpCongestionOpsTestSuite g_tcpCongestionOpsTestSuite;
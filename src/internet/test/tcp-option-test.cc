@@ -22,6 +22,8 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/private/tcp-option-sack-permitted.h"
+#include "ns3/private/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +166,62 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t numBlocks);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_numBlocks;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t numBlocks)
+  : TestCase (name),
+    m_numBlocks (numBlocks)
+{
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  TcpOptionSack opt;
+  for (uint32_t i = 0; i < m_numBlocks; ++i)
+    {
+      opt.AddSackBlock (TcpOptionSack::SackBlock (SequenceNumber32 (1000 * i + 1),
+                                                  SequenceNumber32 (1000 * i + 501)));
+    }
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_numBlocks, "Wrong serialized size");
+
+  Buffer buffer;
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  Buffer::Iterator start = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (start.PeekU8 (), TcpOption::SACK, "Different kind found");
+
+  TcpOptionSack copy;
+  NS_TEST_EXPECT_MSG_EQ (copy.Deserialize (start), 2 + 8 * m_numBlocks, "Wrong deserialized size");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetNumSackBlocks (), m_numBlocks, "Different number of blocks found");
+  TcpOptionSack::SackList list = copy.GetSackList ();
+  uint32_t i = 0;
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it, ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (it->first, SequenceNumber32 (1000 * i + 1), "Different left edge found");
+      NS_TEST_EXPECT_MSG_EQ (it->second, SequenceNumber32 (1000 * i + 501), "Different right edge found");
+    }
+
+  TcpOptionSackPermitted permitted;
+  NS_TEST_EXPECT_MSG_EQ (permitted.GetSerializedSize (), 2, "Wrong SACK-permitted size");
+  Buffer permittedBuffer;
+  permittedBuffer.AddAtStart (permitted.GetSerializedSize ());
+  permitted.Serialize (permittedBuffer.Begin ());
+  NS_TEST_EXPECT_MSG_EQ (permittedBuffer.Begin ().PeekU8 (), TcpOption::SACKPERMITTED, "Different kind found");
+  NS_TEST_EXPECT_MSG_EQ (permitted.Deserialize (permittedBuffer.Begin ()), 2, "Wrong deserialized size");
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +234,11 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= 4; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing SACK option with "
+                                                "blocks", i), TestCase::QUICK);
+      }
   }
 
 } g_TcpOptionTestSuite;
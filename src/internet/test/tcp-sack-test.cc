@@ -0,0 +1,437 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/socket-factory.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/error-model.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/node.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/log.h"
+
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-byte-store.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <string.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackTestSuite");
+
+static Ptr<Packet>
+CreatePayload (uint32_t seq, uint32_t size)
+{
+  uint8_t *data = new uint8_t[size];
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = static_cast<uint8_t> (seq + i);
+    }
+  Ptr<Packet> p = Create<Packet> (data, size);
+  delete [] data;
+  return p;
+}
+
+static bool
+CheckPayload (Ptr<Packet> p, uint32_t seq)
+{
+  uint32_t size = p->GetSize ();
+  uint8_t *data = new uint8_t[size];
+  p->CopyData (data, size);
+  bool ok = true;
+  for (uint32_t i = 0; i < size && ok; ++i)
+    {
+      ok = (data[i] == static_cast<uint8_t> (seq + i));
+    }
+  delete [] data;
+  return ok;
+}
+
+// ===========================================================================
+// Out-of-order and overlapping data in a TcpByteStore
+// ===========================================================================
+class TcpByteStoreTestCase : public TestCase
+{
+public:
+  TcpByteStoreTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpByteStoreTestCase::TcpByteStoreTestCase ()
+  : TestCase ("Check the intervals of TcpByteStore")
+{
+}
+
+void
+TcpByteStoreTestCase::DoRun (void)
+{
+  TcpByteStore store;
+  NS_TEST_EXPECT_MSG_EQ (store.IsEmpty (), true, "A new store must be empty");
+
+  NS_TEST_EXPECT_MSG_EQ (store.Add (SequenceNumber32 (100), CreatePayload (100, 100)), 100, "First interval");
+  NS_TEST_EXPECT_MSG_EQ (store.Add (SequenceNumber32 (300), CreatePayload (300, 100)), 100, "Second interval");
+  // Overlaps the tail of the first interval and the head of the second one
+  NS_TEST_EXPECT_MSG_EQ (store.Add (SequenceNumber32 (150), CreatePayload (150, 200)), 100, "Only the gap must be added");
+  NS_TEST_EXPECT_MSG_EQ (store.Add (SequenceNumber32 (120), CreatePayload (120, 50)), 0, "Nothing new must be added");
+  NS_TEST_EXPECT_MSG_EQ (store.Add (SequenceNumber32 (500), CreatePayload (500, 50)), 50, "Third interval");
+  NS_TEST_EXPECT_MSG_EQ (store.Size (), 350, "Unexpected size");
+  NS_TEST_EXPECT_MSG_EQ (store.HeadSequence (), SequenceNumber32 (100), "Unexpected head");
+
+  NS_TEST_EXPECT_MSG_EQ (store.ContiguousEnd (SequenceNumber32 (100)), SequenceNumber32 (400), "Unexpected contiguous end");
+  NS_TEST_EXPECT_MSG_EQ (store.ContiguousEnd (SequenceNumber32 (450)), SequenceNumber32 (450), "Byte 450 is not stored");
+
+  std::list<TcpByteStore::Interval> intervals = store.GetIntervals (SequenceNumber32 (200));
+  NS_TEST_ASSERT_MSG_EQ (intervals.size (), 2, "Unexpected number of intervals");
+  NS_TEST_EXPECT_MSG_EQ (intervals.front ().first, SequenceNumber32 (200), "First interval must be clipped");
+  NS_TEST_EXPECT_MSG_EQ (intervals.front ().second, SequenceNumber32 (400), "First interval must be merged");
+  NS_TEST_EXPECT_MSG_EQ (intervals.back ().first, SequenceNumber32 (500), "Unexpected second interval");
+
+  Ptr<Packet> p = store.Copy (SequenceNumber32 (110), 280);
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 280, "Unexpected copy size");
+  NS_TEST_EXPECT_MSG_EQ (CheckPayload (p, 110), true, "Unexpected copied data");
+
+  NS_TEST_EXPECT_MSG_EQ (store.DiscardUpTo (SequenceNumber32 (175)), 75, "Unexpected discarded bytes");
+  NS_TEST_EXPECT_MSG_EQ (store.HeadSequence (), SequenceNumber32 (175), "Unexpected head after discard");
+  NS_TEST_EXPECT_MSG_EQ (CheckPayload (store.Copy (SequenceNumber32 (175), 225), 175), true, "Unexpected data after discard");
+  NS_TEST_EXPECT_MSG_EQ (store.DiscardUpTo (SequenceNumber32 (600)), 275, "Unexpected discarded bytes");
+  NS_TEST_EXPECT_MSG_EQ (store.IsEmpty (), true, "The store must be empty");
+}
+
+// ===========================================================================
+// SACK blocks reported by the receive buffer
+// ===========================================================================
+class TcpSackRxBufferTestCase : public TestCase
+{
+public:
+  TcpSackRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void AddSegment (Ptr<TcpRxBuffer> buffer, uint32_t seq, uint32_t size);
+};
+
+TcpSackRxBufferTestCase::TcpSackRxBufferTestCase ()
+  : TestCase ("Check the SACK blocks of TcpRxBuffer")
+{
+}
+
+void
+TcpSackRxBufferTestCase::AddSegment (Ptr<TcpRxBuffer> buffer, uint32_t seq, uint32_t size)
+{
+  TcpHeader header;
+  header.SetSequenceNumber (SequenceNumber32 (seq));
+  buffer->Add (CreatePayload (seq, size), header);
+}
+
+void
+TcpSackRxBufferTestCase::DoRun (void)
+{
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> (1);
+  buffer->SetMaxBufferSize (10000);
+
+  AddSegment (buffer, 1, 100);
+  NS_TEST_EXPECT_MSG_EQ (buffer->GetSackList ().empty (), true, "In-order data must not be reported");
+
+  AddSegment (buffer, 401, 100);
+  AddSegment (buffer, 201, 100);
+  std::list<TcpByteStore::Interval> blocks = buffer->GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 2, "Unexpected number of SACK blocks");
+  NS_TEST_EXPECT_MSG_EQ (blocks.front ().first, SequenceNumber32 (201), "The most recent block must come first");
+  NS_TEST_EXPECT_MSG_EQ (blocks.back ().first, SequenceNumber32 (401), "Unexpected second block");
+  NS_TEST_EXPECT_MSG_EQ (buffer->Available (), 100, "Only in-order data is available");
+
+  AddSegment (buffer, 101, 100);
+  blocks = buffer->GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 1, "Unexpected number of SACK blocks");
+  NS_TEST_EXPECT_MSG_EQ (blocks.front ().first, SequenceNumber32 (401), "Unexpected block");
+  NS_TEST_EXPECT_MSG_EQ (blocks.front ().second, SequenceNumber32 (501), "Unexpected block");
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextRxSequence (), SequenceNumber32 (301), "Unexpected next sequence");
+  NS_TEST_EXPECT_MSG_EQ (buffer->Available (), 300, "Unexpected available data");
+
+  Ptr<Packet> p = buffer->Extract (250);
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 250, "Unexpected extracted size");
+  NS_TEST_EXPECT_MSG_EQ (CheckPayload (p, 1), true, "Unexpected extracted data");
+  NS_TEST_EXPECT_MSG_EQ (buffer->Size (), 150, "Unexpected occupancy");
+
+  AddSegment (buffer, 251, 250);
+  NS_TEST_EXPECT_MSG_EQ (buffer->GetSackList ().empty (), true, "The hole has been filled");
+  p = buffer->Extract (1000);
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 250, "Unexpected extracted size");
+  NS_TEST_EXPECT_MSG_EQ (CheckPayload (p, 251), true, "Unexpected extracted data");
+}
+
+// ===========================================================================
+// SACK scoreboard of the transmission buffer
+// ===========================================================================
+class TcpSackScoreboardTestCase : public TestCase
+{
+public:
+  TcpSackScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpSackScoreboardTestCase::TcpSackScoreboardTestCase ()
+  : TestCase ("Check the SACK scoreboard of TcpTxBuffer")
+{
+}
+
+void
+TcpSackScoreboardTestCase::DoRun (void)
+{
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (1);
+  buffer->SetMaxBufferSize (10000);
+  buffer->Add (CreatePayload (1, 600));
+  buffer->Add (CreatePayload (601, 400));
+
+  SequenceNumber32 holeStart;
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextHole (SequenceNumber32 (1), holeStart), 0, "No hole without SACK blocks");
+
+  buffer->AddSackBlock (SequenceNumber32 (201), SequenceNumber32 (301));
+  buffer->AddSackBlock (SequenceNumber32 (401), SequenceNumber32 (501));
+  buffer->AddSackBlock (SequenceNumber32 (701), SequenceNumber32 (2001));
+  NS_TEST_EXPECT_MSG_EQ (buffer->IsSacked (SequenceNumber32 (250)), true, "Byte 250 has been SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer->IsSacked (SequenceNumber32 (301)), false, "Byte 301 has not been SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer->IsSacked (SequenceNumber32 (1000)), true, "Byte 1000 has been SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer->IsSacked (SequenceNumber32 (1001)), false, "Blocks are clipped to the data");
+
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextHole (SequenceNumber32 (1), holeStart), 200, "Unexpected first hole");
+  NS_TEST_EXPECT_MSG_EQ (holeStart, SequenceNumber32 (1), "Unexpected first hole");
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextHole (SequenceNumber32 (250), holeStart), 100, "Unexpected second hole");
+  NS_TEST_EXPECT_MSG_EQ (holeStart, SequenceNumber32 (301), "Unexpected second hole");
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextHole (SequenceNumber32 (701), holeStart), 0, "No hole after the last block");
+
+  // Filling the second hole merges the first two blocks
+  buffer->AddSackBlock (SequenceNumber32 (301), SequenceNumber32 (401));
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextHole (SequenceNumber32 (201), holeStart), 200, "Unexpected hole after merge");
+  NS_TEST_EXPECT_MSG_EQ (holeStart, SequenceNumber32 (501), "Unexpected hole after merge");
+
+  // A cumulative ACK in the middle of a block
+  buffer->DiscardUpTo (SequenceNumber32 (251));
+  NS_TEST_EXPECT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (251), "Unexpected head");
+  NS_TEST_EXPECT_MSG_EQ (buffer->NextHole (SequenceNumber32 (1), holeStart), 200, "Unexpected hole after ACK");
+  NS_TEST_EXPECT_MSG_EQ (holeStart, SequenceNumber32 (501), "Unexpected hole after ACK");
+  NS_TEST_EXPECT_MSG_EQ (CheckPayload (buffer->CopyFromSequence (536, SequenceNumber32 (501)), 501), true,
+                         "Unexpected retransmitted data");
+
+  buffer->ClearSackBlocks ();
+  NS_TEST_EXPECT_MSG_EQ (buffer->IsSacked (SequenceNumber32 (800)), false, "The scoreboard has been cleared");
+}
+
+// ===========================================================================
+// Bulk transfer with several losses in the same window
+// ===========================================================================
+class TcpSackTransferTestCase : public TestCase
+{
+public:
+  TcpSackTransferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Time RunTransfer (bool sack);
+
+  void ServerHandleConnectionCreated (Ptr<Socket> s, const Address & addr);
+  void ServerHandleRecv (Ptr<Socket> sock);
+  void SourceHandleSend (Ptr<Socket> sock, uint32_t available);
+
+  Ptr<Node> CreateInternetNode (void);
+  Ptr<SimpleNetDevice> AddSimpleNetDevice (Ptr<Node> node, const char* ipaddr, const char* netmask);
+
+  uint32_t m_totalBytes;
+  uint32_t m_sourceTxBytes;
+  uint32_t m_serverRxBytes;
+  bool m_dataOk;
+  Time m_lastRx;
+};
+
+TcpSackTransferTestCase::TcpSackTransferTestCase ()
+  : TestCase ("Check a bulk transfer recovering from several losses with SACK"),
+    m_totalBytes (200000)
+{
+}
+
+void
+TcpSackTransferTestCase::ServerHandleConnectionCreated (Ptr<Socket> s, const Address & addr)
+{
+  s->SetRecvCallback (MakeCallback (&TcpSackTransferTestCase::ServerHandleRecv, this));
+}
+
+void
+TcpSackTransferTestCase::ServerHandleRecv (Ptr<Socket> sock)
+{
+  Ptr<Packet> p;
+  while ((p = sock->Recv ()) != 0 && p->GetSize () > 0)
+    {
+      m_dataOk = m_dataOk && CheckPayload (p, m_serverRxBytes);
+      m_serverRxBytes += p->GetSize ();
+      m_lastRx = Simulator::Now ();
+    }
+}
+
+void
+TcpSackTransferTestCase::SourceHandleSend (Ptr<Socket> sock, uint32_t available)
+{
+  while (m_sourceTxBytes < m_totalBytes && sock->GetTxAvailable () > 0)
+    {
+      uint32_t toSend = std::min (std::min (1000u, m_totalBytes - m_sourceTxBytes), sock->GetTxAvailable ());
+      int sent = sock->Send (CreatePayload (m_sourceTxBytes, toSend));
+      if (sent <= 0)
+        {
+          break;
+        }
+      m_sourceTxBytes += sent;
+    }
+}
+
+Ptr<Node>
+TcpSackTransferTestCase::CreateInternetNode ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  //ARP
+  Ptr<ArpL3Protocol> arp = CreateObject<ArpL3Protocol> ();
+  node->AggregateObject (arp);
+  //IPV4
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  //Routing for Ipv4
+  Ptr<Ipv4ListRouting> ipv4Routing = CreateObject<Ipv4ListRouting> ();
+  ipv4->SetRoutingProtocol (ipv4Routing);
+  Ptr<Ipv4StaticRouting> ipv4staticRouting = CreateObject<Ipv4StaticRouting> ();
+  ipv4Routing->AddRoutingProtocol (ipv4staticRouting, 0);
+  node->AggregateObject (ipv4);
+  //ICMP
+  Ptr<Icmpv4L4Protocol> icmp = CreateObject<Icmpv4L4Protocol> ();
+  node->AggregateObject (icmp);
+  //UDP
+  Ptr<UdpL4Protocol> udp = CreateObject<UdpL4Protocol> ();
+  node->AggregateObject (udp);
+  //TCP
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+  node->AggregateObject (tcp);
+  return node;
+}
+
+Ptr<SimpleNetDevice>
+TcpSackTransferTestCase::AddSimpleNetDevice (Ptr<Node> node, const char* ipaddr, const char* netmask)
+{
+  Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+  dev->SetAddress (Mac48Address::ConvertFrom (Mac48Address::Allocate ()));
+  dev->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+  node->AddDevice (dev);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  uint32_t ndid = ipv4->AddInterface (dev);
+  Ipv4InterfaceAddress ipv4Addr = Ipv4InterfaceAddress (Ipv4Address (ipaddr), Ipv4Mask (netmask));
+  ipv4->AddAddress (ndid, ipv4Addr);
+  ipv4->SetUp (ndid);
+  return dev;
+}
+
+Time
+TcpSackTransferTestCase::RunTransfer (bool sack)
+{
+  m_sourceTxBytes = 0;
+  m_serverRxBytes = 0;
+  m_dataOk = true;
+  m_lastRx = Seconds (0);
+
+  const char* netmask = "255.255.255.0";
+  const char* ipaddr0 = "192.168.1.1";
+  const char* ipaddr1 = "192.168.1.2";
+  Ptr<Node> node0 = CreateInternetNode ();
+  Ptr<Node> node1 = CreateInternetNode ();
+  Ptr<SimpleNetDevice> dev0 = AddSimpleNetDevice (node0, ipaddr0, netmask);
+  Ptr<SimpleNetDevice> dev1 = AddSimpleNetDevice (node1, ipaddr1, netmask);
+
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (20)));
+  dev0->SetChannel (channel);
+  dev1->SetChannel (channel);
+
+  // Several data segments of the same window are lost on their way to the server
+  Ptr<ReceiveListErrorModel> em = CreateObject<ReceiveListErrorModel> ();
+  std::list<uint32_t> drops;
+  drops.push_back (40);
+  drops.push_back (43);
+  drops.push_back (46);
+  drops.push_back (49);
+  em->SetList (drops);
+  dev0->SetReceiveErrorModel (em);
+
+  Ptr<Socket> server = node0->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  Ptr<Socket> source = node1->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  server->SetAttribute ("Sack", BooleanValue (sack));
+  source->SetAttribute ("Sack", BooleanValue (sack));
+
+  uint16_t port = 50000;
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr< Socket >, const Address &> (),
+                             MakeCallback (&TcpSackTransferTestCase::ServerHandleConnectionCreated, this));
+
+  source->SetSendCallback (MakeCallback (&TcpSackTransferTestCase::SourceHandleSend, this));
+  source->Connect (InetSocketAddress (Ipv4Address (ipaddr0), port));
+
+  Simulator::Stop (Seconds (60));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_sourceTxBytes, m_totalBytes, "Source sent all bytes (sack=" << sack << ")");
+  NS_TEST_EXPECT_MSG_EQ (m_serverRxBytes, m_totalBytes, "Server received all bytes (sack=" << sack << ")");
+  NS_TEST_EXPECT_MSG_EQ (m_dataOk, true, "Server received expected data (sack=" << sack << ")");
+  return m_lastRx;
+}
+
+void
+TcpSackTransferTestCase::DoRun (void)
+{
+  Time newReno = RunTransfer (false);
+  Time sack = RunTransfer (true);
+  NS_LOG_INFO ("Transfer completed at " << newReno.GetSeconds () << " s without SACK, "
+               << sack.GetSeconds () << " s with SACK");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (sack, newReno, "SACK must not recover more slowly than NewReno");
+}
+
+class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ();
+};
+
+TcpSackTestSuite::TcpSackTestSuite ()
+  : TestSuite ("tcp-sack", UNIT)
+{
+  AddTestCase (new TcpByteStoreTestCase, TestCase::QUICK);
+  AddTestCase (new TcpSackRxBufferTestCase, TestCase::QUICK);
+  AddTestCase (new TcpSackScoreboardTestCase, TestCase::QUICK);
+  AddTestCase (new TcpSackTransferTestCase, TestCase::QUICK);
+}
+
+static TcpSackTestSuite g_tcpSackTestSuite;
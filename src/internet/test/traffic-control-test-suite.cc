@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/prio-queue-disc.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/pie-queue-disc.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/udp-header.h"
+#include "ns3/ecn-tag.h"
+#include "ns3/mac48-address.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \param tos the Type of Service byte
+ * \param srcPort the UDP source port
+ * \param ecnCapable true to tag the packet as ECN-capable
+ * \returns an IPv4/UDP packet of 1028 bytes
+ */
+static Ptr<QueueDiscItem>
+CreateItem (uint8_t tos, uint16_t srcPort, bool ecnCapable = false)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (srcPort);
+  udpHeader.SetDestinationPort (9);
+  p->AddHeader (udpHeader);
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (17);
+  ipHeader.SetTos (tos);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  p->AddHeader (ipHeader);
+  if (ecnCapable)
+    {
+      p->AddPacketTag (EcnTag (EcnTag::ECT0));
+    }
+  return Create<QueueDiscItem> (p, Mac48Address ("00:00:00:00:00:01"), Ipv4L3Protocol::PROT_NUMBER);
+}
+
+// Strict priority between the bands chosen from the TOS byte
+class PrioQueueDiscTestCase : public TestCase
+{
+public:
+  PrioQueueDiscTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+PrioQueueDiscTestCase::PrioQueueDiscTestCase ()
+  : TestCase ("Check the classification, strict priority and limit of PrioQueueDisc")
+{
+}
+
+void
+PrioQueueDiscTestCase::DoRun (void)
+{
+  Ptr<PrioQueueDisc> qDisc = CreateObjectWithAttributes<PrioQueueDisc> ("Limit", UintegerValue (2));
+
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Classify (0x10), 0, "Low delay goes to band 0");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Classify (0x00), 1, "Best effort goes to band 1");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Classify (0x08), 2, "High throughput goes to band 2");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Classify (0x03), 1, "The ECN bits do not change the band");
+
+  Ptr<QueueDiscItem> bulk = CreateItem (0x08, 1);
+  Ptr<QueueDiscItem> bestEffort = CreateItem (0x00, 2);
+  Ptr<QueueDiscItem> interactive = CreateItem (0x10, 3);
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Enqueue (bulk), true, "Enqueue in band 2");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Enqueue (CreateItem (0x08, 1)), true, "Enqueue in band 2");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Enqueue (CreateItem (0x08, 1)), false, "Band 2 is full");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Enqueue (bestEffort), true, "Enqueue in band 1");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Enqueue (interactive), true, "Enqueue in band 0");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNPackets (), 4, "Four packets held");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNBytes (), 4 * 1028, "Four packets held");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNPacketsInBand (2), 2, "Two packets in band 2");
+
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Dequeue (), interactive, "Band 0 first");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Dequeue (), bestEffort, "Band 1 next");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Dequeue (), bulk, "Band 2 last");
+  qDisc->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Dequeue (), 0, "Empty");
+
+  QueueDisc::Stats stats = qDisc->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.nTotalReceivedPackets, 5, "Five packets received");
+  NS_TEST_EXPECT_MSG_EQ (stats.nTotalDroppedPackets, 1, "One packet dropped");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNPackets (), 0, "No packet held");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNBytes (), 0, "No byte held");
+}
+
+// Flow queueing: a sparse flow overtakes a bulk flow, and the fattest flow
+// pays for overflows
+class FqCoDelQueueDiscSchedulingTestCase : public TestCase
+{
+public:
+  FqCoDelQueueDiscSchedulingTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FqCoDelQueueDiscSchedulingTestCase::FqCoDelQueueDiscSchedulingTestCase ()
+  : TestCase ("Check the deficit round robin and the overflow drops of FqCoDelQueueDisc")
+{
+}
+
+void
+FqCoDelQueueDiscSchedulingTestCase::DoRun (void)
+{
+  Ptr<FqCoDelQueueDisc> qDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("PacketLimit", UintegerValue (10));
+
+  uint32_t bulkFlow = qDisc->Classify (CreateItem (0, 1));
+  uint32_t sparseFlow = qDisc->Classify (CreateItem (0, 2));
+  NS_TEST_ASSERT_MSG_NE (bulkFlow, sparseFlow, "The flows must hash to different queues");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Classify (CreateItem (0x10, 1)), bulkFlow, "The TOS byte does not change the flow");
+
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      qDisc->Enqueue (CreateItem (0, 1));
+    }
+  Ptr<QueueDiscItem> sparse = CreateItem (0, 2);
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Enqueue (sparse), true, "The sparse packet is accepted");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNPackets (), 10, "The limit is enforced");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNPacketsInFlow (bulkFlow), 9, "The bulk flow pays for the overflow");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetStats ().nTotalDroppedPackets, 1, "One packet dropped");
+
+  // The bulk flow sends its quantum (two packets of 1028 bytes for 1514
+  // bytes), then the sparse flow goes ahead of the rest of the bulk flow
+  NS_TEST_EXPECT_MSG_NE (qDisc->Dequeue (), sparse, "Bulk flow first");
+  NS_TEST_EXPECT_MSG_NE (qDisc->Dequeue (), sparse, "Bulk flow again, within its quantum");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->Dequeue (), sparse, "Sparse flow next");
+  uint32_t n = 0;
+  while (qDisc->Dequeue () != 0)
+    {
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 7, "The rest of the bulk flow");
+  NS_TEST_EXPECT_MSG_EQ (qDisc->GetNBytes (), 0, "No byte held");
+}
+
+// Per-flow CoDel: a standing queue is dropped, or marked with ECN
+class FqCoDelQueueDiscCoDelTestCase : public TestCase
+{
+public:
+  /**
+   * \param useEcn true to mark instead of dropping
+   */
+  FqCoDelQueueDiscCoDelTestCase (bool useEcn);
+private:
+  virtual void DoRun (void);
+  /// Dequeue a packet, and schedule the next dequeue while packets are held
+  void Dequeue (void);
+
+  bool m_useEcn;
+  Ptr<FqCoDelQueueDisc> m_qDisc;
+};
+
+FqCoDelQueueDiscCoDelTestCase::FqCoDelQueueDiscCoDelTestCase (bool useEcn)
+  : TestCase (std::string ("Check the CoDel ") + (useEcn ? "marks" : "drops") + " of FqCoDelQueueDisc"),
+    m_useEcn (useEcn)
+{
+}
+
+void
+FqCoDelQueueDiscCoDelTestCase::Dequeue (void)
+{
+  m_qDisc->Dequeue ();
+  if (m_qDisc->GetNPackets () > 0)
+    {
+      Simulator::Schedule (MilliSeconds (10), &FqCoDelQueueDiscCoDelTestCase::Dequeue, this);
+    }
+}
+
+void
+FqCoDelQueueDiscCoDelTestCase::DoRun (void)
+{
+  m_qDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("UseEcn", BooleanValue (m_useEcn));
+
+  // One packet every 10 ms out of a standing queue of 100 packets, whose
+  // sojourn time exceeds the target after 1 packet
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_qDisc->Enqueue (CreateItem (0, 1, true));
+    }
+  Simulator::Schedule (MilliSeconds (10), &FqCoDelQueueDiscCoDelTestCase::Dequeue, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  QueueDisc::Stats stats = m_qDisc->GetStats ();
+  if (m_useEcn)
+    {
+      NS_TEST_EXPECT_MSG_GT (stats.nTotalMarkedPackets, 0, "CoDel must mark the standing queue");
+      NS_TEST_EXPECT_MSG_EQ (stats.nTotalDroppedPackets, 0, "CoDel must not drop ECN-capable packets");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_GT (stats.nTotalDroppedPackets, 0, "CoDel must drop the standing queue");
+      NS_TEST_EXPECT_MSG_EQ (stats.nTotalMarkedPackets, 0, "CoDel must not mark without ECN");
+    }
+  m_qDisc = 0;
+}
+
+// PIE keeps the queue short under overload and goes idle afterwards
+class PieQueueDiscTestCase : public TestCase
+{
+public:
+  PieQueueDiscTestCase ();
+private:
+  virtual void DoRun (void);
+  /// Enqueue a packet every ms until 2 s
+  void Enqueue (void);
+  /// Dequeue a packet every 2 ms while packets are held
+  void Dequeue (void);
+
+  Ptr<PieQueueDisc> m_qDisc;
+  uint32_t m_maxPackets;
+  bool m_dequeueing;
+};
+
+PieQueueDiscTestCase::PieQueueDiscTestCase ()
+  : TestCase ("Check the early drops of PieQueueDisc under overload")
+{
+}
+
+void
+PieQueueDiscTestCase::Enqueue (void)
+{
+  m_qDisc->Enqueue (CreateItem (0, 1));
+  if (Simulator::Now () > Seconds (1))
+    {
+      m_maxPackets = std::max (m_maxPackets, m_qDisc->GetNPackets ());
+    }
+  if (!m_dequeueing)
+    {
+      m_dequeueing = true;
+      Simulator::Schedule (MilliSeconds (2), &PieQueueDiscTestCase::Dequeue, this);
+    }
+  if (Simulator::Now () < Seconds (2))
+    {
+      Simulator::Schedule (MilliSeconds (1), &PieQueueDiscTestCase::Enqueue, this);
+    }
+}
+
+void
+PieQueueDiscTestCase::Dequeue (void)
+{
+  m_qDisc->Dequeue ();
+  m_dequeueing = m_qDisc->GetNPackets () > 0;
+  if (m_dequeueing)
+    {
+      Simulator::Schedule (MilliSeconds (2), &PieQueueDiscTestCase::Dequeue, this);
+    }
+}
+
+void
+PieQueueDiscTestCase::DoRun (void)
+{
+  m_qDisc = CreateObject<PieQueueDisc> ();
+  m_qDisc->AssignStreams (1);
+  m_maxPackets = 0;
+  m_dequeueing = false;
+
+  Simulator::Schedule (Seconds (0), &PieQueueDiscTestCase::Enqueue, this);
+  // Returns once the queue is empty and the drop probability back to zero
+  Simulator::Run ();
+  Time end = Simulator::Now ();
+  Simulator::Destroy ();
+
+  QueueDisc::Stats stats = m_qDisc->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (stats.nTotalDroppedPackets, 500, "PIE must drop the excess load");
+  // 15 ms of queueing delay at 2 ms per packet
+  NS_TEST_EXPECT_MSG_LT (m_maxPackets, 50, "PIE must keep the queueing delay close to the target");
+  NS_TEST_EXPECT_MSG_EQ (m_qDisc->GetDropProbability (), 0, "The drop probability decays to zero");
+  NS_TEST_EXPECT_MSG_LT (end, Seconds (30), "PIE must stop its timer once idle");
+  m_qDisc = 0;
+}
+
+static class TrafficControlTestSuite : public TestSuite
+{
+public:
+  TrafficControlTestSuite ()
+    : TestSuite ("traffic-control", UNIT)
+  {
+    AddTestCase (new PrioQueueDiscTestCase (), TestCase::QUICK);
+    AddTestCase (new FqCoDelQueueDiscSchedulingTestCase (), TestCase::QUICK);
+    AddTestCase (new FqCoDelQueueDiscCoDelTestCase (false), TestCase::QUICK);
+    AddTestCase (new FqCoDelQueueDiscCoDelTestCase (true), TestCase::QUICK);
+    AddTestCase (new PieQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_trafficControlTestSuite;
@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/fading-trace.h"
+
+using namespace ns3;
+
+/*
+ * Convert a fading trace from the text format, as generated by
+ * src/lte/model/fading-traces/fading_trace_generator.m, to the binary
+ * format which TraceFadingLossModel maps in memory, e.g.:
+ *
+ * ./waf --run "lena-fading-trace-converter
+ *     --input=src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad
+ *     --output=src/lte/model/fading-traces/fading_trace_EPA_3kmph.bin"
+ */
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rbNum = 100;
+  uint32_t samplesNum = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "Name of the text fading trace", input);
+  cmd.AddValue ("output", "Name of the binary fading trace to write", output);
+  cmd.AddValue ("rbNum", "Number of RBs of the trace", rbNum);
+  cmd.AddValue ("samplesNum", "Number of samples per RB of the trace", samplesNum);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      NS_FATAL_ERROR ("Both --input and --output must be given");
+    }
+  FadingTrace::ConvertToBinary (input, output, rbNum, samplesNum);
+  return 0;
+}
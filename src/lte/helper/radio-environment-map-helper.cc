@@ -37,9 +37,22 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/building-list.h>
 
 #include <fstream>
 #include <limits>
+#include <cmath>
+
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <unistd.h>
+#endif
 
 namespace ns3 {
 
@@ -47,7 +60,69 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
+#ifdef HAVE_PTHREAD_H
+/// Maximum time a thread waits before checking the state of the map again, in ns
+static const uint64_t WAIT_TIMEOUT = 1000000;
+
+/**
+ * The propagation loss models which compute the loss from the positions
+ * alone, without random variables or any other state, hence which can be
+ * called from several threads at once.
+ */
+static const char * const STATELESS_LOSS_MODELS[] = {
+  "ns3::FriisPropagationLossModel",
+  "ns3::TwoRayGroundPropagationLossModel",
+  "ns3::LogDistancePropagationLossModel",
+  "ns3::ThreeLogDistancePropagationLossModel",
+  "ns3::FixedRssLossModel",
+  "ns3::RangePropagationLossModel",
+  "ns3::Cost231PropagationLossModel",
+  "ns3::OkumuraHataPropagationLossModel",
+  "ns3::ItuR1411LosPropagationLossModel",
+  "ns3::ItuR1411NlosOverRooftopPropagationLossModel",
+  "ns3::Kun2600MhzPropagationLossModel"
+};
+
+/**
+ * \param model the first propagation loss model of a chain
+ * \return true if all the models of the chain are known to be stateless
+ */
+static bool
+IsStatelessLossModel (Ptr<PropagationLossModel> model)
+{
+  for (; model != 0; model = model->GetNext ())
+    {
+      std::string name = model->GetInstanceTypeId ().GetName ();
+      bool stateless = false;
+      for (uint32_t i = 0; i < sizeof (STATELESS_LOSS_MODELS) / sizeof (STATELESS_LOSS_MODELS[0]); ++i)
+        {
+          if (name == STATELESS_LOSS_MODELS[i])
+            {
+              stateless = true;
+              break;
+            }
+        }
+      if (!stateless)
+        {
+          NS_LOG_INFO (name << " may not be called from several threads");
+          return false;
+        }
+    }
+  return true;
+}
+#endif
+
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_maxLossDb (std::numeric_limits<double>::max ()),
+    m_tileSize (0),
+    m_nTiles (0),
+    m_maxPendingTiles (0)
+#ifdef HAVE_PTHREAD_H
+  ,
+    m_nextTile (0),
+    m_nextTileToWrite (0),
+    m_nextWorker (0)
+#endif
 {
 }
 
@@ -144,6 +219,21 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectEvaluation",
+                   "If true, the SINR of the points is computed from the signals transmitted "
+                   "on the channel during one subframe, instead of being measured by "
+                   "RemSpectrumPhy instances attached to the channel",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directEvaluation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Threads",
+                   "The number of threads, including the simulator thread, computing the "
+                   "map with direct evaluation (0 for one thread per processor). With more "
+                   "than one thread, the map is still computed on the simulator thread only "
+                   "unless the propagation loss models of the channel are known to be stateless",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_nThreads),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -181,7 +271,7 @@ void
 RadioEnvironmentMapHelper::Install ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_rem.empty ())
+  if (m_channel != 0)
     {
       NS_FATAL_ERROR ("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -220,6 +310,14 @@ RadioEnvironmentMapHelper::DelayedInstall ()
   NS_LOG_FUNCTION (this);
   m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
   m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  if (m_directEvaluation)
+    {
+      Simulator::Schedule (Seconds (0.0001),
+                           &RadioEnvironmentMapHelper::StartRecording,
+                           this);
+      return;
+    }
   
   if ((double)m_xRes * (double) m_yRes < (double) m_maxPointsPerIteration)
     {
@@ -340,6 +438,353 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::StartRecording ()
+{
+  NS_LOG_FUNCTION (this);
+  m_channel->TraceConnectWithoutContext ("TxSigParams",
+                                         MakeCallback (&RadioEnvironmentMapHelper::RecordTransmission, this));
+  Simulator::Schedule (Seconds (0.0005), &RadioEnvironmentMapHelper::GenerateMap, this);
+}
+
+void
+RadioEnvironmentMapHelper::RecordTransmission (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  if (m_useDataChannel)
+    {
+      if (DynamicCast<LteSpectrumSignalParametersDataFrame> (params) == 0)
+        {
+          return;
+        }
+    }
+  else if (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (params) == 0)
+    {
+      return;
+    }
+
+  // convert the signal to the spectrum model of the map, as the channel
+  // would do for a RemSpectrumPhy
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  RemTransmission t;
+  if (params->psd->GetSpectrumModelUid () == rxSpectrumModel->GetUid ())
+    {
+      t.psd = Copy<SpectrumValue> (params->psd);
+    }
+  else
+    {
+      SpectrumConverter converter (params->psd->GetSpectrumModel (), rxSpectrumModel);
+      t.psd = converter.Convert (params->psd);
+    }
+  if (m_rbId >= 0)
+    {
+      t.power = (*(t.psd))[m_rbId] * 180000;
+    }
+  else
+    {
+      t.power = Integral (*(t.psd));
+    }
+  t.antenna = params->txAntenna;
+  m_transmissions.push_back (t);
+
+  // the transmitter is located with its own mobility model on the simulator
+  // thread, hence by the same object as in the simulation
+  if (m_txMobility.empty ())
+    {
+      m_txMobility.resize (1);
+    }
+  Ptr<MobilityModel> mobility = params->txPhy->GetMobility ();
+  m_txMobility[0].push_back (mobility);
+  if (mobility != 0)
+    {
+      m_transmissions.back ().position = mobility->GetPosition ();
+    }
+}
+
+void
+RadioEnvironmentMapHelper::GenerateMap ()
+{
+  NS_LOG_FUNCTION (this);
+  m_channel->TraceDisconnectWithoutContext ("TxSigParams",
+                                            MakeCallback (&RadioEnvironmentMapHelper::RecordTransmission, this));
+  NS_LOG_INFO ("computing the map from " << m_transmissions.size () << " signals");
+  if (m_txMobility.empty ())
+    {
+      m_txMobility.resize (1);
+    }
+
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  m_spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue maxLossDb;
+  if (m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb))
+    {
+      m_maxLossDb = maxLossDb.Get ();
+    }
+
+  // the same points as with the RemSpectrumPhy listeners, in the same order
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      m_x.push_back (x);
+    }
+  for (double y = m_yMin; y < m_yMax + 0.5*m_yStep; y += m_yStep)
+    {
+      m_y.push_back (y);
+    }
+  uint32_t nPoints = m_x.size () * m_y.size ();
+
+  uint32_t nThreads = 1;
+#ifdef HAVE_PTHREAD_H
+  nThreads = m_nThreads;
+  if (nThreads == 0)
+    {
+      long nProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+      nThreads = nProcessors > 0 ? nProcessors : 1;
+    }
+  // the frequency-dependent loss models, the buildings and the loss
+  // models drawing random variables (e.g., Nakagami) keep state shared
+  // by all the points
+  if (m_spectrumPropagationLoss != 0 || BuildingList::GetNBuildings () > 0
+      || !IsStatelessLossModel (m_propagationLoss))
+    {
+      NS_LOG_INFO ("evaluating the map on the simulator thread only");
+      nThreads = 1;
+    }
+#endif
+  NS_LOG_INFO ("computing the map on " << nThreads << " threads");
+
+  // as many listening points as with the RemSpectrumPhy listeners, which
+  // are not used by two tiles computed at the same time
+  uint32_t nPointMobility = std::min (m_maxPointsPerIteration, nPoints);
+  for (uint32_t i = 0; i < nPointMobility; ++i)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      m_pointMobility.push_back (mobility);
+    }
+  m_maxPendingTiles = std::min (2 * nThreads, nPointMobility);
+  m_tileSize = std::max<uint32_t> (1, std::min<uint32_t> (1024, nPointMobility / m_maxPendingTiles));
+  m_nTiles = (nPoints + m_tileSize - 1) / m_tileSize;
+  m_tileSinr.resize (m_maxPendingTiles, std::vector<double> (m_tileSize));
+
+  // the other threads locate the transmitters with their own copy of the
+  // mobility models, as the reference count of the objects is not thread safe
+  for (uint32_t worker = 1; worker < nThreads; ++worker)
+    {
+      std::vector<Ptr<MobilityModel> > txMobility;
+      for (uint32_t i = 0; i < m_transmissions.size (); ++i)
+        {
+          Ptr<MobilityModel> mobility;
+          if (m_txMobility[0][i] != 0)
+            {
+              mobility = CreateObject<ConstantPositionMobilityModel> ();
+              mobility->SetPosition (m_transmissions[i].position);
+              mobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+              BuildingsHelper::MakeConsistent (mobility);
+            }
+          txMobility.push_back (mobility);
+        }
+      m_txMobility.push_back (txMobility);
+    }
+
+#ifdef HAVE_PTHREAD_H
+  m_nextTile = 0;
+  m_nextTileToWrite = 0;
+  m_nextWorker = 1;
+  m_tileDone.assign (m_maxPendingTiles, false);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t worker = 1; worker < nThreads; ++worker)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&RadioEnvironmentMapHelper::DoRunThread, this));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+
+  // the simulator thread writes the tiles in order and computes tiles
+  // while the next one to write is not complete
+  while (true)
+    {
+      m_tileComputed.SetCondition (false);
+      m_mutex.Lock ();
+      uint32_t tile = m_nextTileToWrite;
+      bool done = (tile < m_nTiles) && m_tileDone[tile % m_maxPendingTiles];
+      m_mutex.Unlock ();
+      if (tile == m_nTiles)
+        {
+          break;
+        }
+      if (done)
+        {
+          WriteTile (tile);
+          m_mutex.Lock ();
+          m_tileDone[tile % m_maxPendingTiles] = false;
+          m_nextTileToWrite++;
+          m_mutex.Unlock ();
+          m_tileAvailable.SetCondition (true);
+          m_tileAvailable.Broadcast ();
+        }
+      else if (!ComputeNextTile (0))
+        {
+          // bounded wait, as the signal may be sent before we wait
+          m_tileComputed.TimedWait (WAIT_TIMEOUT);
+        }
+    }
+  m_tileAvailable.SetCondition (true);
+  m_tileAvailable.Broadcast ();
+  for (std::vector<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+#else
+  for (uint32_t tile = 0; tile < m_nTiles; ++tile)
+    {
+      ComputeTile (0, tile);
+      WriteTile (tile);
+    }
+#endif
+
+  m_transmissions.clear ();
+  m_txMobility.clear ();
+  m_pointMobility.clear ();
+  m_tileSinr.clear ();
+  Finalize ();
+}
+
+double
+RadioEnvironmentMapHelper::EvaluatePoint (uint32_t worker, uint32_t point)
+{
+  Vector position (m_x[point / m_y.size ()], m_y[point % m_y.size ()], m_z);
+  Ptr<MobilityModel> &mobility = m_pointMobility[point % m_pointMobility.size ()];
+  mobility->SetPosition (position);
+  BuildingsHelper::MakeConsistent (mobility);
+
+  // see MultiModelSpectrumChannel::StartTx and RemSpectrumPhy::StartRx
+  double sumPower = 0;
+  double referenceSignalPower = 0;
+  const std::vector<Ptr<MobilityModel> > &txMobility = m_txMobility[worker];
+  for (uint32_t i = 0; i < m_transmissions.size (); ++i)
+    {
+      const RemTransmission &t = m_transmissions[i];
+      double power = t.power;
+      if (txMobility[i] != 0)
+        {
+          double pathLossDb = 0;
+          if (t.antenna != 0)
+            {
+              Angles txAngles (position, t.position);
+              pathLossDb -= t.antenna->GetGainDb (txAngles);
+            }
+          if (m_propagationLoss != 0)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, txMobility[i], mobility);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              // beyond range
+              continue;
+            }
+          double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+          if (m_spectrumPropagationLoss != 0)
+            {
+              Ptr<SpectrumValue> psd = Copy<SpectrumValue> (t.psd);
+              *psd *= pathGainLinear;
+              psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (psd, txMobility[i], mobility);
+              power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+            }
+          else
+            {
+              power *= pathGainLinear;
+            }
+        }
+      sumPower += power;
+      if (power > referenceSignalPower)
+        {
+          referenceSignalPower = power;
+        }
+    }
+  return referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+}
+
+void
+RadioEnvironmentMapHelper::ComputeTile (uint32_t worker, uint32_t tile)
+{
+  std::vector<double> &sinr = m_tileSinr[tile % m_maxPendingTiles];
+  uint32_t first = tile * m_tileSize;
+  uint32_t last = std::min<uint32_t> (first + m_tileSize, m_x.size () * m_y.size ());
+  for (uint32_t point = first; point < last; ++point)
+    {
+      sinr[point - first] = EvaluatePoint (worker, point);
+    }
+}
+
+void
+RadioEnvironmentMapHelper::WriteTile (uint32_t tile)
+{
+  NS_LOG_FUNCTION (this << tile);
+  const std::vector<double> &sinr = m_tileSinr[tile % m_maxPendingTiles];
+  uint32_t first = tile * m_tileSize;
+  uint32_t last = std::min<uint32_t> (first + m_tileSize, m_x.size () * m_y.size ());
+  for (uint32_t point = first; point < last; ++point)
+    {
+      m_outFile << m_x[point / m_y.size ()] << "\t"
+                << m_y[point % m_y.size ()] << "\t"
+                << m_z << "\t"
+                << sinr[point - first]
+                << std::endl;
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+
+bool
+RadioEnvironmentMapHelper::ComputeNextTile (uint32_t worker)
+{
+  uint32_t tile;
+  {
+    CriticalSection cs (m_mutex);
+    if (m_nextTile == m_nTiles || m_nextTile >= m_nextTileToWrite + m_maxPendingTiles)
+      {
+        return false;
+      }
+    tile = m_nextTile++;
+  }
+  ComputeTile (worker, tile);
+  {
+    CriticalSection cs (m_mutex);
+    m_tileDone[tile % m_maxPendingTiles] = true;
+  }
+  m_tileComputed.SetCondition (true);
+  m_tileComputed.Signal ();
+  return true;
+}
+
+void
+RadioEnvironmentMapHelper::DoRunThread ()
+{
+  uint32_t worker;
+  {
+    CriticalSection cs (m_mutex);
+    worker = m_nextWorker++;
+  }
+  while (true)
+    {
+      m_tileAvailable.SetCondition (false);
+      if (!ComputeNextTile (worker))
+        {
+          m_mutex.Lock ();
+          bool finished = (m_nextTile == m_nTiles);
+          m_mutex.Unlock ();
+          if (finished)
+            {
+              return;
+            }
+          // bounded wait, as the signal may be sent before we wait
+          m_tileAvailable.TimedWait (WAIT_TIMEOUT);
+        }
+    }
+}
+
+#endif /* HAVE_PTHREAD_H */
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
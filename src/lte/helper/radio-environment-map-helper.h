@@ -24,7 +24,15 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
+#include <ns3/core-config.h>
 #include <fstream>
+#include <vector>
+
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-mutex.h>
+#include <ns3/system-condition.h>
+#endif
 
 
 namespace ns3 {
@@ -35,6 +43,11 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class SpectrumValue;
+class AntennaModel;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
+class SpectrumSignalParameters;
 
 /** 
  * \ingroup lte
@@ -42,6 +55,15 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is obtained by attaching RemSpectrumPhy listeners to
+ * the channel and running the simulation while they receive the signals.
+ * When the DirectEvaluation attribute is set, the signals transmitted on
+ * the channel during one subframe are recorded instead, and the SINR of
+ * every point is computed from them with the propagation models of the
+ * channel, without simulation events. The points are then evaluated by
+ * tiles on several threads, and the tiles are written to the output file
+ * in order as soon as they are complete.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -108,6 +130,105 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Scheduled by DelayedInstall() with direct evaluation to start recording
+   * the signals transmitted on the channel. Afterwards, schedule a call to
+   * GenerateMap() in 0.5 milliseconds.
+   */
+  void StartRecording ();
+
+  /**
+   * Connected to the `TxSigParams` trace source of the channel while
+   * recording.
+   *
+   * \param params the parameters of the transmitted signal
+   */
+  void RecordTransmission (Ptr<SpectrumSignalParameters> params);
+
+  /// Compute the SINR of every point from the recorded signals and write it.
+  void GenerateMap ();
+
+  /**
+   * Compute the SINR of a point from the recorded signals.
+   *
+   * \param worker the index of the thread computing the point
+   * \param point the index of the point, in output order
+   * \return the SINR in linear units
+   */
+  double EvaluatePoint (uint32_t worker, uint32_t point);
+
+  /**
+   * Compute the SINR of the points of a tile.
+   *
+   * \param worker the index of the thread computing the tile
+   * \param tile the index of the tile
+   */
+  void ComputeTile (uint32_t worker, uint32_t tile);
+
+  /**
+   * Write the SINR of the points of a computed tile to the output file.
+   *
+   * \param tile the index of the tile
+   */
+  void WriteTile (uint32_t tile);
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * Compute the next tile, unless all of them have been started or the
+   * tiles not yet written fill the buffers.
+   *
+   * \param worker the index of the thread computing the tile
+   * \return false if no tile has been computed
+   */
+  bool ComputeNextTile (uint32_t worker);
+
+  /// Body of the threads computing tiles along with the simulator thread.
+  void DoRunThread ();
+#endif
+
+  /// A signal transmitted on the channel while recording.
+  struct RemTransmission
+  {
+    /// Power spectral density, converted to the spectrum model of the map.
+    Ptr<SpectrumValue> psd;
+    /// Power over the bandwidth or the RB of the map, before propagation.
+    double power;
+    /// Position of the transmitter.
+    Vector position;
+    /// Antenna of the transmitter, if any.
+    Ptr<AntennaModel> antenna;
+  };
+
+  /// Signals recorded for direct evaluation.
+  std::vector<RemTransmission> m_transmissions;
+  /// Mobility of the transmitters, one set per thread ([worker][transmission]).
+  std::vector<std::vector<Ptr<MobilityModel> > > m_txMobility;
+  /**
+   * Positions of the points, reused as the map is evaluated: point i is
+   * located with m_pointMobility[i % m_pointMobility.size ()].
+   */
+  std::vector<Ptr<MobilityModel> > m_pointMobility;
+  std::vector<double> m_x;  ///< X coordinates of the points, in output order.
+  std::vector<double> m_y;  ///< Y coordinates of the points, in output order.
+  Ptr<PropagationLossModel> m_propagationLoss;  ///< Loss model of the channel.
+  /// Frequency-dependent loss model of the channel.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  double m_maxLossDb;      ///< The `MaxLossDb` attribute of the channel.
+  uint32_t m_tileSize;     ///< Number of points per tile.
+  uint32_t m_nTiles;       ///< Number of tiles of the map.
+  uint32_t m_maxPendingTiles;  ///< Tiles computed ahead of the output.
+  /// SINR of the points of the pending tiles, tile i in [i % m_maxPendingTiles].
+  std::vector<std::vector<double> > m_tileSinr;
+#ifdef HAVE_PTHREAD_H
+  SystemMutex m_mutex;                ///< Protects the state below.
+  SystemCondition m_tileAvailable;    ///< Signaled when a tile may be started.
+  SystemCondition m_tileComputed;     ///< Signaled when a tile is complete.
+  uint32_t m_nextTile;                ///< Index of the next tile to start.
+  uint32_t m_nextTileToWrite;         ///< Index of the next tile to write.
+  uint32_t m_nextWorker;              ///< Index of the next thread to start.
+  std::vector<bool> m_tileDone;       ///< True if the pending tile is complete.
+#endif
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +273,9 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directEvaluation;  ///< The `DirectEvaluation` attribute.
+  uint32_t m_nThreads;      ///< The `Threads` attribute.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -30,6 +30,7 @@
 #include <ns3/simulator.h>
 #include <ns3/lte-amc.h>
 #include <ns3/cqa-ff-mac-scheduler.h>
+#include <ns3/ff-mac-ue-table.h>
 #include <ns3/ff-mac-common.h>
 #include <ns3/lte-vendor-specific-parameters.h>
 #include <ns3/boolean.h>
@@ -648,23 +649,7 @@ CqaFfMacScheduler::GetRbgSize (int dlbandwidth)
 int
 CqaFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return FfMacUeTable::CountLcActives (m_rlcBufferReq, rnti);
 }
 
 
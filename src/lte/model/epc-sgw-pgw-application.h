@@ -36,6 +36,7 @@
 #include <ns3/application.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
+#include <ns3/sgi-hashmap.h>
 #include <map>
 
 namespace ns3 {
@@ -237,10 +238,15 @@ public:
    */
   Ptr<VirtualNetDevice> m_tunDevice;
 
+  /**
+   * Container of UE info indexed by UE address
+   */
+  typedef sgi::hash_map<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash> UeInfoByAddrMap;
+
   /**
    * Map telling for each UE address the corresponding UE info 
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  UeInfoByAddrMap m_ueInfoByAddrMap;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
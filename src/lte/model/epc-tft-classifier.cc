@@ -31,8 +31,6 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
 
@@ -40,7 +38,28 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
+size_t
+EpcTftClassifier::FlowKeyHash::operator() (FlowKey const &key) const
+{
+  // Fibonacci hashing of each field in turn
+  uint64_t h = key.remoteAddress.Get ();
+  h = h * 0x9e3779b97f4a7c15ULL + key.localAddress.Get ();
+  h = h * 0x9e3779b97f4a7c15ULL + ((key.remotePort << 16) | key.localPort);
+  h *= 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+bool
+EpcTftClassifier::FlowKeyEqual::operator() (FlowKey const &a, FlowKey const &b) const
+{
+  return a.remoteAddress == b.remoteAddress
+         && a.localAddress == b.localAddress
+         && a.remotePort == b.remotePort
+         && a.localPort == b.localPort;
+}
+
 EpcTftClassifier::EpcTftClassifier ()
+  : m_indexStale (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -54,6 +73,8 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
   
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
+
+  m_indexStale = true;
 }
 
 void
@@ -61,6 +82,69 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_indexStale = true;
+}
+
+void
+EpcTftClassifier::IndexFilters ()
+{
+  NS_LOG_FUNCTION (this);
+  m_exactFilters.clear ();
+  m_otherFilters.clear ();
+  m_indexedNumFilters.clear ();
+
+  // we use a reverse iterator since filter priority is not implemented properly.
+  // This way, since the default bearer is expected to be added first, it will be evaluated last.
+  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
+  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+    {
+      m_indexedNumFilters.push_back (it->second->GetNumFilters ());
+      std::list<EpcTft::PacketFilter> filters = it->second->GetPacketFilters ();
+      for (std::list<EpcTft::PacketFilter>::const_iterator fit = filters.begin ();
+           fit != filters.end ();
+           ++fit)
+        {
+          FilterEntry entry;
+          entry.id = it->first;
+          entry.filter = *fit;
+          if (fit->remoteMask == Ipv4Mask::GetOnes ()
+              && fit->localMask == Ipv4Mask::GetOnes ()
+              && fit->remotePortStart == fit->remotePortEnd
+              && fit->localPortStart == fit->localPortEnd)
+            {
+              FlowKey key;
+              key.remoteAddress = fit->remoteAddress;
+              key.localAddress = fit->localAddress;
+              key.remotePort = fit->remotePortStart;
+              key.localPort = fit->localPortStart;
+              m_exactFilters[key].push_back (entry);
+            }
+          else
+            {
+              m_otherFilters.push_back (entry);
+            }
+        }
+    }
+  m_indexStale = false;
+  NS_LOG_LOGIC ("exact filters: " << m_exactFilters.size ()
+                << " other filters: " << m_otherFilters.size ());
+}
+
+bool
+EpcTftClassifier::FiltersAdded () const
+{
+  // the packet filters of a TFT cannot be removed, so a TFT was
+  // modified if and only if its number of filters changed
+  std::vector<uint8_t>::const_iterator nit = m_indexedNumFilters.begin ();
+  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
+  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it, ++nit)
+    {
+      if (it->second->GetNumFilters () != *nit)
+        {
+          return true;
+        }
+    }
+  return false;
 }
 
  
@@ -69,10 +153,13 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 {
   NS_LOG_FUNCTION (this << p << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
+  if (m_indexStale || FiltersAdded ())
+    {
+      IndexFilters ();
+    }
 
   Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  p->PeekHeader (ipv4Header);
 
   Ipv4Address localAddress;
   Ipv4Address remoteAddress;
@@ -97,35 +184,30 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
   uint16_t localPort = 0;
   uint16_t remotePort = 0;
 
-  if (protocol == UdpL4Protocol::PROT_NUMBER)
+  if (protocol == UdpL4Protocol::PROT_NUMBER || protocol == TcpL4Protocol::PROT_NUMBER)
     {
-      UdpHeader udpHeader;
-      pCopy->RemoveHeader (udpHeader);
+      // both the UDP and the TCP header start with the source and
+      // destination ports, there is no need to deserialize them
+      uint8_t buf[64];
+      uint32_t headerSize = ipv4Header.GetSerializedSize ();
+      NS_ASSERT (headerSize + 4 <= sizeof (buf));
+      if (p->CopyData (buf, headerSize + 4) < headerSize + 4)
+        {
+          NS_LOG_WARN ("truncated transport header");
+          return 0;  // no match
+        }
+      uint16_t sourcePort = (buf[headerSize] << 8) | buf[headerSize + 1];
+      uint16_t destinationPort = (buf[headerSize + 2] << 8) | buf[headerSize + 3];
 
       if (direction ==  EpcTft::UPLINK)
 	{
-	  localPort = udpHeader.GetSourcePort ();
-	  remotePort = udpHeader.GetDestinationPort ();
-	}
-      else
-	{
-	  remotePort = udpHeader.GetSourcePort ();
-	  localPort = udpHeader.GetDestinationPort ();
-	}
-    }
-  else if (protocol == TcpL4Protocol::PROT_NUMBER)
-    {
-      TcpHeader tcpHeader;
-      pCopy->RemoveHeader (tcpHeader);
-      if (direction ==  EpcTft::UPLINK)
-	{
-	  localPort = tcpHeader.GetSourcePort ();
-	  remotePort = tcpHeader.GetDestinationPort ();
+	  localPort = sourcePort;
+	  remotePort = destinationPort;
 	}
       else
 	{
-	  remotePort = tcpHeader.GetSourcePort ();
-	  localPort = tcpHeader.GetDestinationPort ();
+	  remotePort = sourcePort;
+	  localPort = destinationPort;
 	}
     }
   else
@@ -141,25 +223,51 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 	       << " remotePort=" << remotePort 
 	       << " tos=0x" << (uint16_t) tos );
 
-  // now it is possible to classify the packet!
-  // we use a reverse iterator since filter priority is not implemented properly.
-  // This way, since the default bearer is expected to be added first, it will be evaluated last.
-  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-  NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
+  // now it is possible to classify the packet! Both sets of filters
+  // are sorted by decreasing TFT id, the first match of each set is
+  // the best one of the set, and the best of both wins.
+  uint32_t matchId = 0;
 
-  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+  FlowKey key;
+  key.remoteAddress = remoteAddress;
+  key.localAddress = localAddress;
+  key.remotePort = remotePort;
+  key.localPort = localPort;
+  ExactFilterMap::iterator eit = m_exactFilters.find (key);
+  if (eit != m_exactFilters.end ())
+    {
+      for (std::vector<FilterEntry>::iterator it = eit->second.begin ();
+           it != eit->second.end ();
+           ++it)
+        {
+          if (it->filter.Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+            {
+              matchId = it->id;
+              break;
+            }
+        }
+    }
+
+  for (std::vector<FilterEntry>::iterator it = m_otherFilters.begin ();
+       it != m_otherFilters.end () && it->id > matchId;
+       ++it)
     {
-      NS_LOG_LOGIC ("TFT id: " << it->first );
-      NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-      Ptr<EpcTft> tft = it->second;         
-      if (tft->Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+      if (it->filter.Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
         {
-	  NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-	  return it->first; // the id of the matching TFT
+          matchId = it->id;
+          break;
         }
     }
-  NS_LOG_LOGIC ("no match");
-  return 0;  // no match
+
+  if (matchId != 0)
+    {
+      NS_LOG_LOGIC ("matches with TFT ID = " << matchId);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("no match");
+    }
+  return matchId;
 }
 
 
@@ -26,8 +26,10 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/epc-tft.h"
+#include "ns3/sgi-hashmap.h"
 
 #include <map>
+#include <vector>
 
 
 namespace ns3 {
@@ -38,7 +40,19 @@ class Packet;
 /**
  * \brief classifies IP packets accoding to Traffic Flow Templates (TFTs)
  * 
+ * The packet filters which match a single remote address, local
+ * address, remote port and local port are indexed by these four
+ * values, so that a packet is checked against them with a single hash
+ * lookup. The other packet filters (address masks, port ranges) are
+ * checked one by one. In both cases the filters are sorted by
+ * decreasing TFT identifier, so that the packet is classified to the
+ * same TFT as if the TFTs were evaluated one by one in that order.
+ *
  * \note this implementation works with IPv4 only.
+ *
+ * The indexes are rebuilt by Classify when a TFT was added or deleted,
+ * or when packet filters were added to a TFT, since the last packet
+ * was classified.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -74,6 +88,73 @@ public:
 protected:
   
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap;
+
+private:
+
+  /// a packet filter along with the identifier of its TFT
+  struct FilterEntry
+  {
+    uint32_t id;                 ///< the identifier of the TFT
+    EpcTft::PacketFilter filter; ///< the packet filter
+  };
+
+  /// the values matched by a packet filter without masks and port ranges
+  struct FlowKey
+  {
+    Ipv4Address remoteAddress; ///< the remote address
+    Ipv4Address localAddress;  ///< the local address
+    uint16_t remotePort;       ///< the remote port
+    uint16_t localPort;        ///< the local port
+  };
+
+  /// hash function for the flow keys
+  class FlowKeyHash : public std::unary_function<FlowKey, size_t>
+  {
+public:
+    /**
+     * \param key the flow key
+     * \return the hash of the flow key
+     */
+    size_t operator() (FlowKey const &key) const;
+  };
+
+  /// equality of the flow keys
+  class FlowKeyEqual : public std::binary_function<FlowKey, FlowKey, bool>
+  {
+public:
+    /**
+     * \param a the first flow key
+     * \param b the second flow key
+     * \return true if the flow keys are equal
+     */
+    bool operator() (FlowKey const &a, FlowKey const &b) const;
+  };
+
+  /// packet filters without masks and port ranges, indexed by flow key
+  typedef sgi::hash_map<FlowKey, std::vector<FilterEntry>, FlowKeyHash, FlowKeyEqual> ExactFilterMap;
+
+  /** 
+   * rebuild the indexes of the packet filters from m_tftMap
+   */
+  void IndexFilters ();
+
+  /** 
+   * \return true if packet filters were added to the TFTs since they
+   * were indexed
+   */
+  bool FiltersAdded () const;
+
+  /// true if TFTs were added or deleted since the filters were indexed
+  bool m_indexStale;
+
+  /// the number of packet filters of each TFT of m_tftMap when indexed
+  std::vector<uint8_t> m_indexedNumFilters;
+
+  /// the packet filters without masks and port ranges
+  ExactFilterMap m_exactFilters;
+
+  /// the other packet filters, by decreasing TFT identifier
+  std::vector<FilterEntry> m_otherFilters;
   
 };
 
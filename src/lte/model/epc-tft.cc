@@ -191,5 +191,18 @@ EpcTft::Matches (Direction direction,
   return false;
 }
 
+std::list<EpcTft::PacketFilter>
+EpcTft::GetPacketFilters () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_filters;
+}
+
+uint8_t
+EpcTft::GetNumFilters () const
+{
+  return m_numFilters;
+}
+
 
 } // namespace ns3
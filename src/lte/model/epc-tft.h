@@ -150,6 +150,16 @@ public:
 		  uint16_t localPort,
 		  uint8_t typeOfService);
 
+  /** 
+   * \return the PacketFilters of the TFT, by increasing precedence value
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
+
+  /** 
+   * \return the number of PacketFilters of the TFT
+   */
+  uint8_t GetNumFilters () const;
+
 
 private:
 
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fading-trace.h"
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <ns3/core-config.h>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_SYS_STAT_H) && defined (HAVE_SYS_TYPES_H)
+/** Do we have an \c mmap function? */
+#define HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FadingTrace");
+
+/// Magic string starting the binary traces
+static const char FADING_TRACE_MAGIC[8] = { 'N', 'S', '3', 'F', 'A', 'D', 'T', 'R' };
+/// Version of the binary format
+static const uint32_t FADING_TRACE_VERSION = 1;
+/// Size of the header of the binary traces
+static const uint32_t FADING_TRACE_HEADER_SIZE = 24;
+
+std::map<FadingTrace::TraceKey, FadingTrace *>&
+FadingTrace::GetTraces (void)
+{
+  static std::map<TraceKey, FadingTrace *> traces;
+  return traces;
+}
+
+Ptr<const FadingTrace>
+FadingTrace::Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (fileName << rbNum << samplesNum);
+  TraceKey key = std::make_pair (fileName, std::make_pair (rbNum, samplesNum));
+  std::map<TraceKey, FadingTrace *>::iterator it = GetTraces ().find (key);
+  if (it != GetTraces ().end ())
+    {
+      return Ptr<const FadingTrace> (it->second);
+    }
+  FadingTrace *trace = new FadingTrace (fileName, rbNum, samplesNum);
+  GetTraces ()[key] = trace;
+  // the map does not hold a reference: the trace is unloaded as soon as no
+  // model uses it
+  return Ptr<const FadingTrace> (trace, false);
+}
+
+FadingTrace::FadingTrace (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+  : m_key (std::make_pair (fileName, std::make_pair (rbNum, samplesNum))),
+    m_rbNum (rbNum),
+    m_samplesNum (samplesNum),
+    m_data (0),
+    m_map (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this << fileName << rbNum << samplesNum);
+
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Fading trace file " << fileName << " not found");
+    }
+  char magic[sizeof (FADING_TRACE_MAGIC)];
+  file.read (magic, sizeof (magic));
+  bool binary = file.gcount () == sizeof (magic)
+    && std::memcmp (magic, FADING_TRACE_MAGIC, sizeof (magic)) == 0;
+  file.close ();
+
+  if (binary)
+    {
+      LoadBinary ();
+    }
+  else
+    {
+      LoadText (ReadFile (fileName));
+    }
+}
+
+FadingTrace::~FadingTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  std::map<TraceKey, FadingTrace *>::iterator it = GetTraces ().find (m_key);
+  if (it != GetTraces ().end () && it->second == this)
+    {
+      GetTraces ().erase (it);
+    }
+#ifdef HAVE_MMAP
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+#endif
+}
+
+std::string
+FadingTrace::ReadFile (std::string fileName)
+{
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Fading trace file " << fileName << " not found");
+    }
+  std::ostringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+void
+FadingTrace::LoadText (const std::string &content)
+{
+  NS_LOG_FUNCTION (this);
+  m_samples.resize (m_rbNum * m_samplesNum);
+  const char *cur = content.c_str ();
+  for (uint32_t i = 0; i < m_samples.size (); i++)
+    {
+      char *end;
+      m_samples[i] = std::strtod (cur, &end);
+      if (end == cur)
+        {
+          NS_FATAL_ERROR ("Fading trace " << m_key.first << " has less than "
+                          << m_rbNum << " RBs of " << m_samplesNum << " samples");
+        }
+      cur = end;
+    }
+  m_data = m_samples.empty () ? 0 : &m_samples[0];
+}
+
+void
+FadingTrace::LoadBinary (void)
+{
+  NS_LOG_FUNCTION (this);
+  const std::string &fileName = m_key.first;
+  const char *bytes;
+  size_t size;
+
+#ifdef HAVE_MMAP
+  int fd = open (fileName.c_str (), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat (fd, &st) != 0)
+    {
+      NS_FATAL_ERROR ("Cannot open fading trace " << fileName);
+    }
+  size = st.st_size;
+  void *map = mmap (0, size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Cannot map fading trace " << fileName);
+    }
+  m_map = map;
+  m_mapSize = size;
+  bytes = static_cast<const char *> (map);
+#else
+  std::string content = ReadFile (fileName);
+  bytes = content.data ();
+  size = content.size ();
+#endif
+
+  uint32_t header[4];
+  if (size < FADING_TRACE_HEADER_SIZE)
+    {
+      NS_FATAL_ERROR ("Fading trace " << fileName << " is truncated");
+    }
+  std::memcpy (header, bytes + sizeof (FADING_TRACE_MAGIC), sizeof (header));
+  uint32_t version = header[0];
+  uint32_t rbNum = header[1];
+  uint32_t samplesNum = header[2];
+  if (version != FADING_TRACE_VERSION)
+    {
+      NS_FATAL_ERROR ("Fading trace " << fileName << " has an unsupported version or byte order");
+    }
+  if (samplesNum != m_samplesNum || rbNum < m_rbNum)
+    {
+      NS_FATAL_ERROR ("Fading trace " << fileName << " has " << rbNum << " RBs of "
+                      << samplesNum << " samples, expected " << m_rbNum << " RBs of "
+                      << m_samplesNum << " samples");
+    }
+  if (size < FADING_TRACE_HEADER_SIZE + (uint64_t) rbNum * samplesNum * sizeof (double))
+    {
+      NS_FATAL_ERROR ("Fading trace " << fileName << " is truncated");
+    }
+
+#ifdef HAVE_MMAP
+  // the mapping is page aligned, hence the samples are aligned too
+  m_data = reinterpret_cast<const double *> (bytes + FADING_TRACE_HEADER_SIZE);
+#else
+  m_samples.resize (m_rbNum * m_samplesNum);
+  std::memcpy (&m_samples[0], bytes + FADING_TRACE_HEADER_SIZE, m_samples.size () * sizeof (double));
+  m_data = &m_samples[0];
+#endif
+}
+
+void
+FadingTrace::ConvertToBinary (std::string textFileName, std::string binaryFileName,
+                              uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (textFileName << binaryFileName << rbNum << samplesNum);
+  Ptr<const FadingTrace> trace = Get (textFileName, rbNum, samplesNum);
+
+  std::ofstream file (binaryFileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Cannot create fading trace " << binaryFileName);
+    }
+  uint32_t header[4] = { FADING_TRACE_VERSION, rbNum, samplesNum, 0 };
+  file.write (FADING_TRACE_MAGIC, sizeof (FADING_TRACE_MAGIC));
+  file.write (reinterpret_cast<const char *> (header), sizeof (header));
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      file.write (reinterpret_cast<const char *> (trace->GetRbSamples (rb)),
+                  samplesNum * sizeof (double));
+    }
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Cannot write fading trace " << binaryFileName);
+    }
+}
+
+uint32_t
+FadingTrace::GetRbNum (void) const
+{
+  return m_rbNum;
+}
+
+uint32_t
+FadingTrace::GetSamplesNum (void) const
+{
+  return m_samplesNum;
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FADING_TRACE_H
+#define FADING_TRACE_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/assert.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * \brief The samples of a fading trace, shared by all the fading models
+ * which use the same trace file.
+ *
+ * A fading trace holds the fading, in dB, of a number of RBs over a number
+ * of samples in time.  Two file formats are supported:
+ *
+ * - the text format, as generated by the matlab script provided in
+ *   `src/lte/model/fading-traces`: one line per RB, one column per sample;
+ *
+ * - a binary format, made of a 24 bytes header (the 8 characters
+ *   `NS3FADTR`, then the version, the number of RBs and the number of
+ *   samples and a reserved word, as 32 bits integers) followed by the
+ *   samples as doubles, RB after RB.  Integers and doubles are stored in
+ *   the byte order of the host.  ConvertToBinary () converts a text trace
+ *   to this format.
+ *
+ * The format is detected from the content of the file.  Binary traces are
+ * mapped in memory where the system supports it, so that their pages are
+ * only read when used and shared with the other processes using the same
+ * trace.  Text traces are parsed once per process.
+ */
+class FadingTrace : public SimpleRefCount<FadingTrace>
+{
+public:
+  ~FadingTrace ();
+
+  /**
+   * \brief Get the trace loaded from a file, loading it if no other model
+   * uses it.
+   * \param fileName the name of the trace file
+   * \param rbNum the number of RBs to read from the trace
+   * \param samplesNum the number of samples per RB of the trace
+   * \return the trace
+   */
+  static Ptr<const FadingTrace> Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * \brief Convert a trace from the text format to the binary format.
+   * \param textFileName the name of the text trace
+   * \param binaryFileName the name of the binary trace to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  static void ConvertToBinary (std::string textFileName, std::string binaryFileName,
+                               uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * \return the number of RBs of the trace
+   */
+  uint32_t GetRbNum (void) const;
+
+  /**
+   * \return the number of samples per RB of the trace
+   */
+  uint32_t GetSamplesNum (void) const;
+
+  /**
+   * \param rb the RB
+   * \param sample the index of the sample
+   * \return the fading of the RB at the given sample, in dB
+   */
+  double GetValue (uint32_t rb, uint32_t sample) const
+  {
+    NS_ASSERT (rb < m_rbNum && sample < m_samplesNum);
+    return m_data[rb * m_samplesNum + sample];
+  }
+
+  /**
+   * \param rb the RB
+   * \return the samples of the RB, GetSamplesNum () of them
+   */
+  const double* GetRbSamples (uint32_t rb) const
+  {
+    NS_ASSERT (rb < m_rbNum);
+    return m_data + rb * m_samplesNum;
+  }
+
+private:
+  /**
+   * \param fileName the name of the trace file
+   * \param rbNum the number of RBs to read from the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  FadingTrace (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * \brief Parse a text trace
+   * \param content the content of the file
+   */
+  void LoadText (const std::string &content);
+
+  /**
+   * \brief Map or read a binary trace
+   */
+  void LoadBinary (void);
+
+  /**
+   * \brief Read a whole file
+   * \param fileName the name of the file
+   * \return the content of the file
+   */
+  static std::string ReadFile (std::string fileName);
+
+  /// Identifies a loaded trace: file name, number of RBs and of samples
+  typedef std::pair<std::string, std::pair<uint32_t, uint32_t> > TraceKey;
+
+  /**
+   * \return the traces currently loaded
+   */
+  static std::map<TraceKey, FadingTrace *>& GetTraces (void);
+
+  TraceKey m_key;                 //!< Key of the trace in GetTraces ()
+  uint32_t m_rbNum;               //!< Number of RBs
+  uint32_t m_samplesNum;          //!< Number of samples per RB
+  const double *m_data;           //!< Samples, RB after RB
+  std::vector<double> m_samples;  //!< Samples, unless the file is mapped
+  void *m_map;                    //!< Mapped file, if any
+  size_t m_mapSize;               //!< Size of the mapped file
+};
+
+} // namespace ns3
+
+#endif /* FADING_TRACE_H */
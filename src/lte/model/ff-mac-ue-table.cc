@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ff-mac-ue-table.h"
+#include <ns3/lte-common.h>
+#include <ns3/assert.h>
+
+namespace ns3 {
+
+/**
+ * \param req the RLC buffer status of a logical channel
+ * \returns true if the logical channel has data to transmit
+ */
+static bool
+IsLcActive (const FfMacSchedSapProvider::SchedDlRlcBufferReqParameters &req)
+{
+  return (req.m_rlcTransmissionQueueSize > 0)
+         || (req.m_rlcRetransmissionQueueSize > 0)
+         || (req.m_rlcStatusPduSize > 0);
+}
+
+void
+FfMacUeTable::Clear (void)
+{
+  m_ues.clear ();
+}
+
+void
+FfMacUeTable::AddUe (uint16_t rnti)
+{
+  NS_ASSERT (m_ues.empty () || m_ues.back ().rnti < rnti);
+  Ue ue;
+  ue.rnti = rnti;
+  ue.nLayers = 0;
+  ue.wbCqi = 0;
+  ue.sbCqi = 0;
+  ue.lcActives = 0;
+  ue.schedulable = true;
+  m_ues.push_back (ue);
+}
+
+uint32_t
+FfMacUeTable::Find (uint16_t rnti) const
+{
+  uint32_t first = 0;
+  uint32_t last = m_ues.size ();
+  while (first < last)
+    {
+      uint32_t middle = first + (last - first) / 2;
+      if (m_ues[middle].rnti < rnti)
+        {
+          first = middle + 1;
+        }
+      else
+        {
+          last = middle;
+        }
+    }
+  if (first < m_ues.size () && m_ues[first].rnti == rnti)
+    {
+      return first;
+    }
+  return m_ues.size ();
+}
+
+void
+FfMacUeTable::SetTxModes (const std::map <uint16_t, uint8_t> &uesTxMode)
+{
+  std::map <uint16_t, uint8_t>::const_iterator it = uesTxMode.begin ();
+  for (uint32_t i = 0; i < m_ues.size (); i++)
+    {
+      while (it != uesTxMode.end () && (*it).first < m_ues[i].rnti)
+        {
+          it++;
+        }
+      if (it != uesTxMode.end () && (*it).first == m_ues[i].rnti)
+        {
+          m_ues[i].nLayers = TransmissionModesLayers::TxMode2LayerNum ((*it).second);
+        }
+      else
+        {
+          m_ues[i].nLayers = 0;
+        }
+    }
+}
+
+void
+FfMacUeTable::SetWidebandCqis (const std::map <uint16_t, uint8_t> &p10CqiRxed)
+{
+  std::map <uint16_t, uint8_t>::const_iterator it = p10CqiRxed.begin ();
+  for (uint32_t i = 0; i < m_ues.size (); i++)
+    {
+      while (it != p10CqiRxed.end () && (*it).first < m_ues[i].rnti)
+        {
+          it++;
+        }
+      if (it != p10CqiRxed.end () && (*it).first == m_ues[i].rnti)
+        {
+          m_ues[i].wbCqi = &(*it).second;
+        }
+      else
+        {
+          m_ues[i].wbCqi = 0;
+        }
+    }
+}
+
+void
+FfMacUeTable::SetSubbandCqis (const std::map <uint16_t, SbMeasResult_s> &a30CqiRxed)
+{
+  std::map <uint16_t, SbMeasResult_s>::const_iterator it = a30CqiRxed.begin ();
+  for (uint32_t i = 0; i < m_ues.size (); i++)
+    {
+      while (it != a30CqiRxed.end () && (*it).first < m_ues[i].rnti)
+        {
+          it++;
+        }
+      if (it != a30CqiRxed.end () && (*it).first == m_ues[i].rnti)
+        {
+          m_ues[i].sbCqi = &(*it).second;
+        }
+      else
+        {
+          m_ues[i].sbCqi = 0;
+        }
+    }
+}
+
+void
+FfMacUeTable::SetLcActives (const RlcBufferReqMap &rlcBufferReq)
+{
+  RlcBufferReqMap::const_iterator it = rlcBufferReq.begin ();
+  for (uint32_t i = 0; i < m_ues.size (); i++)
+    {
+      m_ues[i].lcActives = 0;
+      while (it != rlcBufferReq.end () && (*it).first.m_rnti < m_ues[i].rnti)
+        {
+          it++;
+        }
+      for (; it != rlcBufferReq.end () && (*it).first.m_rnti == m_ues[i].rnti; it++)
+        {
+          if (IsLcActive ((*it).second))
+            {
+              m_ues[i].lcActives++;
+            }
+        }
+    }
+}
+
+void
+FfMacUeTable::SetNotSchedulable (const std::set <uint16_t> &rntis)
+{
+  for (std::set <uint16_t>::const_iterator it = rntis.begin (); it != rntis.end (); it++)
+    {
+      uint32_t i = Find (*it);
+      if (i < m_ues.size ())
+        {
+          m_ues[i].schedulable = false;
+        }
+    }
+}
+
+int
+FfMacUeTable::CountLcActives (const RlcBufferReqMap &rlcBufferReq, uint16_t rnti)
+{
+  // the logical channels of a UE are contiguous in the map
+  int lcActive = 0;
+  RlcBufferReqMap::const_iterator it;
+  for (it = rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0));
+       it != rlcBufferReq.end () && (*it).first.m_rnti == rnti; it++)
+    {
+      if (IsLcActive ((*it).second))
+        {
+          lcActive++;
+        }
+    }
+  return lcActive;
+}
+
+} // namespace ns3
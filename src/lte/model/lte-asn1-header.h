@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -69,13 +70,37 @@ protected:
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
   mutable Buffer m_serializationResult; //!< serialization result
+  mutable std::vector<uint8_t> m_serializationOctets; //!< octets serialized since the last FinalizeSerialization
 
   /**
-   * Function to write in m_serializationResult, after resizing its size
+   * Function to write an octet, appended to m_serializationResult by
+   * FinalizeSerialization
    * \param octet bits to write
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Serialize the least significant bits of a value, the most significant
+   * one first
+   * \param value value to serialize
+   * \param nBits number of bits to serialize, at most 32
+   */
+  void SerializeBits (uint32_t value, int nBits) const;
+  /**
+   * Deserialize bits, the most significant one first
+   * \param value buffer to store the result
+   * \param nBits number of bits to deserialize, at most 32
+   * \param bIterator buffer iterator
+   * \returns the modified buffer iterator
+   */
+  Buffer::Iterator DeserializeBits (uint32_t *value, int nBits,
+                                    Buffer::Iterator bIterator);
+  /**
+   * \param range number of values of a constrained whole number
+   * \returns the number of bits encoding the number (Clause 11.5.6 ITU-T X.691)
+   */
+  static int GetRequiredBits (int range);
+
   // Serialization functions
 
   /**
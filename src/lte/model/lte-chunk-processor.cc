@@ -50,7 +50,11 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
+  if (m_sumValues != 0)
+    {
+      // reuse the values of the previous calculation
+      (*m_sumValues) = 0.0;
+    }
   m_totDuration = MicroSeconds (0);
 }
 
@@ -59,11 +63,16 @@ void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
+  if (m_sumValues == 0 || m_sumValues->GetSpectrumModelUid () != sinr.GetSpectrumModelUid ())
     {
       m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
+  double seconds = duration.GetSeconds ();
+  Values::const_iterator value = sinr.ConstValuesBegin ();
+  for (Values::iterator sum = m_sumValues->ValuesBegin (); sum != m_sumValues->ValuesEnd (); ++sum, ++value)
+    {
+      (*sum) += (*value) * seconds;
+    }
   m_totDuration += duration;
 }
 
@@ -73,10 +82,11 @@ LteChunkProcessor::End ()
   NS_LOG_FUNCTION (this);
   if (m_totDuration.GetSeconds () > 0)
     {
+      (*m_sumValues) /= m_totDuration.GetSeconds ();
       std::vector<LteChunkProcessorCallback>::iterator it;
       for (it = m_lteChunkProcessorCallbacks.begin (); it != m_lteChunkProcessorCallbacks.end (); it++)
         {
-          (*it)((*m_sumValues) / m_totDuration.GetSeconds ());
+          (*it)(*m_sumValues);
         }
     }
   else
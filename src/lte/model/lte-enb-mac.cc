@@ -24,6 +24,8 @@
 #include <ns3/pointer.h>
 #include <ns3/packet.h>
 #include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/simulation-singleton.h>
 
 #include "lte-amc.h"
 #include "lte-control-messages.h"
@@ -33,6 +35,7 @@
 #include <ns3/lte-enb-mac.h>
 #include <ns3/lte-radio-bearer-tag.h>
 #include <ns3/lte-ue-phy.h>
+#include <ns3/lte-scheduler-thread-pool.h>
 
 #include "ns3/lte-mac-sap.h"
 #include <ns3/lte-common.h>
@@ -44,6 +47,9 @@ NS_LOG_COMPONENT_DEFINE ("LteEnbMac");
 
 NS_OBJECT_ENSURE_REGISTERED (LteEnbMac);
 
+/// Subframes after an allocation during which the HARQ processes of the
+/// schedulers may be in use, see HARQ_DL_TIMEOUT
+static const uint32_t HARQ_ACTIVITY_SUBFRAMES = 12;
 
 
 // //////////////////////////////////////
@@ -155,6 +161,11 @@ EnbMacMemberFfMacSchedSapUser::EnbMacMemberFfMacSchedSapUser (LteEnbMac* mac)
 void
 EnbMacMemberFfMacSchedSapUser::SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
 {
+  if (m_mac->m_holdSchedIndications)
+    {
+      m_mac->m_heldDlConfigInd.push_back (params);
+      return;
+    }
   m_mac->DoSchedDlConfigInd (params);
 }
 
@@ -163,6 +174,11 @@ EnbMacMemberFfMacSchedSapUser::SchedDlConfigInd (const struct SchedDlConfigIndPa
 void
 EnbMacMemberFfMacSchedSapUser::SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
 {
+  if (m_mac->m_holdSchedIndications)
+    {
+      m_mac->m_heldUlConfigInd.push_back (params);
+      return;
+    }
   m_mac->DoSchedUlConfigInd (params);
 }
 
@@ -251,6 +267,7 @@ public:
   virtual void UlCqiReport (FfMacSchedSapProvider::SchedUlCqiInfoReqParameters ulcqi);
   virtual void UlInfoListElementHarqFeeback (UlInfoListElement_s params);
   virtual void DlInfoListElementHarqFeeback (DlInfoListElement_s params);
+  virtual bool IsQuiescent ();
 
 private:
   LteEnbMac* m_mac;
@@ -303,6 +320,12 @@ EnbMacMemberLteEnbPhySapUser::DlInfoListElementHarqFeeback (DlInfoListElement_s
   m_mac->DoDlInfoListElementHarqFeeback (params);
 }
 
+bool
+EnbMacMemberLteEnbPhySapUser::IsQuiescent ()
+{
+  return m_mac->DoIsQuiescent ();
+}
+
 
 // //////////////////////////////////////
 // generic LteEnbMac methods
@@ -331,6 +354,12 @@ LteEnbMac::GetTypeId (void)
                    UintegerValue (3),
                    MakeUintegerAccessor (&LteEnbMac::m_raResponseWindowSize),
                    MakeUintegerChecker<uint8_t> (2, 10))
+    .AddAttribute ("ParallelScheduling",
+                   "If true, the scheduler is run along with those of the other eNBs starting "
+                   "a subframe at the same time, on the threads of LteSchedulerThreadPool",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbMac::m_parallelScheduling),
+                   MakeBooleanChecker ())
     .AddTraceSource ("DlScheduling",
                      "Information regarding DL scheduling.",
                      MakeTraceSourceAccessor (&LteEnbMac::m_dlScheduling),
@@ -346,6 +375,10 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ()
+  : m_holdSchedIndications (false),
+    m_rachInfoReqPending (false),
+    m_dataReported (false),
+    m_lastActiveSubframe (0)
 {
   NS_LOG_FUNCTION (this);
   m_macSapProvider = new EnbMacMemberLteMacSapProvider<LteEnbMac> (this);
@@ -452,29 +485,15 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   // Store current frame / subframe number
   m_frameNo = frameNo;
   m_subframeNo = subframeNo;
+  m_dataReported = false;
 
-
-  // --- DOWNLINK ---
-  // Send Dl-CQI info to the scheduler
-  if (m_dlCqiReceived.size () > 0)
-    {
-      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlcqiInfoReq;
-      dlcqiInfoReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
-
-      int cqiNum = m_dlCqiReceived.size ();
-      if (cqiNum > MAX_CQI_LIST)
-        {
-          cqiNum = MAX_CQI_LIST;
-        }
-      dlcqiInfoReq.m_cqiList.insert (dlcqiInfoReq.m_cqiList.begin (), m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
-      m_dlCqiReceived.erase (m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
-      m_schedSapProvider->SchedDlCqiInfoReq (dlcqiInfoReq);
-    }
-
-  if (!m_receivedRachPreambleCount.empty ())
+  // the RNTIs of the RACH preambles are allocated by the RRC, which is not
+  // done along with the scheduling when it runs on another thread
+  m_rachInfoReqPending = !m_receivedRachPreambleCount.empty ();
+  if (m_rachInfoReqPending)
     {
-      // process received RACH preambles and notify the scheduler
-      FfMacSchedSapProvider::SchedDlRachInfoReqParameters rachInfoReqParams;
+      // process received RACH preambles, the scheduler is notified in ScheduleDownlink
+      m_rachInfoReq.m_rachList.clear ();
       NS_ASSERT (subframeNo > 0 && subframeNo <= 10); // subframe in 1..10
       for (std::map<uint8_t, uint32_t>::const_iterator it = m_receivedRachPreambleCount.begin ();
            it != m_receivedRachPreambleCount.end ();
@@ -507,13 +526,52 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
               RachListElement_s rachLe;
               rachLe.m_rnti = rnti;
               rachLe.m_estimatedSize = 144; // to be confirmed
-              rachInfoReqParams.m_rachList.push_back (rachLe);
+              m_rachInfoReq.m_rachList.push_back (rachLe);
               m_rapIdRntiMap.insert (std::pair <uint16_t, uint32_t> (rnti, it->first));
             }
         }
-      m_schedSapProvider->SchedDlRachInfoReq (rachInfoReqParams);
       m_receivedRachPreambleCount.clear ();
     }
+
+  if (m_parallelScheduling)
+    {
+      SimulationSingleton<LteSchedulerThreadPool>::Get ()->Submit (this);
+    }
+  else
+    {
+      ScheduleDownlink ();
+      ScheduleUplink ();
+    }
+}
+
+void
+LteEnbMac::ScheduleDownlink (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // --- DOWNLINK ---
+  // Send Dl-CQI info to the scheduler
+  if (m_dlCqiReceived.size () > 0)
+    {
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlcqiInfoReq;
+      dlcqiInfoReq.m_sfnSf = ((0x3FF & m_frameNo) << 4) | (0xF & m_subframeNo);
+
+      int cqiNum = m_dlCqiReceived.size ();
+      if (cqiNum > MAX_CQI_LIST)
+        {
+          cqiNum = MAX_CQI_LIST;
+        }
+      dlcqiInfoReq.m_cqiList.insert (dlcqiInfoReq.m_cqiList.begin (), m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
+      m_dlCqiReceived.erase (m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
+      m_schedSapProvider->SchedDlCqiInfoReq (dlcqiInfoReq);
+    }
+
+  if (m_rachInfoReqPending)
+    {
+      m_schedSapProvider->SchedDlRachInfoReq (m_rachInfoReq);
+      m_rachInfoReqPending = false;
+    }
+
   // Get downlink transmission opportunities
   uint32_t dlSchedFrameNo = m_frameNo;
   uint32_t dlSchedSubframeNo = m_subframeNo;
@@ -539,20 +597,25 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     }
 
   m_schedSapProvider->SchedDlTriggerReq (dlparams);
+}
 
+void
+LteEnbMac::ScheduleUplink (void)
+{
+  NS_LOG_FUNCTION (this);
 
   // --- UPLINK ---
   // Send UL-CQI info to the scheduler
   std::vector <FfMacSchedSapProvider::SchedUlCqiInfoReqParameters>::iterator itCqi;
   for (uint16_t i = 0; i < m_ulCqiReceived.size (); i++)
     {
-      if (subframeNo > 1)
+      if (m_subframeNo > 1)
         {        
-          m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & (subframeNo - 1));
+          m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & m_frameNo) << 4) | (0xF & (m_subframeNo - 1));
         }
       else
         {
-          m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & (frameNo - 1)) << 4) | (0xF & 10);
+          m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & (m_frameNo - 1)) << 4) | (0xF & 10);
         }
       m_schedSapProvider->SchedUlCqiInfoReq (m_ulCqiReceived.at (i));
     }
@@ -562,7 +625,7 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   if (m_ulCeReceived.size () > 0)
     {
       FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters ulMacReq;
-      ulMacReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
+      ulMacReq.m_sfnSf = ((0x3FF & m_frameNo) << 4) | (0xF & m_subframeNo);
       ulMacReq.m_macCeList.insert (ulMacReq.m_macCeList.begin (), m_ulCeReceived.begin (), m_ulCeReceived.end ());
       m_ulCeReceived.erase (m_ulCeReceived.begin (), m_ulCeReceived.end ());
       m_schedSapProvider->SchedUlMacCtrlInfoReq (ulMacReq);
@@ -594,7 +657,40 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     }
 
   m_schedSapProvider->SchedUlTriggerReq (ulparams);
+}
+
+void
+LteEnbMac::RunScheduler (bool downlink)
+{
+  NS_LOG_FUNCTION (this << downlink);
+  m_holdSchedIndications = true;
+  if (downlink)
+    {
+      ScheduleDownlink ();
+    }
+  else
+    {
+      ScheduleUplink ();
+    }
+  m_holdSchedIndications = false;
+}
 
+void
+LteEnbMac::DeliverSchedulingIndications (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<FfMacSchedSapUser::SchedDlConfigIndParameters>::const_iterator it = m_heldDlConfigInd.begin ();
+       it != m_heldDlConfigInd.end (); ++it)
+    {
+      DoSchedDlConfigInd (*it);
+    }
+  m_heldDlConfigInd.clear ();
+  for (std::vector<FfMacSchedSapUser::SchedUlConfigIndParameters>::const_iterator it = m_heldUlConfigInd.begin ();
+       it != m_heldUlConfigInd.end (); ++it)
+    {
+      DoSchedUlConfigInd (*it);
+    }
+  m_heldUlConfigInd.clear ();
 }
 
 
@@ -955,6 +1051,11 @@ LteEnbMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters
   req.m_rlcRetransmissionHolDelay = params.retxQueueHolDelay;
   req.m_rlcStatusPduSize = params.statusPduSize;
   m_schedSapProvider->SchedDlRlcBufferReq (req);
+  if (params.txQueueSize > 0 || params.retxQueueSize > 0 || params.statusPduSize > 0)
+    {
+      m_dataReported = true;
+      m_enbPhySapProvider->NotifyDataPending ();
+    }
 }
 
 
@@ -969,6 +1070,10 @@ void
 LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (!ind.m_buildDataList.empty () || !ind.m_buildRarList.empty ())
+    {
+      NotifySchedulerActivity ();
+    }
   // Create DL PHY PDU
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
@@ -1096,6 +1201,10 @@ void
 LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (!ind.m_dciList.empty ())
+    {
+      NotifySchedulerActivity ();
+    }
 
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
@@ -1209,4 +1318,24 @@ LteEnbMac::DoDlInfoListElementHarqFeeback (DlInfoListElement_s params)
 }
 
 
+bool
+LteEnbMac::DoIsQuiescent (void) const
+{
+  if (!m_receivedRachPreambleCount.empty () || m_rachInfoReqPending || m_dataReported
+      || !m_ulCqiReceived.empty () || !m_ulCeReceived.empty ()
+      || !m_dlInfoListReceived.empty () || !m_ulInfoListReceived.empty ())
+    {
+      return false;
+    }
+  // HARQ feedbacks and retransmissions may follow an allocation
+  return m_frameNo * 10 + m_subframeNo >= m_lastActiveSubframe + HARQ_ACTIVITY_SUBFRAMES;
+}
+
+void
+LteEnbMac::NotifySchedulerActivity (void)
+{
+  m_lastActiveSubframe = m_frameNo * 10 + m_subframeNo;
+}
+
+
 } // namespace ns3
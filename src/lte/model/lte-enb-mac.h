@@ -35,6 +35,7 @@
 #include "ns3/trace-source-accessor.h"
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
+#include <ns3/nstime.h>
 
 namespace ns3 {
 
@@ -120,6 +121,23 @@ public:
   */
   void SetLteEnbPhySapProvider (LteEnbPhySapProvider* s);
 
+  /**
+   * \brief Run the downlink or the uplink part of the scheduling of the
+   * current subframe, holding back the indications of the scheduler
+   *
+   * Used by LteSchedulerThreadPool when ParallelScheduling is enabled.  It
+   * may be invoked on any thread, as it only involves the MAC, its scheduler
+   * and the FFR algorithm of the scheduler.
+   *
+   * \param downlink true for the downlink part, false for the uplink part
+   */
+  void RunScheduler (bool downlink);
+  /**
+   * \brief Process the indications of the scheduler held back by
+   * RunScheduler ()
+   */
+  void DeliverSchedulingIndications (void);
+
   /**
    * TracedCallback signature for DL scheduling events.
    *
@@ -201,6 +219,15 @@ private:
 
   // forwarded from LteEnbPhySapUser
   void DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo);
+
+  /**
+   * \brief Run the downlink part of the scheduling of the current subframe
+   */
+  void ScheduleDownlink (void);
+  /**
+   * \brief Run the uplink part of the scheduling of the current subframe
+   */
+  void ScheduleUplink (void);
   void DoReceiveRachPreamble (uint8_t prachId);
 
 public:
@@ -210,6 +237,17 @@ public:
 private:
   void DoUlInfoListElementHarqFeeback (UlInfoListElement_s params);
   void DoDlInfoListElementHarqFeeback (DlInfoListElement_s params);
+  /**
+   * \returns true if no input waits for the scheduler but DL CQIs, no data
+   * has been reported since the last subframe and the scheduler has
+   * allocated nothing during a HARQ round trip
+   */
+  bool DoIsQuiescent (void) const;
+  /**
+   * \brief Record that the scheduler has allocated resources in the
+   * current subframe
+   */
+  void NotifySchedulerActivity (void);
 
   //            rnti,             lcid, SAP of the RLC instance
   std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> > m_rlcAttached;
@@ -247,6 +285,15 @@ private:
 
   uint32_t m_frameNo;
   uint32_t m_subframeNo;
+
+  bool m_parallelScheduling; ///< run the scheduler on the threads of LteSchedulerThreadPool
+  bool m_holdSchedIndications; ///< hold back the indications of the scheduler, see RunScheduler
+  std::vector<FfMacSchedSapUser::SchedDlConfigIndParameters> m_heldDlConfigInd; ///< DL indications held back
+  std::vector<FfMacSchedSapUser::SchedUlConfigIndParameters> m_heldUlConfigInd; ///< UL indications held back
+  bool m_rachInfoReqPending; ///< true if m_rachInfoReq is to be sent to the scheduler
+  FfMacSchedSapProvider::SchedDlRachInfoReqParameters m_rachInfoReq; ///< RACH info of the current subframe
+  bool m_dataReported; ///< true if the RLC has reported data since the last subframe indication
+  uint32_t m_lastActiveSubframe; ///< index of the last subframe in which the scheduler allocated resources
   /**
    * Trace information regarding DL scheduling
    * Frame number, Subframe number, RNTI, MCS of TB1, size of TB1,
@@ -61,6 +61,11 @@ public:
   */
   virtual uint8_t GetMacChTtiDelay () = 0;
 
+  /**
+   * \brief Notify the PHY that the MAC has data to schedule, so that it
+   * does not skip the coming subframes
+   */
+  virtual void NotifyDataPending () = 0;
 
 };
 
@@ -125,6 +130,12 @@ public:
    */
   virtual void DlInfoListElementHarqFeeback (DlInfoListElement_s params) = 0;
 
+  /**
+   * \returns true if the MAC and the scheduler have nothing to process in
+   * the coming subframes, so that the PHY may skip them
+   */
+  virtual bool IsQuiescent () = 0;
+
 };
 
 
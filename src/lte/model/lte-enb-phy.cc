@@ -26,6 +26,7 @@
 #include <ns3/simulator.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 
 
 #include "lte-enb-phy.h"
@@ -82,7 +83,7 @@ public:
   virtual void SetCellId (uint16_t cellId);
   virtual void SendLteControlMessage (Ptr<LteControlMessage> msg);
   virtual uint8_t GetMacChTtiDelay ();
-
+  virtual void NotifyDataPending ();
 
 private:
   LteEnbPhy* m_phy;
@@ -123,6 +124,12 @@ EnbMemberLteEnbPhySapProvider::GetMacChTtiDelay ()
   return (m_phy->DoGetMacChTtiDelay ());
 }
 
+void
+EnbMemberLteEnbPhySapProvider::NotifyDataPending ()
+{
+  m_phy->WakeUp ();
+}
+
 
 ////////////////////////////////////////
 // generic LteEnbPhy methods
@@ -142,6 +149,9 @@ LteEnbPhy::LteEnbPhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_enbCphySapUser (0),
     m_nrFrames (0),
     m_nrSubFrames (0),
+    m_skipIdleSubframes (false),
+    m_idleFrameNo (0),
+    m_idleSubframeNo (0),
     m_srsPeriodicity (0),
     m_srsStartTime (Seconds (0)),
     m_currentSrsOffset (0),
@@ -192,6 +202,21 @@ LteEnbPhy::GetTypeId (void)
                    MakeUintegerAccessor (&LteEnbPhy::SetMacChDelay, 
                                          &LteEnbPhy::GetMacChDelay),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("SkipIdleSubframes",
+                   "If true, the subframes which carry no broadcast signal "
+                   "(MIB, SIB1 or PSS) nor SRS are not processed while the "
+                   "eNB is quiescent: nothing is queued for transmission or "
+                   "expected in uplink, and the MAC has no input for the "
+                   "scheduler, no data reported since the last subframe "
+                   "and no allocation during a HARQ round trip.  The "
+                   "subframe loop resumes at the next subframe boundary "
+                   "upon reception of a RACH preamble, a PDU or a control "
+                   "message other than a DL CQI, or upon request of the "
+                   "MAC.  Note that the skipped subframes do not interfere "
+                   "with the control region of the neighbouring cells.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbPhy::m_skipIdleSubframes),
+                   MakeBooleanChecker ())
     .AddTraceSource ("ReportUeSinr",
                      "Report UEs' averaged linear SINR",
                      MakeTraceSourceAccessor (&LteEnbPhy::m_reportUeSinr),
@@ -398,6 +423,7 @@ void
 LteEnbPhy::DoSendMacPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this);
+  WakeUp ();
   SetMacPdu (p);
 }
 
@@ -412,6 +438,7 @@ void
 LteEnbPhy::PhyPduReceived (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this);
+  WakeUp ();
   m_enbPhySapUser->ReceivePhyPdu (p);
 }
 
@@ -487,6 +514,7 @@ void
 LteEnbPhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
+  WakeUp ();
   // queues the message (wait for MAC-PHY delay)
   SetControlMessages (msg);
 }
@@ -508,6 +536,12 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
   std::list<Ptr<LteControlMessage> >::iterator it;
   for (it = msgList.begin (); it != msgList.end (); it++)
     {
+      // the DL CQIs wait for the next subframe processed, the other
+      // messages are handled by the MAC at the next subframe indication
+      if ((*it)->GetMessageType () != LteControlMessage::DL_CQI)
+        {
+          WakeUp ();
+        }
       switch ((*it)->GetMessageType ())
         {
         case LteControlMessage::RACH_PREAMBLE:
@@ -784,6 +818,36 @@ void
 LteEnbPhy::EndSubFrame (void)
 {
   NS_LOG_FUNCTION (this << Simulator::Now ().GetSeconds ());
+  if (m_skipIdleSubframes && IsIdle ())
+    {
+      // only subframes 1 (MIB and PSS) and 6 (SIB1 and PSS) are processed
+      uint32_t nSkipped = (m_nrSubFrames < 6) ? 5 - m_nrSubFrames : 10 - m_nrSubFrames;
+      // as well as the SRS occasions, as the UL CQI of an SRS is mapped to
+      // the UE by the SRS offset of the current subframe
+      if (m_srsPeriodicity > 0)
+        {
+          uint32_t index = (m_nrFrames - 1) * 10 + (m_nrSubFrames - 1);
+          for (uint32_t i = 1; i <= nSkipped; i++)
+            {
+              if (m_srsUeOffset.at ((index + i) % m_srsPeriodicity) != 0)
+                {
+                  nSkipped = i - 1;
+                  break;
+                }
+            }
+        }
+      if (nSkipped > 0)
+        {
+          NS_LOG_LOGIC (this << " skipping " << nSkipped << " idle subframes");
+          m_idleStart = Simulator::Now ();
+          m_idleFrameNo = m_nrFrames;
+          m_idleSubframeNo = m_nrSubFrames;
+          m_resumeSubFramesEvent = Simulator::Schedule (Seconds (GetTti ()) * nSkipped,
+                                                        &LteEnbPhy::ResumeSubFrames,
+                                                        this);
+          return;
+        }
+    }
   if (m_nrSubFrames == 10)
     {
       Simulator::ScheduleNow (&LteEnbPhy::EndFrame, this);
@@ -803,6 +867,75 @@ LteEnbPhy::EndFrame (void)
 }
 
 
+bool
+LteEnbPhy::IsIdle (void) const
+{
+  if (HasQueuedTransmissions ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_ulDciQueue.size (); i++)
+    {
+      if (!m_ulDciQueue.at (i).empty ())
+        {
+          return false;
+        }
+    }
+  return m_enbPhySapUser->IsQuiescent ();
+}
+
+
+void
+LteEnbPhy::ResumeSubFrames (void)
+{
+  NS_LOG_FUNCTION (this);
+  int64_t nSkipped = (Simulator::Now () - m_idleStart) / Seconds (GetTti ());
+  // index of the subframe starting now, counting from 0 at the first
+  // subframe of the first frame
+  uint64_t index = (m_idleFrameNo - 1) * 10 + m_idleSubframeNo + nSkipped;
+  uint32_t frameNo = index / 10 + 1;
+  uint32_t subframeNo = index % 10 + 1;
+  NS_LOG_LOGIC (this << " resuming at frame " << frameNo << " subframe " << subframeNo);
+  if (subframeNo == 1)
+    {
+      m_nrFrames = frameNo - 1;
+      StartFrame ();
+    }
+  else
+    {
+      m_nrFrames = frameNo;
+      m_nrSubFrames = subframeNo - 1;
+      StartSubFrame ();
+    }
+}
+
+
+void
+LteEnbPhy::WakeUp (void)
+{
+  if (!m_resumeSubFramesEvent.IsRunning ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  Time tti = Seconds (GetTti ());
+  int64_t nSkipped = (Simulator::Now () - m_idleStart) / tti;
+  Time resume = m_idleStart + tti * nSkipped;
+  if (resume < Simulator::Now ())
+    {
+      resume += tti;
+    }
+  Time delay = resume - Simulator::Now ();
+  if (delay < Simulator::GetDelayLeft (m_resumeSubFramesEvent))
+    {
+      m_resumeSubFramesEvent.Cancel ();
+      m_resumeSubFramesEvent = Simulator::Schedule (delay,
+                                                    &LteEnbPhy::ResumeSubFrames,
+                                                    this);
+    }
+}
+
+
 void 
 LteEnbPhy::GenerateCtrlCqiReport (const SpectrumValue& sinr)
 {
@@ -905,6 +1038,7 @@ LteEnbPhy::DoAddUe (uint16_t rnti)
  
   bool success = AddUePhy (rnti);
   NS_ASSERT_MSG (success, "AddUePhy() failed");
+  WakeUp ();
 
   // add default P_A value
   DoSetPa (rnti, 0);
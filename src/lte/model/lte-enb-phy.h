@@ -28,6 +28,7 @@
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/lte-phy.h>
 #include <ns3/lte-harq-phy.h>
+#include <ns3/event-id.h>
 
 #include <map>
 #include <set>
@@ -258,6 +259,23 @@ public:
    */
   void EndFrame (void);
 
+  /**
+   * \returns true if the eNB has nothing to send or to receive in the
+   * coming subframes and its MAC is quiescent, so that only the broadcast
+   * subframes and the SRS occasions need to be processed
+   */
+  bool IsIdle (void) const;
+  /**
+   * \brief Resume the subframe loop at the current subframe boundary, after
+   * idle subframes have been skipped
+   */
+  void ResumeSubFrames (void);
+  /**
+   * \brief Bring the resumption of the subframe loop forward to the next
+   * subframe boundary, if idle subframes are being skipped
+   */
+  void WakeUp (void);
+
   /**
    * \brief PhySpectrum received a new PHY-PDU
    */
@@ -380,6 +398,20 @@ private:
    */
   uint32_t m_nrSubFrames;
 
+  /**
+   * The `SkipIdleSubframes` attribute. If true, the subframes of an idle eNB
+   * which carry no broadcast signal nor SRS are not processed.
+   */
+  bool m_skipIdleSubframes;
+  /// Event resuming the subframe loop after idle subframes
+  EventId m_resumeSubFramesEvent;
+  /// Start of the first skipped subframe
+  Time m_idleStart;
+  /// Frame number of the last subframe processed before the skipped ones
+  uint32_t m_idleFrameNo;
+  /// Subframe number of the last subframe processed before the skipped ones
+  uint32_t m_idleSubframeNo;
+
   uint16_t m_srsPeriodicity;
   Time m_srsStartTime;
   std::map <uint16_t,uint16_t> m_srsCounter;
@@ -24,6 +24,7 @@
 
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <algorithm>
 
 
 namespace ns3 {
@@ -53,6 +54,8 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -75,7 +78,15 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   if (m_receiving == false)
     {
       NS_LOG_LOGIC ("first signal");
-      m_rxSignal = rxPsd->Copy ();
+      if (m_rxSignal == 0 || m_rxSignal->GetSpectrumModelUid () != rxPsd->GetSpectrumModelUid ())
+        {
+          m_rxSignal = rxPsd->Copy ();
+        }
+      else
+        {
+          std::copy (rxPsd->ConstValuesBegin (), rxPsd->ConstValuesEnd (), m_rxSignal->ValuesBegin ());
+        }
+      std::fill (m_rbChanged.begin (), m_rbChanged.end (), true);
       m_lastChangeTime = Now ();
       m_receiving = true;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
@@ -99,6 +110,7 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
       // make sure they use orthogonal resource blocks
       NS_ASSERT (Sum ((*rxPsd) * (*m_rxSignal)) == 0.0);
       (*m_rxSignal) += (*rxPsd);
+      MarkChangedRbs (*rxPsd);
     }
 }
 
@@ -156,6 +168,7 @@ LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
   (*m_allSignals) += (*spd);
+  MarkChangedRbs (*spd);
 }
 
 void
@@ -167,6 +180,7 @@ LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signa
   if (deltaSignalId > 0)
     {   
       (*m_allSignals) -= (*spd);
+      MarkChangedRbs (*spd);
     }
   else
     {
@@ -188,17 +202,15 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      UpdateSinr ();
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (*m_sinr, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (*m_interf, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
@@ -208,6 +220,39 @@ LteInterference::ConditionallyEvaluateChunk ()
     }
 }
 
+void
+LteInterference::MarkChangedRbs (const SpectrumValue& spd)
+{
+  Values::const_iterator value = spd.ConstValuesBegin ();
+  for (uint32_t i = 0; i < m_rbChanged.size (); i++, value++)
+    {
+      if (*value != 0.0)
+        {
+          m_rbChanged[i] = true;
+        }
+    }
+}
+
+void
+LteInterference::UpdateSinr ()
+{
+  NS_ASSERT (m_rxSignal->GetSpectrumModelUid () == m_noise->GetSpectrumModelUid ());
+  Values::const_iterator allSignals = m_allSignals->ConstValuesBegin ();
+  Values::const_iterator rxSignal = m_rxSignal->ConstValuesBegin ();
+  Values::const_iterator noise = m_noise->ConstValuesBegin ();
+  Values::iterator interf = m_interf->ValuesBegin ();
+  Values::iterator sinr = m_sinr->ValuesBegin ();
+  for (uint32_t i = 0; i < m_rbChanged.size (); i++)
+    {
+      if (m_rbChanged[i])
+        {
+          interf[i] = allSignals[i] - rxSignal[i] + noise[i];
+          sinr[i] = rxSignal[i] / interf[i];
+          m_rbChanged[i] = false;
+        }
+    }
+}
+
 void
 LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
 {
@@ -217,6 +262,9 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_rbChanged.assign (noisePsd->GetSpectrumModel ()->GetNumBands (), true);
   if (m_receiving == true)
     {
       // abort rx
@@ -28,6 +28,7 @@
 #include <ns3/spectrum-value.h>
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -42,6 +43,9 @@ class LteChunkProcessor;
  * This class implements a gaussian interference model, i.e., all
  * incoming signals are added to the total interference.
  *
+ * The interference and the SINR passed to the chunk processors are kept
+ * in buffers allocated along with the noise, and each chunk only
+ * computes them again on the RBs where a signal started or ended.
  */
 class LteInterference : public Object
 {
@@ -118,6 +122,18 @@ private:
   void ConditionallyEvaluateChunk ();
   void DoAddSignal  (Ptr<const SpectrumValue> spd);
   void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  /**
+   * Mark the RBs where a signal has power as needing their interference
+   * and SINR to be computed again
+   *
+   * @param spd the power spectral density of the signal
+   */
+  void MarkChangedRbs (const SpectrumValue& spd);
+  /**
+   * Compute the interference and the SINR of the RBs which have changed
+   * since the last chunk
+   */
+  void UpdateSinr ();
 
 
 
@@ -135,6 +151,17 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  Ptr<SpectrumValue> m_interf; /**< stores the interference plus
+                                * noise of the last chunk
+                                */
+
+  Ptr<SpectrumValue> m_sinr; /**< stores the SINR of the last chunk */
+
+  std::vector<bool> m_rbChanged; /**< for each RB, true if its
+                                  * interference and SINR have to be
+                                  * computed again
+                                  */
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
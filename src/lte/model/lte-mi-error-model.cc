@@ -323,105 +323,212 @@ static const double cEcrTable [9][38] = {
 };
 
 
+/**
+ * \brief SINR to MI mapping of a modulation, sampled at uniformly spaced SINRs
+ */
+struct MiMap
+{
+  const double *mi;      //!< MI per sample
+  const double *axis;    //!< SINR (linear) per sample
+  uint16_t size;         //!< number of samples
+  double scalingCoeff;   //!< inverse of the SINR step between two samples
+};
+
+/// SINR to MI mapping of QPSK
+static const MiMap g_miMapQpsk = {
+  MI_map_qpsk, MI_map_qpsk_axis, MI_MAP_QPSK_SIZE,
+  (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0])
+};
+/// SINR to MI mapping of 16-QAM
+static const MiMap g_miMap16qam = {
+  MI_map_16qam, MI_map_16qam_axis, MI_MAP_16QAM_SIZE,
+  (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0])
+};
+/// SINR to MI mapping of 64-QAM
+static const MiMap g_miMap64qam = {
+  MI_map_64qam, MI_map_64qam_axis, MI_MAP_64QAM_SIZE,
+  (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0])
+};
+
 double 
 LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
-  
-  double MI;
+
+  // the modulation is the same for all the RBs: select its mapping once
+  const MiMap *miMap;
+  if (mcs <= MI_QPSK_MAX_ID)
+    {
+      miMap = &g_miMapQpsk;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID)
+    {
+      miMap = &g_miMap16qam;
+    }
+  else
+    {
+      miMap = &g_miMap64qam;
+    }
+  const double maxSinr = miMap->axis[miMap->size - 1];
+  const double minSinr = miMap->axis[0];
+  const double scalingCoeff = miMap->scalingCoeff;
+  const double *mi = miMap->mi;
+
+  Values::const_iterator sinrValues = sinr.ConstValuesBegin ();
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
+      double sinrLin = sinrValues[map[i]];
+      double MI;
+      if (sinrLin > maxSinr)
         {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
+          MI = 1;
         }
       else
         {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
+          // since the values of the axis are uniformly spaced, we have
+          // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+          double sinrIndexDouble = (sinrLin - minSinr) * scalingCoeff + 1;
+          uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+          NS_ASSERT_MSG (sinrIndex < miMap->size, "MI map out of data");
+          MI = mi[sinrIndex];
         }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      NS_LOG_LOGIC (" RB " << map[i] << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
     }
-  MI = MIsum / map.size ();
+  double MI = MIsum / map.size ();
   NS_LOG_LOGIC (" MI = " << MI);
   return MI;
 }
 
 
+/**
+ * \param cbSize the size of a code block
+ * \return the index of the largest CB size of the BLER curves not greater
+ * than the size of the code block
+ */
+static int
+GetCbMiSizeIndex (uint16_t cbSize)
+{
+  int cbIndex = 1;
+  while ((cbIndex < 9)&&(cbMiSizeTable[cbIndex]<= cbSize))
+    {
+      cbIndex++;
+    }
+  return cbIndex - 1;
+}
+
+/// Number of intervals of the quantized BLER curves
+static const uint32_t BLER_CURVE_INTERVALS = 512;
+/// Half width of the quantized BLER curves, in units of the c parameter
+static const double BLER_CURVE_HALF_WIDTH = 6.0;
+
+/**
+ * \brief A BLER curve sampled at uniformly spaced MIBs
+ *
+ * The curve is sampled around its b parameter, within
+ * BLER_CURVE_HALF_WIDTH times its c parameter, beyond which the BLER
+ * differs from 1 or 0 by less than 1e-9.
+ */
+struct BlerCurve
+{
+  double minMib;              //!< MIB of the first sample
+  double scalingCoeff;        //!< inverse of the MIB step between two samples
+  std::vector<double> bler;   //!< BLER per sample, empty if not sampled
+};
+
+/**
+ * \brief The BLER curves of all the ECRs and CB sizes, sampled at once
+ */
+class BlerCurves
+{
+public:
+  BlerCurves ()
+  {
+    for (uint8_t cbIndex = 0; cbIndex < 9; cbIndex++)
+      {
+        for (uint8_t ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+          {
+            BlerCurve &curve = m_curves[cbIndex][ecrId];
+            double b = bEcrTable[cbIndex][ecrId];
+            double c = cEcrTable[cbIndex][ecrId];
+            // curves of unsupported ECRs and CB sizes are evaluated exactly
+            for (int i = cbIndex; (i < 9) && (b < 0); i++)
+              {
+                b = bEcrTable[i][ecrId];
+              }
+            for (int i = cbIndex; (i < 9) && (c < 0); i++)
+              {
+                c = cEcrTable[i][ecrId];
+              }
+            if (b < 0 || c <= 0)
+              {
+                continue;
+              }
+            double step = 2 * BLER_CURVE_HALF_WIDTH * c / BLER_CURVE_INTERVALS;
+            curve.minMib = b - BLER_CURVE_HALF_WIDTH * c;
+            curve.scalingCoeff = 1 / step;
+            curve.bler.resize (BLER_CURVE_INTERVALS + 1);
+            uint16_t cbSize = cbMiSizeTable[cbIndex];
+            for (uint32_t i = 0; i <= BLER_CURVE_INTERVALS; i++)
+              {
+                curve.bler[i] = LteMiErrorModel::MappingMiBlerExact (curve.minMib + i * step, ecrId, cbSize);
+              }
+          }
+      }
+  }
+
+  /**
+   * \param cbIndex the index of the CB size in cbMiSizeTable
+   * \param ecrId the ECR ID
+   * \return the curve
+   */
+  const BlerCurve& Get (int cbIndex, uint8_t ecrId) const
+  {
+    return m_curves[cbIndex][ecrId];
+  }
+
+private:
+  BlerCurve m_curves[9][MI_64QAM_BLER_MAX_ID + 1];  //!< curves per CB size and ECR
+};
+
 double 
 LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
+{
+  NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
+  NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
+
+  static const BlerCurves curves;
+  const BlerCurve &curve = curves.Get (GetCbMiSizeIndex (cbSize), ecrId);
+  if (curve.bler.empty ())
+    {
+      return MappingMiBlerExact (mib, ecrId, cbSize);
+    }
+  // linear interpolation between the two closest samples
+  double x = (mib - curve.minMib) * curve.scalingCoeff;
+  if (x <= 0)
+    {
+      return curve.bler.front ();
+    }
+  if (x >= BLER_CURVE_INTERVALS)
+    {
+      return curve.bler.back ();
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double bler = curve.bler[i] + (x - i) * (curve.bler[i + 1] - curve.bler[i]);
+  NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler);
+  return bler;
+}
+
+double 
+LteMiErrorModel::MappingMiBlerExact (double mib, uint8_t ecrId, uint16_t cbSize)
 {
   NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
   double b = 0;
   double c = 0;
 
   NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
-  int cbIndex = 1;
-  while ((cbIndex < 9)&&(cbMiSizeTable[cbIndex]<= cbSize))
-    {
-      cbIndex++;
-    }
-  cbIndex--;
+  int cbIndex = GetCbMiSizeIndex (cbSize);
   NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
 
   b = bEcrTable[cbIndex][ecrId];
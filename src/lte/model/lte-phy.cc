@@ -240,6 +240,26 @@ LtePhy::GetControlMessages (void)
     }
 }
 
+bool
+LtePhy::HasQueuedTransmissions (void) const
+{
+  for (uint32_t i = 0; i < m_packetBurstQueue.size (); i++)
+    {
+      if (m_packetBurstQueue.at (i)->GetNPackets () > 0)
+        {
+          return true;
+        }
+    }
+  for (uint32_t i = 0; i < m_controlMessagesQueue.size (); i++)
+    {
+      if (!m_controlMessagesQueue.at (i).empty ())
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 
 void
 LtePhy::DoSetCellId (uint16_t cellId)
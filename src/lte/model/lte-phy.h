@@ -175,6 +175,12 @@ public:
   */
   std::list<Ptr<LteControlMessage> > GetControlMessages (void);
 
+  /**
+  * \returns true if a packet or a control message waits in the queues for
+  * a future TTI
+  */
+  bool HasQueuedTransmissions (void) const;
+
 
   /** 
    * generate a CQI report based on the given SINR of Ctrl frame
@@ -37,6 +37,8 @@ LteRlcAmHeader::LteRlcAmHeader ()
     m_sequenceNumber (0xfffa),
     m_segmentOffset (0xffff),
     m_lastOffset (0xffff),
+    m_extensionBitsPopped (0),
+    m_lengthIndicatorsPopped (0),
     m_controlPduType (0xff),
     m_ackSn (0xffff),
     m_nackSn (0xffff)
@@ -134,8 +136,7 @@ LteRlcAmHeader::PushLengthIndicator (uint16_t lengthIndicator)
 uint8_t
 LteRlcAmHeader::PopExtensionBit (void)
 {
-  uint8_t extensionBit = m_extensionBits.front ();
-  m_extensionBits.pop_front ();
+  uint8_t extensionBit = m_extensionBits.at (m_extensionBitsPopped++);
 
   return extensionBit;
 }
@@ -143,8 +144,7 @@ LteRlcAmHeader::PopExtensionBit (void)
 uint16_t
 LteRlcAmHeader::PopLengthIndicator (void)
 {
-  uint16_t lengthIndicator = m_lengthIndicators.front ();
-  m_lengthIndicators.pop_front ();
+  uint16_t lengthIndicator = m_lengthIndicators.at (m_lengthIndicatorsPopped++);
 
   return lengthIndicator;
 }
@@ -241,8 +241,8 @@ LteRlcAmHeader::GetInstanceTypeId (void) const
 void
 LteRlcAmHeader::Print (std::ostream &os)  const
 {
-  std::list <uint8_t>::const_iterator it1 = m_extensionBits.begin ();
-  std::list <uint16_t>::const_iterator it2 = m_lengthIndicators.begin ();
+  std::vector <uint8_t>::const_iterator it1 = m_extensionBits.begin () + m_extensionBitsPopped;
+  std::vector <uint16_t>::const_iterator it2 = m_lengthIndicators.begin () + m_lengthIndicatorsPopped;
 
   os << "Len=" << m_headerLength;
   os << " D/C=" << (uint16_t)m_dataControlBit;
@@ -294,8 +294,8 @@ void LteRlcAmHeader::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  std::list <uint8_t>::const_iterator it1 = m_extensionBits.begin ();
-  std::list <uint16_t>::const_iterator it2 = m_lengthIndicators.begin ();
+  std::vector <uint8_t>::const_iterator it1 = m_extensionBits.begin () + m_extensionBitsPopped;
+  std::vector <uint16_t>::const_iterator it2 = m_lengthIndicators.begin () + m_lengthIndicatorsPopped;
 
   if ( m_dataControlBit == DATA_PDU )
     {
@@ -363,6 +363,10 @@ uint32_t LteRlcAmHeader::Deserialize (Buffer::Iterator start)
 
   byte_1 = i.ReadU8 ();
   m_headerLength = 1;
+  m_extensionBits.clear ();
+  m_lengthIndicators.clear ();
+  m_extensionBitsPopped = 0;
+  m_lengthIndicatorsPopped = 0;
   m_dataControlBit = (byte_1 & 0x80) >> 7;
 
   if ( m_dataControlBit == DATA_PDU )
@@ -25,6 +25,7 @@
 #include "ns3/lte-rlc-sequence-number.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -149,8 +150,10 @@ private:
   uint16_t m_segmentOffset;
   uint16_t m_lastOffset;
 
-  std::list <uint8_t> m_extensionBits; // Includes extensionBit of the fixed part
-  std::list <uint16_t> m_lengthIndicators;
+  std::vector <uint8_t> m_extensionBits; // Includes extensionBit of the fixed part
+  std::vector <uint16_t> m_lengthIndicators;
+  uint16_t m_extensionBitsPopped;    // Extension bits already popped
+  uint16_t m_lengthIndicatorsPopped; // Length indicators already popped
 
   // Control PDU fields
   uint8_t  m_controlPduType;
@@ -23,7 +23,6 @@
 
 #include "ns3/lte-rlc-am-header.h"
 #include "ns3/lte-rlc-am.h"
-#include "ns3/lte-rlc-sdu-status-tag.h"
 #include "ns3/lte-rlc-tag.h"
 
 namespace ns3 {
@@ -38,10 +37,12 @@ LteRlcAm::LteRlcAm ()
 
   // Buffers
   m_txonBufferSize = 0;
+  m_txonBufferOffset = 0;
   m_retxBuffer.resize (1024);
   m_retxBufferSize = 0;
   m_txedBuffer.resize (1024);
   m_txedBufferSize = 0;
+  m_rxonBuffer.resize (1024);
 
   m_statusPduRequested = false;
   m_statusPduBufferSize = 0;
@@ -116,6 +117,7 @@ LteRlcAm::DoDispose ()
 
   m_txonBuffer.clear ();
   m_txonBufferSize = 0;
+  m_txonBufferOffset = 0;
   m_txedBuffer.clear ();
   m_txedBufferSize = 0;
   m_retxBuffer.clear ();
@@ -145,10 +147,6 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
 
   /** Store PDCP PDU */
 
-  LteRlcSduStatusTag tag;
-  tag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-  p->AddPacketTag (tag);
-
   NS_LOG_LOGIC ("Txon Buffer: New packet added");
   m_txonBuffer.push_back (p);
   m_txonBufferSize += p->GetSize ();
@@ -317,15 +315,15 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   LteRlcAmHeader rlcAmHeader;
   rlcAmHeader.SetDataPdu ();
 
-  // Build Data field
+  // Build Data field. The SDUs stay in the transmission buffer until
+  // they are completely sent: the Data field refers to segments of them,
+  // and m_txonBufferOffset tells how much of the first one has been sent
   uint32_t nextSegmentSize = bytes - 4;
   uint32_t nextSegmentId = 1;
-  uint32_t dataFieldTotalSize = 0;
-  uint32_t dataFieldAddedSize = 0;
   std::vector < Ptr<Packet> > dataField;
+  bool firstByte = (m_txonBufferOffset == 0);
+  bool lastByte = false;
 
-  // Remove the first packet from the transmission buffer.
-  // If only a segment of the packet is taken, then the remaining is given back later
   if ( m_txonBuffer.size () == 0 )
     {
       NS_LOG_LOGIC ("No data pending");
@@ -333,172 +331,79 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     }
 
   NS_LOG_LOGIC ("SDUs in TxonBuffer  = " << m_txonBuffer.size ());
-  NS_LOG_LOGIC ("First SDU buffer  = " << *(m_txonBuffer.begin()));
-  NS_LOG_LOGIC ("First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
+  NS_LOG_LOGIC ("First SDU offset  = " << m_txonBufferOffset);
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
-  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
-  m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-  NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
 
-  while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
+  while ( ! m_txonBuffer.empty () && (nextSegmentSize > 0) )
     {
-      NS_LOG_LOGIC ("WHILE ( firstSegment && firstSegment->GetSize > 0 && nextSegmentSize > 0 )");
-      NS_LOG_LOGIC ("    firstSegment size = " << firstSegment->GetSize ());
-      NS_LOG_LOGIC ("    nextSegmentSize   = " << nextSegmentSize);
-      if ( (firstSegment->GetSize () > nextSegmentSize) ||
+      Ptr<Packet> sdu = m_txonBuffer.front ();
+      uint32_t remainingSize = sdu->GetSize () - m_txonBufferOffset;
+      NS_LOG_LOGIC ("    remaining SDU size = " << remainingSize);
+      NS_LOG_LOGIC ("    nextSegmentSize    = " << nextSegmentSize);
+
+      if ( (remainingSize > nextSegmentSize) ||
            // Segment larger than 2047 octets can only be mapped to the end of the Data field
-           (firstSegment->GetSize () > 2047)
+           (remainingSize > 2047)
          )
         {
           // Take the minimum size, due to the 2047-bytes 3GPP exception
           // This exception is due to the length of the LI field (just 11 bits)
-          uint32_t currSegmentSize = std::min (firstSegment->GetSize (), nextSegmentSize);
-
-          NS_LOG_LOGIC ("    IF ( firstSegment > nextSegmentSize ||");
-          NS_LOG_LOGIC ("         firstSegment > 2047 )");
-
-          // Segment txBuffer.FirstBuffer and
-          // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
-          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
-
-          // Status tag of the new and remaining segments
-          // Note: This is the only place where a PDU is segmented and
-          // therefore its status can change
-          LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
-          if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
-              oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-          else if (oldTag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::MIDDLE_SEGMENT);
-              //oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-
-          // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
+          uint32_t currSegmentSize = std::min (remainingSize, nextSegmentSize);
+          dataField.push_back (sdu->CreateFragment (m_txonBufferOffset, currSegmentSize));
+          m_txonBufferSize -= currSegmentSize;
+          if (currSegmentSize < remainingSize)
             {
-              firstSegment->AddPacketTag (oldTag);
-
-              m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-              m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize ();
-
-              NS_LOG_LOGIC ("    Txon buffer: Give back the remaining segment");
-              NS_LOG_LOGIC ("    Txon buffers = " << m_txonBuffer.size ());
-              NS_LOG_LOGIC ("    Front buffer size = " << (*(m_txonBuffer.begin()))->GetSize ());
-              NS_LOG_LOGIC ("    txonBufferSize = " << m_txonBufferSize );
+              // The remaining segment stays in the transmission buffer
+              m_txonBufferOffset += currSegmentSize;
+              lastByte = false;
             }
           else
             {
-              // Whole segment was taken, so adjust tag
-              if (newTag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-                }
-              else if (newTag.GetStatus () == LteRlcSduStatusTag::MIDDLE_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-                }
+              m_txonBuffer.pop_front ();
+              m_txonBufferOffset = 0;
+              lastByte = true;
             }
-          // Segment is completely taken or
-          // the remaining segment is given back to the transmission buffer
-          firstSegment = 0;
-
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
-
-          // Add Segment to Data field
-          dataFieldAddedSize = newSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (newSegment);
-          newSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::DATA_FIELD_FOLLOWS);
 
           // no LengthIndicator for the last one
+          break;
+        }
 
-          nextSegmentSize -= dataFieldAddedSize;
-          nextSegmentId++;
-
-          // nextSegmentSize MUST be zero (only if segment is smaller or equal to 2047)
-
-          // (NO more segments) → exit
-          // break;
+      // Add the remaining SDU (or the whole SDU) to the Data field
+      if (m_txonBufferOffset == 0)
+        {
+          dataField.push_back (sdu);
         }
-      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txonBuffer.size () == 0) )
+      else
         {
-          NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txonBuffer.size == 0");
-
-          // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
-          firstSegment = 0;
+          dataField.push_back (sdu->CreateFragment (m_txonBufferOffset, remainingSize));
+        }
+      m_txonBuffer.pop_front ();
+      m_txonBufferOffset = 0;
+      m_txonBufferSize -= remainingSize;
+      lastByte = true;
 
+      if ( (nextSegmentSize - remainingSize <= 2) || m_txonBuffer.empty () )
+        {
           // ExtensionBit (Next_Segment - 1) = 0
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::DATA_FIELD_FOLLOWS);
 
           // no LengthIndicator for the last one
-
-          nextSegmentSize -= dataFieldAddedSize;
-          nextSegmentId++;
-
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.size ());
-          if (m_txonBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
-            }
-          NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-
-          // nextSegmentSize <= 2 (only if txBuffer is not empty)
-
-          // (NO more segments) → exit
-          // break;
+          break;
         }
-      else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txBuffer.size () > 0)
-        {
-          NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txonBuffer.size > 0");
-          // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
-
-          // ExtensionBit (Next_Segment - 1) = 1
-          rlcAmHeader.PushExtensionBit (LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
 
-          // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
-          rlcAmHeader.PushLengthIndicator (firstSegment->GetSize ());
+      // ExtensionBit (Next_Segment - 1) = 1
+      rlcAmHeader.PushExtensionBit (LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
 
-          nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
-          nextSegmentId++;
-
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.size ());
-          if (m_txonBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
-            }
-          NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-          NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
-
-          // (more segments)
-          firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
-          m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
-          NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
-        }
+      // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
+      rlcAmHeader.PushLengthIndicator (remainingSize);
 
+      nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + remainingSize;
+      nextSegmentId++;
     }
+  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize );
 
   //
   // Build RLC header
@@ -509,50 +414,18 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   rlcAmHeader.SetLastSegmentFlag (LteRlcAmHeader::LAST_PDU_SEGMENT);
   rlcAmHeader.SetSegmentOffset (0);
 
-  // Calculate FramingInfo flag according the status of the SDUs in the DataField
-  uint8_t framingInfo = 0;
-  std::vector< Ptr<Packet> >::iterator it;
-  it = dataField.begin ();
-
-  // FIRST SEGMENT
-  LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-       (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
-     )
-    {
-      framingInfo |= LteRlcAmHeader::FIRST_BYTE;
-    }
-  else
-    {
-      framingInfo |= LteRlcAmHeader::NO_FIRST_BYTE;
-    }
-  (*it)->AddPacketTag (tag);
-
   // Add all SDUs (in DataField) to the Packet
-  while (it < dataField.end ())
+  for (std::vector< Ptr<Packet> >::iterator it = dataField.begin (); it != dataField.end (); ++it)
     {
       NS_LOG_LOGIC ("Adding SDU/segment to packet, length = " << (*it)->GetSize ());
-
       packet->AddAtEnd (*it);
-      it++;
     }
 
-  // LAST SEGMENT (Note: There could be only one and be the first one)
-  it--;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
-    {
-      framingInfo |= LteRlcAmHeader::LAST_BYTE;
-    }
-  else
-    {
-      framingInfo |= LteRlcAmHeader::NO_LAST_BYTE;
-    }
-  (*it)->AddPacketTag (tag);
-
-  // Set the FramingInfo flag after the calculation
+  // FramingInfo flag: whether the Data field starts with the first byte
+  // of an SDU and ends with the last byte of an SDU
+  uint8_t framingInfo = 0;
+  framingInfo |= firstByte ? LteRlcAmHeader::FIRST_BYTE : LteRlcAmHeader::NO_FIRST_BYTE;
+  framingInfo |= lastByte ? LteRlcAmHeader::LAST_BYTE : LteRlcAmHeader::NO_LAST_BYTE;
   rlcAmHeader.SetFramingInfo (framingInfo);
 
 
@@ -753,8 +626,8 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
       else
         {
           NS_LOG_LOGIC ("Place PDU in the reception buffer ( SN = " << seqNumber << " )");
-          m_rxonBuffer[ seqNumber.GetValue () ].m_byteSegments.push_back (p);
-          m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete = true;
+          m_rxonBuffer.at (seqNumber.GetValue ()).m_byteSegments.push_back (p);
+          m_rxonBuffer.at (seqNumber.GetValue ()).m_pduComplete = true;
 
           // - if some byte segments of the AMD PDU contained in the RLC data PDU have been received before:
           //         - discard the duplicate byte segments.
@@ -777,16 +650,12 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
       //     - update VR(MS) to the SN of the first AMD PDU with SN > current VR(MS) for
       //       which not all byte segments have been received;
 
-      std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-      if ( it != m_rxonBuffer.end () &&
-           m_rxonBuffer[ m_vrMs.GetValue () ].m_pduComplete )
+      if ( m_rxonBuffer.at (m_vrMs.GetValue ()).m_pduComplete )
         {
           int firstVrMs = m_vrMs.GetValue ();
-          while ( it != m_rxonBuffer.end () &&
-                  m_rxonBuffer[ m_vrMs.GetValue () ].m_pduComplete )
+          while ( m_rxonBuffer.at (m_vrMs.GetValue ()).m_pduComplete )
             {
               m_vrMs++;
-              it = m_rxonBuffer.find (m_vrMs.GetValue ());
               NS_LOG_LOGIC ("Incr VR(MS) = " << m_vrMs);
 
               NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in RxonBuffer");
@@ -802,23 +671,20 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 
       if ( seqNumber == m_vrR )
         {
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if ( it != m_rxonBuffer.end () &&
-               m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete )
+          if ( m_rxonBuffer.at (seqNumber.GetValue ()).m_pduComplete )
             {
-              it = m_rxonBuffer.find (m_vrR.GetValue ());
               int firstVrR = m_vrR.GetValue ();
-              while ( it != m_rxonBuffer.end () &&
-                      m_rxonBuffer[ m_vrR.GetValue () ].m_pduComplete )
+              while ( m_rxonBuffer.at (m_vrR.GetValue ()).m_pduComplete )
                 {
                   NS_LOG_LOGIC ("Reassemble and Deliver ( SN = " << m_vrR << " )");
-                  NS_ASSERT_MSG (m_rxonBuffer[ m_vrR.GetValue () ].m_byteSegments.size () == 1,
+                  PduBuffer &pduBuffer = m_rxonBuffer.at (m_vrR.GetValue ());
+                  NS_ASSERT_MSG (pduBuffer.m_byteSegments.size () == 1,
                                 "Too many segments. PDU Reassembly process didn't work");
-                  ReassembleAndDeliver (m_rxonBuffer[ m_vrR.GetValue () ].m_byteSegments.front ());
-                  m_rxonBuffer.erase (m_vrR.GetValue ());
+                  ReassembleAndDeliver (pduBuffer.m_byteSegments.front ());
+                  pduBuffer.m_byteSegments.clear ();
+                  pduBuffer.m_pduComplete = false;
 
                   m_vrR++;
-                  it = m_rxonBuffer.find (m_vrR.GetValue ());
 
                   NS_ASSERT_MSG (firstVrR != m_vrR.GetValue (), "Infinite loop in RxonBuffer");
                 }
@@ -1630,12 +1496,9 @@ LteRlcAm::ExpireReorderingTimer (void)
 
   m_vrMs = m_vrX;
   int firstVrMs = m_vrMs.GetValue ();
-  std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-  while ( it != m_rxonBuffer.end () &&
-          m_rxonBuffer[ m_vrMs.GetValue () ].m_pduComplete )
+  while ( m_rxonBuffer.at (m_vrMs.GetValue ()).m_pduComplete )
     {
       m_vrMs++;
-      it = m_rxonBuffer.find (m_vrMs.GetValue ());
 
       NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in ExpireReorderingTimer");
     }
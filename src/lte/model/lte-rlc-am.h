@@ -25,8 +25,8 @@
 #include <ns3/lte-rlc-sequence-number.h>
 #include <ns3/lte-rlc.h>
 
+#include <deque>
 #include <vector>
-#include <map>
 
 namespace ns3 {
 
@@ -72,7 +72,8 @@ private:
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
+    std::deque < Ptr<Packet> > m_txonBuffer;        // Transmission buffer
+    uint32_t m_txonBufferOffset;                    // Bytes of the first SDU already sent
     std::vector < Ptr<Packet> > m_txedBuffer;       // Transmitted packets buffer
 
     struct RetxBuffer
@@ -100,7 +101,7 @@ private:
       uint16_t  m_currSize;
     };
 
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; // Reception buffer
+    std::vector < PduBuffer > m_rxonBuffer;        // Reception buffer, indexed by SN
 
     Ptr<Packet> m_controlPduBuffer;               // Control PDU buffer (just one PDU)
 
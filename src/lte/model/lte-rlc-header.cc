@@ -31,7 +31,9 @@ NS_OBJECT_ENSURE_REGISTERED (LteRlcHeader);
 LteRlcHeader::LteRlcHeader ()
   : m_headerLength (0),
     m_framingInfo (0xff),
-    m_sequenceNumber (0xfffa)
+    m_sequenceNumber (0xfffa),
+    m_extensionBitsPopped (0),
+    m_lengthIndicatorsPopped (0)
 {
 }
 
@@ -95,8 +97,7 @@ LteRlcHeader::PushLengthIndicator (uint16_t lengthIndicator)
 uint8_t
 LteRlcHeader::PopExtensionBit (void)
 {
-  uint8_t extensionBit = m_extensionBits.front ();
-  m_extensionBits.pop_front ();
+  uint8_t extensionBit = m_extensionBits.at (m_extensionBitsPopped++);
 
   return extensionBit;
 }
@@ -104,8 +105,7 @@ LteRlcHeader::PopExtensionBit (void)
 uint16_t
 LteRlcHeader::PopLengthIndicator (void)
 {
-  uint16_t lengthIndicator = m_lengthIndicators.front ();
-  m_lengthIndicators.pop_front ();
+  uint16_t lengthIndicator = m_lengthIndicators.at (m_lengthIndicatorsPopped++);
 
   return lengthIndicator;
 }
@@ -130,8 +130,8 @@ LteRlcHeader::GetInstanceTypeId (void) const
 
 void LteRlcHeader::Print (std::ostream &os)  const
 {
-  std::list <uint8_t>::const_iterator it1 = m_extensionBits.begin ();
-  std::list <uint16_t>::const_iterator it2 = m_lengthIndicators.begin ();
+  std::vector <uint8_t>::const_iterator it1 = m_extensionBits.begin () + m_extensionBitsPopped;
+  std::vector <uint16_t>::const_iterator it2 = m_lengthIndicators.begin () + m_lengthIndicatorsPopped;
 
   os << "Len=" << m_headerLength;
   os << " FI=" << (uint16_t)m_framingInfo;
@@ -169,8 +169,8 @@ void LteRlcHeader::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  std::list <uint8_t>::const_iterator it1 = m_extensionBits.begin ();
-  std::list <uint16_t>::const_iterator it2 = m_lengthIndicators.begin ();
+  std::vector <uint8_t>::const_iterator it1 = m_extensionBits.begin () + m_extensionBitsPopped;
+  std::vector <uint16_t>::const_iterator it2 = m_lengthIndicators.begin () + m_lengthIndicatorsPopped;
 
   i.WriteU8 ( ((m_framingInfo << 3) & 0x18) |
               (((*it1) << 2) & 0x04) |
@@ -223,6 +223,10 @@ uint32_t LteRlcHeader::Deserialize (Buffer::Iterator start)
   byte_2 = i.ReadU8 ();
   m_headerLength = 2;
   m_framingInfo = (byte_1 & 0x18) >> 3;
+  m_extensionBits.clear ();
+  m_lengthIndicators.clear ();
+  m_extensionBitsPopped = 0;
+  m_lengthIndicatorsPopped = 0;
   m_sequenceNumber = ((byte_1 & 0x03) << 8) | byte_2;
 
   extensionBit = (byte_1 & 0x04) >> 2;
@@ -24,7 +24,7 @@
 #include "ns3/header.h"
 #include "ns3/lte-rlc-sequence-number.h"
 
-#include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -88,8 +88,10 @@ private:
   uint8_t  m_framingInfo;      //  2 bits
   SequenceNumber10 m_sequenceNumber;
 
-  std::list <uint8_t> m_extensionBits; // Includes extensionBit of the fixed part
-  std::list <uint16_t> m_lengthIndicators;
+  std::vector <uint8_t> m_extensionBits; // Includes extensionBit of the fixed part
+  std::vector <uint16_t> m_lengthIndicators;
+  uint16_t m_extensionBitsPopped;    // Extension bits already popped
+  uint16_t m_lengthIndicatorsPopped; // Length indicators already popped
 
 };
 
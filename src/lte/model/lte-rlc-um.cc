@@ -23,7 +23,6 @@
 
 #include "ns3/lte-rlc-header.h"
 #include "ns3/lte-rlc-um.h"
-#include "ns3/lte-rlc-sdu-status-tag.h"
 #include "ns3/lte-rlc-tag.h"
 
 namespace ns3 {
@@ -35,6 +34,7 @@ NS_OBJECT_ENSURE_REGISTERED (LteRlcUm);
 LteRlcUm::LteRlcUm ()
   : m_maxTxBufferSize (10 * 1024),
     m_txBufferSize (0),
+    m_txBufferOffset (0),
     m_sequenceNumber (0),
     m_vrUr (0),
     m_vrUx (0),
@@ -44,6 +44,7 @@ LteRlcUm::LteRlcUm ()
 {
   NS_LOG_FUNCTION (this);
   m_reassemblingState = WAITING_S0_FULL;
+  m_rxBuffer.resize (1024);
 }
 
 LteRlcUm::~LteRlcUm ()
@@ -94,10 +95,6 @@ LteRlcUm::DoTransmitPdcpPdu (Ptr<Packet> p)
 
       /** Store PDCP PDU */
 
-      LteRlcSduStatusTag tag;
-      tag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-      p->AddPacketTag (tag);
-
       NS_LOG_LOGIC ("Tx Buffer: New packet added");
       m_txBuffer.push_back (p);
       m_txBufferSize += p->GetSize ();
@@ -135,236 +132,112 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       return;
     }
 
+  if (m_txBuffer.empty ())
+    {
+      NS_LOG_LOGIC ("No data pending");
+      return;
+    }
+
   Ptr<Packet> packet = Create<Packet> ();
   LteRlcHeader rlcHeader;
 
-  // Build Data field
+  // Build Data field. The SDUs stay in the transmission buffer until
+  // they are completely sent: the Data field refers to segments of them,
+  // and m_txBufferOffset tells how much of the first one has been sent
   uint32_t nextSegmentSize = bytes - 2;
   uint32_t nextSegmentId = 1;
-  uint32_t dataFieldTotalSize = 0;
-  uint32_t dataFieldAddedSize = 0;
   std::vector < Ptr<Packet> > dataField;
-
-  // Remove the first packet from the transmission buffer.
-  // If only a segment of the packet is taken, then the remaining is given back later
-  if ( m_txBuffer.size () == 0 )
-    {
-      NS_LOG_LOGIC ("No data pending");
-      return;
-    }
+  bool firstByte = (m_txBufferOffset == 0);
+  bool lastByte = false;
 
   NS_LOG_LOGIC ("SDUs in TxBuffer  = " << m_txBuffer.size ());
-  NS_LOG_LOGIC ("First SDU buffer  = " << *(m_txBuffer.begin()));
-  NS_LOG_LOGIC ("First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
+  NS_LOG_LOGIC ("First SDU offset  = " << m_txBufferOffset);
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
-  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txBuffer.begin ()))->Copy ();
-  m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-  NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
-  m_txBuffer.erase (m_txBuffer.begin ());
 
-  while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
+  while ( ! m_txBuffer.empty () && (nextSegmentSize > 0) )
     {
-      NS_LOG_LOGIC ("WHILE ( firstSegment && firstSegment->GetSize > 0 && nextSegmentSize > 0 )");
-      NS_LOG_LOGIC ("    firstSegment size = " << firstSegment->GetSize ());
-      NS_LOG_LOGIC ("    nextSegmentSize   = " << nextSegmentSize);
-      if ( (firstSegment->GetSize () > nextSegmentSize) ||
+      Ptr<Packet> sdu = m_txBuffer.front ();
+      uint32_t remainingSize = sdu->GetSize () - m_txBufferOffset;
+      NS_LOG_LOGIC ("    remaining SDU size = " << remainingSize);
+      NS_LOG_LOGIC ("    nextSegmentSize    = " << nextSegmentSize);
+
+      if ( (remainingSize > nextSegmentSize) ||
            // Segment larger than 2047 octets can only be mapped to the end of the Data field
-           (firstSegment->GetSize () > 2047)
+           (remainingSize > 2047)
          )
         {
           // Take the minimum size, due to the 2047-bytes 3GPP exception
           // This exception is due to the length of the LI field (just 11 bits)
-          uint32_t currSegmentSize = std::min (firstSegment->GetSize (), nextSegmentSize);
-
-          NS_LOG_LOGIC ("    IF ( firstSegment > nextSegmentSize ||");
-          NS_LOG_LOGIC ("         firstSegment > 2047 )");
-
-          // Segment txBuffer.FirstBuffer and
-          // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
-          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
-
-          // Status tag of the new and remaining segments
-          // Note: This is the only place where a PDU is segmented and
-          // therefore its status can change
-          LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
-          if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
-              oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-          else if (oldTag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT)
+          uint32_t currSegmentSize = std::min (remainingSize, nextSegmentSize);
+          dataField.push_back (sdu->CreateFragment (m_txBufferOffset, currSegmentSize));
+          m_txBufferSize -= currSegmentSize;
+          if (currSegmentSize < remainingSize)
             {
-              newTag.SetStatus (LteRlcSduStatusTag::MIDDLE_SEGMENT);
-              //oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-
-          // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
-            {
-              firstSegment->AddPacketTag (oldTag);
-
-              m_txBuffer.insert (m_txBuffer.begin (), firstSegment);
-              m_txBufferSize += (*(m_txBuffer.begin()))->GetSize ();
-
-              NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
-              NS_LOG_LOGIC ("    TX buffers = " << m_txBuffer.size ());
-              NS_LOG_LOGIC ("    Front buffer size = " << (*(m_txBuffer.begin()))->GetSize ());
-              NS_LOG_LOGIC ("    txBufferSize = " << m_txBufferSize );
+              // The remaining segment stays in the transmission buffer
+              m_txBufferOffset += currSegmentSize;
+              lastByte = false;
             }
           else
             {
-              // Whole segment was taken, so adjust tag
-              if (newTag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-                }
-              else if (newTag.GetStatus () == LteRlcSduStatusTag::MIDDLE_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-                }
+              m_txBuffer.pop_front ();
+              m_txBufferOffset = 0;
+              lastByte = true;
             }
-          // Segment is completely taken or
-          // the remaining segment is given back to the transmission buffer
-          firstSegment = 0;
-
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
-
-          // Add Segment to Data field
-          dataFieldAddedSize = newSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (newSegment);
-          newSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
 
           // no LengthIndicator for the last one
+          break;
+        }
 
-          nextSegmentSize -= dataFieldAddedSize;
-          nextSegmentId++;
-
-          // nextSegmentSize MUST be zero (only if segment is smaller or equal to 2047)
-
-          // (NO more segments) → exit
-          // break;
+      // Add the remaining SDU (or the whole SDU) to the Data field
+      if (m_txBufferOffset == 0)
+        {
+          dataField.push_back (sdu);
         }
-      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txBuffer.size () == 0) )
+      else
         {
-          NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txBuffer.size == 0");
-          // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
-          firstSegment = 0;
+          dataField.push_back (sdu->CreateFragment (m_txBufferOffset, remainingSize));
+        }
+      m_txBuffer.pop_front ();
+      m_txBufferOffset = 0;
+      m_txBufferSize -= remainingSize;
+      lastByte = true;
 
+      if ( (nextSegmentSize - remainingSize <= 2) || m_txBuffer.empty () )
+        {
           // ExtensionBit (Next_Segment - 1) = 0
           rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
 
           // no LengthIndicator for the last one
-
-          nextSegmentSize -= dataFieldAddedSize;
-          nextSegmentId++;
-
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.size ());
-          if (m_txBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
-            }
-          NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-
-          // nextSegmentSize <= 2 (only if txBuffer is not empty)
-
-          // (NO more segments) → exit
-          // break;
+          break;
         }
-      else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txBuffer.size () > 0)
-        {
-          NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txBuffer.size > 0");
-          // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
-
-          // ExtensionBit (Next_Segment - 1) = 1
-          rlcHeader.PushExtensionBit (LteRlcHeader::E_LI_FIELDS_FOLLOWS);
 
-          // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
-          rlcHeader.PushLengthIndicator (firstSegment->GetSize ());
+      // ExtensionBit (Next_Segment - 1) = 1
+      rlcHeader.PushExtensionBit (LteRlcHeader::E_LI_FIELDS_FOLLOWS);
 
-          nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
-          nextSegmentId++;
-
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.size ());
-          if (m_txBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
-            }
-          NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-          NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
-
-          // (more segments)
-          firstSegment = (*(m_txBuffer.begin ()))->Copy ();
-          m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-          m_txBuffer.erase (m_txBuffer.begin ());
-          NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
-        }
+      // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
+      rlcHeader.PushLengthIndicator (remainingSize);
 
+      nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + remainingSize;
+      nextSegmentId++;
     }
+  NS_LOG_LOGIC ("txBufferSize = " << m_txBufferSize );
 
   // Build RLC header
   rlcHeader.SetSequenceNumber (m_sequenceNumber++);
 
   // Build RLC PDU with DataField and Header
-  std::vector< Ptr<Packet> >::iterator it;
-  it = dataField.begin ();
-
-  uint8_t framingInfo = 0;
-
-  // FIRST SEGMENT
-  LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT) )
-    {
-      framingInfo |= LteRlcHeader::FIRST_BYTE;
-    }
-  else
-    {
-      framingInfo |= LteRlcHeader::NO_FIRST_BYTE;
-    }
-  (*it)->AddPacketTag (tag);
-
-  while (it < dataField.end ())
+  for (std::vector< Ptr<Packet> >::iterator it = dataField.begin (); it != dataField.end (); ++it)
     {
       NS_LOG_LOGIC ("Adding SDU/segment to packet, length = " << (*it)->GetSize ());
-
       packet->AddAtEnd (*it);
-      it++;
     }
 
-  // LAST SEGMENT (Note: There could be only one and be the first one)
-  it--;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
-    {
-      framingInfo |= LteRlcHeader::LAST_BYTE;
-    }
-  else
-    {
-      framingInfo |= LteRlcHeader::NO_LAST_BYTE;
-    }
-  (*it)->AddPacketTag (tag);
-
+  uint8_t framingInfo = 0;
+  framingInfo |= firstByte ? LteRlcHeader::FIRST_BYTE : LteRlcHeader::NO_FIRST_BYTE;
+  framingInfo |= lastByte ? LteRlcHeader::LAST_BYTE : LteRlcHeader::NO_LAST_BYTE;
   rlcHeader.SetFramingInfo (framingInfo);
 
   NS_LOG_LOGIC ("RLC header: " << rlcHeader);
@@ -448,7 +321,7 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   m_vrUh.SetModulusBase (m_vrUh - m_windowSize);
   seqNumber.SetModulusBase (m_vrUh - m_windowSize);
 
-  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer.count (seqNumber.GetValue ()) > 0) ) ||
+  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer.at (seqNumber.GetValue ()) != 0) ) ||
        ( ((m_vrUh - m_windowSize) <= seqNumber) && (seqNumber < m_vrUr) )
      )
     {
@@ -459,7 +332,7 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   else
     {
       NS_LOG_LOGIC ("Place PDU in the reception buffer");
-      m_rxBuffer[seqNumber.GetValue ()] = p;
+      m_rxBuffer.at (seqNumber.GetValue ()) = p;
     }
 
 
@@ -497,17 +370,13 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   //      so and deliver the reassembled RLC SDUs to upper layer in ascending order of the RLC SN if not delivered
   //      before;
 
-  if ( m_rxBuffer.count (m_vrUr.GetValue ()) > 0 )
+  if ( m_rxBuffer.at (m_vrUr.GetValue ()) != 0 )
     {
       NS_LOG_LOGIC ("Reception buffer contains SN = " << m_vrUr);
 
-      std::map <uint16_t, Ptr<Packet> >::iterator it;
-      uint16_t newVrUr;
       SequenceNumber10 oldVrUr = m_vrUr;
-
-      it = m_rxBuffer.find (m_vrUr.GetValue ());
-      newVrUr = (it->first) + 1;
-      while ( m_rxBuffer.count (newVrUr) > 0 )
+      SequenceNumber10 newVrUr = m_vrUr + 1;
+      while ( m_rxBuffer.at (newVrUr.GetValue ()) != 0 )
         {
           newVrUr++;
         }
@@ -1056,24 +925,26 @@ LteRlcUm::ReassembleOutsideWindow (void)
 {
   NS_LOG_LOGIC ("Reassemble Outside Window");
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-  it = m_rxBuffer.begin ();
-
-  while ( (it != m_rxBuffer.end ()) && ! IsInsideReorderingWindow (SequenceNumber10 (it->first)) )
+  // The PDUs in the reception buffer have SNs between VR(UR) and VR(UH):
+  // the ones outside of the reordering window are those from VR(UR) to
+  // the lower edge of the window
+  if (IsInsideReorderingWindow (m_vrUr))
     {
-      NS_LOG_LOGIC ("SN = " << it->first);
-
-      // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-      ReassembleAndDeliver (it->second);
-
-      std::map <uint16_t, Ptr<Packet> >::iterator it_tmp = it;
-      ++it;
-      m_rxBuffer.erase (it_tmp);
+      return;
     }
-
-  if (it != m_rxBuffer.end ())
+  uint16_t outsideSns = ((m_vrUh - m_windowSize) - m_vrUr) % 1024;
+  SequenceNumber10 sn = m_vrUr;
+  for (uint16_t i = 0; i < outsideSns; ++i, sn++)
     {
-      NS_LOG_LOGIC ("(SN = " << it->first << ") is inside the reordering window");
+      if (m_rxBuffer.at (sn.GetValue ()) != 0)
+        {
+          NS_LOG_LOGIC ("SN = " << sn);
+
+          // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
+          ReassembleAndDeliver (m_rxBuffer.at (sn.GetValue ()));
+
+          m_rxBuffer.at (sn.GetValue ()) = 0;
+        }
     }
 }
 
@@ -1082,25 +953,20 @@ LteRlcUm::ReassembleSnInterval (SequenceNumber10 lowSeqNumber, SequenceNumber10
 {
   NS_LOG_LOGIC ("Reassemble SN between " << lowSeqNumber << " and " << highSeqNumber);
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-
   SequenceNumber10 reassembleSn = lowSeqNumber;
   NS_LOG_LOGIC ("reassembleSN = " << reassembleSn);
   NS_LOG_LOGIC ("highSeqNumber = " << highSeqNumber);
   while (reassembleSn < highSeqNumber)
     {
       NS_LOG_LOGIC ("reassembleSn < highSeqNumber");
-      it = m_rxBuffer.find (reassembleSn.GetValue ());
-      NS_LOG_LOGIC ("it->first  = " << it->first);
-      NS_LOG_LOGIC ("it->second = " << it->second);
-      if (it != m_rxBuffer.end () )
+      if (m_rxBuffer.at (reassembleSn.GetValue ()) != 0)
         {
-          NS_LOG_LOGIC ("SN = " << it->first);
+          NS_LOG_LOGIC ("SN = " << reassembleSn);
 
           // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-          ReassembleAndDeliver (it->second);
+          ReassembleAndDeliver (m_rxBuffer.at (reassembleSn.GetValue ()));
 
-          m_rxBuffer.erase (it);
+          m_rxBuffer.at (reassembleSn.GetValue ()) = 0;
         }
         
       reassembleSn++;
@@ -1152,10 +1018,9 @@ LteRlcUm::ExpireReorderingTimer (void)
   //    - start t-Reordering;
   //    - set VR(UX) to VR(UH).
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
   SequenceNumber10 newVrUr = m_vrUx;
 
-  while ( (it = m_rxBuffer.find (newVrUr.GetValue ())) != m_rxBuffer.end () )
+  while ( m_rxBuffer.at (newVrUr.GetValue ()) != 0 )
     {
       newVrUr++;
     }
@@ -25,7 +25,7 @@
 #include "ns3/lte-rlc.h"
 
 #include <ns3/event-id.h>
-#include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -68,8 +68,9 @@ private:
 private:
   uint32_t m_maxTxBufferSize;
   uint32_t m_txBufferSize;
-  std::vector < Ptr<Packet> > m_txBuffer;       // Transmission buffer
-  std::map <uint16_t, Ptr<Packet> > m_rxBuffer; // Reception buffer
+  std::deque < Ptr<Packet> > m_txBuffer;        // Transmission buffer
+  uint32_t m_txBufferOffset;                    // Bytes of the first SDU of m_txBuffer already sent
+  std::vector < Ptr<Packet> > m_rxBuffer;       // Reception buffer, indexed by SN
   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 
   std::list < Ptr<Packet> > m_sdusBuffer;       // List of SDUs in a packet
@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-scheduler-thread-pool.h"
+#include <ns3/lte-enb-mac.h>
+#include <ns3/global-value.h>
+#include <ns3/uinteger.h>
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteSchedulerThreadPool");
+
+/**
+ * \ingroup lte
+ * The number of threads running the schedulers of the eNBs with
+ * parallel scheduling.
+ */
+static GlobalValue g_lteSchedulingThreads ("LteSchedulingThreads",
+                                           "The number of threads, including the simulator thread, "
+                                           "running the schedulers of the eNBs whose ParallelScheduling "
+                                           "attribute is set (0 for one thread per processor)",
+                                           UintegerValue (0),
+                                           MakeUintegerChecker<uint32_t> ());
+
+LteSchedulerThreadPool::LteSchedulerThreadPool ()
+  : m_runPending (false)
+#ifdef HAVE_PTHREAD_H
+  ,
+    m_downlink (true),
+    m_nMacs (0),
+    m_nextMac (0),
+    m_pendingMacs (0),
+    m_stop (false),
+    m_blockedThreads (0),
+    m_wakeups (0)
+#endif
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_workAvailable, 0);
+  pthread_cond_init (&m_workDone, 0);
+  UintegerValue value;
+  g_lteSchedulingThreads.GetValue (value);
+  uint32_t nThreads = value.Get ();
+  if (nThreads == 0)
+    {
+      long nProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+      nThreads = nProcessors > 0 ? nProcessors : 1;
+    }
+  NS_LOG_INFO ("running the schedulers on " << nThreads << " threads");
+  // the simulator thread runs schedulers as well
+  for (uint32_t i = 1; i < nThreads; i++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&LteSchedulerThreadPool::DoRunThread, this));
+      thread->Start ();
+      m_threads.push_back (thread);
+    }
+#endif
+}
+
+LteSchedulerThreadPool::~LteSchedulerThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  m_stop = true;
+  pthread_cond_broadcast (&m_workAvailable);
+  pthread_mutex_unlock (&m_mutex);
+  for (std::vector<Ptr<SystemThread> >::iterator it = m_threads.begin (); it != m_threads.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  pthread_cond_destroy (&m_workDone);
+  pthread_cond_destroy (&m_workAvailable);
+  pthread_mutex_destroy (&m_mutex);
+#endif
+}
+
+void
+LteSchedulerThreadPool::Submit (Ptr<LteEnbMac> mac)
+{
+  NS_LOG_FUNCTION (this << mac);
+  m_macs.push_back (mac);
+  if (!m_runPending)
+    {
+      // the MACs of the other eNBs starting a subframe now have already been
+      // scheduled to be indicated the subframe, hence they submit themselves
+      // before Run () is invoked
+      m_runPending = true;
+      Simulator::ScheduleNow (&LteSchedulerThreadPool::Run, this);
+    }
+}
+
+void
+LteSchedulerThreadPool::Run (void)
+{
+  NS_LOG_FUNCTION (this << m_macs.size ());
+  m_runPending = false;
+
+  RunSchedulers (true);
+  for (std::vector<Ptr<LteEnbMac> >::iterator it = m_macs.begin (); it != m_macs.end (); ++it)
+    {
+      (*it)->DeliverSchedulingIndications ();
+    }
+  RunSchedulers (false);
+  for (std::vector<Ptr<LteEnbMac> >::iterator it = m_macs.begin (); it != m_macs.end (); ++it)
+    {
+      (*it)->DeliverSchedulingIndications ();
+    }
+  m_macs.clear ();
+}
+
+#ifdef HAVE_PTHREAD_H
+
+uint32_t
+LteSchedulerThreadPool::GetNThreads (void) const
+{
+  return m_threads.size ();
+}
+
+uint32_t
+LteSchedulerThreadPool::GetNBlockedThreads (void) const
+{
+  pthread_mutex_lock (&m_mutex);
+  uint32_t blockedThreads = m_blockedThreads;
+  pthread_mutex_unlock (&m_mutex);
+  return blockedThreads;
+}
+
+uint64_t
+LteSchedulerThreadPool::GetNWakeups (void) const
+{
+  pthread_mutex_lock (&m_mutex);
+  uint64_t wakeups = m_wakeups;
+  pthread_mutex_unlock (&m_mutex);
+  return wakeups;
+}
+
+void
+LteSchedulerThreadPool::RunSchedulers (bool downlink)
+{
+  NS_LOG_FUNCTION (this << downlink);
+  pthread_mutex_lock (&m_mutex);
+  m_downlink = downlink;
+  m_nMacs = m_macs.size ();
+  m_nextMac = 0;
+  m_pendingMacs = m_nMacs;
+  if (m_nMacs > 1)
+    {
+      pthread_cond_broadcast (&m_workAvailable);
+    }
+  pthread_mutex_unlock (&m_mutex);
+
+  while (RunNextScheduler ())
+    {
+    }
+  pthread_mutex_lock (&m_mutex);
+  while (m_pendingMacs > 0)
+    {
+      pthread_cond_wait (&m_workDone, &m_mutex);
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+
+bool
+LteSchedulerThreadPool::RunNextScheduler (void)
+{
+  pthread_mutex_lock (&m_mutex);
+  if (m_nextMac == m_nMacs)
+    {
+      pthread_mutex_unlock (&m_mutex);
+      return false;
+    }
+  // no reference is taken here, as the reference count is not thread safe
+  LteEnbMac *mac = PeekPointer (m_macs[m_nextMac++]);
+  bool downlink = m_downlink;
+  pthread_mutex_unlock (&m_mutex);
+
+  mac->RunScheduler (downlink);
+
+  pthread_mutex_lock (&m_mutex);
+  if (--m_pendingMacs == 0)
+    {
+      pthread_cond_signal (&m_workDone);
+    }
+  pthread_mutex_unlock (&m_mutex);
+  return true;
+}
+
+void
+LteSchedulerThreadPool::DoRunThread (void)
+{
+  while (true)
+    {
+      pthread_mutex_lock (&m_mutex);
+      while (!m_stop && m_nextMac == m_nMacs)
+        {
+          m_blockedThreads++;
+          pthread_cond_wait (&m_workAvailable, &m_mutex);
+          m_blockedThreads--;
+          m_wakeups++;
+        }
+      bool stop = m_stop;
+      pthread_mutex_unlock (&m_mutex);
+      if (stop)
+        {
+          return;
+        }
+      while (RunNextScheduler ())
+        {
+        }
+    }
+}
+
+#else /* HAVE_PTHREAD_H */
+
+uint32_t
+LteSchedulerThreadPool::GetNThreads (void) const
+{
+  return 0;
+}
+
+uint32_t
+LteSchedulerThreadPool::GetNBlockedThreads (void) const
+{
+  return 0;
+}
+
+uint64_t
+LteSchedulerThreadPool::GetNWakeups (void) const
+{
+  return 0;
+}
+
+void
+LteSchedulerThreadPool::RunSchedulers (bool downlink)
+{
+  NS_LOG_FUNCTION (this << downlink);
+  for (std::vector<Ptr<LteEnbMac> >::iterator it = m_macs.begin (); it != m_macs.end (); ++it)
+    {
+      (*it)->RunScheduler (downlink);
+    }
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+} // namespace ns3
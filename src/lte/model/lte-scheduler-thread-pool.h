@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_SCHEDULER_THREAD_POOL_H
+#define LTE_SCHEDULER_THREAD_POOL_H
+
+#include <ns3/ptr.h>
+#include <ns3/core-config.h>
+#include <vector>
+
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <pthread.h>
+#endif
+
+namespace ns3 {
+
+class LteEnbMac;
+
+/**
+ * \ingroup lte
+ *
+ * \brief Runs the schedulers of the eNBs triggered at the same time on a
+ * pool of threads
+ *
+ * An LteEnbMac whose ParallelScheduling attribute is set does not run its
+ * scheduler when the PHY indicates a new subframe: it submits itself to the
+ * pool, which runs the submitted schedulers once all the eNBs starting a
+ * subframe at this time have done so.  The downlink and then the uplink
+ * scheduling of the cells are run on the threads of the pool, and after
+ * each of them the indications of the schedulers are delivered to the
+ * MACs on the simulator thread, in the order the MACs were submitted.
+ * Since the scheduling of a cell only involves its MAC, its scheduler and
+ * its FFR algorithm, the results do not depend on the number of threads.
+ *
+ * The number of threads, including the simulator thread, is set by the
+ * LteSchedulingThreads global value (0 for one thread per processor).
+ * Between two scheduling rounds, the other threads are blocked on a
+ * condition variable until schedulers are submitted or the pool is
+ * destroyed.  Without threading support, the schedulers are run on the
+ * simulator thread.
+ */
+class LteSchedulerThreadPool
+{
+public:
+  LteSchedulerThreadPool ();
+  ~LteSchedulerThreadPool ();
+
+  /**
+   * \brief Schedule the current subframe of a MAC along with the others
+   * starting a subframe at this time
+   * \param mac the MAC
+   */
+  void Submit (Ptr<LteEnbMac> mac);
+
+  /**
+   * \return the number of threads of the pool, excluding the simulator
+   * thread
+   */
+  uint32_t GetNThreads (void) const;
+  /**
+   * \return the number of threads of the pool currently blocked waiting
+   * for schedulers to run
+   */
+  uint32_t GetNBlockedThreads (void) const;
+  /**
+   * \return the number of times a thread of the pool stopped waiting for
+   * schedulers to run
+   */
+  uint64_t GetNWakeups (void) const;
+
+private:
+  /**
+   * \brief Run the scheduling of the submitted MACs and deliver its
+   * results
+   */
+  void Run (void);
+  /**
+   * \brief Run the downlink or the uplink scheduling of the submitted MACs,
+   * and return once all of them are done
+   * \param downlink true for the downlink scheduling
+   */
+  void RunSchedulers (bool downlink);
+
+  std::vector<Ptr<LteEnbMac> > m_macs;  //!< MACs submitted at this time
+  bool m_runPending;                    //!< true if Run () is scheduled
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * \brief Run the scheduler of the next submitted MAC, if any
+   * \return false if all the schedulers have been started
+   */
+  bool RunNextScheduler (void);
+  /**
+   * \brief Body of the threads of the pool
+   */
+  void DoRunThread (void);
+
+  std::vector<Ptr<SystemThread> > m_threads;  //!< threads of the pool
+  mutable pthread_mutex_t m_mutex;  //!< protects the state below
+  pthread_cond_t m_workAvailable;   //!< signaled when schedulers are to be run or m_stop is set
+  pthread_cond_t m_workDone;        //!< signaled when all schedulers are done
+  bool m_downlink;                  //!< part of the scheduling being run
+  uint32_t m_nMacs;                 //!< number of MACs being scheduled
+  uint32_t m_nextMac;               //!< index of the next MAC to schedule
+  uint32_t m_pendingMacs;           //!< number of MACs not yet scheduled
+  bool m_stop;                      //!< true when the threads must exit
+  uint32_t m_blockedThreads;        //!< number of threads waiting for work
+  uint64_t m_wakeups;               //!< number of returns from waiting for work
+#endif
+};
+
+} // namespace ns3
+
+#endif /* LTE_SCHEDULER_THREAD_POOL_H */
@@ -517,23 +517,7 @@ PfFfMacScheduler::GetRbgSize (int dlbandwidth)
 int
 PfFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return FfMacUeTable::CountLcActives (m_rlcBufferReq, rnti);
 }
 
 
@@ -1076,73 +1060,85 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
 
 
+  // collect the state of the UEs once for all the RBGs
+  m_dlUeTable.Clear ();
+  std::vector <std::map <uint16_t, pfsFlowPerf_t>::iterator> flowStats;
+  for (std::map <uint16_t, pfsFlowPerf_t>::iterator it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+    {
+      m_dlUeTable.AddUe ((*it).first);
+      flowStats.push_back (it);
+    }
+  m_dlUeTable.SetTxModes (m_uesTxMode);
+  m_dlUeTable.SetSubbandCqis (m_a30CqiRxed);
+  m_dlUeTable.SetLcActives (m_rlcBufferReq);
+  m_dlUeTable.SetNotSchedulable (rntiAllocated);
+  for (uint32_t u = 0; u < m_dlUeTable.GetNUes (); u++)
+    {
+      FfMacUeTable::Ue &ue = m_dlUeTable.Get (u);
+      // UE already allocated for HARQ or without HARQ process available -> drop it
+      if (!ue.schedulable)
+        {
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << ue.rnti);
+        }
+      else if (!HarqProcessAvailability (ue.rnti))
+        {
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << ue.rnti);
+          ue.schedulable = false;
+        }
+    }
+
+  std::vector <uint8_t> defaultSbCqi;
   for (int i = 0; i < rbgNum; i++)
     {
       NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
       if (rbgMap.at (i) == false)
         {
-          std::map <uint16_t, pfsFlowPerf_t>::iterator it;
-          std::map <uint16_t, pfsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
+          uint32_t uMax = m_dlUeTable.GetNUes ();
           double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+          for (uint32_t u = 0; u < m_dlUeTable.GetNUes (); u++)
             {
-              if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
-                continue;
-
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
+              const FfMacUeTable::Ue &ue = m_dlUeTable.Get (u);
+              if (!ue.schedulable)
                 {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                    }
-                  if (!HarqProcessAvailability ((*it).first))
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                    }
                   continue;
                 }
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end ())
+              if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, ue.rnti)) == false)
+                continue;
+
+              if (ue.nLayers == 0)
                 {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+                  NS_FATAL_ERROR ("No Transmission Mode info on user " << ue.rnti);
                 }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
+              int nLayer = ue.nLayers;
+              const std::vector <uint8_t> *sbCqi;
+              if (ue.sbCqi == 0)
                 {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
+                  defaultSbCqi.assign (nLayer, 1);  // start with lowest value
+                  sbCqi = &defaultSbCqi;
                 }
               else
                 {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
+                  sbCqi = &ue.sbCqi->m_higherLayerSelected.at (i).m_sbCqi;
                 }
-              uint8_t cqi1 = sbCqi.at (0);
+              uint8_t cqi1 = sbCqi->at (0);
               uint8_t cqi2 = 1;
-              if (sbCqi.size () > 1)
+              if (sbCqi->size () > 1)
                 {
-                  cqi2 = sbCqi.at (1);
+                  cqi2 = sbCqi->at (1);
                 }
 
               if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                 {
-                  if (LcActivePerFlow ((*it).first) > 0)
+                  if (ue.lcActives > 0)
                     {
                       // this UE has data to transmit
                       double achievableRate = 0.0;
                       uint8_t mcs = 0;
                       for (uint8_t k = 0; k < nLayer; k++)
                         {
-                          if (sbCqi.size () > k)
+                          if (sbCqi->size () > k)
                             {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
+                              mcs = m_amc->GetMcsFromCqi (sbCqi->at (k));
                             }
                           else
                             {
@@ -1152,19 +1148,19 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
                           achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
                         }
 
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
-                      NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
+                      double rcqi = achievableRate / (*flowStats[u]).second.lastAveragedThroughput;
+                      NS_LOG_INFO (this << " RNTI " << ue.rnti << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*flowStats[u]).second.lastAveragedThroughput << " RCQI " << rcqi);
 
                       if (rcqi > rcqiMax)
                         {
                           rcqiMax = rcqi;
-                          itMax = it;
+                          uMax = u;
                         }
                     }
                 }   // end if cqi
-            } // end for m_rlcBufferReq
+            } // end for UEs
 
-          if (itMax == m_flowStatsDl.end ())
+          if (uMax == m_dlUeTable.GetNUes ())
             {
               // no UE available for this RB
               NS_LOG_INFO (this << " any UE found");
@@ -1172,20 +1168,21 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
           else
             {
               rbgMap.at (i) = true;
+              uint16_t rntiMax = m_dlUeTable.Get (uMax).rnti;
               std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-              itMap = allocationMap.find ((*itMax).first);
+              itMap = allocationMap.find (rntiMax);
               if (itMap == allocationMap.end ())
                 {
                   // insert new element
                   std::vector <uint16_t> tempMap;
                   tempMap.push_back (i);
-                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > ((*itMax).first, tempMap));
+                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > (rntiMax, tempMap));
                 }
               else
                 {
                   (*itMap).second.push_back (i);
                 }
-              NS_LOG_INFO (this << " UE assigned " << (*itMax).first);
+              NS_LOG_INFO (this << " UE assigned " << rntiMax);
             }
         } // end for RBG free
     } // end for RBGs
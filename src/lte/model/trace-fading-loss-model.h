@@ -29,6 +29,7 @@
 #include <map>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
+#include <ns3/fading-trace.h>
 
 namespace ns3 {
 
@@ -99,20 +100,12 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile;
   
-  FadingTrace m_fadingTrace;
+  /**
+   * Fading samples per RB, shared with the models using the same trace
+   */
+  Ptr<const FadingTrace> m_fadingTrace;
 
   
   Time m_traceLength;
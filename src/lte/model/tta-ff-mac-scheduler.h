@@ -26,6 +26,7 @@
 #include <ns3/ff-mac-csched-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
 #include <ns3/ff-mac-scheduler.h>
+#include <ns3/ff-mac-ue-table.h>
 #include <vector>
 #include <map>
 #include <set>
@@ -210,6 +211,12 @@ private:
   */
   std::map <uint16_t,uint32_t> m_a30CqiTimers;
 
+  /*
+  * Snapshot of the per-UE state looked up by the DL RBG allocation,
+  * filled from the maps at each TTI
+  */
+  FfMacUeTable m_dlUeTable;
+
   /*
   * Map of previous allocated UE per RBG
   * (used to retrieve info from UL-CQI)
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/lte-module.h>
+#include <cmath>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteDlRbgAllocationTest");
+
+/// Number of RBs of the fading trace
+static const uint32_t g_rbNum = 25;
+/// Number of samples per RB of the fading trace, one per ms
+static const uint32_t g_samplesNum = 1000;
+
+/**
+ * \brief Write a frequency selective fading trace
+ *
+ * The fading does not vary with time, so that the random offsets in the
+ * trace drawn by TraceFadingLossModel do not matter.
+ *
+ * \param fileName the name of the trace
+ */
+static void
+WriteFadingTrace (std::string fileName)
+{
+  std::ofstream file (fileName.c_str ());
+  for (uint32_t rb = 0; rb < g_rbNum; rb++)
+    {
+      for (uint32_t j = 0; j < g_samplesNum; j++)
+        {
+          file << " " << -12.0 * std::fabs (std::sin (0.4 * rb));
+        }
+      file << "\n";
+    }
+  file.close ();
+}
+
+/**
+ * Runs a saturated cell whose UEs see different, frequency selective,
+ * channel qualities, with HARQ retransmissions, and checks the downlink scheduling decisions, as
+ * reported by the DlScheduling trace of the eNB MAC, against those of the
+ * schedulers before their RBG allocation looked up the UEs in a
+ * FfMacUeTable.
+ *
+ * The decisions are compared through the amount of data scheduled and a
+ * hash of every decision, in order.
+ */
+class LteDlRbgAllocationTestCase : public TestCase
+{
+public:
+  /**
+   * \param schedulerType the type of scheduler
+   * \param transmissionMode the transmission mode of the UEs
+   * \param bytes the expected amount of data scheduled, in bytes
+   * \param hash the expected hash of the decisions
+   */
+  LteDlRbgAllocationTestCase (std::string schedulerType, uint8_t transmissionMode,
+                              uint64_t bytes, uint32_t hash);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Add a downlink scheduling decision to the hash
+   * \param frame the frame number
+   * \param subframe the subframe number
+   * \param rnti the RNTI of the UE
+   * \param mcs0 the MCS of the first transport block
+   * \param tbs0Size the size of the first transport block
+   * \param mcs1 the MCS of the second transport block
+   * \param tbs1Size the size of the second transport block
+   */
+  void DlScheduling (uint32_t frame, uint32_t subframe, uint16_t rnti,
+                     uint8_t mcs0, uint16_t tbs0Size, uint8_t mcs1, uint16_t tbs1Size);
+  /**
+   * \brief Add a value to the hash
+   * \param value the value
+   */
+  void Hash (uint32_t value);
+
+  std::string m_schedulerType;  //!< type of scheduler
+  uint8_t m_transmissionMode;   //!< transmission mode of the UEs
+  uint64_t m_expectedBytes;     //!< expected amount of data scheduled
+  uint32_t m_expectedHash;      //!< expected hash of the decisions
+  uint64_t m_bytes;             //!< amount of data scheduled
+  uint32_t m_hash;              //!< FNV-1a hash of the decisions
+};
+
+LteDlRbgAllocationTestCase::LteDlRbgAllocationTestCase (std::string schedulerType, uint8_t transmissionMode,
+                                                        uint64_t bytes, uint32_t hash)
+  : TestCase ("DL RBG allocation of " + schedulerType + ", transmission mode "
+              + (transmissionMode == 0 ? "1" : "3")),
+    m_schedulerType (schedulerType),
+    m_transmissionMode (transmissionMode),
+    m_expectedBytes (bytes),
+    m_expectedHash (hash),
+    m_bytes (0),
+    m_hash (2166136261U)
+{
+}
+
+void
+LteDlRbgAllocationTestCase::Hash (uint32_t value)
+{
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_hash ^= (value >> (8 * i)) & 0xff;
+      m_hash *= 16777619U;
+    }
+}
+
+void
+LteDlRbgAllocationTestCase::DlScheduling (uint32_t frame, uint32_t subframe, uint16_t rnti,
+                                          uint8_t mcs0, uint16_t tbs0Size, uint8_t mcs1, uint16_t tbs1Size)
+{
+  Hash (frame);
+  Hash (subframe);
+  Hash (rnti);
+  Hash (mcs0);
+  Hash (tbs0Size);
+  Hash (mcs1);
+  Hash (tbs1Size);
+  m_bytes += tbs0Size + tbs1Size;
+}
+
+void
+LteDlRbgAllocationTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LteEnbRrc::DefaultTransmissionMode", UintegerValue (m_transmissionMode));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSchedulerType (m_schedulerType);
+  // frequency selective fading, so that the subband CQIs of a UE differ
+  std::string fadingFileName = CreateTempDirFilename ("dl-rbg-allocation.fad");
+  WriteFadingTrace (fadingFileName);
+  lteHelper->SetFadingModel ("ns3::TraceFadingLossModel");
+  lteHelper->SetFadingModelAttribute ("TraceFilename", StringValue (fadingFileName));
+  lteHelper->SetFadingModelAttribute ("TraceLength", TimeValue (MilliSeconds (g_samplesNum)));
+  lteHelper->SetFadingModelAttribute ("SamplesNum", UintegerValue (g_samplesNum));
+  lteHelper->SetFadingModelAttribute ("WindowSize", TimeValue (MilliSeconds (g_samplesNum / 2)));
+  lteHelper->SetFadingModelAttribute ("RbNum", UintegerValue (g_rbNum));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (8);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      // from the highest MCS down to the cell edge
+      positions->Add (Vector (500 + 1500 * i, 0, 0));
+    }
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1000);
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Ptr<LteEnbMac> mac = enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetMac ();
+  mac->TraceConnectWithoutContext ("DlScheduling",
+                                   MakeCallback (&LteDlRbgAllocationTestCase::DlScheduling, this));
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_LOG_INFO (GetName () << ": " << m_bytes << " bytes, hash " << m_hash);
+  NS_TEST_ASSERT_MSG_EQ (m_bytes, m_expectedBytes, "the amount of data scheduled changed");
+  NS_TEST_ASSERT_MSG_EQ (m_hash, m_expectedHash, "the scheduling decisions changed");
+}
+
+
+class LteDlRbgAllocationTestSuite : public TestSuite
+{
+public:
+  LteDlRbgAllocationTestSuite ();
+};
+
+LteDlRbgAllocationTestSuite::LteDlRbgAllocationTestSuite ()
+  : TestSuite ("lte-dl-rbg-allocation", SYSTEM)
+{
+  // the expected values are those of the schedulers before FfMacUeTable
+  AddTestCase (new LteDlRbgAllocationTestCase ("ns3::PfFfMacScheduler", 0, 476741, 2607573381U), TestCase::QUICK);
+  AddTestCase (new LteDlRbgAllocationTestCase ("ns3::FdMtFfMacScheduler", 0, 1041261, 2755913066U), TestCase::QUICK);
+  AddTestCase (new LteDlRbgAllocationTestCase ("ns3::TtaFfMacScheduler", 0, 613231, 2406565025U), TestCase::QUICK);
+  AddTestCase (new LteDlRbgAllocationTestCase ("ns3::PfFfMacScheduler", 2, 854022, 2695805932U), TestCase::QUICK);
+  AddTestCase (new LteDlRbgAllocationTestCase ("ns3::FdMtFfMacScheduler", 2, 2068408, 4042572236U), TestCase::QUICK);
+  AddTestCase (new LteDlRbgAllocationTestCase ("ns3::TtaFfMacScheduler", 2, 1188174, 3866898281U), TestCase::QUICK);
+}
+
+static LteDlRbgAllocationTestSuite g_lteDlRbgAllocationTestSuite;
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/fading-trace.h>
+#include <ns3/trace-fading-loss-model.h>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteFadingTraceTest");
+
+/// Number of RBs of the test traces
+static const uint32_t g_rbNum = 6;
+/// Number of samples per RB of the test traces
+static const uint32_t g_samplesNum = 20;
+
+/**
+ * \param rb the RB
+ * \param sample the index of the sample
+ * \return the fading written in the test traces, exactly representable
+ */
+static double
+GetTestSample (uint32_t rb, uint32_t sample)
+{
+  return -0.25 * rb - 0.125 * sample - 0.5;
+}
+
+/**
+ * \brief Write a text fading trace and convert it to the binary format
+ * \param textFileName the name of the text trace
+ * \param binaryFileName the name of the binary trace
+ */
+static void
+WriteTestTraces (std::string textFileName, std::string binaryFileName)
+{
+  std::ofstream file (textFileName.c_str ());
+  for (uint32_t rb = 0; rb < g_rbNum; rb++)
+    {
+      for (uint32_t j = 0; j < g_samplesNum; j++)
+        {
+          file << " " << GetTestSample (rb, j);
+        }
+      file << "\n";
+    }
+  file.close ();
+  FadingTrace::ConvertToBinary (textFileName, binaryFileName, g_rbNum, g_samplesNum);
+}
+
+
+/**
+ * Loads a text trace and its binary conversion, and checks that both hold
+ * the samples written, and that a trace is loaded once while it is used.
+ */
+class LteFadingTraceFormatTestCase : public TestCase
+{
+public:
+  LteFadingTraceFormatTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteFadingTraceFormatTestCase::LteFadingTraceFormatTestCase ()
+  : TestCase ("Text and binary fading traces")
+{
+}
+
+void
+LteFadingTraceFormatTestCase::DoRun (void)
+{
+  std::string textFileName = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFileName = CreateTempDirFilename ("fading-trace.bin");
+  WriteTestTraces (textFileName, binaryFileName);
+
+  Ptr<const FadingTrace> text = FadingTrace::Get (textFileName, g_rbNum, g_samplesNum);
+  Ptr<const FadingTrace> binary = FadingTrace::Get (binaryFileName, g_rbNum, g_samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (text->GetRbNum (), g_rbNum, "wrong number of RBs");
+  NS_TEST_ASSERT_MSG_EQ (binary->GetSamplesNum (), g_samplesNum, "wrong number of samples");
+  for (uint32_t rb = 0; rb < g_rbNum; rb++)
+    {
+      for (uint32_t j = 0; j < g_samplesNum; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (text->GetValue (rb, j), GetTestSample (rb, j), "wrong text sample");
+          NS_TEST_ASSERT_MSG_EQ (binary->GetValue (rb, j), GetTestSample (rb, j), "wrong binary sample");
+          NS_TEST_ASSERT_MSG_EQ (binary->GetRbSamples (rb)[j], GetTestSample (rb, j), "wrong binary sample");
+        }
+    }
+
+  // a binary trace may be used with less RBs than it holds
+  Ptr<const FadingTrace> fewerRbs = FadingTrace::Get (binaryFileName, g_rbNum - 1, g_samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (fewerRbs->GetValue (g_rbNum - 2, 3), GetTestSample (g_rbNum - 2, 3), "wrong binary sample");
+
+  // the trace is shared while it is used, and reloaded afterwards
+  Ptr<const FadingTrace> shared = FadingTrace::Get (binaryFileName, g_rbNum, g_samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (PeekPointer (shared), PeekPointer (binary), "trace loaded twice");
+  shared = 0;
+  binary = 0;
+  binary = FadingTrace::Get (binaryFileName, g_rbNum, g_samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (binary->GetValue (1, 2), GetTestSample (1, 2), "wrong binary sample");
+}
+
+
+/**
+ * Checks that TraceFadingLossModel applies the same fading with the text
+ * and the binary formats of a trace.
+ */
+class LteFadingTraceModelTestCase : public TestCase
+{
+public:
+  LteFadingTraceModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param fileName the name of the trace
+   * \return a fading model using the trace
+   */
+  Ptr<TraceFadingLossModel> CreateModel (std::string fileName);
+};
+
+LteFadingTraceModelTestCase::LteFadingTraceModelTestCase ()
+  : TestCase ("TraceFadingLossModel with text and binary fading traces")
+{
+}
+
+Ptr<TraceFadingLossModel>
+LteFadingTraceModelTestCase::CreateModel (std::string fileName)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (fileName));
+  model->SetAttribute ("TraceLength", TimeValue (MilliSeconds (g_samplesNum)));
+  model->SetAttribute ("SamplesNum", UintegerValue (g_samplesNum));
+  model->SetAttribute ("WindowSize", TimeValue (MilliSeconds (g_samplesNum / 2)));
+  model->SetAttribute ("RbNum", UintegerValue (g_rbNum));
+  model->AssignStreams (1);
+  model->Initialize ();
+  return model;
+}
+
+void
+LteFadingTraceModelTestCase::DoRun (void)
+{
+  std::string textFileName = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFileName = CreateTempDirFilename ("fading-trace.bin");
+  WriteTestTraces (textFileName, binaryFileName);
+
+  Ptr<TraceFadingLossModel> textModel = CreateModel (textFileName);
+  Ptr<TraceFadingLossModel> binaryModel = CreateModel (binaryFileName);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (LteSpectrumValueHelper::GetSpectrumModel (100, g_rbNum));
+  (*txPsd) = 1e-10;
+
+  Ptr<SpectrumValue> textRxPsd = textModel->CalcRxPowerSpectralDensity (txPsd, a, b);
+  Ptr<SpectrumValue> binaryRxPsd = binaryModel->CalcRxPowerSpectralDensity (txPsd, a, b);
+  for (uint32_t rb = 0; rb < g_rbNum; rb++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((*textRxPsd)[rb], (*binaryRxPsd)[rb], "different fading for RB " << rb);
+      NS_TEST_ASSERT_MSG_NE ((*textRxPsd)[rb], (*txPsd)[rb], "no fading applied to RB " << rb);
+    }
+  Simulator::Destroy ();
+}
+
+
+class LteFadingTraceTestSuite : public TestSuite
+{
+public:
+  LteFadingTraceTestSuite ();
+};
+
+LteFadingTraceTestSuite::LteFadingTraceTestSuite ()
+  : TestSuite ("lte-fading-trace", UNIT)
+{
+  AddTestCase (new LteFadingTraceFormatTestCase, TestCase::QUICK);
+  AddTestCase (new LteFadingTraceModelTestCase, TestCase::QUICK);
+}
+
+static LteFadingTraceTestSuite g_lteFadingTraceTestSuite;
@@ -0,0 +1,213 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/lte-module.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteIdleSubframesTest");
+
+/**
+ * Runs a cell with a camped UE, which is not attached to the eNB, and a UE
+ * which connects later on, with and without the `SkipIdleSubframes`
+ * attribute of the eNB PHY, and with and without a saturated data radio
+ * bearer for the connected UE.
+ *
+ * The camped UE counts the control frames it receives from the eNB: while
+ * no UE is attached, the idle eNB must only send the subframes carrying the
+ * PSS, i.e., two subframes per frame.  Once the UE is connected, the eNB
+ * must send all the subframes if the bearer has data, and only those
+ * carrying the PSS or in which an SRS is expected otherwise.  The
+ * connection must be established at the same time in all the runs, which
+ * checks that the eNB resumes at the right subframe with the right frame
+ * and subframe numbers.
+ */
+class LteIdleSubframesTestCase : public TestCase
+{
+public:
+  LteIdleSubframesTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Run the simulation
+   * \param skipIdleSubframes value of the `SkipIdleSubframes` attribute
+   * \param data whether the connected UE has a saturated data radio bearer
+   */
+  void RunScenario (bool skipIdleSubframes, bool data);
+  /**
+   * \brief Connect a UE to the eNB
+   * \param ueDevice the UE
+   * \param enbDevice the eNB
+   */
+  void Connect (Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice);
+  /**
+   * \brief Count the control frames received by the camped UE
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param rsrp the RSRP
+   * \param sinr the SINR
+   */
+  void ReportRsrpSinr (uint16_t cellId, uint16_t rnti, double rsrp, double sinr);
+  /**
+   * \brief Record the time of the connection establishment
+   * \param imsi the IMSI
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   */
+  void ConnectionEstablished (uint64_t imsi, uint16_t cellId, uint16_t rnti);
+
+  uint32_t m_nIdleCtrlFrames;    //!< Control frames received before the connection
+  uint32_t m_nActiveCtrlFrames;  //!< Control frames received after the connection
+  Time m_connectionTime;         //!< Time of the connection establishment
+};
+
+/// Start of the window before the connection in which the control frames are counted
+static const Time g_idleWindowStart = MilliSeconds (300);
+/// End of the window before the connection
+static const Time g_idleWindowEnd = MilliSeconds (400);
+/// Time of the connection request
+static const Time g_connectTime = MicroSeconds (500300);
+/// Start of the window after the connection in which the control frames are counted
+static const Time g_activeWindowStart = MilliSeconds (800);
+/// End of the simulation and of the window after the connection
+static const Time g_stopTime = MilliSeconds (1000);
+
+LteIdleSubframesTestCase::LteIdleSubframesTestCase ()
+  : TestCase ("Skip idle subframes of the eNB PHY")
+{
+}
+
+void
+LteIdleSubframesTestCase::ReportRsrpSinr (uint16_t cellId, uint16_t rnti, double rsrp, double sinr)
+{
+  Time now = Simulator::Now ();
+  if (now >= g_idleWindowStart && now < g_idleWindowEnd)
+    {
+      m_nIdleCtrlFrames++;
+    }
+  else if (now >= g_activeWindowStart)
+    {
+      m_nActiveCtrlFrames++;
+    }
+}
+
+void
+LteIdleSubframesTestCase::ConnectionEstablished (uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  m_connectionTime = Simulator::Now ();
+}
+
+void
+LteIdleSubframesTestCase::Connect (Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice)
+{
+  Ptr<LteEnbNetDevice> enbLteDevice = enbDevice->GetObject<LteEnbNetDevice> ();
+  ueDevice->GetObject<LteUeNetDevice> ()->GetNas ()->Connect (enbLteDevice->GetCellId (),
+                                                               enbLteDevice->GetDlEarfcn ());
+}
+
+void
+LteIdleSubframesTestCase::RunScenario (bool skipIdleSubframes, bool data)
+{
+  m_nIdleCtrlFrames = 0;
+  m_nActiveCtrlFrames = 0;
+  m_connectionTime = Seconds (0);
+
+  Config::SetDefault ("ns3::LteEnbPhy::SkipIdleSubframes", BooleanValue (skipIdleSubframes));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (1);
+  ueNodes.Create (2);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+
+  // the first UE camps on the cell without connecting
+  Ptr<LteUeNetDevice> campedUe = ueDevs.Get (0)->GetObject<LteUeNetDevice> ();
+  campedUe->GetNas ()->StartCellSelection (campedUe->GetDlEarfcn ());
+  campedUe->GetPhy ()->TraceConnectWithoutContext ("ReportCurrentCellRsrpSinr",
+                                                   MakeCallback (&LteIdleSubframesTestCase::ReportRsrpSinr, this));
+
+  // the second UE connects in the middle of a subframe
+  Simulator::Schedule (g_connectTime, &LteIdleSubframesTestCase::Connect, this,
+                       ueDevs.Get (1), enbDevs.Get (0));
+  ueDevs.Get (1)->GetObject<LteUeNetDevice> ()->GetRrc ()
+    ->TraceConnectWithoutContext ("ConnectionEstablished",
+                                  MakeCallback (&LteIdleSubframesTestCase::ConnectionEstablished, this));
+  if (data)
+    {
+      // the RLC SM always has data to send; the bearer is set up once the
+      // UE is connected
+      ueDevs.Get (1)->GetObject<LteUeNetDevice> ()->SetTargetEnb (enbDevs.Get (0)->GetObject<LteEnbNetDevice> ());
+      lteHelper->ActivateDataRadioBearer (ueDevs.Get (1), EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+    }
+
+  Simulator::Stop (g_stopTime);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteIdleSubframesTestCase::DoRun (void)
+{
+  RunScenario (false, false);
+  uint32_t nIdleCtrlFrames = m_nIdleCtrlFrames;
+  uint32_t nActiveCtrlFrames = m_nActiveCtrlFrames;
+  Time connectionTime = m_connectionTime;
+  uint32_t nIdleSubframes = (g_idleWindowEnd - g_idleWindowStart).GetMilliSeconds ();
+  uint32_t nActiveSubframes = (g_stopTime - g_activeWindowStart).GetMilliSeconds ();
+  NS_TEST_ASSERT_MSG_EQ (nIdleCtrlFrames, nIdleSubframes, "camped UE missed control frames");
+  NS_TEST_ASSERT_MSG_EQ (nActiveCtrlFrames, nActiveSubframes, "camped UE missed control frames");
+  NS_TEST_ASSERT_MSG_GT (connectionTime, g_connectTime, "connection not established");
+
+  RunScenario (true, false);
+  NS_TEST_ASSERT_MSG_EQ (m_nIdleCtrlFrames, nIdleSubframes / 5, "idle eNB sent non-broadcast subframes");
+  // the broadcast subframes and the SRS occasions of the connected UE
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_nActiveCtrlFrames, nActiveSubframes / 5, "quiescent eNB missed broadcast subframes");
+  NS_TEST_ASSERT_MSG_LT (m_nActiveCtrlFrames, nActiveSubframes / 4, "quiescent eNB sent the idle subframes");
+  NS_TEST_ASSERT_MSG_EQ (m_connectionTime, connectionTime, "connection established at a different time");
+
+  RunScenario (true, true);
+  NS_TEST_ASSERT_MSG_EQ (m_nIdleCtrlFrames, nIdleSubframes / 5, "idle eNB sent non-broadcast subframes");
+  NS_TEST_ASSERT_MSG_EQ (m_nActiveCtrlFrames, nActiveSubframes, "eNB with data did not send every subframe");
+  NS_TEST_ASSERT_MSG_EQ (m_connectionTime, connectionTime, "connection established at a different time");
+}
+
+
+class LteIdleSubframesTestSuite : public TestSuite
+{
+public:
+  LteIdleSubframesTestSuite ();
+};
+
+LteIdleSubframesTestSuite::LteIdleSubframesTestSuite ()
+  : TestSuite ("lte-idle-subframes", SYSTEM)
+{
+  AddTestCase (new LteIdleSubframesTestCase, TestCase::QUICK);
+}
+
+static LteIdleSubframesTestSuite g_lteIdleSubframesTestSuite;
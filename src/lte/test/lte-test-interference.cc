@@ -35,6 +35,8 @@
 #include "ns3/lte-ue-phy.h"
 #include "ns3/lte-ue-net-device.h"
 
+#include "ns3/lte-chunk-processor.h"
+
 #include "lte-test-interference.h"
 
 #include "lte-test-sinr-chunk-processor.h"
@@ -81,6 +83,8 @@ LteInterferenceTestSuite::LteInterferenceTestSuite ()
   AddTestCase (new LteInterferenceTestCase ("d1=4500, d2=12600",  4500.000000, 12600.000000,  6.654462, 1.139831,  1.139781, 0.270399, 8, 2), TestCase::QUICK);
   AddTestCase (new LteInterferenceTestCase ("d1=5400, d2=12600",  5400.000000, 12600.000000,  4.621154, 0.791549,  0.876368, 0.193019, 6, 0), TestCase::QUICK);
 
+  AddTestCase (new LteInterferenceChunksTestCase (), TestCase::QUICK);
+
 
 }
 
@@ -253,3 +257,163 @@ LteInterferenceTestCase::UlScheduling (uint32_t frameNo, uint32_t subframeNo, ui
       NS_TEST_ASSERT_MSG_EQ ((uint32_t)mcs, (uint32_t)m_ulMcs, "Wrong UL MCS");
     }
 }
+
+
+/**
+ * Chunk processor passing every chunk to LteInterferenceChunksTestCase
+ */
+class LteTestCheckChunkProcessor : public LteChunkProcessor
+{
+public:
+  /**
+   * \param testCase the test case checking the chunks
+   * \param sinr true if the chunks are the SINR, false if they are the interference
+   */
+  LteTestCheckChunkProcessor (LteInterferenceChunksTestCase *testCase, bool sinr)
+    : m_testCase (testCase),
+      m_sinr (sinr)
+  {
+  }
+
+  virtual void Start ()
+  {
+  }
+  virtual void EvaluateChunk (const SpectrumValue& value, Time duration)
+  {
+    m_testCase->CheckChunk (value, duration, m_sinr);
+  }
+  virtual void End ()
+  {
+  }
+
+private:
+  LteInterferenceChunksTestCase *m_testCase;  ///< the test case checking the chunks
+  bool m_sinr;                                ///< true if the chunks are the SINR
+};
+
+
+/**
+ * TestCase
+ */
+
+LteInterferenceChunksTestCase::LteInterferenceChunksTestCase ()
+  : TestCase ("SINR chunks with signals starting and ending during the reception"),
+    m_nSinrChunks (0),
+    m_nInterfChunks (0)
+{
+}
+
+LteInterferenceChunksTestCase::~LteInterferenceChunksTestCase ()
+{
+}
+
+Ptr<SpectrumValue>
+LteInterferenceChunksTestCase::CreateSignal (uint32_t first, uint32_t last, double power)
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (m_model);
+  for (uint32_t i = first; i <= last; i++)
+    {
+      (*psd)[i] = power * (1.0 + 0.25 * (i - first));
+    }
+  return psd;
+}
+
+void
+LteInterferenceChunksTestCase::AddSignal (Ptr<SpectrumValue> psd, Time duration)
+{
+  Signal signal;
+  signal.psd = psd;
+  signal.start = Simulator::Now ();
+  signal.end = Simulator::Now () + duration;
+  m_signals.push_back (signal);
+  m_interference->AddSignal (psd, duration);
+}
+
+void
+LteInterferenceChunksTestCase::StartRx (Ptr<SpectrumValue> psd, Time duration)
+{
+  AddSignal (psd, duration);
+  m_rxPsd = psd;
+  m_interference->StartRx (psd);
+  Simulator::Schedule (duration, &LteInterference::EndRx, m_interference);
+}
+
+void
+LteInterferenceChunksTestCase::CheckChunk (const SpectrumValue& value, Time duration, bool sinr)
+{
+  Time start = Simulator::Now () - duration;
+  NS_LOG_INFO ((sinr ? "SINR" : "interference") << " chunk from " << start << ": " << value);
+  if (sinr)
+    {
+      m_nSinrChunks++;
+    }
+  else
+    {
+      m_nInterfChunks++;
+    }
+
+  // sum of the signals present during the whole chunk
+  SpectrumValue allSignals (m_model);
+  for (std::vector<Signal>::const_iterator it = m_signals.begin (); it != m_signals.end (); ++it)
+    {
+      if (it->start <= start && it->end >= Simulator::Now ())
+        {
+          allSignals += *(it->psd);
+        }
+    }
+  SpectrumValue interf = allSignals - *m_rxPsd + *m_noise;
+  SpectrumValue expected = sinr ? *m_rxPsd / interf : interf;
+  for (uint32_t i = 0; i < m_model->GetNumBands (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (value[i], expected[i], 1e-12 * expected[i],
+                                 "wrong " << (sinr ? "SINR" : "interference") << " on RB " << i
+                                          << " for the chunk from " << start);
+    }
+}
+
+void
+LteInterferenceChunksTestCase::DoRun (void)
+{
+  std::vector<double> frequencies;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      frequencies.push_back (2.0e9 + 180.0e3 * i);
+    }
+  m_model = Create<SpectrumModel> (frequencies);
+  m_noise = Create<SpectrumValue> (m_model);
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      (*m_noise)[i] = 1.0e-3 * (1 + i);
+    }
+
+  m_interference = CreateObject<LteInterference> ();
+  m_interference->SetNoisePowerSpectralDensity (m_noise);
+  m_interference->AddSinrChunkProcessor (Create<LteTestCheckChunkProcessor> (this, true));
+  m_interference->AddInterferenceChunkProcessor (Create<LteTestCheckChunkProcessor> (this, false));
+
+  // first reception on RBs 0-3, from 200 to 1200 us
+  Simulator::Schedule (MicroSeconds (100), &LteInterferenceChunksTestCase::AddSignal, this,
+                       CreateSignal (1, 3, 0.02), MicroSeconds (400));
+  Simulator::Schedule (MicroSeconds (200), &LteInterferenceChunksTestCase::AddSignal, this,
+                       CreateSignal (2, 5, 0.05), MicroSeconds (300));
+  Simulator::Schedule (MicroSeconds (200), &LteInterferenceChunksTestCase::StartRx, this,
+                       CreateSignal (0, 3, 1.0), MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (400), &LteInterferenceChunksTestCase::AddSignal, this,
+                       CreateSignal (0, 1, 0.1), MicroSeconds (500));
+  Simulator::Schedule (MicroSeconds (800), &LteInterferenceChunksTestCase::AddSignal, this,
+                       CreateSignal (3, 4, 0.3), MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (1000), &LteInterferenceChunksTestCase::AddSignal, this,
+                       CreateSignal (5, 5, 0.7), MicroSeconds (100));
+  // second reception on RBs 2-5, from 1500 to 2500 us
+  Simulator::Schedule (MicroSeconds (1500), &LteInterferenceChunksTestCase::StartRx, this,
+                       CreateSignal (2, 5, 2.0), MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (1700), &LteInterferenceChunksTestCase::AddSignal, this,
+                       CreateSignal (0, 5, 0.04), MicroSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference->Dispose ();
+
+  // a chunk ends at every change of the signals during a reception
+  NS_TEST_ASSERT_MSG_EQ (m_nSinrChunks, 11, "wrong number of SINR chunks");
+  NS_TEST_ASSERT_MSG_EQ (m_nInterfChunks, 11, "wrong number of interference chunks");
+}
@@ -23,6 +23,10 @@
 #define LTE_TEST_INTERFERENCE_H
 
 #include "ns3/test.h"
+#include "ns3/nstime.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/lte-interference.h"
+#include <vector>
 
 
 using namespace ns3;
@@ -62,4 +66,65 @@ private:
   uint16_t m_ulMcs;
 };
 
+/**
+ * Test that the SINR and interference chunks computed incrementally by
+ * LteInterference, when signals overlapping the received signal on some
+ * RBs start and end in the middle of the reception, are those of a full
+ * recomputation.
+ */
+class LteInterferenceChunksTestCase : public TestCase
+{
+public:
+  LteInterferenceChunksTestCase ();
+  virtual ~LteInterferenceChunksTestCase ();
+
+  /**
+   * \brief Check a chunk against a full recomputation
+   * \param value the SINR or interference of the chunk
+   * \param duration the duration of the chunk
+   * \param sinr true if value is the SINR, false if it is the interference
+   */
+  void CheckChunk (const SpectrumValue& value, Time duration, bool sinr);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param first the first RB of the signal
+   * \param last the last RB of the signal
+   * \param power the power of the signal on the first RB
+   * \return the PSD of the signal
+   */
+  Ptr<SpectrumValue> CreateSignal (uint32_t first, uint32_t last, double power);
+  /**
+   * \brief Add a signal to the LteInterference and to the signals used by
+   * the full recomputation
+   * \param psd the PSD of the signal
+   * \param duration the duration of the signal
+   */
+  void AddSignal (Ptr<SpectrumValue> psd, Time duration);
+  /**
+   * \brief Add a signal and start receiving it
+   * \param psd the PSD of the signal
+   * \param duration the duration of the signal
+   */
+  void StartRx (Ptr<SpectrumValue> psd, Time duration);
+
+  /// A signal added to the LteInterference
+  struct Signal
+  {
+    Ptr<SpectrumValue> psd;  ///< PSD of the signal
+    Time start;              ///< start of the signal
+    Time end;                ///< end of the signal
+  };
+
+  Ptr<SpectrumModel> m_model;          ///< spectrum model of the signals
+  Ptr<LteInterference> m_interference; ///< the LteInterference tested
+  Ptr<SpectrumValue> m_noise;          ///< noise PSD
+  Ptr<SpectrumValue> m_rxPsd;          ///< PSD of the signal being received
+  std::vector<Signal> m_signals;       ///< signals added so far
+  uint32_t m_nSinrChunks;              ///< number of SINR chunks checked
+  uint32_t m_nInterfChunks;            ///< number of interference chunks checked
+};
+
 #endif /* LTE_TEST_INTERFERENCE_H */
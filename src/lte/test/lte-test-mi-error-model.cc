@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/lte-mi-error-model.h>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteMiErrorModelTest");
+
+/**
+ * \brief Check that the sampled BLER curves of the MIESM error model match
+ * the BLER curves evaluated exactly, for all the ECRs and CB sizes.
+ */
+class LteMiBlerCurvesTestCase : public TestCase
+{
+public:
+  LteMiBlerCurvesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteMiBlerCurvesTestCase::LteMiBlerCurvesTestCase ()
+  : TestCase ("Sampled BLER curves against the exact BLER curves")
+{
+}
+
+void
+LteMiBlerCurvesTestCase::DoRun (void)
+{
+  // the CB sizes of the curves, and sizes in between
+  static const uint16_t cbSizes[] = {40, 64, 104, 160, 200, 256, 512, 1024, 2000, 2560, 4032, 6144};
+  static const uint32_t mibSteps = 100000;
+  const double tolerance = 1e-4;
+
+  for (uint8_t ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+    {
+      for (uint32_t j = 0; j < sizeof (cbSizes) / sizeof (cbSizes[0]); j++)
+        {
+          double maxError = 0;
+          double maxErrorMib = 0;
+          for (uint32_t i = 0; i <= mibSteps; i++)
+            {
+              double mib = static_cast<double> (i) / mibSteps;
+              double error = std::fabs (LteMiErrorModel::MappingMiBler (mib, ecrId, cbSizes[j])
+                                        - LteMiErrorModel::MappingMiBlerExact (mib, ecrId, cbSizes[j]));
+              if (error > maxError)
+                {
+                  maxError = error;
+                  maxErrorMib = mib;
+                }
+            }
+          NS_LOG_INFO ("ECR ID " << (uint32_t) ecrId << " CB size " << cbSizes[j] << " max error " << maxError << " at MIB " << maxErrorMib);
+          NS_TEST_ASSERT_MSG_EQ_TOL (maxError, 0, tolerance, "BLER out of tolerance for ECR ID " << (uint32_t) ecrId << ", CB size " << cbSizes[j] << " at MIB " << maxErrorMib);
+        }
+    }
+}
+
+
+class LteMiErrorModelTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelTestSuite ();
+};
+
+LteMiErrorModelTestSuite::LteMiErrorModelTestSuite ()
+  : TestSuite ("lte-mi-error-model", UNIT)
+{
+  AddTestCase (new LteMiBlerCurvesTestCase, TestCase::QUICK);
+}
+
+static LteMiErrorModelTestSuite g_lteMiErrorModelTestSuite;
@@ -0,0 +1,340 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/lte-module.h>
+#include <sstream>
+
+#ifdef HAVE_PTHREAD_H
+#include <unistd.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteParallelSchedulingTest");
+
+/**
+ * Runs several saturated cells with the scheduling of the eNBs done in
+ * parallel on one thread and on several threads, then sequentially.
+ *
+ * The downlink and uplink scheduling decisions of each cell, as reported by
+ * the DlScheduling and UlScheduling traces of the eNB MAC, must be the same
+ * whatever the number of threads.  As the parallel scheduling runs after
+ * the other events of the beginning of the subframe, the decisions differ
+ * from those of the sequential scheduling, but the amount of data
+ * scheduled must be similar.
+ */
+class LteParallelSchedulingTestCase : public TestCase
+{
+public:
+  /**
+   * \param schedulerType the type of scheduler
+   */
+  LteParallelSchedulingTestCase (std::string schedulerType);
+
+private:
+  virtual void DoRun (void);
+
+  /// Scheduling decisions, per eNB MAC
+  typedef std::map<std::string, std::vector<std::string> > Decisions;
+
+  /**
+   * \brief Run the simulation
+   * \param parallelScheduling value of the `ParallelScheduling` attribute
+   * \param nThreads value of the `LteSchedulingThreads` global value
+   */
+  void RunScenario (bool parallelScheduling, uint32_t nThreads);
+  /**
+   * \brief Record a downlink scheduling decision
+   * \param context the context of the trace source
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI
+   * \param mcs0 the MCS of the first TB
+   * \param tbs0Size the size of the first TB
+   * \param mcs1 the MCS of the second TB
+   * \param tbs1Size the size of the second TB
+   */
+  void DlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                     uint8_t mcs0, uint16_t tbs0Size, uint8_t mcs1, uint16_t tbs1Size);
+  /**
+   * \brief Record an uplink scheduling decision
+   * \param context the context of the trace source
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI
+   * \param mcs the MCS of the TB
+   * \param tbsSize the size of the TB
+   */
+  void UlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                     uint8_t mcs, uint16_t tbsSize);
+
+  std::string m_schedulerType;                //!< Type of scheduler
+  Decisions m_decisions;                      //!< Decisions of the current run
+  std::map<std::string, uint64_t> m_bytes;    //!< Bytes scheduled in the current run, per eNB MAC
+};
+
+LteParallelSchedulingTestCase::LteParallelSchedulingTestCase (std::string schedulerType)
+  : TestCase ("Parallel scheduling with " + schedulerType),
+    m_schedulerType (schedulerType)
+{
+}
+
+void
+LteParallelSchedulingTestCase::DlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                             uint8_t mcs0, uint16_t tbs0Size, uint8_t mcs1, uint16_t tbs1Size)
+{
+  std::ostringstream oss;
+  oss << "DL " << Simulator::Now ().GetMicroSeconds () << " " << frameNo << " " << subframeNo << " " << rnti
+      << " " << (uint32_t) mcs0 << " " << tbs0Size << " " << (uint32_t) mcs1 << " " << tbs1Size;
+  m_decisions[context].push_back (oss.str ());
+  m_bytes[context] += tbs0Size + tbs1Size;
+}
+
+void
+LteParallelSchedulingTestCase::UlScheduling (std::string context, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                             uint8_t mcs, uint16_t tbsSize)
+{
+  std::ostringstream oss;
+  oss << "UL " << Simulator::Now ().GetMicroSeconds () << " " << frameNo << " " << subframeNo << " " << rnti
+      << " " << (uint32_t) mcs << " " << tbsSize;
+  m_decisions[context].push_back (oss.str ());
+  m_bytes[context] += tbsSize;
+}
+
+void
+LteParallelSchedulingTestCase::RunScenario (bool parallelScheduling, uint32_t nThreads)
+{
+  m_decisions.clear ();
+  m_bytes.clear ();
+
+  Config::SetDefault ("ns3::LteEnbMac::ParallelScheduling", BooleanValue (parallelScheduling));
+  Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_SM_ALWAYS));
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (20));
+  Config::SetGlobal ("LteSchedulingThreads", UintegerValue (nThreads));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSchedulerType (m_schedulerType);
+
+  const uint32_t nEnbs = 4;
+  const uint32_t nUesPerEnb = 3;
+  NodeContainer enbNodes;
+  enbNodes.Create (nEnbs);
+
+  // the cells interfere with each other
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nEnbs; i++)
+    {
+      enbPositions->Add (Vector (500.0 * i, 0, 0));
+    }
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  // the same random streams in all the runs
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+
+  for (uint32_t i = 0; i < nEnbs; i++)
+    {
+      NodeContainer ueNodes;
+      ueNodes.Create (nUesPerEnb);
+      Ptr<ListPositionAllocator> uePositions = CreateObject<ListPositionAllocator> ();
+      for (uint32_t j = 0; j < nUesPerEnb; j++)
+        {
+          uePositions->Add (Vector (500.0 * i + 60.0 * (j + 1), 30.0 * j, 0));
+        }
+      mobility.SetPositionAllocator (uePositions);
+      mobility.Install (ueNodes);
+      NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+      stream += lteHelper->AssignStreams (ueDevs, stream);
+      lteHelper->Attach (ueDevs, enbDevs.Get (i));
+      lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::GBR_CONV_VOICE));
+    }
+
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/DlScheduling",
+                   MakeCallback (&LteParallelSchedulingTestCase::DlScheduling, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/UlScheduling",
+                   MakeCallback (&LteParallelSchedulingTestCase::UlScheduling, this));
+
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteParallelSchedulingTestCase::DoRun (void)
+{
+  RunScenario (true, 1);
+  Decisions parallelDecisions = m_decisions;
+  std::map<std::string, uint64_t> parallelBytes = m_bytes;
+  // DL and UL decisions of each eNB
+  NS_TEST_ASSERT_MSG_EQ (parallelDecisions.size (), 8, "not all the eNBs have scheduled UEs");
+
+  RunScenario (true, 4);
+  NS_TEST_ASSERT_MSG_EQ (m_decisions.size (), parallelDecisions.size (), "not all the eNBs have scheduled UEs");
+  for (Decisions::const_iterator it = parallelDecisions.begin (); it != parallelDecisions.end (); ++it)
+    {
+      const std::vector<std::string> &decisions = m_decisions[it->first];
+      NS_TEST_ASSERT_MSG_EQ (decisions.size (), it->second.size (),
+                             "different number of decisions of " << it->first);
+      for (uint32_t i = 0; i < decisions.size () && i < it->second.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (decisions[i], it->second[i], "different decision of " << it->first);
+        }
+    }
+
+  RunScenario (false, 1);
+  NS_TEST_ASSERT_MSG_EQ (m_bytes.size (), parallelBytes.size (), "not all the eNBs have scheduled UEs");
+  for (std::map<std::string, uint64_t>::const_iterator it = parallelBytes.begin (); it != parallelBytes.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_bytes[it->first], it->second, it->second * 0.05,
+                                 "different amount of data scheduled by " << it->first);
+    }
+
+  // restore the default for the other tests
+  Config::SetGlobal ("LteSchedulingThreads", UintegerValue (0));
+}
+
+
+#ifdef HAVE_PTHREAD_H
+
+/**
+ * Runs two cells with the scheduling of the eNBs done in parallel on
+ * several threads, and blocks the simulator thread for some wall-clock time
+ * between two subframes.
+ *
+ * The worker threads have no scheduler to run meanwhile, hence they must
+ * all be blocked waiting for work, and must not wake up while no work is
+ * submitted.
+ */
+class LteSchedulerIdleThreadsTestCase : public TestCase
+{
+public:
+  LteSchedulerIdleThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Block the simulator thread and check the state of the thread pool meanwhile
+  void CheckIdleThreads (void);
+
+  uint32_t m_nThreads;          //!< Number of threads of the pool
+  uint32_t m_nBlockedThreads;   //!< Number of threads blocked once they stopped running schedulers
+  uint32_t m_nBlockedThreadsAfter;  //!< Number of threads blocked after the simulator thread slept
+  uint64_t m_nIdleWakeups;      //!< Number of wakeups while the simulator thread slept
+};
+
+LteSchedulerIdleThreadsTestCase::LteSchedulerIdleThreadsTestCase ()
+  : TestCase ("Idle scheduler threads between subframes"),
+    m_nThreads (0),
+    m_nBlockedThreads (0),
+    m_nBlockedThreadsAfter (0),
+    m_nIdleWakeups (0)
+{
+}
+
+void
+LteSchedulerIdleThreadsTestCase::CheckIdleThreads (void)
+{
+  LteSchedulerThreadPool *pool = SimulationSingleton<LteSchedulerThreadPool>::Get ();
+  m_nThreads = pool->GetNThreads ();
+  // the threads may still be returning from the last schedulers: wait for
+  // them a long time, so that a slow machine does not fail the test
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      m_nBlockedThreads = pool->GetNBlockedThreads ();
+      if (m_nBlockedThreads == m_nThreads)
+        {
+          break;
+        }
+      usleep (1000);
+    }
+  uint64_t wakeups = pool->GetNWakeups ();
+  usleep (50000);
+  m_nIdleWakeups = pool->GetNWakeups () - wakeups;
+  m_nBlockedThreadsAfter = pool->GetNBlockedThreads ();
+  NS_LOG_INFO (m_nBlockedThreads << " of " << m_nThreads << " threads blocked, "
+               << m_nIdleWakeups << " wakeups while idle");
+}
+
+void
+LteSchedulerIdleThreadsTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LteEnbMac::ParallelScheduling", BooleanValue (true));
+  Config::SetGlobal ("LteSchedulingThreads", UintegerValue (4));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  NodeContainer ueNodes;
+  ueNodes.Create (2);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  positions->Add (Vector (500, 0, 0));
+  positions->Add (Vector (60, 0, 0));
+  positions->Add (Vector (560, 0, 0));
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i));
+    }
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::GBR_CONV_VOICE));
+
+  // between two subframes, once the threads have run schedulers
+  Simulator::Schedule (MicroSeconds (100500), &LteSchedulerIdleThreadsTestCase::CheckIdleThreads, this);
+  Simulator::Stop (MilliSeconds (120));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nThreads, 3, "unexpected number of scheduler threads");
+  NS_TEST_ASSERT_MSG_EQ (m_nBlockedThreads, m_nThreads, "the scheduler threads are not blocked between subframes");
+  NS_TEST_ASSERT_MSG_EQ (m_nIdleWakeups, 0, "the scheduler threads woke up without work");
+  NS_TEST_ASSERT_MSG_EQ (m_nBlockedThreadsAfter, m_nThreads, "the scheduler threads are not blocked between subframes");
+
+  // restore the default for the other tests
+  Config::SetGlobal ("LteSchedulingThreads", UintegerValue (0));
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+
+class LteParallelSchedulingTestSuite : public TestSuite
+{
+public:
+  LteParallelSchedulingTestSuite ();
+};
+
+LteParallelSchedulingTestSuite::LteParallelSchedulingTestSuite ()
+  : TestSuite ("lte-parallel-scheduling", SYSTEM)
+{
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PfFfMacScheduler"), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::TdTbfqFfMacScheduler"), TestCase::EXTENSIVE);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::CqaFfMacScheduler"), TestCase::EXTENSIVE);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new LteSchedulerIdleThreadsTestCase (), TestCase::QUICK);
+#endif
+}
+
+static LteParallelSchedulingTestSuite g_lteParallelSchedulingTestSuite;
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/lte-module.h>
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRadioEnvironmentMapTest");
+
+/**
+ * Generates the REM of a few cells with the RemSpectrumPhy listeners, then
+ * with direct evaluation on one thread and on several threads.
+ *
+ * The direct evaluation uses the same propagation models as the channel,
+ * hence the maps must be the same, and the number of threads must not
+ * change the map.  The listeners are deployed at once, as the data
+ * transmissions change from one subframe to the next.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * \param useDataChannel value of the `UseDataChannel` attribute
+   * \param rbId value of the `RbId` attribute
+   * \param maxPointsPerIteration value of the `MaxPointsPerIteration` attribute
+   * with direct evaluation
+   */
+  LteRadioEnvironmentMapTestCase (bool useDataChannel, int32_t rbId, uint32_t maxPointsPerIteration);
+
+private:
+  virtual void DoRun (void);
+
+  /// A map: x, y, z and SINR of each point
+  typedef std::vector<std::vector<double> > Map;
+
+  /**
+   * \brief Run the simulation and read the REM
+   * \param directEvaluation value of the `DirectEvaluation` attribute
+   * \param nThreads value of the `Threads` attribute
+   * \return the REM
+   */
+  Map RunScenario (bool directEvaluation, uint32_t nThreads);
+
+  bool m_useDataChannel;             ///< value of the `UseDataChannel` attribute
+  int32_t m_rbId;                    ///< value of the `RbId` attribute
+  uint32_t m_maxPointsPerIteration;  ///< `MaxPointsPerIteration` with direct evaluation
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (bool useDataChannel, int32_t rbId,
+                                                                uint32_t maxPointsPerIteration)
+  : TestCase ("REM direct evaluation, data channel: " + std::string (useDataChannel ? "yes" : "no")),
+    m_useDataChannel (useDataChannel),
+    m_rbId (rbId),
+    m_maxPointsPerIteration (maxPointsPerIteration)
+{
+}
+
+LteRadioEnvironmentMapTestCase::Map
+LteRadioEnvironmentMapTestCase::RunScenario (bool directEvaluation, uint32_t nThreads)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  NodeContainer ueNodes;
+  ueNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 10));
+  positionAlloc->Add (Vector (300, 0, 10));
+  positionAlloc->Add (Vector (0, 250, 10));
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      positionAlloc->Add (Vector (20 + 80 * i, 10 * i, 1.5));
+    }
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // the same random streams in all the runs
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  stream += lteHelper->AssignStreams (ueDevs, stream);
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i));
+    }
+  EpsBearer bearer (EpsBearer::GBR_CONV_VOICE);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  std::ostringstream fileName;
+  fileName << "rem-" << directEvaluation << "-" << nThreads << ".out";
+  std::string outputFile = CreateTempDirFilename (fileName.str ());
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (outputFile));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (400.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (40));
+  remHelper->SetAttribute ("YMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (300.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (30));
+  remHelper->SetAttribute ("UseDataChannel", BooleanValue (m_useDataChannel));
+  remHelper->SetAttribute ("RbId", IntegerValue (m_rbId));
+  if (directEvaluation)
+    {
+      remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (m_maxPointsPerIteration));
+    }
+  remHelper->SetAttribute ("DirectEvaluation", BooleanValue (directEvaluation));
+  remHelper->SetAttribute ("Threads", UintegerValue (nThreads));
+  remHelper->Install ();
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Map map;
+  std::ifstream file (outputFile.c_str ());
+  std::vector<double> point (4);
+  while (file >> point[0] >> point[1] >> point[2] >> point[3])
+    {
+      map.push_back (point);
+    }
+  return map;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  Map simulatedMap = RunScenario (false, 1);
+  NS_TEST_ASSERT_MSG_EQ (simulatedMap.size (), 40 * 30, "incomplete map");
+
+  Map directMap = RunScenario (true, 1);
+  NS_TEST_ASSERT_MSG_EQ (directMap.size (), simulatedMap.size (), "incomplete map");
+  for (uint32_t i = 0; i < directMap.size () && i < simulatedMap.size (); i++)
+    {
+      for (uint32_t j = 0; j < 3; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (directMap[i][j], simulatedMap[i][j], "different position of point " << i);
+        }
+      NS_TEST_ASSERT_MSG_EQ_TOL (directMap[i][3], simulatedMap[i][3], simulatedMap[i][3] * 1e-5,
+                                 "different SINR at point " << i);
+    }
+
+  Map parallelMap = RunScenario (true, 4);
+  NS_TEST_ASSERT_MSG_EQ (parallelMap.size (), directMap.size (), "incomplete map");
+  for (uint32_t i = 0; i < parallelMap.size () && i < directMap.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((parallelMap[i] == directMap[i]), true, "different value at point " << i);
+    }
+}
+
+
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase (false, -1, 20000), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (true, 10, 100), TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite;
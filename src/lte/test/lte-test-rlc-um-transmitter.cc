@@ -20,9 +20,11 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include <sstream>
 
 #include "ns3/lte-rlc-header.h"
 #include "ns3/lte-rlc-um.h"
+#include "ns3/lte-rlc-sap.h"
 
 #include "lte-test-rlc-um-transmitter.h"
 #include "lte-test-entities.h"
@@ -47,6 +49,7 @@ LteRlcUmTransmitterTestSuite::LteRlcUmTransmitterTestSuite ()
   AddTestCase (new LteRlcUmTransmitterSegmentationTestCase ("Segmentation"), TestCase::QUICK);
   AddTestCase (new LteRlcUmTransmitterConcatenationTestCase ("Concatenation"), TestCase::QUICK);
   AddTestCase (new LteRlcUmTransmitterReportBufferStatusTestCase ("ReportBufferStatus primitive"), TestCase::QUICK);
+  AddTestCase (new LteRlcUmReceiverWraparoundTestCase ("Reception outside the reordering window across SN wraparound"), TestCase::QUICK);
 
 }
 
@@ -297,3 +300,87 @@ LteRlcUmTransmitterReportBufferStatusTestCase::DoRun (void)
   Simulator::Run ();
   Simulator::Destroy ();
 }
+
+/**
+ * Test 4.1.1.5 Reception outside the reordering window across SN wraparound
+ */
+LteRlcUmReceiverWraparoundTestCase::LteRlcUmReceiverWraparoundTestCase (std::string name)
+  : TestCase (name),
+    rlcSapUser (0)
+{
+}
+
+LteRlcUmReceiverWraparoundTestCase::~LteRlcUmReceiverWraparoundTestCase ()
+{
+  delete rlcSapUser;
+}
+
+void
+LteRlcUmReceiverWraparoundTestCase::ReceivePdu (uint16_t sn)
+{
+  std::ostringstream data;
+  data << sn << ",";
+  std::string s = data.str ();
+  Ptr<Packet> p = Create<Packet> ((const uint8_t *) s.data (), s.size ());
+
+  LteRlcHeader rlcHeader;
+  rlcHeader.SetFramingInfo (LteRlcHeader::FIRST_BYTE | LteRlcHeader::LAST_BYTE);
+  rlcHeader.SetSequenceNumber (SequenceNumber10 (sn));
+  rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
+  p->AddHeader (rlcHeader);
+
+  rxRlc->GetLteMacSapUser ()->ReceivePdu (p);
+}
+
+void
+LteRlcUmReceiverWraparoundTestCase::DoReceivePdcpPdu (Ptr<Packet> p)
+{
+  uint32_t dataLen = p->GetSize ();
+  uint8_t *buf = new uint8_t[dataLen];
+  p->CopyData (buf, dataLen);
+  receivedData += std::string ((char *)buf, dataLen);
+  delete [] buf;
+}
+
+void
+LteRlcUmReceiverWraparoundTestCase::DoRun (void)
+{
+  //
+  // e) The PDUs which fall outside of the reordering window when VR(UH)
+  //    jumps ahead are delivered in SN order, even when their SNs wrap
+  //    around in the middle of them.
+  //
+
+  rxRlc = CreateObject<LteRlcUm> ();
+  rxRlc->SetRnti (1111);
+  rxRlc->SetLcId (222);
+  rlcSapUser = new LteRlcSpecificLteRlcSapUser<LteRlcUmReceiverWraparoundTestCase> (this);
+  rxRlc->SetLteRlcSapUser (rlcSapUser);
+
+  // SNs 0 to 989 are received in order and delivered at once
+  std::ostringstream expected;
+  for (uint16_t sn = 0; sn < 990; ++sn)
+    {
+      ReceivePdu (sn);
+      expected << sn << ",";
+    }
+  NS_TEST_ASSERT_MSG_EQ (receivedData, expected.str (), "SDUs received in order are not delivered");
+
+  // SN 990 is lost: SNs 991 to 1023 and 0 to 3 wait in the reception buffer
+  receivedData.clear ();
+  expected.str ("");
+  for (uint16_t sn = 991; sn < 1024 + 4; ++sn)
+    {
+      ReceivePdu (sn % 1024);
+      expected << sn % 1024 << ",";
+    }
+  NS_TEST_ASSERT_MSG_EQ (receivedData, "", "SDUs delivered across the missing SN");
+
+  // SN 515 moves the reordering window to [4, 516): everything from
+  // VR(UR) = 990 up to SN 4 falls outside of it and is delivered
+  ReceivePdu (515);
+  NS_TEST_ASSERT_MSG_EQ (receivedData, expected.str (), "SDUs outside of the reordering window are not delivered in SN order");
+
+  rxRlc->Dispose ();
+  Simulator::Destroy ();
+}
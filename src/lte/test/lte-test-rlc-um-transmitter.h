@@ -28,6 +28,8 @@ namespace ns3 {
 class LteTestRrc;
 class LteTestMac;
 class LteTestPdcp;
+class LteRlcSapUser;
+template <class C> class LteRlcSpecificLteRlcSapUser;
 
 }
 
@@ -123,4 +125,35 @@ class LteRlcUmTransmitterReportBufferStatusTestCase : public LteRlcUmTransmitter
 
 };
 
+/**
+ * Test 4.1.1.5 Reception outside the reordering window across SN wraparound
+ */
+class LteRlcUmReceiverWraparoundTestCase : public TestCase
+{
+  friend class LteRlcSpecificLteRlcSapUser<LteRlcUmReceiverWraparoundTestCase>;
+
+  public:
+    LteRlcUmReceiverWraparoundTestCase (std::string name);
+    virtual ~LteRlcUmReceiverWraparoundTestCase ();
+
+  private:
+    virtual void DoRun (void);
+
+    /**
+     * Send an UMD PDU holding one whole SDU to the RLC entity.
+     * \param sn the SN of the PDU, which is also its data
+     */
+    void ReceivePdu (uint16_t sn);
+    /**
+     * Receive an SDU from the RLC entity.
+     * \param p the SDU
+     */
+    void DoReceivePdcpPdu (Ptr<Packet> p);
+
+    Ptr<LteRlc> rxRlc;
+    LteRlcSapUser* rlcSapUser;
+    std::string receivedData;
+
+};
+
 #endif /* LTE_TEST_RLC_UM_TRANSMITTER_H */
@@ -26,6 +26,7 @@
 #include "ns3/test.h"
 #include "ns3/ptr.h"
 #include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
 
 #include "ns3/lte-rrc-header.h"
 #include "ns3/lte-rrc-sap.h"
@@ -1020,6 +1021,319 @@ MeasurementReportTestCase::DoRun (void)
   packet = 0;
 }
 
+// --------------------------- CLASS RrcHeaderFixtureTestCase -----------------------------
+/**
+ * Base class of the test cases encoding the same RRC messages many times
+ */
+class RrcHeaderFixtureTestCase : public RrcHeaderTestCase
+{
+public:
+  RrcHeaderFixtureTestCase (std::string s);
+  LteRrcSap::RrcConnectionReconfiguration CreateRrcConnectionReconfiguration ();
+  LteRrcSap::HandoverPreparationInfo CreateHandoverPreparationInfo ();
+  LteRrcSap::MeasurementReport CreateMeasurementReport ();
+};
+
+RrcHeaderFixtureTestCase::RrcHeaderFixtureTestCase (std::string s) : RrcHeaderTestCase (s)
+{
+}
+
+LteRrcSap::RrcConnectionReconfiguration
+RrcHeaderFixtureTestCase :: CreateRrcConnectionReconfiguration ()
+{
+  LteRrcSap::RrcConnectionReconfiguration msg;
+  msg.rrcTransactionIdentifier = 2;
+
+  msg.haveMeasConfig = true;
+
+  msg.measConfig.haveQuantityConfig = true;
+  msg.measConfig.quantityConfig.filterCoefficientRSRP = 8;
+  msg.measConfig.quantityConfig.filterCoefficientRSRQ = 7;
+
+  msg.measConfig.haveMeasGapConfig = true;
+  msg.measConfig.measGapConfig.type = LteRrcSap::MeasGapConfig::SETUP;
+  msg.measConfig.measGapConfig.gapOffsetChoice = LteRrcSap::MeasGapConfig::GP0;
+  msg.measConfig.measGapConfig.gapOffsetValue = 21;
+
+  msg.measConfig.haveSmeasure = true;
+  msg.measConfig.sMeasure = 57;
+
+  msg.measConfig.haveSpeedStatePars = true;
+  msg.measConfig.speedStatePars.type = LteRrcSap::SpeedStatePars::SETUP;
+  msg.measConfig.speedStatePars.mobilityStateParameters.tEvaluation = 240;
+  msg.measConfig.speedStatePars.mobilityStateParameters.tHystNormal = 60;
+  msg.measConfig.speedStatePars.mobilityStateParameters.nCellChangeMedium = 5;
+  msg.measConfig.speedStatePars.mobilityStateParameters.nCellChangeHigh = 13;
+  msg.measConfig.speedStatePars.timeToTriggerSf.sfMedium = 25;
+  msg.measConfig.speedStatePars.timeToTriggerSf.sfHigh = 75;
+
+  msg.measConfig.measObjectToRemoveList.push_back (23);
+  msg.measConfig.measObjectToRemoveList.push_back (13);
+
+  msg.measConfig.reportConfigToRemoveList.push_back (7);
+  msg.measConfig.reportConfigToRemoveList.push_back (16);
+
+  msg.measConfig.measIdToRemoveList.push_back (4);
+  msg.measConfig.measIdToRemoveList.push_back (18);
+
+  // Set measObjectToAddModList
+  LteRrcSap::MeasObjectToAddMod measObjectToAddMod;
+  measObjectToAddMod.measObjectId = 3;
+  measObjectToAddMod.measObjectEutra.carrierFreq = 21;
+  measObjectToAddMod.measObjectEutra.allowedMeasBandwidth = 15;
+  measObjectToAddMod.measObjectEutra.presenceAntennaPort1 = true;
+  measObjectToAddMod.measObjectEutra.neighCellConfig = 3;
+  measObjectToAddMod.measObjectEutra.offsetFreq = -12;
+  measObjectToAddMod.measObjectEutra.cellsToRemoveList.push_back (5);
+  measObjectToAddMod.measObjectEutra.cellsToRemoveList.push_back (2);
+  measObjectToAddMod.measObjectEutra.blackCellsToRemoveList.push_back (1);
+  measObjectToAddMod.measObjectEutra.haveCellForWhichToReportCGI = true;
+  measObjectToAddMod.measObjectEutra.cellForWhichToReportCGI = 250;
+  LteRrcSap::CellsToAddMod cellsToAddMod;
+  cellsToAddMod.cellIndex = 20;
+  cellsToAddMod.physCellId = 14;
+  cellsToAddMod.cellIndividualOffset = 22;
+  measObjectToAddMod.measObjectEutra.cellsToAddModList.push_back (cellsToAddMod);
+  LteRrcSap::BlackCellsToAddMod blackCellsToAddMod;
+  blackCellsToAddMod.cellIndex = 18;
+  blackCellsToAddMod.physCellIdRange.start = 128;
+  blackCellsToAddMod.physCellIdRange.haveRange = true;
+  blackCellsToAddMod.physCellIdRange.range = 128;
+  measObjectToAddMod.measObjectEutra.blackCellsToAddModList.push_back (blackCellsToAddMod);
+  msg.measConfig.measObjectToAddModList.push_back (measObjectToAddMod);
+
+  // Set reportConfigToAddModList
+  LteRrcSap::ReportConfigToAddMod reportConfigToAddMod;
+  reportConfigToAddMod.reportConfigId = 22;
+  reportConfigToAddMod.reportConfigEutra.triggerType = LteRrcSap::ReportConfigEutra::EVENT;
+  reportConfigToAddMod.reportConfigEutra.eventId = LteRrcSap::ReportConfigEutra::EVENT_A2;
+  reportConfigToAddMod.reportConfigEutra.threshold1.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRP;
+  reportConfigToAddMod.reportConfigEutra.threshold1.range = 15;
+  reportConfigToAddMod.reportConfigEutra.threshold2.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRQ;
+  reportConfigToAddMod.reportConfigEutra.threshold2.range = 10;
+  reportConfigToAddMod.reportConfigEutra.reportOnLeave = true;
+  reportConfigToAddMod.reportConfigEutra.a3Offset = -25;
+  reportConfigToAddMod.reportConfigEutra.hysteresis = 18;
+  reportConfigToAddMod.reportConfigEutra.timeToTrigger = 100;
+  reportConfigToAddMod.reportConfigEutra.purpose = LteRrcSap::ReportConfigEutra::REPORT_STRONGEST_CELLS;
+  reportConfigToAddMod.reportConfigEutra.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRQ;
+  reportConfigToAddMod.reportConfigEutra.reportQuantity = LteRrcSap::ReportConfigEutra::SAME_AS_TRIGGER_QUANTITY;
+  reportConfigToAddMod.reportConfigEutra.maxReportCells = 5;
+  reportConfigToAddMod.reportConfigEutra.reportInterval = LteRrcSap::ReportConfigEutra::MIN60;
+  reportConfigToAddMod.reportConfigEutra.reportAmount = 16; 
+  msg.measConfig.reportConfigToAddModList.push_back (reportConfigToAddMod);
+
+  // Set measIdToAddModList
+  LteRrcSap::MeasIdToAddMod measIdToAddMod,measIdToAddMod2;
+  measIdToAddMod.measId = 7;
+  measIdToAddMod.measObjectId = 6;
+  measIdToAddMod.reportConfigId = 5;
+  measIdToAddMod2.measId = 4;
+  measIdToAddMod2.measObjectId = 8;
+  measIdToAddMod2.reportConfigId = 12;
+  msg.measConfig.measIdToAddModList.push_back (measIdToAddMod);
+  msg.measConfig.measIdToAddModList.push_back (measIdToAddMod2);
+
+  msg.haveMobilityControlInfo = true;
+  msg.mobilityControlInfo.targetPhysCellId = 4;
+  msg.mobilityControlInfo.haveCarrierFreq = true;
+  msg.mobilityControlInfo.carrierFreq.dlCarrierFreq = 3;
+  msg.mobilityControlInfo.carrierFreq.ulCarrierFreq = 5;
+  msg.mobilityControlInfo.haveCarrierBandwidth = true;
+  msg.mobilityControlInfo.carrierBandwidth.dlBandwidth = 50;
+  msg.mobilityControlInfo.carrierBandwidth.ulBandwidth = 25;
+  msg.mobilityControlInfo.newUeIdentity = 11;
+  msg.mobilityControlInfo.haveRachConfigDedicated = true;
+  msg.mobilityControlInfo.rachConfigDedicated.raPreambleIndex = 2;
+  msg.mobilityControlInfo.rachConfigDedicated.raPrachMaskIndex = 2;
+  msg.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.preambleInfo.numberOfRaPreambles = 4;
+  msg.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.preambleTransMax = 3;
+  msg.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.raResponseWindowSize = 6;
+
+  msg.haveRadioResourceConfigDedicated = true;
+
+  msg.radioResourceConfigDedicated = CreateRadioResourceConfigDedicated ();
+
+  return msg;
+}
+
+LteRrcSap::HandoverPreparationInfo
+RrcHeaderFixtureTestCase :: CreateHandoverPreparationInfo ()
+{
+  LteRrcSap::HandoverPreparationInfo msg;
+  msg.asConfig.sourceDlCarrierFreq = 3;
+  msg.asConfig.sourceUeIdentity = 11;
+  msg.asConfig.sourceRadioResourceConfig = CreateRadioResourceConfigDedicated ();
+  msg.asConfig.sourceMasterInformationBlock.dlBandwidth = 3;
+  msg.asConfig.sourceMasterInformationBlock.systemFrameNumber = 1;
+
+  msg.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.csgIndication = true;
+  msg.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.cellIdentity = 5;
+  msg.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.csgIdentity = 4;
+  msg.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.plmnIdentityInfo.plmnIdentity = 123;
+
+  msg.asConfig.sourceSystemInformationBlockType2.freqInfo.ulBandwidth = 100;
+  msg.asConfig.sourceSystemInformationBlockType2.freqInfo.ulCarrierFreq = 10;
+  msg.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.preambleInfo.numberOfRaPreambles = 4;
+  msg.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.preambleTransMax = 3;
+  msg.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.raResponseWindowSize = 6;
+
+  msg.asConfig.sourceMeasConfig.haveQuantityConfig = false;
+  msg.asConfig.sourceMeasConfig.haveMeasGapConfig = false;
+  msg.asConfig.sourceMeasConfig.haveSmeasure = false;
+  msg.asConfig.sourceMeasConfig.haveSpeedStatePars = false;
+
+  return msg;
+}
+
+LteRrcSap::MeasurementReport
+RrcHeaderFixtureTestCase :: CreateMeasurementReport ()
+{
+  LteRrcSap::MeasurementReport msg;
+  msg.measResults.measId = 5;
+  msg.measResults.rsrpResult = 18;
+  msg.measResults.rsrqResult = 21;
+  msg.measResults.haveMeasResultNeighCells = true;
+
+  LteRrcSap::MeasResultEutra mResEutra;
+  mResEutra.physCellId = 9;
+  mResEutra.haveRsrpResult = true;
+  mResEutra.rsrpResult = 33;
+  mResEutra.haveRsrqResult = true;
+  mResEutra.rsrqResult = 22;
+  mResEutra.haveCgiInfo = true;
+  mResEutra.cgiInfo.plmnIdentity = 7;
+  mResEutra.cgiInfo.cellIdentity = 6;
+  mResEutra.cgiInfo.trackingAreaCode = 5;
+  msg.measResults.measResultListEutra.push_back (mResEutra);
+
+  return msg;
+}
+
+// --------------------------- CLASS RrcHeaderOctetsTestCase -----------------------------
+/**
+ * Check the octets of the encoded headers, so that the encoder keeps
+ * producing the same PER bitstream
+ */
+class RrcHeaderOctetsTestCase : public RrcHeaderFixtureTestCase
+{
+public:
+  RrcHeaderOctetsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check the octets of a header
+   * \param source the header
+   * \param octets the expected octets, in hex format
+   */
+  template <class T>
+  void CheckOctets (T source, std::string octets);
+};
+
+RrcHeaderOctetsTestCase::RrcHeaderOctetsTestCase () : RrcHeaderFixtureTestCase ("Testing the octets of the encoding")
+{
+}
+
+template <class T>
+void
+RrcHeaderOctetsTestCase::CheckOctets (T source, std::string octets)
+{
+  packet = Create<Packet> ();
+  packet->AddHeader (source);
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), octets, "Different octets!");
+
+  // the decoded header is encoded again in the same octets
+  T destination;
+  packet->RemoveHeader (destination);
+  packet->AddHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), octets, "Different octets after decoding!");
+  packet = 0;
+}
+
+void
+RrcHeaderOctetsTestCase::DoRun (void)
+{
+  NS_LOG_DEBUG ("============= RrcHeaderOctetsTestCase ===========");
+
+  RrcConnectionReconfigurationHeader reconfiguration;
+  reconfiguration.SetMessage (CreateRrcConnectionReconfiguration ());
+  CheckOctets (reconfiguration,
+               "24 1a 3f e8 6c c0 08 3e 00 2a 79 82 40 82 60 ee 80 00 8d 01 4f a0 99 e0 a8 10 f9 25 32 04 71 09 "
+               "8a 41 9d 68 87 8a b9 c2 98 4d 02 40 00 c0 01 66 40 00 2d 00 00 00 80 00 00 00 02 02 27 23 38 53 "
+               "82 e2 02 01 36 61 18 42 10 a0 69 80 00 c0 10 ");
+
+  HandoverPreparationInfoHeader handoverPreparationInfo;
+  handoverPreparationInfo.SetMessage (CreateHandoverPreparationInfo ());
+  CheckOctets (handoverPreparationInfo,
+               "08 00 00 39 19 c2 9c 17 10 10 09 b3 08 c2 10 85 03 4c 00 06 00 80 00 05 b0 02 a0 88 44 8c 00 00 "
+               "00 00 00 a4 00 00 02 14 00 00 00 00 00 01 00 00 00 1e 00 00 00 00 00 00 7e 0d 00 08 00 00 60 01 "
+               "57 80 00 03 ");
+
+  MeasurementReportHeader measurementReport;
+  measurementReport.SetMessage (CreateMeasurementReport ());
+  CheckOctets (measurementReport,
+               "08 12 12 54 10 48 07 00 00 00 30 00 2b 42 b0 ");
+}
+
+// --------------------------- CLASS Asn1EncodingBenchmarkTestCase -----------------------------
+/**
+ * Measure the time taken to encode and decode a RRC message
+ */
+template <class H, class M>
+class Asn1EncodingBenchmarkTestCase : public RrcHeaderFixtureTestCase
+{
+public:
+  /// Function creating the message
+  typedef M (RrcHeaderFixtureTestCase::*CreateMessage) ();
+
+  /**
+   * \param name the name of the message
+   * \param createMessage the function creating the message
+   * \param iterations the number of times the message is encoded and decoded
+   */
+  Asn1EncodingBenchmarkTestCase (std::string name, CreateMessage createMessage, uint32_t iterations);
+  virtual void DoRun (void);
+
+private:
+  CreateMessage m_createMessage; //!< function creating the message
+  uint32_t m_iterations;         //!< number of times the message is encoded and decoded
+};
+
+template <class H, class M>
+Asn1EncodingBenchmarkTestCase<H, M>::Asn1EncodingBenchmarkTestCase (std::string name, CreateMessage createMessage, uint32_t iterations)
+  : RrcHeaderFixtureTestCase ("Encoding and decoding " + name),
+    m_createMessage (createMessage),
+    m_iterations (iterations)
+{
+}
+
+template <class H, class M>
+void
+Asn1EncodingBenchmarkTestCase<H, M>::DoRun (void)
+{
+  M msg = (this->*m_createMessage) ();
+  uint32_t size = 0;
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < m_iterations; i++)
+    {
+      H source;
+      source.SetMessage (msg);
+      Ptr<Packet> p = Create<Packet> ();
+      p->AddHeader (source);
+      size = p->GetSize ();
+      H destination;
+      p->RemoveHeader (destination);
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 0, "The header has not been entirely decoded");
+    }
+  int64_t elapsedMs = clock.End ();
+
+  NS_LOG_INFO (GetName () << " (" << size << " octets): " << m_iterations
+               << " iterations in " << elapsedMs << " ms");
+}
+
 // --------------------------- CLASS Asn1EncodingSuite -----------------------------
 class Asn1EncodingSuite : public TestSuite
 {
@@ -1042,7 +1356,33 @@ Asn1EncodingSuite::Asn1EncodingSuite ()
   AddTestCase (new RrcConnectionReestablishmentCompleteTestCase (), TestCase::QUICK);
   AddTestCase (new RrcConnectionRejectTestCase (), TestCase::QUICK);
   AddTestCase (new MeasurementReportTestCase (), TestCase::QUICK);
+  AddTestCase (new RrcHeaderOctetsTestCase (), TestCase::QUICK);
 }
 
 Asn1EncodingSuite asn1EncodingSuite;
 
+// --------------------------- CLASS Asn1EncodingBenchmarkSuite -----------------------------
+class Asn1EncodingBenchmarkSuite : public TestSuite
+{
+public:
+  Asn1EncodingBenchmarkSuite ();
+};
+
+Asn1EncodingBenchmarkSuite::Asn1EncodingBenchmarkSuite ()
+  : TestSuite ("test-asn1-encoding-benchmark", PERFORMANCE)
+{
+  NS_LOG_FUNCTION (this);
+  const uint32_t iterations = 10000;
+  AddTestCase (new Asn1EncodingBenchmarkTestCase<MeasurementReportHeader, LteRrcSap::MeasurementReport>
+                 ("MeasurementReport", &RrcHeaderFixtureTestCase::CreateMeasurementReport, iterations),
+               TestCase::QUICK);
+  AddTestCase (new Asn1EncodingBenchmarkTestCase<RrcConnectionReconfigurationHeader, LteRrcSap::RrcConnectionReconfiguration>
+                 ("RrcConnectionReconfiguration", &RrcHeaderFixtureTestCase::CreateRrcConnectionReconfiguration, iterations),
+               TestCase::QUICK);
+  AddTestCase (new Asn1EncodingBenchmarkTestCase<HandoverPreparationInfoHeader, LteRrcSap::HandoverPreparationInfo>
+                 ("HandoverPreparationInfo", &RrcHeaderFixtureTestCase::CreateHandoverPreparationInfo, iterations),
+               TestCase::QUICK);
+}
+
+Asn1EncodingBenchmarkSuite asn1EncodingBenchmarkSuite;
+
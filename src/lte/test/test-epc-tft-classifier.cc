@@ -135,6 +135,38 @@ EpcTftClassifierTestCase::DoRun (void)
 
 
 
+/**
+ * Adds a packet filter to a TFT when run, so that the test cases
+ * following it check the classification with the new filter
+ */
+class EpcTftAddPacketFilterTestCase : public TestCase
+{
+public:
+  EpcTftAddPacketFilterTestCase (Ptr<EpcTft> tft, EpcTft::PacketFilter f);
+
+private:
+
+  Ptr<EpcTft> m_tft;
+  EpcTft::PacketFilter m_filter;
+
+  virtual void DoRun (void);
+};
+
+EpcTftAddPacketFilterTestCase::EpcTftAddPacketFilterTestCase (Ptr<EpcTft> tft, EpcTft::PacketFilter f)
+  : TestCase ("add a packet filter to a classified TFT"),
+    m_tft (tft),
+    m_filter (f)
+{
+}
+
+void
+EpcTftAddPacketFilterTestCase::DoRun (void)
+{
+  m_tft->Add (m_filter);
+}
+
+
+
 
 class EpcTftClassifierTestSuite : public TestSuite
 {
@@ -328,4 +360,79 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+
+  ///////////////////////////////////////////
+  // check TFTs without masks and port ranges
+  ///////////////////////////////////////////
+
+  Ptr<EpcTftClassifier> c5 = Create<EpcTftClassifier> ();
+  c5->Add (EpcTft::Default (), 1);
+
+  Ptr<EpcTft> tft5_2 = Create<EpcTft> ();
+  EpcTft::PacketFilter pf5_2_1;
+  pf5_2_1.direction = EpcTft::DOWNLINK;
+  pf5_2_1.remoteAddress.Set ("9.1.1.1");
+  pf5_2_1.remoteMask = Ipv4Mask::GetOnes ();
+  pf5_2_1.localAddress.Set ("8.1.1.1");
+  pf5_2_1.localMask = Ipv4Mask::GetOnes ();
+  pf5_2_1.remotePortStart = 4;
+  pf5_2_1.remotePortEnd   = 4;
+  pf5_2_1.localPortStart = 1234;
+  pf5_2_1.localPortEnd   = 1234;
+  pf5_2_1.typeOfService = 0xb8;
+  pf5_2_1.typeOfServiceMask = 0xfc;
+  tft5_2->Add (pf5_2_1);
+  EpcTft::PacketFilter pf5_2_2 = pf5_2_1;
+  pf5_2_2.remotePortStart = 1030;
+  pf5_2_2.remotePortEnd   = 1030;
+  pf5_2_2.typeOfServiceMask = 0;
+  tft5_2->Add (pf5_2_2);
+  c5->Add (tft5_2, 2);
+
+  Ptr<EpcTft> tft5_3 = Create<EpcTft> ();
+  tft5_3->Add (pf1_2_1);
+  c5->Add (tft5_3, 3);
+
+  Ptr<EpcTft> tft5_4 = Create<EpcTft> ();
+  EpcTft::PacketFilter pf5_4_1 = pf5_2_2;
+  pf5_4_1.direction = EpcTft::UPLINK;
+  tft5_4->Add (pf5_4_1);
+  c5->Add (tft5_4, 4);
+
+  // ------------------------------------classifier---direction--------------src address---------------dst address---src port--dst port--ToS--TFT id
+
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     4,     1234,  0xb8,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     4,     1234,     0,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  1234,        4,  0xb8,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     4,     1235,  0xb8,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.2"), Ipv4Address ("8.1.1.1"),     4,     1234,  0xb8,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  1030,     1234,     0,    3), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  1234,     1030,     0,    4), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  1234,     1040,     0,    1), TestCase::QUICK);
+
+
+
+  ////////////////////////////////////////////////////////////
+  // check packet filters added after packets were classified
+  ////////////////////////////////////////////////////////////
+
+  Ptr<EpcTftClassifier> c6 = Create<EpcTftClassifier> ();
+  c6->Add (EpcTft::Default (), 1);
+  Ptr<EpcTft> tft6_2 = Create<EpcTft> ();
+  tft6_2->Add (pf5_2_2);
+  c6->Add (tft6_2, 2);
+
+  // ------------------------------------classifier---direction--------------src address---------------dst address---src port--dst port--ToS--TFT id
+
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  1030,     1234,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  1234,     1030,     0,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  3460,        4,     0,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftAddPacketFilterTestCase (tft6_2, pf5_4_1), TestCase::QUICK);
+  AddTestCase (new EpcTftAddPacketFilterTestCase (tft6_2, pf1_2_2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  1030,     1234,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  1234,     1030,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  3460,        4,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("8.1.1.1"), Ipv4Address ("9.1.1.1"),  1234,     1040,     0,    1), TestCase::QUICK);
+
 }
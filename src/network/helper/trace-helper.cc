@@ -390,6 +390,53 @@ AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
+Ptr<BinaryTraceFile>
+AsciiTraceHelper::CreateBinaryFile (std::string filename, uint32_t headerBytes)
+{
+  NS_LOG_FUNCTION (filename << headerBytes);
+
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> ();
+  file->Open (filename, std::ios::out);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename);
+
+  file->Init (headerBytes);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Init " << filename);
+
+  //
+  // As with the ascii streams, ownership passes to the callbacks the file is
+  // bound into.  Buffered records are flushed when the last of them goes away.
+  //
+  return file;
+}
+
+//
+// The binary default trace sink.  The event type, node and device are bound
+// at hook time, so tracing an event is a handful of stores into the column
+// buffers of the file.
+//
+void
+AsciiTraceHelper::DefaultBinarySink (Ptr<BinaryTraceSink> sink, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (sink << p);
+  sink->Write (p);
+}
+
+BinaryTraceSink::BinaryTraceSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                                  BinaryTraceFile::EventType event)
+  : m_file (file),
+    m_node (node),
+    m_device (device),
+    m_event (event)
+{
+  NS_LOG_FUNCTION (this << file << node << device << event);
+}
+
+void
+BinaryTraceSink::Write (Ptr<const Packet> p)
+{
+  m_file->Write (Simulator::Now ().GetNanoSeconds (), m_node, m_device, m_event, p);
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -643,5 +690,57 @@ AsciiTraceHelperForDevice::EnableAsciiImpl (
     }
 }
 
+void
+AsciiTraceHelperForDevice::EnableBinaryInternal (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  NS_FATAL_ERROR ("AsciiTraceHelperForDevice::EnableBinaryInternal(): binary traces are not supported by this helper");
+}
+
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  EnableBinaryInternal (file, nd);
+}
+
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, NetDeviceContainer d)
+{
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      EnableBinaryInternal (file, *i);
+    }
+}
+
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, NodeContainer n)
+{
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          EnableBinaryInternal (file, node->GetDevice (j));
+        }
+    }
+}
+
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::EnableBinaryAll (Ptr<BinaryTraceFile> file)
+{
+  EnableBinary (file, NodeContainer::GetGlobal ());
+}
+
 } // namespace ns3
 
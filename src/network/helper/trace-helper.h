@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-file.h"
 
 namespace ns3 {
 
@@ -131,6 +132,41 @@ PcapHelper::HookDefaultSink (Ptr<T> object, std::string tracename, Ptr<PcapFileW
   NS_ASSERT_MSG (result == true, "PcapHelper::HookDefaultSink():  Unable to hook \"" << tracename << "\"");
 }
 
+/**
+ * \brief The state bound into the default binary trace sink
+ *
+ * A binary trace record identifies the node and device by number rather
+ * than by a trace context string, so these are resolved once when the sink
+ * is hooked and carried along with the file.
+ */
+class BinaryTraceSink : public SimpleRefCount<BinaryTraceSink>
+{
+public:
+  /**
+   * @brief Create a binary trace sink.
+   *
+   * @param file the binary trace file
+   * @param node node id recorded with each event
+   * @param device device index recorded with each event
+   * @param event event type recorded with each event
+   */
+  BinaryTraceSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device,
+                   BinaryTraceFile::EventType event);
+
+  /**
+   * @brief Record one event for a packet.
+   *
+   * @param p the packet
+   */
+  void Write (Ptr<const Packet> p);
+
+private:
+  Ptr<BinaryTraceFile> m_file;          //!< the binary trace file
+  uint32_t m_node;                      //!< node id
+  uint32_t m_device;                    //!< device index
+  BinaryTraceFile::EventType m_event;   //!< event type
+};
+
 /**
  * \brief Manage ASCII trace files for device models
  *
@@ -202,6 +238,35 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create and initialize a binary trace file.
+   *
+   * The binary trace file is a compact, columnar alternative to the text
+   * files produced by the default ascii trace sinks.  See BinaryTraceFile.
+   *
+   * @param filename file name
+   * @param headerBytes number of leading packet bytes to store with each event
+   * @returns a smart pointer to the binary trace file
+   */
+  Ptr<BinaryTraceFile> CreateBinaryFile (std::string filename, uint32_t headerBytes = 0);
+
+  /**
+   * @brief Hook a trace source to the default binary trace sink.
+   *
+   * Unlike the ascii sinks, the binary sink does not use a trace context;
+   * the node and device identifiers are taken from the device once, when
+   * the sink is hooked.
+   *
+   * @param object object
+   * @param traceName trace source name
+   * @param file binary trace file
+   * @param device the device the events are attributed to
+   * @param event the event type recorded for each traced packet
+   */
+  template <typename T>
+  void HookDefaultBinarySink (Ptr<T> object, std::string traceName, Ptr<BinaryTraceFile> file,
+                              Ptr<NetDevice> device, BinaryTraceFile::EventType event);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -435,8 +500,34 @@ public:
    * @param p the packet
    */
   static void DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * @brief Basic binary default trace sink.
+   *
+   * Appends one fixed-size record (time, node, device, event, uid, size
+   * and optionally the leading packet bytes) to a binary trace file.
+   *
+   * @param sink the file and the event identification bound at hook time
+   * @param p the packet
+   */
+  static void DefaultBinarySink (Ptr<BinaryTraceSink> sink, Ptr<const Packet> p);
 };
 
+template <typename T> void
+AsciiTraceHelper::HookDefaultBinarySink (
+  Ptr<T> object,
+  std::string tracename,
+  Ptr<BinaryTraceFile> file,
+  Ptr<NetDevice> device,
+  BinaryTraceFile::EventType event)
+{
+  Ptr<BinaryTraceSink> sink = Create<BinaryTraceSink> (file, device->GetNode ()->GetId (), device->GetIfIndex (), event);
+  bool result =
+    object->TraceConnectWithoutContext (tracename, MakeBoundCallback (&DefaultBinarySink, sink));
+  NS_ASSERT_MSG (result == true, "AsciiTraceHelper::HookDefaultBinarySink():  Unable to hook \""
+                 << tracename << "\"");
+}
+
 template <typename T> void
 AsciiTraceHelper::HookDefaultEnqueueSinkWithoutContext (Ptr<T> object, std::string tracename, Ptr<OutputStreamWrapper> file)
 {
@@ -778,6 +869,52 @@ public:
    */
   void EnableAscii (Ptr<OutputStreamWrapper> stream, uint32_t nodeid, uint32_t deviceid);
 
+  /**
+   * @brief Enable binary trace output on the indicated net device.
+   *
+   * Helpers supporting binary traces override this method and hook the
+   * same trace sources as EnableAsciiInternal to the default binary sink.
+   * The default implementation aborts.
+   *
+   * @param file The binary trace file to append events to.
+   * @param nd Net device for which you want to enable tracing
+   */
+  virtual void EnableBinaryInternal (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd);
+
+  /**
+   * @brief Enable binary trace output on the indicated net device.
+   *
+   * @param file The binary trace file to append events to.
+   * @param nd Net device for which you want to enable tracing.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd);
+
+  /**
+   * @brief Enable binary trace output on each device in the container which
+   * is of the appropriate type.
+   *
+   * @param file The binary trace file to append events to.
+   * @param d container of devices
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, NetDeviceContainer d);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the
+   * appropriate type) in the nodes provided in the container.
+   *
+   * @param file The binary trace file to append events to.
+   * @param n container of nodes.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, NodeContainer n);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the
+   * appropriate type) in the set of all nodes created in the simulation.
+   *
+   * @param file The binary trace file to append events to.
+   */
+  void EnableBinaryAll (Ptr<BinaryTraceFile> file);
+
 private:
   /**
    * @brief Enable ascii trace output on the device specified by a global
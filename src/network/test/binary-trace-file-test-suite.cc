@@ -0,0 +1,278 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Write records spanning several blocks and read them back.
+// ===========================================================================
+class BinaryTraceRoundTripTestCase : public TestCase
+{
+public:
+  BinaryTraceRoundTripTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceRoundTripTestCase::BinaryTraceRoundTripTestCase ()
+  : TestCase ("Check that records written in several blocks read back unchanged")
+{
+}
+
+void
+BinaryTraceRoundTripTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-round-trip.btr");
+  const uint32_t nRecords = 10;
+  const uint32_t headerBytes = 4;
+
+  BinaryTraceFile f;
+  f.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  f.Init (headerBytes, 3);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Init returns error");
+
+  std::vector<uint64_t> uids;
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      // every other packet is shorter than the captured header
+      uint8_t data[8] = { uint8_t (i), 1, 2, 3, 4, 5, 6, 7 };
+      Ptr<Packet> p = Create<Packet> (data, (i % 2) ? 2 : 8);
+      uids.push_back (p->GetUid ());
+      f.Write (1000 * i, i, i + 1, BinaryTraceFile::EventType (i % 4), p);
+      NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Write must not fail");
+    }
+  f.Close ();
+
+  f.Open (filename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::in\") returns error");
+  NS_TEST_EXPECT_MSG_EQ (f.GetHeaderBytes (), headerBytes, "Header bytes not preserved");
+
+  BinaryTraceFile::Record record;
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (f.Read (record), true, "Unable to read record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.time, int64_t (1000 * i), "Time of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.node, i, "Node of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.device, i + 1, "Device of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (uint32_t (record.event), i % 4, "Event of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.uid, uids[i], "Uid of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.size, uint32_t ((i % 2) ? 2 : 8), "Size of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.header.size (), headerBytes, "Header size of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (uint32_t (record.header[0]), i, "Header byte 0 of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (uint32_t (record.header[3]), uint32_t ((i % 2) ? 0 : 3), "Header byte 3 of record " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (f.Read (record), false, "Read past the last record");
+  f.Close ();
+
+  std::remove (filename.c_str ());
+}
+
+// ===========================================================================
+// Convert a file to CSV and to text.
+// ===========================================================================
+class BinaryTraceConvertTestCase : public TestCase
+{
+public:
+  BinaryTraceConvertTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceConvertTestCase::BinaryTraceConvertTestCase ()
+  : TestCase ("Check conversion of binary trace files to CSV and text")
+{
+}
+
+void
+BinaryTraceConvertTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-convert.btr");
+
+  BinaryTraceFile f;
+  f.Open (filename, std::ios::out);
+  f.Init ();
+  f.Write (1500000000, 2, 1, BinaryTraceFile::ENQUEUE, 7, 1040, 0);
+  f.Write (2000000000, 3, 0, BinaryTraceFile::RECEIVE, 7, 1040, 0);
+  f.Close ();
+
+  std::ostringstream csv;
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::ToCsv (filename, csv), true, "Unable to convert to CSV");
+  NS_TEST_EXPECT_MSG_EQ (csv.str (),
+                         "time_ns,node,device,event,uid,size\n"
+                         "1500000000,2,1,+,7,1040\n"
+                         "2000000000,3,0,r,7,1040\n",
+                         "Unexpected CSV output");
+
+  std::ostringstream text;
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::ToText (filename, text), true, "Unable to convert to text");
+  NS_TEST_EXPECT_MSG_EQ (text.str (),
+                         "+ 1.5 /NodeList/2/DeviceList/1 uid=7 size=1040\n"
+                         "r 2 /NodeList/3/DeviceList/0 uid=7 size=1040\n",
+                         "Unexpected text output");
+
+  std::remove (filename.c_str ());
+}
+
+// ===========================================================================
+// Files whose sizes do not match their contents are rejected.
+// ===========================================================================
+class BinaryTraceCorruptTestCase : public TestCase
+{
+public:
+  BinaryTraceCorruptTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write a file of one block of two records, overwrite one of its 32-bit fields and
+   * check that it is rejected.
+   * \param offset offset of the field in the file, in bytes
+   * \param value new value of the field
+   * \param size size to truncate the file to, 0 to keep it whole
+   * \param what description of the corruption
+   */
+  void CheckCorrupt (uint32_t offset, uint32_t value, uint32_t size, std::string what);
+};
+
+BinaryTraceCorruptTestCase::BinaryTraceCorruptTestCase ()
+  : TestCase ("Check that corrupt sizes in binary trace files are rejected")
+{
+}
+
+void
+BinaryTraceCorruptTestCase::CheckCorrupt (uint32_t offset, uint32_t value, uint32_t size, std::string what)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-corrupt.btr");
+  {
+    BinaryTraceFile f;
+    f.Open (filename, std::ios::out);
+    f.Init (4, 4);
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    f.Write (1000, 1, 1, BinaryTraceFile::ENQUEUE, 7, 4, data);
+    f.Write (2000, 1, 1, BinaryTraceFile::DEQUEUE, 7, 4, data);
+    f.Close ();
+  }
+
+  std::string contents;
+  {
+    std::ifstream ifs (filename.c_str (), std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf ();
+    contents = oss.str ();
+  }
+  std::memcpy (&contents[offset], &value, sizeof (value));
+  if (size > 0)
+    {
+      contents.resize (size);
+    }
+  {
+    std::ofstream ofs (filename.c_str (), std::ios::binary | std::ios::trunc);
+    ofs.write (contents.data (), contents.size ());
+  }
+
+  std::ostringstream csv;
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceFile::ToCsv (filename, csv), false, "A file with " << what << " must not convert");
+
+  BinaryTraceFile f;
+  f.Open (filename, std::ios::in);
+  BinaryTraceFile::Record record;
+  while (f.Read (record))
+    {
+    }
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), true, "A file with " << what << " must be left in the failed state");
+
+  std::remove (filename.c_str ());
+}
+
+void
+BinaryTraceCorruptTestCase::DoRun (void)
+{
+  // the file header is followed by the number of records of the block
+  const uint32_t headerBytesOffset = 8;
+  const uint32_t blockRecordsOffset = 12;
+  const uint32_t blockOffset = 16;
+
+  CheckCorrupt (headerBytesOffset, 0xfffffff0, 0, "huge header bytes");
+  CheckCorrupt (blockRecordsOffset, 0, 0, "empty blocks");
+  CheckCorrupt (blockOffset, 3, 0, "a block larger than the file");
+  CheckCorrupt (blockOffset, 2, blockOffset + 20, "a truncated block");
+}
+
+// ===========================================================================
+// Files which are not binary trace files are rejected.
+// ===========================================================================
+class BinaryTraceBadMagicTestCase : public TestCase
+{
+public:
+  BinaryTraceBadMagicTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceBadMagicTestCase::BinaryTraceBadMagicTestCase ()
+  : TestCase ("Check that files with a bad magic number are rejected")
+{
+}
+
+void
+BinaryTraceBadMagicTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-bad-magic.btr");
+  {
+    std::ofstream ofs (filename.c_str ());
+    ofs << "+ 1.5 /NodeList/2/DeviceList/1 ns3::PppHeader (Point-to-Point Protocol: IP (0x0021))" << std::endl;
+  }
+
+  BinaryTraceFile f;
+  f.Open (filename, std::ios::in);
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), true, "An ascii trace file must not be accepted");
+
+  std::ostringstream csv;
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceFile::ToCsv (filename, csv), false, "An ascii trace file must not convert");
+
+  std::remove (filename.c_str ());
+}
+
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceRoundTripTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceConvertTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceBadMagicTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceCorruptTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite binaryTraceFileTestSuite;
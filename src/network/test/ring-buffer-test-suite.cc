@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ring-buffer.h"
+
+using namespace ns3;
+
+class RingBufferTestCase : public TestCase
+{
+public:
+  RingBufferTestCase ();
+  virtual void DoRun (void);
+};
+
+RingBufferTestCase::RingBufferTestCase ()
+  : TestCase ("Check the order of the elements of a ring buffer across wrap-arounds and growth")
+{
+}
+
+void
+RingBufferTestCase::DoRun (void)
+{
+  RingBuffer<uint32_t> buffer;
+  NS_TEST_EXPECT_MSG_EQ (buffer.IsEmpty (), true, "A new buffer is empty");
+
+  // Wrap around the initial capacity several times, then grow while the
+  // elements straddle the end of the storage
+  uint32_t next = 0;
+  uint32_t expected = 0;
+  for (uint32_t round = 0; round < 5; round++)
+    {
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          buffer.PushBack (next++);
+        }
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buffer.Front (), expected++, "FIFO order");
+          buffer.PopFront ();
+        }
+    }
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      buffer.PushBack (next++);
+    }
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSize (), 100, "All the elements are kept when growing");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buffer.Get (i), expected + i, "Indexed access from the front");
+    }
+  NS_TEST_EXPECT_MSG_EQ (buffer.Back (), next - 1, "Last element");
+
+  buffer.PushFront (1000);
+  NS_TEST_EXPECT_MSG_EQ (buffer.Front (), 1000, "Pushed at the front");
+  buffer.PopFront ();
+  buffer.PopBack ();
+  NS_TEST_EXPECT_MSG_EQ (buffer.Back (), next - 2, "Popped from the back");
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSize (), 99, "Size after the pops");
+
+  buffer.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (buffer.IsEmpty (), true, "Cleared");
+  buffer.PushFront (1);
+  buffer.PushFront (0);
+  NS_TEST_EXPECT_MSG_EQ (buffer.Get (0), 0, "Pushed at the front of an empty buffer");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Get (1), 1, "Pushed at the front of an empty buffer");
+}
+
+static class RingBufferTestSuite : public TestSuite
+{
+public:
+  RingBufferTestSuite ()
+    : TestSuite ("ring-buffer", UNIT)
+  {
+    AddTestCase (new RingBufferTestCase (), TestCase::QUICK);
+  }
+} g_ringBufferTestSuite;
@@ -0,0 +1,458 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <iomanip>
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/log.h"
+#include "binary-trace-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+const uint32_t MAGIC = 0x4e534254;            /**< Magic number identifying a binary trace file ("NSBT") */
+const uint32_t SWAPPED_MAGIC = 0x5442534e;    /**< Looks this way if the file was written with another byte order */
+
+const uint16_t VERSION_MAJOR = 1;             /**< Major version of supported binary trace format */
+const uint16_t VERSION_MINOR = 0;             /**< Minor version of supported binary trace format */
+
+/** Bytes of a record in a block, excluding the packet header bytes */
+const uint32_t RECORD_BYTES = sizeof (int64_t) + 2 * sizeof (uint32_t) + sizeof (uint8_t)
+  + sizeof (uint64_t) + sizeof (uint32_t);
+
+BinaryTraceFile::BinaryTraceFile ()
+  : m_file (),
+    m_writing (false),
+    m_fileSize (0),
+    m_count (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+  std::memset (&m_fileHeader, 0, sizeof (m_fileHeader));
+  FatalImpl::RegisterStream (&m_file);
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+bool
+BinaryTraceFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.fail ();
+}
+
+bool
+BinaryTraceFile::Eof (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.eof ();
+}
+
+void
+BinaryTraceFile::Open (std::string const &filename, std::ios::openmode mode)
+{
+  NS_LOG_FUNCTION (this << filename << mode);
+  NS_ASSERT ((mode & std::ios::app) == 0);
+  NS_ASSERT ((mode & std::ios::ate) == 0);
+  NS_ASSERT ((mode & std::ios::trunc) == 0);
+  NS_ASSERT_MSG (((mode & std::ios::out) == 0) != ((mode & std::ios::in) == 0),
+                 "BinaryTraceFile::Open(): file must be opened either for reading or for writing");
+
+  m_file.close ();
+  m_file.clear ();
+  m_filename = filename;
+  m_writing = (mode & std::ios::out) != 0;
+  m_fileSize = 0;
+  m_count = 0;
+  m_next = 0;
+  m_file.open (filename.c_str (), mode | std::ios::binary);
+  if ((mode & std::ios::in) && !m_file.fail ())
+    {
+      ReadAndVerifyFileHeader ();
+    }
+}
+
+void
+BinaryTraceFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writing && m_file.is_open ())
+    {
+      Flush ();
+    }
+  m_file.close ();
+  m_writing = false;
+}
+
+void
+BinaryTraceFile::Init (uint32_t headerBytes, uint32_t blockRecords)
+{
+  NS_LOG_FUNCTION (this << headerBytes << blockRecords);
+  NS_ASSERT_MSG (m_writing, "BinaryTraceFile::Init(): file not opened for writing");
+  NS_ASSERT_MSG (blockRecords > 0, "BinaryTraceFile::Init(): blocks must hold at least one record");
+
+  m_fileHeader.m_magicNumber = MAGIC;
+  m_fileHeader.m_versionMajor = VERSION_MAJOR;
+  m_fileHeader.m_versionMinor = VERSION_MINOR;
+  m_fileHeader.m_headerBytes = headerBytes;
+  m_fileHeader.m_blockRecords = blockRecords;
+
+  //
+  // Size the column buffers once; Write () then only stores into them.
+  //
+  m_count = 0;
+  m_time.resize (blockRecords);
+  m_node.resize (blockRecords);
+  m_device.resize (blockRecords);
+  m_event.resize (blockRecords);
+  m_uid.resize (blockRecords);
+  m_size.resize (blockRecords);
+  m_header.resize (blockRecords * headerBytes);
+
+  m_file.seekp (0, std::ios::beg);
+  m_file.write ((const char *)&m_fileHeader, sizeof (m_fileHeader));
+}
+
+uint32_t
+BinaryTraceFile::GetHeaderBytes (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_fileHeader.m_headerBytes;
+}
+
+void
+BinaryTraceFile::Write (int64_t time, uint32_t node, uint32_t device, EventType event, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << time << node << device << event << p);
+  NS_ASSERT_MSG (m_fileHeader.m_blockRecords > 0, "BinaryTraceFile::Write(): file not initialized");
+
+  uint32_t i = m_count;
+  m_time[i] = time;
+  m_node[i] = node;
+  m_device[i] = device;
+  m_event[i] = event;
+  m_uid[i] = p->GetUid ();
+  m_size[i] = p->GetSize ();
+
+  uint32_t headerBytes = m_fileHeader.m_headerBytes;
+  if (headerBytes > 0)
+    {
+      uint8_t *buffer = &m_header[i * headerBytes];
+      uint32_t copied = p->CopyData (buffer, headerBytes);
+      std::memset (buffer + copied, 0, headerBytes - copied);
+    }
+
+  if (++m_count == m_fileHeader.m_blockRecords)
+    {
+      Flush ();
+    }
+}
+
+void
+BinaryTraceFile::Write (int64_t time, uint32_t node, uint32_t device, EventType event,
+                        uint64_t uid, uint32_t size, uint8_t const *data)
+{
+  NS_LOG_FUNCTION (this << time << node << device << event << uid << size);
+  NS_ASSERT_MSG (m_fileHeader.m_blockRecords > 0, "BinaryTraceFile::Write(): file not initialized");
+
+  uint32_t i = m_count;
+  m_time[i] = time;
+  m_node[i] = node;
+  m_device[i] = device;
+  m_event[i] = event;
+  m_uid[i] = uid;
+  m_size[i] = size;
+
+  uint32_t headerBytes = m_fileHeader.m_headerBytes;
+  if (headerBytes > 0)
+    {
+      std::memcpy (&m_header[i * headerBytes], data, headerBytes);
+    }
+
+  if (++m_count == m_fileHeader.m_blockRecords)
+    {
+      Flush ();
+    }
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_count == 0)
+    {
+      return;
+    }
+
+  uint32_t n = m_count;
+  m_file.write ((const char *)&n, sizeof (n));
+  m_file.write ((const char *)&m_time[0], n * sizeof (int64_t));
+  m_file.write ((const char *)&m_node[0], n * sizeof (uint32_t));
+  m_file.write ((const char *)&m_device[0], n * sizeof (uint32_t));
+  m_file.write ((const char *)&m_event[0], n * sizeof (uint8_t));
+  m_file.write ((const char *)&m_uid[0], n * sizeof (uint64_t));
+  m_file.write ((const char *)&m_size[0], n * sizeof (uint32_t));
+  if (m_fileHeader.m_headerBytes > 0)
+    {
+      m_file.write ((const char *)&m_header[0], n * m_fileHeader.m_headerBytes);
+    }
+  m_file.flush ();
+  m_count = 0;
+}
+
+void
+BinaryTraceFile::ReadAndVerifyFileHeader (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_file.seekg (0, std::ios::end);
+  m_fileSize = m_file.tellg ();
+  m_file.seekg (0, std::ios::beg);
+  m_file.read ((char *)&m_fileHeader, sizeof (m_fileHeader));
+  if (m_file.fail ())
+    {
+      return;
+    }
+
+  if (m_fileHeader.m_magicNumber == SWAPPED_MAGIC)
+    {
+      NS_LOG_WARN ("Binary trace file " << m_filename << " was written with a different byte order");
+      m_file.setstate (std::ios::failbit);
+      return;
+    }
+
+  if (m_fileHeader.m_magicNumber != MAGIC
+      || m_fileHeader.m_versionMajor != VERSION_MAJOR
+      || m_fileHeader.m_blockRecords == 0)
+    {
+      m_file.setstate (std::ios::failbit);
+      return;
+    }
+
+  //
+  // If there is any block, it must hold at least one record.
+  //
+  uint64_t remaining = m_fileSize - sizeof (m_fileHeader);
+  if (remaining > 0
+      && remaining < sizeof (uint32_t) + RECORD_BYTES + uint64_t (m_fileHeader.m_headerBytes))
+    {
+      NS_LOG_WARN ("Header bytes of binary trace file " << m_filename << " exceed its size");
+      m_file.setstate (std::ios::failbit);
+    }
+}
+
+bool
+BinaryTraceFile::ReadBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint64_t offset = m_file.tellg ();
+  if (m_file.fail () || offset == m_fileSize)
+    {
+      m_file.setstate (std::ios::eofbit);
+      return false;
+    }
+
+  //
+  // The record count and the header bytes come from the file: check that
+  // the block fits in the rest of the file before sizing the buffers.
+  //
+  uint32_t n = 0;
+  m_file.read ((char *)&n, sizeof (n));
+  uint32_t headerBytes = m_fileHeader.m_headerBytes;
+  uint64_t blockBytes = uint64_t (n) * (RECORD_BYTES + uint64_t (headerBytes));
+  if (m_file.fail () || n == 0 || n > m_fileHeader.m_blockRecords
+      || blockBytes > m_fileSize - offset - sizeof (n))
+    {
+      NS_LOG_WARN ("Corrupt block in binary trace file " << m_filename);
+      m_file.setstate (std::ios::failbit);
+      return false;
+    }
+
+  m_time.resize (n);
+  m_node.resize (n);
+  m_device.resize (n);
+  m_event.resize (n);
+  m_uid.resize (n);
+  m_size.resize (n);
+  m_header.resize (n * headerBytes);
+
+  m_file.read ((char *)&m_time[0], n * sizeof (int64_t));
+  m_file.read ((char *)&m_node[0], n * sizeof (uint32_t));
+  m_file.read ((char *)&m_device[0], n * sizeof (uint32_t));
+  m_file.read ((char *)&m_event[0], n * sizeof (uint8_t));
+  m_file.read ((char *)&m_uid[0], n * sizeof (uint64_t));
+  m_file.read ((char *)&m_size[0], n * sizeof (uint32_t));
+  if (headerBytes > 0)
+    {
+      m_file.read ((char *)&m_header[0], n * headerBytes);
+    }
+  if (m_file.fail ())
+    {
+      NS_LOG_WARN ("Truncated block in binary trace file " << m_filename);
+      return false;
+    }
+
+  m_count = n;
+  m_next = 0;
+  return true;
+}
+
+bool
+BinaryTraceFile::Read (Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_writing, "BinaryTraceFile::Read(): file not opened for reading");
+
+  if (m_next == m_count && !ReadBlock ())
+    {
+      return false;
+    }
+
+  uint32_t i = m_next++;
+  uint32_t headerBytes = m_fileHeader.m_headerBytes;
+  record.time = m_time[i];
+  record.node = m_node[i];
+  record.device = m_device[i];
+  record.event = m_event[i];
+  record.uid = m_uid[i];
+  record.size = m_size[i];
+  record.header.assign (m_header.begin () + i * headerBytes, m_header.begin () + (i + 1) * headerBytes);
+  return true;
+}
+
+/**
+ * \brief Map an event type to its ascii trace operation character
+ * \param event the event type
+ * \returns the operation character
+ */
+static char
+EventToChar (uint8_t event)
+{
+  switch (event)
+    {
+    case BinaryTraceFile::ENQUEUE:
+      return '+';
+    case BinaryTraceFile::DEQUEUE:
+      return '-';
+    case BinaryTraceFile::DROP:
+      return 'd';
+    case BinaryTraceFile::RECEIVE:
+      return 'r';
+    default:
+      return '?';
+    }
+}
+
+/**
+ * \brief Print the header bytes of a record in hexadecimal
+ * \param os the output stream
+ * \param record the record
+ */
+static void
+PrintHeaderBytes (std::ostream &os, BinaryTraceFile::Record const &record)
+{
+  std::ios::fmtflags flags = os.flags ();
+  char fill = os.fill ('0');
+  for (std::vector<uint8_t>::const_iterator i = record.header.begin (); i != record.header.end (); ++i)
+    {
+      os << std::hex << std::setw (2) << (uint32_t)*i;
+    }
+  os.fill (fill);
+  os.flags (flags);
+}
+
+void
+BinaryTraceFile::PrintText (std::ostream &os, Record const &record)
+{
+  os << EventToChar (record.event) << " " << record.time / 1e9
+     << " /NodeList/" << record.node << "/DeviceList/" << record.device
+     << " uid=" << record.uid << " size=" << record.size;
+  if (!record.header.empty ())
+    {
+      os << " header=";
+      PrintHeaderBytes (os, record);
+    }
+  os << std::endl;
+}
+
+void
+BinaryTraceFile::PrintCsv (std::ostream &os, Record const &record)
+{
+  os << record.time << "," << record.node << "," << record.device << ","
+     << EventToChar (record.event) << "," << record.uid << "," << record.size;
+  if (!record.header.empty ())
+    {
+      os << ",";
+      PrintHeaderBytes (os, record);
+    }
+  os << std::endl;
+}
+
+bool
+BinaryTraceFile::ToText (std::string const &filename, std::ostream &os)
+{
+  NS_LOG_FUNCTION (filename);
+  BinaryTraceFile file;
+  file.Open (filename, std::ios::in);
+  if (file.Fail ())
+    {
+      return false;
+    }
+
+  Record record;
+  while (file.Read (record))
+    {
+      PrintText (os, record);
+    }
+  return !file.Fail ();
+}
+
+bool
+BinaryTraceFile::ToCsv (std::string const &filename, std::ostream &os)
+{
+  NS_LOG_FUNCTION (filename);
+  BinaryTraceFile file;
+  file.Open (filename, std::ios::in);
+  if (file.Fail ())
+    {
+      return false;
+    }
+
+  os << "time_ns,node,device,event,uid,size";
+  if (file.GetHeaderBytes () > 0)
+    {
+      os << ",header";
+    }
+  os << std::endl;
+
+  Record record;
+  while (file.Read (record))
+    {
+      PrintCsv (os, record);
+    }
+  return !file.Fail ();
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ecn-tag.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EcnTag");
+
+NS_OBJECT_ENSURE_REGISTERED (EcnTag);
+
+TypeId 
+EcnTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EcnTag")
+    .SetParent<Tag> ()
+    .SetGroupName("Network")
+    .AddConstructor<EcnTag> ()
+  ;
+  return tid;
+}
+TypeId 
+EcnTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t 
+EcnTag::GetSerializedSize (void) const
+{
+  return 1;
+}
+void 
+EcnTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU8 (m_ecn);
+}
+void 
+EcnTag::Deserialize (TagBuffer buf)
+{
+  m_ecn = buf.ReadU8 ();
+}
+void 
+EcnTag::Print (std::ostream &os) const
+{
+  os << "Ecn=" << (uint32_t) m_ecn;
+}
+EcnTag::EcnTag ()
+  : Tag (),
+    m_ecn (NOT_ECT)
+{
+}
+
+EcnTag::EcnTag (uint8_t ecn)
+  : Tag (),
+    m_ecn (ecn & CE)
+{
+}
+
+void
+EcnTag::SetEcn (uint8_t ecn)
+{
+  m_ecn = ecn & CE;
+}
+uint8_t
+EcnTag::GetEcn (void) const
+{
+  return m_ecn;
+}
+
+bool
+EcnTag::IsEcnCapable (void) const
+{
+  return m_ecn != NOT_ECT;
+}
+
+bool
+EcnTag::IsCongestionExperienced (void) const
+{
+  return m_ecn == CE;
+}
+
+} // namespace ns3
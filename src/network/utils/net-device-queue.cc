@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "net-device-queue.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NetDeviceQueue");
+
+NS_OBJECT_ENSURE_REGISTERED (NetDeviceQueue);
+
+TypeId
+NetDeviceQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NetDeviceQueue")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<NetDeviceQueue> ()
+  ;
+  return tid;
+}
+
+NetDeviceQueue::NetDeviceQueue ()
+  : m_stopped (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+NetDeviceQueue::~NetDeviceQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+NetDeviceQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_wakeCb = MakeNullCallback<void> ();
+  Object::DoDispose ();
+}
+
+void
+NetDeviceQueue::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stopped = false;
+}
+
+void
+NetDeviceQueue::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stopped = true;
+}
+
+void
+NetDeviceQueue::Wake (void)
+{
+  NS_LOG_FUNCTION (this);
+  bool wasStopped = m_stopped;
+  m_stopped = false;
+  if (wasStopped && !m_wakeCb.IsNull ())
+    {
+      m_wakeCb ();
+    }
+}
+
+bool
+NetDeviceQueue::IsStopped (void) const
+{
+  return m_stopped;
+}
+
+void
+NetDeviceQueue::SetWakeCallback (Callback<void> cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_wakeCb = cb;
+}
+
+} // namespace ns3
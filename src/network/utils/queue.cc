@@ -19,6 +19,7 @@
 #include "ns3/log.h"
 #include "ns3/trace-source-accessor.h"
 #include "queue.h"
+#include "ecn-tag.h"
 
 namespace ns3 {
 
@@ -203,4 +204,20 @@ Queue::Drop (Ptr<Packet> p)
   m_traceDrop (p);
 }
 
+bool
+Queue::Mark (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  EcnTag tag;
+  if (!p->PeekPacketTag (tag) || !tag.IsEcnCapable ())
+    {
+      return false;
+    }
+  p->RemovePacketTag (tag);
+  tag.SetEcn (EcnTag::CE);
+  p->AddPacketTag (tag);
+  return true;
+}
+
 } // namespace ns3
@@ -180,6 +180,17 @@ protected:
    */
   void Drop (Ptr<Packet> packet);
 
+  /**
+   *  \brief Mark a packet with the ECN Congestion Experienced codepoint
+   *  \param packet packet to mark
+   *  \return false if the packet does not belong to an ECN-capable
+   *  transport, in which case it must be dropped instead
+   *
+   *  This method is called by active queue management subclasses which
+   *  signal congestion with ECN (\RFC{3168}) rather than by dropping.
+   */
+  bool Mark (Ptr<Packet> packet);
+
   /// Traced callback: fired when a packet is enqueued
   TracedCallback<Ptr<const Packet> > m_traceEnqueue;
   /// Traced callback: fired when a packet is dequeued
@@ -133,6 +133,11 @@ TypeId RedQueue::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&RedQueue::m_isNs1Compat),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN-capable packets instead of dropping them early",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RedQueue::m_useEcn),
+                   MakeBooleanChecker ())
     .AddAttribute ("LinkBandwidth", 
                    "The RED link bandwidth",
                    DataRateValue (DataRate ("1.5Mbps")),
@@ -230,7 +235,7 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
       NS_LOG_DEBUG ("Enqueue in packets mode");
-      nQueued = m_packets.size ();
+      nQueued = m_packets.GetSize ();
     }
 
   // simulate number of packets arrival during idle period
@@ -257,7 +262,7 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
   m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
 
   NS_LOG_DEBUG ("\t bytesInQueue  " << m_bytesInQueue << "\tQavg " << m_qAvg);
-  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.size () << "\tQavg " << m_qAvg);
+  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.GetSize () << "\tQavg " << m_qAvg);
 
   m_count++;
   m_countBytes += p->GetSize ();
@@ -303,7 +308,12 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
       m_stats.qLimDrop++;
     }
 
-  if (dropType == DTYPE_UNFORCED)
+  if (dropType == DTYPE_UNFORCED && m_useEcn && Mark (p))
+    {
+      NS_LOG_DEBUG ("\t Marking due to Prob Mark " << m_qAvg);
+      m_stats.unforcedMark++;
+    }
+  else if (dropType == DTYPE_UNFORCED)
     {
       NS_LOG_DEBUG ("\t Dropping due to Prob Mark " << m_qAvg);
       m_stats.unforcedDrop++;
@@ -324,9 +334,9 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
     }
 
   m_bytesInQueue += p->GetSize ();
-  m_packets.push_back (p);
+  m_packets.PushBack (p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
   return true;
@@ -347,6 +357,7 @@ RedQueue::InitializeParams (void)
   m_stats.forcedDrop = 0;
   m_stats.unforcedDrop = 0;
   m_stats.qLimDrop = 0;
+  m_stats.unforcedMark = 0;
 
   m_cautious = 0;
   m_ptc = m_linkBandwidth.GetBitRate () / (8.0 * m_meanPktSize);
@@ -601,7 +612,7 @@ RedQueue::GetQueueSize (void)
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
-      return m_packets.size ();
+      return m_packets.GetSize ();
     }
   else
     {
@@ -614,7 +625,7 @@ RedQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       m_idle = 1;
@@ -625,13 +636,13 @@ RedQueue::DoDequeue (void)
   else
     {
       m_idle = 0;
-      Ptr<Packet> p = m_packets.front ();
-      m_packets.pop_front ();
+      Ptr<Packet> p = m_packets.Front ();
+      m_packets.PopFront ();
       m_bytesInQueue -= p->GetSize ();
 
       NS_LOG_LOGIC ("Popped " << p);
 
-      NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+      NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
       NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
       return p;
@@ -642,15 +653,15 @@ Ptr<const Packet>
 RedQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
   return p;
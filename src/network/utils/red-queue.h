@@ -61,9 +61,9 @@
 #ifndef RED_QUEUE_H
 #define RED_QUEUE_H
 
-#include <queue>
 #include "ns3/packet.h"
 #include "ns3/queue.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/nstime.h"
 #include "ns3/boolean.h"
 #include "ns3/data-rate.h"
@@ -109,6 +109,7 @@ public:
     uint32_t unforcedDrop;  //!< Early probability drops
     uint32_t forcedDrop;    //!< Forced drops, qavg > max threshold
     uint32_t qLimDrop;      //!< Drops due to queue limits
+    uint32_t unforcedMark;  //!< Early probability ECN marks
   } Stats;
 
   /** 
@@ -233,7 +234,7 @@ private:
   double ModifyP (double p, uint32_t count, uint32_t countBytes,
                   uint32_t meanPktSize, bool wait, uint32_t size);
 
-  std::list<Ptr<Packet> > m_packets; //!< packets in the queue
+  RingBuffer<Ptr<Packet> > m_packets; //!< packets in the queue
 
   uint32_t m_bytesInQueue; //!< bytes in the queue
   bool m_hasRedStarted; //!< True if RED has started
@@ -251,6 +252,7 @@ private:
   double m_qW;              //!< Queue weight given to cur queue size sample
   double m_lInterm;         //!< The max probability of dropping a packet
   bool m_isNs1Compat;       //!< Ns-1 compatibility
+  bool m_useEcn;            //!< True to mark ECN-capable packets instead of dropping them early
   DataRate m_linkBandwidth; //!< Link bandwidth
   Time m_linkDelay;         //!< Link delay
 
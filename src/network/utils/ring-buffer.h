@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief A double-ended queue stored in one contiguous circular buffer
+ *
+ * The queues of packets push at one end and pop at the other: a circular
+ * buffer serves them without allocating memory once it has grown to the
+ * largest backlog, and keeps the elements contiguous.  The capacity is a
+ * power of two, doubled whenever the buffer is full.  Popped elements are
+ * reset to a default value, so that smart pointers release their objects.
+ *
+ * \tparam T the type of the elements
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+  RingBuffer ();
+
+  /**
+   * \param item the element to append
+   */
+  void PushBack (const T &item);
+  /**
+   * \param item the element to prepend
+   */
+  void PushFront (const T &item);
+  /**
+   * \brief Remove the first element.
+   */
+  void PopFront (void);
+  /**
+   * \brief Remove the last element.
+   */
+  void PopBack (void);
+  /**
+   * \returns the first element
+   */
+  const T& Front (void) const;
+  /**
+   * \returns the last element
+   */
+  const T& Back (void) const;
+  /**
+   * \param i the index of an element, from the first one
+   * \returns the element
+   */
+  const T& Get (uint32_t i) const;
+  /**
+   * \returns the number of elements
+   */
+  uint32_t GetSize (void) const;
+  /**
+   * \returns true if there is no element
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \brief Remove all the elements, keeping the capacity.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * \brief Double the capacity, moving the elements to the start of the
+   * buffer.
+   */
+  void Grow (void);
+
+  std::vector<T> m_buffer;  //!< Storage, of a power of two size
+  uint32_t m_mask;          //!< Capacity minus one
+  uint32_t m_head;          //!< Index of the first element
+  uint32_t m_size;          //!< Number of elements
+};
+
+template <typename T>
+RingBuffer<T>::RingBuffer ()
+  : m_buffer (16),
+    m_mask (15),
+    m_head (0),
+    m_size (0)
+{
+}
+
+template <typename T>
+void
+RingBuffer<T>::Grow (void)
+{
+  std::vector<T> buffer (2 * m_buffer.size ());
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      buffer[i] = m_buffer[(m_head + i) & m_mask];
+    }
+  m_buffer.swap (buffer);
+  m_mask = m_buffer.size () - 1;
+  m_head = 0;
+}
+
+template <typename T>
+void
+RingBuffer<T>::PushBack (const T &item)
+{
+  if (m_size == m_buffer.size ())
+    {
+      Grow ();
+    }
+  m_buffer[(m_head + m_size) & m_mask] = item;
+  m_size++;
+}
+
+template <typename T>
+void
+RingBuffer<T>::PushFront (const T &item)
+{
+  if (m_size == m_buffer.size ())
+    {
+      Grow ();
+    }
+  m_head = (m_head - 1) & m_mask;
+  m_buffer[m_head] = item;
+  m_size++;
+}
+
+template <typename T>
+void
+RingBuffer<T>::PopFront (void)
+{
+  NS_ASSERT (m_size > 0);
+  m_buffer[m_head] = T ();
+  m_head = (m_head + 1) & m_mask;
+  m_size--;
+}
+
+template <typename T>
+void
+RingBuffer<T>::PopBack (void)
+{
+  NS_ASSERT (m_size > 0);
+  m_size--;
+  m_buffer[(m_head + m_size) & m_mask] = T ();
+}
+
+template <typename T>
+const T&
+RingBuffer<T>::Front (void) const
+{
+  NS_ASSERT (m_size > 0);
+  return m_buffer[m_head];
+}
+
+template <typename T>
+const T&
+RingBuffer<T>::Back (void) const
+{
+  NS_ASSERT (m_size > 0);
+  return m_buffer[(m_head + m_size - 1) & m_mask];
+}
+
+template <typename T>
+const T&
+RingBuffer<T>::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_size);
+  return m_buffer[(m_head + i) & m_mask];
+}
+
+template <typename T>
+uint32_t
+RingBuffer<T>::GetSize (void) const
+{
+  return m_size;
+}
+
+template <typename T>
+bool
+RingBuffer<T>::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+template <typename T>
+void
+RingBuffer<T>::Clear (void)
+{
+  while (m_size > 0)
+    {
+      PopFront ();
+    }
+  m_head = 0;
+}
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENT_OFFLOAD_TAG_H
+#define SEGMENT_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Mark a packet as a super-segment standing for several segments
+ *
+ * With segmentation offload, a transport protocol hands a payload of
+ * several segments down the stack at once, with a single copy of its
+ * headers.  This packet tag records how the payload is to be cut into
+ * segments, so that:
+ *
+ * - a device supporting offload (see the SegmentOffload attribute of
+ *   PointToPointNetDevice) transmits the super-segment as a single event,
+ *   but over the time the individual segments would take on the wire;
+ * - the network layer splits it into segments before any other device;
+ * - the receiving transport protocol counts it as several segments.
+ */
+class SegmentOffloadTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  SegmentOffloadTag ();
+
+  /**
+   * \param segmentSize maximum payload of each segment, in bytes
+   * \param payloadSize total payload of the super-segment, in bytes
+   */
+  SegmentOffloadTag (uint32_t segmentSize, uint32_t payloadSize);
+
+  /**
+   * \param segmentSize maximum payload of each segment, in bytes
+   */
+  void SetSegmentSize (uint32_t segmentSize);
+  /**
+   * \returns the maximum payload of each segment, in bytes
+   */
+  uint32_t GetSegmentSize (void) const;
+  /**
+   * \param payloadSize total payload of the super-segment, in bytes
+   */
+  void SetPayloadSize (uint32_t payloadSize);
+  /**
+   * \returns the total payload of the super-segment, in bytes
+   */
+  uint32_t GetPayloadSize (void) const;
+  /**
+   * \returns the number of segments the super-segment stands for
+   */
+  uint32_t GetSegmentCount (void) const;
+  /**
+   * \brief Get the number of bytes the segments take on the wire
+   *
+   * Every segment carries a copy of the headers which precede the payload
+   * in the super-segment.
+   *
+   * \param packetSize the size of the super-segment, headers included
+   * \returns the total size of the segments, headers included
+   */
+  uint32_t GetWireSize (uint32_t packetSize) const;
+private:
+  uint32_t m_segmentSize; //!< Maximum payload of each segment
+  uint32_t m_payloadSize; //!< Total payload
+};
+
+} // namespace ns3
+
+#endif /* SEGMENT_OFFLOAD_TAG_H */
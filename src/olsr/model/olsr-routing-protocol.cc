@@ -47,6 +47,7 @@
 #include "ns3/enum.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/ipv4-header.h"
+#include <algorithm>
 
 /********** Useful macros **********/
 
@@ -195,6 +196,7 @@ RoutingProtocol::GetTypeId (void)
 RoutingProtocol::RoutingProtocol ()
   : m_routingTableAssociation (0),
     m_ipv4 (0),
+    m_routesExpiration (Seconds (0)),
     m_helloTimer (Timer::CANCEL_ON_DESTROY),
     m_tcTimer (Timer::CANCEL_ON_DESTROY),
     m_midTimer (Timer::CANCEL_ON_DESTROY),
@@ -875,12 +877,52 @@ RoutingProtocol::GetMainAddress (Ipv4Address iface_addr) const
 ///
 /// \brief Creates the routing table of the node following \RFC{3626} hints.
 ///
+/// The routes to the nodes of the network only depend on the state and on
+/// the expiration of the link tuples, hence they are kept as long as
+/// neither changes.
+///
 void
 RoutingProtocol::RoutingTableComputation ()
 {
   NS_LOG_DEBUG (Simulator::Now ().GetSeconds () << " s: Node " << m_mainAddress
                                                 << ": RoutingTableComputation begin...");
 
+  if (m_state.IsChanged () || Simulator::Now () > m_routesExpiration)
+    {
+      RouteComputation ();
+    }
+  else
+    {
+      NS_LOG_LOGIC ("State unchanged since the last computation; routes kept.");
+    }
+
+  HnaRouteComputation ();
+
+  NS_LOG_DEBUG ("Node " << m_mainAddress << ": RoutingTableComputation end.");
+  m_routingTableChanged (GetSize ());
+}
+
+///
+/// \brief Computes the routes to the nodes of the network (steps 1 to 4 of
+/// the routing table calculation of \RFC{3626}, section 10).
+///
+void
+RoutingProtocol::RouteComputation ()
+{
+  m_state.SetChanged (false);
+
+  // The routes over a link tuple are valid until it expires
+  Time now = Simulator::Now ();
+  m_routesExpiration = Time::Max ();
+  for (LinkSet::const_iterator it = m_state.GetLinks ().begin ();
+       it != m_state.GetLinks ().end (); it++)
+    {
+      if (it->time >= now && it->time < m_routesExpiration)
+        {
+          m_routesExpiration = it->time;
+        }
+    }
+
   // 1. All the entries from the routing table are removed.
   Clear ();
 
@@ -1026,27 +1068,50 @@ RoutingProtocol::RoutingTableComputation ()
         }
     }
 
-  for (uint32_t h = 2;; h++)
+  // The route entries whose R_dist is equal to h, starting with the
+  // 2-hop neighbors
+  std::vector<Ipv4Address> lastAddrs;
+  for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator it = m_table.begin ();
+       it != m_table.end (); it++)
     {
-      bool added = false;
+      if (it->second.distance == 2)
+        {
+          lastAddrs.push_back (it->first);
+        }
+    }
 
+  const TopologySet &topology = m_state.GetTopologySet ();
+  for (uint32_t h = 2; !lastAddrs.empty (); h++)
+    {
       // 3.1. For each topology entry in the topology table, if its
       // T_dest_addr does not correspond to R_dest_addr of any
       // route entry in the routing table AND its T_last_addr
       // corresponds to R_dest_addr of a route entry whose R_dist
       // is equal to h, then a new route entry MUST be recorded in
       // the routing table (if it does not already exist)
-      const TopologySet &topology = m_state.GetTopologySet ();
-      for (TopologySet::const_iterator it = topology.begin ();
-           it != topology.end (); it++)
+      //
+      // Only the topology entries of these T_last_addr are looked at, in
+      // the order of the topology table, as the first one decides the route.
+      std::vector<uint32_t> positions;
+      for (std::vector<Ipv4Address>::const_iterator it = lastAddrs.begin ();
+           it != lastAddrs.end (); it++)
+        {
+          m_state.FindTopologyTuples (*it, positions);
+        }
+      std::sort (positions.begin (), positions.end ());
+      lastAddrs.clear ();
+
+      for (std::vector<uint32_t>::const_iterator it = positions.begin ();
+           it != positions.end (); it++)
         {
-          const TopologyTuple &topology_tuple = *it;
+          const TopologyTuple &topology_tuple = topology[*it];
           NS_LOG_LOGIC ("Looking at topology tuple: " << topology_tuple);
 
           RoutingTableEntry destAddrEntry, lastAddrEntry;
           bool have_destAddrEntry = Lookup (topology_tuple.destAddr, destAddrEntry);
-          bool have_lastAddrEntry = Lookup (topology_tuple.lastAddr, lastAddrEntry);
-          if (!have_destAddrEntry && have_lastAddrEntry && lastAddrEntry.distance == h)
+          Lookup (topology_tuple.lastAddr, lastAddrEntry);
+          NS_ASSERT (lastAddrEntry.distance == h);
+          if (!have_destAddrEntry)
             {
               NS_LOG_LOGIC ("Adding routing table entry based on the topology tuple.");
               // then a new route entry MUST be recorded in
@@ -1063,20 +1128,15 @@ RoutingProtocol::RoutingTableComputation ()
                         lastAddrEntry.nextAddr,
                         lastAddrEntry.interface,
                         h + 1);
-              added = true;
+              lastAddrs.push_back (topology_tuple.destAddr);
             }
           else
             {
               NS_LOG_LOGIC ("NOT adding routing table entry based on the topology tuple: "
                             "have_destAddrEntry=" << have_destAddrEntry
-                                                  << " have_lastAddrEntry=" << have_lastAddrEntry
-                                                  << " lastAddrEntry.distance=" << (int) lastAddrEntry.distance
                                                   << " (h=" << h << ")");
             }
         }
-
-      if (!added)
-        break;
     }
 
   // 4. For each entry in the multiple interface association base
@@ -1106,7 +1166,15 @@ RoutingProtocol::RoutingTableComputation ()
                     entry1.distance);
         }
     }
+}
 
+///
+/// \brief Computes the routes to the networks associated to the nodes
+/// (step 5 of the routing table calculation of \RFC{3626}, section 10).
+///
+void
+RoutingProtocol::HnaRouteComputation ()
+{
   // 5. For each tuple in the association set,
   //    If there is no entry in the routing table with:
   //        R_dest_addr     == A_network_addr/A_netmask
@@ -1184,9 +1252,6 @@ RoutingProtocol::RoutingTableComputation ()
 
         }
     }
-
-  NS_LOG_DEBUG ("Node " << m_mainAddress << ": RoutingTableComputation end.");
-  m_routingTableChanged (GetSize ());
 }
 
 
@@ -1382,20 +1447,13 @@ RoutingProtocol::ProcessMid (const olsr::MessageHeader &msg,
   for (std::vector<Ipv4Address>::const_iterator i = mid.interfaceAddresses.begin ();
        i != mid.interfaceAddresses.end (); i++)
     {
-      bool updated = false;
-      IfaceAssocSet &ifaceAssoc = m_state.GetIfaceAssocSetMutable ();
-      for (IfaceAssocSet::iterator tuple = ifaceAssoc.begin ();
-           tuple != ifaceAssoc.end (); tuple++)
+      IfaceAssocTuple *existing = m_state.FindIfaceAssocTuple (*i, msg.GetOriginatorAddress ());
+      if (existing != NULL)
         {
-          if (tuple->ifaceAddr == *i
-              && tuple->mainAddr == msg.GetOriginatorAddress ())
-            {
-              NS_LOG_LOGIC ("IfaceAssoc updated: " << *tuple);
-              tuple->time = now + msg.GetVTime ();
-              updated = true;
-            }
+          NS_LOG_LOGIC ("IfaceAssoc updated: " << *existing);
+          existing->time = now + msg.GetVTime ();
         }
-      if (!updated)
+      else
         {
           IfaceAssocTuple tuple;
           tuple.ifaceAddr = *i;
@@ -1412,19 +1470,7 @@ RoutingProtocol::ProcessMid (const olsr::MessageHeader &msg,
   // 3. (not part of the RFC) iterate over all NeighborTuple's and
   // TwoHopNeighborTuples, update the neighbor addresses taking into account
   // the new MID information.
-  NeighborSet &neighbors = m_state.GetNeighbors ();
-  for (NeighborSet::iterator neighbor = neighbors.begin (); neighbor != neighbors.end (); neighbor++)
-    {
-      neighbor->neighborMainAddr = GetMainAddress (neighbor->neighborMainAddr);
-    }
-
-  TwoHopNeighborSet &twoHopNeighbors = m_state.GetTwoHopNeighbors ();
-  for (TwoHopNeighborSet::iterator twoHopNeighbor = twoHopNeighbors.begin ();
-       twoHopNeighbor != twoHopNeighbors.end (); twoHopNeighbor++)
-    {
-      twoHopNeighbor->neighborMainAddr = GetMainAddress (twoHopNeighbor->neighborMainAddr);
-      twoHopNeighbor->twoHopNeighborAddr = GetMainAddress (twoHopNeighbor->twoHopNeighborAddr);
-    }
+  m_state.UpdateNeighborMainAddresses ();
   NS_LOG_DEBUG ("Node " << m_mainAddress << " ProcessMid from " << senderIface << " -> END.");
 }
 
@@ -2018,6 +2064,7 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
       NS_LOG_LOGIC ("Existing link tuple already exists => will update it");
       updated = true;
     }
+  Time linkTime = link_tuple->time;
 
   link_tuple->asymTime = now + msg.GetVTime ();
   for (std::vector<olsr::MessageHeader::Hello::LinkMessage>::const_iterator linkMessage =
@@ -2102,6 +2149,12 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
       NS_LOG_DEBUG ("Link tuple updated: " << int (updated));
     }
   link_tuple->time = std::max (link_tuple->time, link_tuple->asymTime);
+  // The routes over an expired link come back, and the routes over a
+  // link may expire earlier than they were computed to
+  if (linkTime < now || link_tuple->time < linkTime)
+    {
+      m_state.SetChanged (true);
+    }
 
   if (updated)
     {
@@ -2128,9 +2181,10 @@ RoutingProtocol::PopulateNeighborSet (const olsr::MessageHeader &msg,
                                       const olsr::MessageHeader::Hello &hello)
 {
   NeighborTuple *nb_tuple = m_state.FindNeighborTuple (msg.GetOriginatorAddress ());
-  if (nb_tuple != NULL)
+  if (nb_tuple != NULL && nb_tuple->willingness != hello.willingness)
     {
       nb_tuple->willingness = hello.willingness;
+      m_state.SetChanged (true);
     }
 }
 
@@ -2487,6 +2541,10 @@ RoutingProtocol::LinkTupleUpdated (const LinkTuple &tuple, uint8_t willingness)
           NS_LOG_DEBUG (*nb_tuple << "->status = STATUS_NOT_SYM; changed:"
                                   << int (statusBefore != nb_tuple->status));
         }
+      if (statusBefore != nb_tuple->status)
+        {
+          m_state.SetChanged (true);
+        }
     }
   else
     {
@@ -185,6 +185,9 @@ private:
 
   Ptr<Ipv4> m_ipv4;
 
+  /// Time at which a link tuple the routes were computed from expires.
+  Time m_routesExpiration;
+
   void Clear ();
   uint32_t GetSize () const { return m_table.size (); }
   void RemoveEntry (const Ipv4Address &dest);
@@ -233,6 +236,8 @@ private:
 
   void MprComputation ();
   void RoutingTableComputation ();
+  void RouteComputation ();
+  void HnaRouteComputation ();
   Ipv4Address GetMainAddress (Ipv4Address iface_addr) const;
   bool UsesNonOlsrOutgoingInterface (const Ipv4RoutingTableEntry &route);
 
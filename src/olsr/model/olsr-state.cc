@@ -27,11 +27,72 @@
 ///
 
 #include "olsr-state.h"
+#include "ns3/assert.h"
+#include <algorithm>
 
 
 namespace ns3 {
 namespace olsr {
 
+/********** Tuple Index **********/
+
+OlsrState::TupleIndex::TupleIndex ()
+  : m_nextNumber (0)
+{
+}
+
+void
+OlsrState::TupleIndex::Insert (const Ipv4Address &key)
+{
+  m_map[key].push_back (m_nextNumber);
+  m_numbers.push_back (m_nextNumber);
+  m_nextNumber++;
+}
+
+void
+OlsrState::TupleIndex::Erase (const Ipv4Address &key, uint32_t position)
+{
+  NS_ASSERT (position < m_numbers.size ());
+  uint64_t number = m_numbers[position];
+  m_numbers.erase (m_numbers.begin () + position);
+  Map::iterator it = m_map.find (key);
+  NS_ASSERT (it != m_map.end ());
+  Numbers &numbers = it->second;
+  Numbers::iterator n = std::lower_bound (numbers.begin (), numbers.end (), number);
+  NS_ASSERT (n != numbers.end () && *n == number);
+  numbers.erase (n);
+  if (numbers.empty ())
+    {
+      m_map.erase (it);
+    }
+}
+
+void
+OlsrState::TupleIndex::Clear ()
+{
+  m_map.clear ();
+  m_numbers.clear ();
+}
+
+const OlsrState::TupleIndex::Numbers*
+OlsrState::TupleIndex::Find (const Ipv4Address &key) const
+{
+  Map::const_iterator it = m_map.find (key);
+  if (it == m_map.end ())
+    {
+      return NULL;
+    }
+  return &it->second;
+}
+
+uint32_t
+OlsrState::TupleIndex::GetPosition (uint64_t number) const
+{
+  Numbers::const_iterator it = std::lower_bound (m_numbers.begin (), m_numbers.end (), number);
+  NS_ASSERT (it != m_numbers.end () && *it == number);
+  return it - m_numbers.begin ();
+}
+
 /********** MPR Selector Set Manipulation **********/
 
 MprSelectorTuple*
@@ -107,23 +168,24 @@ OlsrState::PrintMprSelectorSet () const
 NeighborTuple*
 OlsrState::FindNeighborTuple (Ipv4Address const &mainAddr)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
-    {
-      if (it->neighborMainAddr == mainAddr)
-        return &(*it);
-    }
-  return NULL;
+  const TupleIndex::Numbers *numbers = m_neighborIndex.Find (mainAddr);
+  if (numbers == NULL)
+    return NULL;
+  return &m_neighborSet[m_neighborIndex.GetPosition (numbers->front ())];
 }
 
 const NeighborTuple*
 OlsrState::FindSymNeighborTuple (Ipv4Address const &mainAddr) const
 {
-  for (NeighborSet::const_iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_neighborIndex.Find (mainAddr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->neighborMainAddr == mainAddr && it->status == NeighborTuple::STATUS_SYM)
-        return &(*it);
+      const NeighborTuple &tuple = m_neighborSet[m_neighborIndex.GetPosition (*it)];
+      if (tuple.status == NeighborTuple::STATUS_SYM)
+        return &tuple;
     }
   return NULL;
 }
@@ -131,11 +193,15 @@ OlsrState::FindSymNeighborTuple (Ipv4Address const &mainAddr) const
 NeighborTuple*
 OlsrState::FindNeighborTuple (Ipv4Address const &mainAddr, uint8_t willingness)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_neighborIndex.Find (mainAddr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->neighborMainAddr == mainAddr && it->willingness == willingness)
-        return &(*it);
+      NeighborTuple &tuple = m_neighborSet[m_neighborIndex.GetPosition (*it)];
+      if (tuple.willingness == willingness)
+        return &tuple;
     }
   return NULL;
 }
@@ -143,12 +209,18 @@ OlsrState::FindNeighborTuple (Ipv4Address const &mainAddr, uint8_t willingness)
 void
 OlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_neighborIndex.Find (tuple.neighborMainAddr);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (*it == tuple)
+      uint32_t position = m_neighborIndex.GetPosition (*it);
+      if (m_neighborSet[position] == tuple)
         {
-          m_neighborSet.erase (it);
+          m_neighborIndex.Erase (tuple.neighborMainAddr, position);
+          m_neighborSet.erase (m_neighborSet.begin () + position);
+          m_changed = true;
           break;
         }
     }
@@ -157,31 +229,28 @@ OlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
 void
 OlsrState::EraseNeighborTuple (const Ipv4Address &mainAddr)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
-    {
-      if (it->neighborMainAddr == mainAddr)
-        {
-          it = m_neighborSet.erase (it);
-          break;
-        }
-    }
+  const TupleIndex::Numbers *numbers = m_neighborIndex.Find (mainAddr);
+  if (numbers == NULL)
+    return;
+  uint32_t position = m_neighborIndex.GetPosition (numbers->front ());
+  m_neighborIndex.Erase (mainAddr, position);
+  m_neighborSet.erase (m_neighborSet.begin () + position);
+  m_changed = true;
 }
 
 void
 OlsrState::InsertNeighborTuple (NeighborTuple const &tuple)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  m_changed = true;
+  NeighborTuple *existing = FindNeighborTuple (tuple.neighborMainAddr);
+  if (existing != NULL)
     {
-      if (it->neighborMainAddr == tuple.neighborMainAddr)
-        {
-          // Update it
-          *it = tuple;
-          return;
-        }
+      // Update it
+      *existing = tuple;
+      return;
     }
   m_neighborSet.push_back (tuple);
+  m_neighborIndex.Insert (tuple.neighborMainAddr);
 }
 
 /********** Neighbor 2 Hop Set Manipulation **********/
@@ -190,13 +259,16 @@ TwoHopNeighborTuple*
 OlsrState::FindTwoHopNeighborTuple (Ipv4Address const &neighborMainAddr,
                                     Ipv4Address const &twoHopNeighborAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_twoHopNeighborIndex.Find (neighborMainAddr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->neighborMainAddr == neighborMainAddr
-          && it->twoHopNeighborAddr == twoHopNeighborAddr)
+      TwoHopNeighborTuple &tuple = m_twoHopNeighborSet[m_twoHopNeighborIndex.GetPosition (*it)];
+      if (tuple.twoHopNeighborAddr == twoHopNeighborAddr)
         {
-          return &(*it);
+          return &tuple;
         }
     }
   return NULL;
@@ -205,12 +277,18 @@ OlsrState::FindTwoHopNeighborTuple (Ipv4Address const &neighborMainAddr,
 void
 OlsrState::EraseTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_twoHopNeighborIndex.Find (tuple.neighborMainAddr);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (*it == tuple)
+      uint32_t position = m_twoHopNeighborIndex.GetPosition (*it);
+      if (m_twoHopNeighborSet[position] == tuple)
         {
-          m_twoHopNeighborSet.erase (it);
+          m_twoHopNeighborIndex.Erase (tuple.neighborMainAddr, position);
+          m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + position);
+          m_changed = true;
           break;
         }
     }
@@ -220,17 +298,22 @@ void
 OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr,
                                       const Ipv4Address &twoHopNeighborAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end ();)
+  const TupleIndex::Numbers *numbers = m_twoHopNeighborIndex.Find (neighborMainAddr);
+  if (numbers == NULL)
+    return;
+  // from the last one, which does not move the others; the address may
+  // belong to an erased tuple
+  TupleIndex::Numbers found (*numbers);
+  Ipv4Address key = neighborMainAddr;
+  for (TupleIndex::Numbers::reverse_iterator it = found.rbegin ();
+       it != found.rend (); it++)
     {
-      if (it->neighborMainAddr == neighborMainAddr
-          && it->twoHopNeighborAddr == twoHopNeighborAddr)
+      uint32_t position = m_twoHopNeighborIndex.GetPosition (*it);
+      if (m_twoHopNeighborSet[position].twoHopNeighborAddr == twoHopNeighborAddr)
         {
-          it = m_twoHopNeighborSet.erase (it);
-        }
-      else
-        {
-          it++;
+          m_twoHopNeighborIndex.Erase (key, position);
+          m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + position);
+          m_changed = true;
         }
     }
 }
@@ -238,24 +321,78 @@ OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr,
 void
 OlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end ();)
+  const TupleIndex::Numbers *numbers = m_twoHopNeighborIndex.Find (neighborMainAddr);
+  if (numbers == NULL)
+    return;
+  // from the last one, which does not move the others; the address may
+  // belong to an erased tuple
+  TupleIndex::Numbers found (*numbers);
+  Ipv4Address key = neighborMainAddr;
+  for (TupleIndex::Numbers::reverse_iterator it = found.rbegin ();
+       it != found.rend (); it++)
     {
-      if (it->neighborMainAddr == neighborMainAddr)
-        {
-          it = m_twoHopNeighborSet.erase (it);
-        }
-      else
-        {
-          it++;
-        }
+      uint32_t position = m_twoHopNeighborIndex.GetPosition (*it);
+      m_twoHopNeighborIndex.Erase (key, position);
+      m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + position);
     }
+  m_changed = true;
 }
 
 void
 OlsrState::InsertTwoHopNeighborTuple (TwoHopNeighborTuple const &tuple)
 {
   m_twoHopNeighborSet.push_back (tuple);
+  m_twoHopNeighborIndex.Insert (tuple.neighborMainAddr);
+  m_changed = true;
+}
+
+void
+OlsrState::UpdateNeighborMainAddresses ()
+{
+  bool updated = false;
+  for (NeighborSet::iterator it = m_neighborSet.begin ();
+       it != m_neighborSet.end (); it++)
+    {
+      const IfaceAssocTuple *ifaceAssoc = FindIfaceAssocTuple (it->neighborMainAddr);
+      if (ifaceAssoc != NULL && ifaceAssoc->mainAddr != it->neighborMainAddr)
+        {
+          it->neighborMainAddr = ifaceAssoc->mainAddr;
+          updated = true;
+        }
+    }
+  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
+       it != m_twoHopNeighborSet.end (); it++)
+    {
+      const IfaceAssocTuple *ifaceAssoc = FindIfaceAssocTuple (it->neighborMainAddr);
+      if (ifaceAssoc != NULL && ifaceAssoc->mainAddr != it->neighborMainAddr)
+        {
+          it->neighborMainAddr = ifaceAssoc->mainAddr;
+          updated = true;
+        }
+      ifaceAssoc = FindIfaceAssocTuple (it->twoHopNeighborAddr);
+      if (ifaceAssoc != NULL && ifaceAssoc->mainAddr != it->twoHopNeighborAddr)
+        {
+          it->twoHopNeighborAddr = ifaceAssoc->mainAddr;
+          updated = true;
+        }
+    }
+  if (!updated)
+    return;
+
+  // the tuples keep their positions
+  m_neighborIndex.Clear ();
+  for (NeighborSet::const_iterator it = m_neighborSet.begin ();
+       it != m_neighborSet.end (); it++)
+    {
+      m_neighborIndex.Insert (it->neighborMainAddr);
+    }
+  m_twoHopNeighborIndex.Clear ();
+  for (TwoHopNeighborSet::const_iterator it = m_twoHopNeighborSet.begin ();
+       it != m_twoHopNeighborSet.end (); it++)
+    {
+      m_twoHopNeighborIndex.Insert (it->neighborMainAddr);
+    }
+  m_changed = true;
 }
 
 /********** MPR Set Manipulation **********/
@@ -283,11 +420,15 @@ OlsrState::GetMprSet () const
 DuplicateTuple*
 OlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_duplicateIndex.Find (addr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->address == addr && it->sequenceNumber == sequenceNumber)
-        return &(*it);
+      DuplicateTuple &tuple = m_duplicateSet[m_duplicateIndex.GetPosition (*it)];
+      if (tuple.sequenceNumber == sequenceNumber)
+        return &tuple;
     }
   return NULL;
 }
@@ -295,12 +436,17 @@ OlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber)
 void
 OlsrState::EraseDuplicateTuple (const DuplicateTuple &tuple)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_duplicateIndex.Find (tuple.address);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (*it == tuple)
+      uint32_t position = m_duplicateIndex.GetPosition (*it);
+      if (m_duplicateSet[position] == tuple)
         {
-          m_duplicateSet.erase (it);
+          m_duplicateIndex.Erase (tuple.address, position);
+          m_duplicateSet.erase (m_duplicateSet.begin () + position);
           break;
         }
     }
@@ -310,6 +456,7 @@ void
 OlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 {
   m_duplicateSet.push_back (tuple);
+  m_duplicateIndex.Insert (tuple.address);
 }
 
 /********** Link Set Manipulation **********/
@@ -317,41 +464,36 @@ OlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 LinkTuple*
 OlsrState::FindLinkTuple (Ipv4Address const & ifaceAddr)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
-    {
-      if (it->neighborIfaceAddr == ifaceAddr)
-        return &(*it);
-    }
-  return NULL;
+  const TupleIndex::Numbers *numbers = m_linkIndex.Find (ifaceAddr);
+  if (numbers == NULL)
+    return NULL;
+  return &m_linkSet[m_linkIndex.GetPosition (numbers->front ())];
 }
 
 LinkTuple*
 OlsrState::FindSymLinkTuple (Ipv4Address const &ifaceAddr, Time now)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
-    {
-      if (it->neighborIfaceAddr == ifaceAddr)
-        {
-          if (it->symTime > now)
-            return &(*it);
-          else
-            break;
-        }
-    }
+  LinkTuple *tuple = FindLinkTuple (ifaceAddr);
+  if (tuple != NULL && tuple->symTime > now)
+    return tuple;
   return NULL;
 }
 
 void
 OlsrState::EraseLinkTuple (const LinkTuple &tuple)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_linkIndex.Find (tuple.neighborIfaceAddr);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (*it == tuple)
+      uint32_t position = m_linkIndex.GetPosition (*it);
+      if (m_linkSet[position] == tuple)
         {
-          m_linkSet.erase (it);
+          m_linkIndex.Erase (tuple.neighborIfaceAddr, position);
+          m_linkSet.erase (m_linkSet.begin () + position);
+          m_changed = true;
           break;
         }
     }
@@ -361,6 +503,8 @@ LinkTuple&
 OlsrState::InsertLinkTuple (LinkTuple const &tuple)
 {
   m_linkSet.push_back (tuple);
+  m_linkIndex.Insert (tuple.neighborIfaceAddr);
+  m_changed = true;
   return m_linkSet.back ();
 }
 
@@ -370,11 +514,15 @@ TopologyTuple*
 OlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
                               Ipv4Address const &lastAddr)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_topologyIndex.Find (lastAddr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->destAddr == destAddr && it->lastAddr == lastAddr)
-        return &(*it);
+      TopologyTuple &tuple = m_topologySet[m_topologyIndex.GetPosition (*it)];
+      if (tuple.destAddr == destAddr)
+        return &tuple;
     }
   return NULL;
 }
@@ -382,24 +530,48 @@ OlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
 TopologyTuple*
 OlsrState::FindNewerTopologyTuple (Ipv4Address const & lastAddr, uint16_t ansn)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_topologyIndex.Find (lastAddr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->lastAddr == lastAddr && it->sequenceNumber > ansn)
-        return &(*it);
+      TopologyTuple &tuple = m_topologySet[m_topologyIndex.GetPosition (*it)];
+      if (tuple.sequenceNumber > ansn)
+        return &tuple;
     }
   return NULL;
 }
 
+void
+OlsrState::FindTopologyTuples (const Ipv4Address &lastAddr,
+                               std::vector<uint32_t> &positions) const
+{
+  const TupleIndex::Numbers *numbers = m_topologyIndex.Find (lastAddr);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
+    {
+      positions.push_back (m_topologyIndex.GetPosition (*it));
+    }
+}
+
 void
 OlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_topologyIndex.Find (tuple.lastAddr);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (*it == tuple)
+      uint32_t position = m_topologyIndex.GetPosition (*it);
+      if (m_topologySet[position] == tuple)
         {
-          m_topologySet.erase (it);
+          m_topologyIndex.Erase (tuple.lastAddr, position);
+          m_topologySet.erase (m_topologySet.begin () + position);
+          m_changed = true;
           break;
         }
     }
@@ -408,16 +580,22 @@ OlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 void
 OlsrState::EraseOlderTopologyTuples (const Ipv4Address &lastAddr, uint16_t ansn)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end ();)
+  const TupleIndex::Numbers *numbers = m_topologyIndex.Find (lastAddr);
+  if (numbers == NULL)
+    return;
+  // from the last one, which does not move the others; the address may
+  // belong to an erased tuple
+  TupleIndex::Numbers found (*numbers);
+  Ipv4Address key = lastAddr;
+  for (TupleIndex::Numbers::reverse_iterator it = found.rbegin ();
+       it != found.rend (); it++)
     {
-      if (it->lastAddr == lastAddr && it->sequenceNumber < ansn)
-        {
-          it = m_topologySet.erase (it);
-        }
-      else
+      uint32_t position = m_topologyIndex.GetPosition (*it);
+      if (m_topologySet[position].sequenceNumber < ansn)
         {
-          it++;
+          m_topologyIndex.Erase (key, position);
+          m_topologySet.erase (m_topologySet.begin () + position);
+          m_changed = true;
         }
     }
 }
@@ -426,6 +604,8 @@ void
 OlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 {
   m_topologySet.push_back (tuple);
+  m_topologyIndex.Insert (tuple.lastAddr);
+  m_changed = true;
 }
 
 /********** Interface Association Set Manipulation **********/
@@ -433,23 +613,34 @@ OlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 IfaceAssocTuple*
 OlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr)
 {
-  for (IfaceAssocSet::iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
-    {
-      if (it->ifaceAddr == ifaceAddr)
-        return &(*it);
-    }
-  return NULL;
+  const TupleIndex::Numbers *numbers = m_ifaceAssocIndex.Find (ifaceAddr);
+  if (numbers == NULL)
+    return NULL;
+  return &m_ifaceAssocSet[m_ifaceAssocIndex.GetPosition (numbers->front ())];
 }
 
 const IfaceAssocTuple*
 OlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr) const
 {
-  for (IfaceAssocSet::const_iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_ifaceAssocIndex.Find (ifaceAddr);
+  if (numbers == NULL)
+    return NULL;
+  return &m_ifaceAssocSet[m_ifaceAssocIndex.GetPosition (numbers->front ())];
+}
+
+IfaceAssocTuple*
+OlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr,
+                                Ipv4Address const &mainAddr)
+{
+  const TupleIndex::Numbers *numbers = m_ifaceAssocIndex.Find (ifaceAddr);
+  if (numbers == NULL)
+    return NULL;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (it->ifaceAddr == ifaceAddr)
-        return &(*it);
+      IfaceAssocTuple &tuple = m_ifaceAssocSet[m_ifaceAssocIndex.GetPosition (*it)];
+      if (tuple.mainAddr == mainAddr)
+        return &tuple;
     }
   return NULL;
 }
@@ -457,12 +648,18 @@ OlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr) const
 void
 OlsrState::EraseIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
-  for (IfaceAssocSet::iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  const TupleIndex::Numbers *numbers = m_ifaceAssocIndex.Find (tuple.ifaceAddr);
+  if (numbers == NULL)
+    return;
+  for (TupleIndex::Numbers::const_iterator it = numbers->begin ();
+       it != numbers->end (); it++)
     {
-      if (*it == tuple)
+      uint32_t position = m_ifaceAssocIndex.GetPosition (*it);
+      if (m_ifaceAssocSet[position] == tuple)
         {
-          m_ifaceAssocSet.erase (it);
+          m_ifaceAssocIndex.Erase (tuple.ifaceAddr, position);
+          m_ifaceAssocSet.erase (m_ifaceAssocSet.begin () + position);
+          m_changed = true;
           break;
         }
     }
@@ -472,6 +669,8 @@ void
 OlsrState::InsertIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
   m_ifaceAssocSet.push_back (tuple);
+  m_ifaceAssocIndex.Insert (tuple.ifaceAddr);
+  m_changed = true;
 }
 
 std::vector<Ipv4Address>
@@ -26,15 +26,68 @@
 #define OLSR_STATE_H
 
 #include "olsr-repositories.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 namespace olsr {
 
-/// This class encapsulates all data structures needed for maintaining internal state of an OLSR node.
+/**
+ * This class encapsulates all data structures needed for maintaining internal state of an OLSR node.
+ *
+ * The Link, Neighbor, 2-hop Neighbor, Topology, Duplicate and Interface
+ * Association Sets are indexed by an address of their tuples, so that the
+ * Find and Erase methods do not scan the whole set.  The sets keep the
+ * order in which the tuples were inserted, which decides between equal
+ * candidates in the MPR and routing table computations.
+ */
 class OlsrState
 {
   //  friend class Olsr;
 
+  /**
+   * \brief Index of the tuples of a set by an address.
+   *
+   * Each tuple gets a number when it is inserted, which increases with its
+   * position in the set.  The index maps an address to the numbers of its
+   * tuples, and the position of a number is found by binary search.
+   */
+  class TupleIndex
+  {
+  public:
+    /// Numbers of the tuples of an address, in the order of the set
+    typedef std::vector<uint64_t> Numbers;
+
+    TupleIndex ();
+    /**
+     * \param key address of a tuple appended to the set
+     */
+    void Insert (const Ipv4Address &key);
+    /**
+     * \param key address of the tuple
+     * \param position position of the tuple erased from the set
+     */
+    void Erase (const Ipv4Address &key, uint32_t position);
+    /// Forget all the tuples
+    void Clear ();
+    /**
+     * \param key an address
+     * \returns the numbers of the tuples of the address, NULL if none
+     */
+    const Numbers* Find (const Ipv4Address &key) const;
+    /**
+     * \param number number of a tuple
+     * \returns the position of the tuple in the set
+     */
+    uint32_t GetPosition (uint64_t number) const;
+
+  private:
+    /// Map of the addresses to the numbers of their tuples
+    typedef sgi::hash_map<Ipv4Address, Numbers, Ipv4AddressHash> Map;
+    Map m_map;                  ///< Numbers of the tuples of each address
+    Numbers m_numbers;          ///< Number of the tuple at each position
+    uint64_t m_nextNumber;      ///< Number of the next inserted tuple
+  };
+
 protected:
   LinkSet m_linkSet;    ///< Link Set (\RFC{3626}, section 4.2.1).
   NeighborSet m_neighborSet;            ///< Neighbor Set (\RFC{3626}, section 4.3.1).
@@ -47,11 +100,38 @@ protected:
   AssociationSet m_associationSet; ///<	Association Set (\RFC{3626}, section12.2). Associations obtained from HNA messages generated by other nodes.
   Associations m_associations;  ///< The node's local Host Network Associations that will be advertised using HNA messages.
 
+  TupleIndex m_linkIndex;       ///< Link Set by neighbor interface address.
+  TupleIndex m_neighborIndex;   ///< Neighbor Set by neighbor main address.
+  TupleIndex m_twoHopNeighborIndex;     ///< 2-hop Neighbor Set by neighbor main address.
+  TupleIndex m_topologyIndex;   ///< Topology Set by last address.
+  TupleIndex m_duplicateIndex;  ///< Duplicate Set by originator address.
+  TupleIndex m_ifaceAssocIndex; ///< Interface Association Set by interface address.
+  bool m_changed;               ///< True if a tuple the routing table is computed from has changed.
+
 public:
 
   OlsrState ()
+    : m_changed (false)
   {}
 
+  /**
+   * \returns true if a tuple of the Link, Neighbor, 2-hop Neighbor,
+   * Topology or Interface Association Sets has been inserted, erased or
+   * changed since the last call to SetChanged (false)
+   */
+  bool IsChanged () const
+  {
+    return m_changed;
+  }
+  /**
+   * \param changed whether the routing table must be computed again, e.g.
+   * after a tuple has been updated through a pointer
+   */
+  void SetChanged (bool changed)
+  {
+    m_changed = changed;
+  }
+
   // MPR selector
   const MprSelectorSet & GetMprSelectors () const
   {
@@ -68,10 +148,6 @@ public:
   {
     return m_neighborSet;
   }
-  NeighborSet & GetNeighbors ()
-  {
-    return m_neighborSet;
-  }
   NeighborTuple* FindNeighborTuple (const Ipv4Address &mainAddr);
   const NeighborTuple* FindSymNeighborTuple (const Ipv4Address &mainAddr) const;
   NeighborTuple* FindNeighborTuple (const Ipv4Address &mainAddr,
@@ -85,10 +161,6 @@ public:
   {
     return m_twoHopNeighborSet;
   }
-  TwoHopNeighborSet & GetTwoHopNeighbors ()
-  {
-    return m_twoHopNeighborSet;
-  }
   TwoHopNeighborTuple* FindTwoHopNeighborTuple (const Ipv4Address &neighbor,
                                                 const Ipv4Address &twoHopNeighbor);
   void EraseTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple);
@@ -96,6 +168,9 @@ public:
   void EraseTwoHopNeighborTuples (const Ipv4Address &neighbor,
                                   const Ipv4Address &twoHopNeighbor);
   void InsertTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple);
+  /// Replace the interface addresses of the Neighbor and 2-hop Neighbor
+  /// Sets by the main addresses of the Interface Association Set.
+  void UpdateNeighborMainAddresses ();
 
   // MPR
   bool FindMprAddress (const Ipv4Address &address);
@@ -129,6 +204,14 @@ public:
                                     const Ipv4Address &lastAddr);
   TopologyTuple* FindNewerTopologyTuple (const Ipv4Address &lastAddr,
                                          uint16_t ansn);
+  /**
+   * \brief Find the topology tuples of a last address.
+   * \param lastAddr the last address
+   * \param positions vector the positions of the tuples in the Topology Set
+   * are appended to, in increasing order
+   */
+  void FindTopologyTuples (const Ipv4Address &lastAddr,
+                           std::vector<uint32_t> &positions) const;
   void EraseTopologyTuple (const TopologyTuple &tuple);
   void EraseOlderTopologyTuples (const Ipv4Address &lastAddr,
                                  uint16_t ansn);
@@ -139,12 +222,10 @@ public:
   {
     return m_ifaceAssocSet;
   }
-  IfaceAssocSet & GetIfaceAssocSetMutable ()
-  {
-    return m_ifaceAssocSet;
-  }
   IfaceAssocTuple* FindIfaceAssocTuple (const Ipv4Address &ifaceAddr);
   const IfaceAssocTuple* FindIfaceAssocTuple (const Ipv4Address &ifaceAddr) const;
+  IfaceAssocTuple* FindIfaceAssocTuple (const Ipv4Address &ifaceAddr,
+                                        const Ipv4Address &mainAddr);
   void EraseIfaceAssocTuple (const IfaceAssocTuple &tuple);
   void InsertIfaceAssocTuple (const IfaceAssocTuple &tuple);
 
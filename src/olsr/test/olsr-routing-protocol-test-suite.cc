@@ -167,6 +167,114 @@ OlsrMprTestCase::DoRun ()
   NS_TEST_EXPECT_MSG_EQ ((mpr.find ("10.0.0.9") == mpr.end ()), true, "Node 1 must NOT select node 8 as MPR");
 }
 
+/// Testcase for the indexed sets of the OLSR state
+class OlsrStateTestCase : public TestCase {
+public:
+  OlsrStateTestCase ();
+  /// \brief Run test case
+  virtual void DoRun (void);
+};
+
+OlsrStateTestCase::OlsrStateTestCase ()
+  : TestCase ("Check OLSR state sets")
+{
+}
+
+void
+OlsrStateTestCase::DoRun ()
+{
+  OlsrState state;
+  NS_TEST_EXPECT_MSG_EQ (state.IsChanged (), false, "The state must start unchanged");
+
+  /*
+   * Topology tuples of two last addresses, interleaved: the set keeps the
+   * order of insertion across erasures
+   */
+  TopologyTuple topology;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      topology.destAddr = Ipv4Address (0x0a000100 + i);
+      topology.lastAddr = Ipv4Address (i % 2 ? "10.0.0.2" : "10.0.0.1");
+      topology.sequenceNumber = i;
+      state.InsertTopologyTuple (topology);
+    }
+  NS_TEST_EXPECT_MSG_EQ (state.IsChanged (), true, "Inserting a topology tuple changes the state");
+  state.SetChanged (false);
+
+  TopologyTuple *found = state.FindTopologyTuple (Ipv4Address ("10.0.1.3"), Ipv4Address ("10.0.0.2"));
+  NS_TEST_ASSERT_MSG_NE (found, 0, "Topology tuple not found");
+  NS_TEST_EXPECT_MSG_EQ (found->sequenceNumber, 3, "Wrong topology tuple");
+  NS_TEST_EXPECT_MSG_EQ (state.FindTopologyTuple (Ipv4Address ("10.0.1.3"), Ipv4Address ("10.0.0.1")), 0,
+                         "Topology tuple of another last address found");
+  found = state.FindNewerTopologyTuple (Ipv4Address ("10.0.0.1"), 1);
+  NS_TEST_ASSERT_MSG_NE (found, 0, "Newer topology tuple not found");
+  NS_TEST_EXPECT_MSG_EQ (found->sequenceNumber, 2, "Wrong newer topology tuple");
+
+  state.EraseOlderTopologyTuples (Ipv4Address ("10.0.0.1"), 4);
+  NS_TEST_EXPECT_MSG_EQ (state.IsChanged (), true, "Erasing topology tuples changes the state");
+  const TopologySet &topologySet = state.GetTopologySet ();
+  NS_TEST_ASSERT_MSG_EQ (topologySet.size (), 4, "Older topology tuples not erased");
+  const uint16_t sequenceNumbers[] = { 1, 3, 4, 5 };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (topologySet[i].sequenceNumber, sequenceNumbers[i], "Wrong order of the topology set");
+    }
+  std::vector<uint32_t> positions;
+  state.FindTopologyTuples (Ipv4Address ("10.0.0.2"), positions);
+  NS_TEST_ASSERT_MSG_EQ (positions.size (), 3, "Wrong number of topology tuples");
+  NS_TEST_EXPECT_MSG_EQ (positions[0], 0, "Wrong position of topology tuple");
+  NS_TEST_EXPECT_MSG_EQ (positions[1], 1, "Wrong position of topology tuple");
+  NS_TEST_EXPECT_MSG_EQ (positions[2], 3, "Wrong position of topology tuple");
+  state.EraseTopologyTuple (topologySet[1]);
+  NS_TEST_EXPECT_MSG_EQ (state.FindTopologyTuple (Ipv4Address ("10.0.1.3"), Ipv4Address ("10.0.0.2")), 0,
+                         "Topology tuple not erased");
+  found = state.FindTopologyTuple (Ipv4Address ("10.0.1.4"), Ipv4Address ("10.0.0.1"));
+  NS_TEST_EXPECT_MSG_EQ ((found == &topologySet[1]), true, "Topology tuple not moved");
+
+  /*
+   * The 2-hop neighbors of a neighbor are erased together, and the main
+   * addresses of the interface association set replace the interface
+   * addresses
+   */
+  TwoHopNeighborTuple twoHop;
+  twoHop.neighborMainAddr = Ipv4Address ("10.0.0.2");
+  twoHop.twoHopNeighborAddr = Ipv4Address ("10.0.0.4");
+  state.InsertTwoHopNeighborTuple (twoHop);
+  twoHop.neighborMainAddr = Ipv4Address ("10.0.0.3");
+  state.InsertTwoHopNeighborTuple (twoHop);
+  twoHop.twoHopNeighborAddr = Ipv4Address ("10.0.0.5");
+  state.InsertTwoHopNeighborTuple (twoHop);
+  state.EraseTwoHopNeighborTuples (Ipv4Address ("10.0.0.3"));
+  NS_TEST_ASSERT_MSG_EQ (state.GetTwoHopNeighbors ().size (), 1, "2-hop neighbor tuples not erased");
+  NS_TEST_EXPECT_MSG_NE (state.FindTwoHopNeighborTuple (Ipv4Address ("10.0.0.2"), Ipv4Address ("10.0.0.4")), 0,
+                         "2-hop neighbor tuple erased");
+
+  IfaceAssocTuple ifaceAssoc;
+  ifaceAssoc.ifaceAddr = Ipv4Address ("10.0.0.2");
+  ifaceAssoc.mainAddr = Ipv4Address ("10.0.0.6");
+  state.InsertIfaceAssocTuple (ifaceAssoc);
+  state.UpdateNeighborMainAddresses ();
+  NS_TEST_EXPECT_MSG_EQ (state.FindTwoHopNeighborTuple (Ipv4Address ("10.0.0.2"), Ipv4Address ("10.0.0.4")), 0,
+                         "2-hop neighbor tuple kept its interface address");
+  NS_TEST_EXPECT_MSG_NE (state.FindTwoHopNeighborTuple (Ipv4Address ("10.0.0.6"), Ipv4Address ("10.0.0.4")), 0,
+                         "2-hop neighbor tuple did not get the main address");
+
+  /*
+   * Duplicate tuples are not used by the routing table
+   */
+  state.SetChanged (false);
+  DuplicateTuple duplicate;
+  duplicate.address = Ipv4Address ("10.0.0.7");
+  duplicate.sequenceNumber = 10;
+  state.InsertDuplicateTuple (duplicate);
+  duplicate.sequenceNumber = 11;
+  state.InsertDuplicateTuple (duplicate);
+  NS_TEST_EXPECT_MSG_NE (state.FindDuplicateTuple (Ipv4Address ("10.0.0.7"), 10), 0, "Duplicate tuple not found");
+  state.EraseDuplicateTuple (duplicate);
+  NS_TEST_EXPECT_MSG_EQ (state.FindDuplicateTuple (Ipv4Address ("10.0.0.7"), 11), 0, "Duplicate tuple not erased");
+  NS_TEST_EXPECT_MSG_EQ (state.IsChanged (), false, "Duplicate tuples changed the state");
+}
+
 static class OlsrProtocolTestSuite : public TestSuite
 {
 public:
@@ -177,4 +285,5 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite()
   : TestSuite ("routing-olsr", UNIT)
 {
   AddTestCase (new OlsrMprTestCase (), TestCase::QUICK);
+  AddTestCase (new OlsrStateTestCase (), TestCase::QUICK);
 }
@@ -214,6 +214,32 @@ PointToPointHelper::EnableAsciiInternal (
   Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
 }
 
+void
+PointToPointHelper::EnableBinaryInternal (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  Ptr<PointToPointNetDevice> device = nd->GetObject<PointToPointNetDevice> ();
+  if (device == 0)
+    {
+      NS_LOG_INFO ("PointToPointHelper::EnableBinaryInternal(): Device " << device << 
+                   " not of type ns3::PointToPointNetDevice");
+      return;
+    }
+
+  //
+  // The binary sinks record the same events as the ascii ones, but they do
+  // not print packets, so there is no need to enable packet printing.
+  //
+  AsciiTraceHelper asciiTraceHelper;
+  asciiTraceHelper.HookDefaultBinarySink<PointToPointNetDevice> (device, "MacRx", file, device, BinaryTraceFile::RECEIVE);
+
+  Ptr<Queue> queue = device->GetQueue ();
+  asciiTraceHelper.HookDefaultBinarySink<Queue> (queue, "Enqueue", file, device, BinaryTraceFile::ENQUEUE);
+  asciiTraceHelper.HookDefaultBinarySink<Queue> (queue, "Drop", file, device, BinaryTraceFile::DROP);
+  asciiTraceHelper.HookDefaultBinarySink<Queue> (queue, "Dequeue", file, device, BinaryTraceFile::DEQUEUE);
+
+  asciiTraceHelper.HookDefaultBinarySink<PointToPointNetDevice> (device, "PhyRxDrop", file, device, BinaryTraceFile::DROP);
+}
+
 NetDeviceContainer 
 PointToPointHelper::Install (NodeContainer c)
 {
@@ -25,6 +25,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/segment-offload-tag.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -67,6 +69,12 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("SegmentOffload",
+                   "Whether super-segments larger than the MTU (see SegmentOffloadTag) "
+                   "are transmitted as a single frame rather than split beforehand",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointNetDevice::m_segmentOffload),
+                   MakeBooleanChecker ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -177,6 +185,7 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
+    m_segmentOffload (false),
     m_currentPkt (0)
 {
   NS_LOG_FUNCTION (this);
@@ -214,9 +223,21 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_deviceQueue = 0;
   NetDevice::DoDispose ();
 }
 
+void
+PointToPointNetDevice::NotifyNewAggregate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_deviceQueue == 0)
+    {
+      m_deviceQueue = GetObject<NetDeviceQueue> ();
+    }
+  NetDevice::NotifyNewAggregate ();
+}
+
 void
 PointToPointNetDevice::SetDataRate (DataRate bps)
 {
@@ -247,7 +268,13 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  uint32_t wireSize = p->GetSize ();
+  SegmentOffloadTag offloadTag;
+  if (m_segmentOffload && p->PeekPacketTag (offloadTag))
+    { // A super-segment takes the time of all its segments on the wire
+      wireSize = offloadTag.GetWireSize (wireSize);
+    }
+  Time txTime = m_bps.CalculateBytesTxTime (wireSize);
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
@@ -284,8 +311,13 @@ PointToPointNetDevice::TransmitComplete (void)
   if (p == 0)
     {
       //
-      // No packet was on the queue, so we just exit.
+      // No packet was on the queue, so we just exit, after asking the
+      // queueing discipline above for more.
       //
+      if (m_deviceQueue != 0)
+        {
+          m_deviceQueue->Wake ();
+        }
       return;
     }
 
@@ -295,6 +327,15 @@ PointToPointNetDevice::TransmitComplete (void)
   m_snifferTrace (p);
   m_promiscSnifferTrace (p);
   TransmitStart (p);
+
+  //
+  // Let the queueing discipline above send the next packet, which will
+  // wait in the transmit queue for this one to be sent.
+  //
+  if (m_deviceQueue != 0 && m_queue->IsEmpty ())
+    {
+      m_deviceQueue->Wake ();
+    }
 }
 
 bool
@@ -547,6 +588,14 @@ PointToPointNetDevice::Send (
           m_promiscSnifferTrace (packet);
           return TransmitStart (packet);
         }
+      //
+      // A packet now waits for the transmission in progress: let the
+      // queueing discipline above, if any, hold the next ones.
+      //
+      if (m_deviceQueue != 0)
+        {
+          m_deviceQueue->Stop ();
+        }
       return true;
     }
 
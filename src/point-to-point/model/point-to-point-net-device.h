@@ -30,6 +30,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
+#include "ns3/net-device-queue.h"
 
 namespace ns3 {
 
@@ -229,6 +230,12 @@ private:
    */
   virtual void DoDispose (void);
 
+  /**
+   * \brief Look for the NetDeviceQueue of a queueing discipline, to stop
+   * it while the transmit queue holds a packet waiting.
+   */
+  virtual void NotifyNewAggregate (void);
+
 private:
 
   /**
@@ -326,6 +333,12 @@ private:
    */
   Ptr<Queue> m_queue;
 
+  /**
+   * Flow control state towards the queueing discipline, if any, which
+   * sends packets to this device.
+   */
+  Ptr<NetDeviceQueue> m_deviceQueue;
+
   /**
    * Error model for receive packet events
    */
@@ -349,7 +362,7 @@ private:
    * transition).  This is a promiscuous trace (which doesn't mean a lot here
    * in the point-to-point device).
    */
-  TracedCallback<Ptr<const Packet> > m_macPromiscRxTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_macPromiscRxTrace;
 
   /**
    * The trace source fired for packets successfully received by the device
@@ -370,13 +383,13 @@ private:
    * The trace source fired when a packet begins the transmission process on
    * the medium.
    */
-  TracedCallback<Ptr<const Packet> > m_phyTxBeginTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyTxBeginTrace;
 
   /**
    * The trace source fired when a packet ends the transmission process on
    * the medium.
    */
-  TracedCallback<Ptr<const Packet> > m_phyTxEndTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyTxEndTrace;
 
   /**
    * The trace source fired when the phy layer drops a packet before it tries
@@ -388,13 +401,13 @@ private:
    * The trace source fired when a packet begins the reception process from
    * the medium -- when the simulated first bit(s) arrive.
    */
-  TracedCallback<Ptr<const Packet> > m_phyRxBeginTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyRxBeginTrace;
 
   /**
    * The trace source fired when a packet ends the reception process from
    * the medium.
    */
-  TracedCallback<Ptr<const Packet> > m_phyRxEndTrace;
+  OptionalTracedCallback<Ptr<const Packet> > m_phyRxEndTrace;
 
   /**
    * The trace source fired when the phy layer drops a packet it has received.
@@ -460,6 +473,14 @@ private:
    */
   uint32_t m_mtu;
 
+  /**
+   * \brief Whether super-segments are transmitted whole
+   *
+   * A super-segment (see SegmentOffloadTag) is then sent as a single
+   * frame, which takes the transmission time of all its segments.
+   */
+  bool m_segmentOffload;
+
   Ptr<Packet> m_currentPkt; //!< Current packet processed
 
   /**
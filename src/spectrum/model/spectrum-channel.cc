@@ -19,6 +19,7 @@
  */
 
 #include "spectrum-channel.h"
+#include <ns3/trace-source-accessor.h>
 
 
 namespace ns3 {
@@ -32,6 +33,10 @@ SpectrumChannel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::SpectrumChannel")
     .SetParent<Channel> ()
     .SetGroupName ("Spectrum")
+    .AddTraceSource ("TxSigParams",
+                     "Signal parameters of the signals transmitted on the channel",
+                     MakeTraceSourceAccessor (&SpectrumChannel::m_txSigParamsTrace),
+                     "ns3::SpectrumChannel::SignalParametersTracedCallback")
   ;
   return tid;
 }
@@ -26,6 +26,7 @@
 #include <ns3/nstime.h>
 #include <ns3/channel.h>
 #include <ns3/spectrum-signal-parameters.h>
+#include <ns3/traced-callback.h>
 
 namespace ns3 {
 
@@ -95,6 +96,18 @@ public:
    */
   virtual void AddRx (Ptr<SpectrumPhy> phy) = 0;
 
+  /**
+   * \return the single-frequency propagation loss model used by the
+   * channel, 0 if none
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void) = 0;
+
+  /**
+   * \return the frequency-dependent propagation loss model used by the
+   * channel, 0 if none
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void) = 0;
+
   /**
    * TracedCallback signature for path loss calculation events.
    *
@@ -105,7 +118,21 @@ public:
   typedef void (* LossTracedCallback)
     (const Ptr<const SpectrumPhy> txPhy, const Ptr<const SpectrumPhy> rxPhy,
      const double lossDb);
-  
+
+  /**
+   * TracedCallback signature for the signals transmitted on the channel.
+   *
+   * \param [in] params The parameters of the transmitted signal.
+   */
+  typedef void (* SignalParametersTracedCallback)
+    (Ptr<SpectrumSignalParameters> params);
+
+protected:
+  /**
+   * The `TxSigParams` trace source, fired by StartTx for every signal
+   * transmitted on the channel.
+   */
+  TracedCallback<Ptr<SpectrumSignalParameters> > m_txSigParamsTrace;
 };
 
 
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/type-id.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/red-queue.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ecn-tag.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpEcnTest");
+
+// ===========================================================================
+// Bulk transfer through a RED bottleneck
+//
+//   n0 ---------------------- n1 ---------------------- n2
+//       100 Mb/s, 1 ms             10 Mb/s, 5 ms, RED
+//
+// ===========================================================================
+class Ns3TcpEcnTestCase : public TestCase
+{
+public:
+  Ns3TcpEcnTestCase (std::string congestionOps, bool useEcn);
+  virtual ~Ns3TcpEcnTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void ReceiverRx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+  void ReceiverTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  std::string m_congestionOps;
+  bool m_useEcn;
+  uint32_t m_totalBytes;
+  bool m_echoExpected;        // a CE mark has been received and no CWR since
+  uint32_t m_echoes;          // ACKs sent by the receiver with ECE
+  uint32_t m_wrongEchoes;     // ACKs sent by the receiver with the wrong ECE
+};
+
+Ns3TcpEcnTestCase::Ns3TcpEcnTestCase (std::string congestionOps, bool useEcn)
+  : TestCase ("Check a bulk transfer with " + congestionOps + (useEcn ? " and ECN" : "") + " through a RED bottleneck"),
+    m_congestionOps (congestionOps),
+    m_useEcn (useEcn),
+    m_totalBytes (2000000)
+{
+}
+
+void
+Ns3TcpEcnTestCase::ReceiverRx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> packet = p->Copy ();
+  Ipv4Header ipHeader;
+  packet->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  packet->RemoveHeader (tcpHeader);
+  EcnTag ecnTag;
+  if (tcpHeader.GetFlags () & TcpHeader::CWR)
+    {
+      m_echoExpected = false;
+    }
+  if (packet->GetSize () > 0 && packet->PeekPacketTag (ecnTag) && ecnTag.IsCongestionExperienced ())
+    {
+      m_echoExpected = true;
+    }
+}
+
+void
+Ns3TcpEcnTestCase::ReceiverTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> packet = p->Copy ();
+  Ipv4Header ipHeader;
+  packet->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  packet->RemoveHeader (tcpHeader);
+  if ((tcpHeader.GetFlags () & (TcpHeader::SYN | TcpHeader::ACK)) != TcpHeader::ACK)
+    {
+      return;
+    }
+  bool echo = tcpHeader.GetFlags () & TcpHeader::ECE;
+  m_echoes += echo;
+  m_wrongEchoes += (echo != m_echoExpected);
+}
+
+void
+Ns3TcpEcnTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpNewReno::CongestionOps", TypeIdValue (TypeId::LookupByName (m_congestionOps)));
+  Config::SetDefault ("ns3::TcpNewReno::UseEcn", BooleanValue (m_useEcn));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper accessLink;
+  accessLink.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  accessLink.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer accessDevices = accessLink.Install (nodes.Get (0), nodes.Get (1));
+
+  // Instantaneous queue length, marking probability growing from 0 at 5
+  // packets to 1 at 15 packets
+  PointToPointHelper bottleneckLink;
+  bottleneckLink.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  bottleneckLink.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  Config::SetDefault ("ns3::RedQueue::QW", DoubleValue (1));
+  Config::SetDefault ("ns3::RedQueue::LInterm", DoubleValue (1));
+  bottleneckLink.SetQueue ("ns3::RedQueue",
+                           "MinTh", DoubleValue (5),
+                           "MaxTh", DoubleValue (15),
+                           "QueueLimit", UintegerValue (50),
+                           "UseEcn", BooleanValue (m_useEcn));
+  NetDeviceContainer bottleneckDevices = bottleneckLink.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (accessDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer bottleneckInterfaces = address.Assign (bottleneckDevices);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (bottleneckInterfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (m_totalBytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (2));
+  sinkApps.Start (Seconds (0.0));
+
+  m_echoExpected = false;
+  m_echoes = 0;
+  m_wrongEchoes = 0;
+  Ptr<Ipv4L3Protocol> receiver = nodes.Get (2)->GetObject<Ipv4L3Protocol> ();
+  receiver->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpEcnTestCase::ReceiverRx, this));
+  receiver->TraceConnectWithoutContext ("Tx", MakeCallback (&Ns3TcpEcnTestCase::ReceiverTx, this));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+
+  uint32_t rxBytes = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Ptr<RedQueue> queue = DynamicCast<RedQueue> (DynamicCast<PointToPointNetDevice> (bottleneckDevices.Get (0))->GetQueue ());
+  RedQueue::Stats stats = queue->GetStats ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+  Config::SetDefault ("ns3::TcpNewReno::CongestionOps", TypeIdValue (TcpCongestionOps::GetTypeId ()));
+  Config::SetDefault ("ns3::TcpNewReno::UseEcn", BooleanValue (false));
+  Config::SetDefault ("ns3::RedQueue::QW", DoubleValue (0.002));
+  Config::SetDefault ("ns3::RedQueue::LInterm", DoubleValue (50));
+
+  NS_TEST_ASSERT_MSG_EQ (rxBytes, m_totalBytes, "All the data must be received");
+  if (m_useEcn)
+    {
+      NS_TEST_EXPECT_MSG_GT (stats.unforcedMark, 0, "RED must mark the ECN-capable segments");
+      NS_TEST_EXPECT_MSG_EQ (stats.unforcedDrop, 0, "RED must not drop the ECN-capable segments early");
+      NS_TEST_EXPECT_MSG_EQ (stats.qLimDrop, 0, "The ECN echoes must keep the queue below its limit");
+      NS_TEST_EXPECT_MSG_GT (m_echoes, 0, "The receiver must echo the marks");
+      if (m_congestionOps != "ns3::TcpDctcp")
+        { // DCTCP echoes the mark of each segment instead
+          NS_TEST_EXPECT_MSG_EQ (m_wrongEchoes, 0, "The receiver must echo ECE from a mark until CWR");
+        }
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (stats.unforcedMark, 0, "RED must not mark without ECN");
+      NS_TEST_EXPECT_MSG_EQ (m_echoes, 0, "The receiver must not echo without ECN");
+    }
+}
+
+class Ns3TcpEcnTestSuite : public TestSuite
+{
+public:
+  Ns3TcpEcnTestSuite ();
+};
+
+Ns3TcpEcnTestSuite::Ns3TcpEcnTestSuite ()
+  : TestSuite ("ns3-tcp-ecn", SYSTEM)
+{
+  AddTestCase (new Ns3TcpEcnTestCase ("ns3::TcpCongestionOps", false), TestCase::QUICK);
+  AddTestCase (new Ns3TcpEcnTestCase ("ns3::TcpCongestionOps", true), TestCase::QUICK);
+  AddTestCase (new Ns3TcpEcnTestCase ("ns3::TcpCubic", false), TestCase::QUICK);
+  AddTestCase (new Ns3TcpEcnTestCase ("ns3::TcpCubic", true), TestCase::QUICK);
+  AddTestCase (new Ns3TcpEcnTestCase ("ns3::TcpDctcp", true), TestCase::QUICK);
+  AddTestCase (new Ns3TcpEcnTestCase ("ns3::TcpBbr", false), TestCase::QUICK);
+}
+
+static Ns3TcpEcnTestSuite ns3TcpEcnTestSuite;
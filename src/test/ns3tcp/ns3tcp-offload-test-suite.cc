@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/ppp-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpOffloadTest");
+
+// ===========================================================================
+// Bulk transfer over an offload-capable link followed by a regular one
+//
+//   n0 ---------------------- n1 ---------------------- n2
+//       1 Gb/s, offload            100 Mb/s, no offload
+//
+// ===========================================================================
+class Ns3TcpOffloadTestCase : public TestCase
+{
+public:
+  Ns3TcpOffloadTestCase ();
+  virtual ~Ns3TcpOffloadTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  void RunTransfer (bool offload);
+
+  void FirstLinkTx (Ptr<const Packet> p);
+  void SecondLinkTx (Ptr<const Packet> p);
+
+  uint32_t m_totalBytes;
+  uint32_t m_rxBytes;
+  uint32_t m_firstLinkFrames;
+  uint32_t m_firstLinkMaxFrame;
+  uint32_t m_secondLinkMaxFrame;
+  std::set<uint16_t> m_secondLinkIds;
+  uint32_t m_secondLinkDuplicateIds;
+};
+
+Ns3TcpOffloadTestCase::Ns3TcpOffloadTestCase ()
+  : TestCase ("Check that TCP super-segments cross an offload-capable link whole and are split before a regular one"),
+    m_totalBytes (2000000)
+{
+}
+
+void
+Ns3TcpOffloadTestCase::FirstLinkTx (Ptr<const Packet> p)
+{
+  m_firstLinkFrames++;
+  m_firstLinkMaxFrame = std::max (m_firstLinkMaxFrame, p->GetSize ());
+}
+
+void
+Ns3TcpOffloadTestCase::SecondLinkTx (Ptr<const Packet> p)
+{
+  m_secondLinkMaxFrame = std::max (m_secondLinkMaxFrame, p->GetSize ());
+  Ptr<Packet> copy = p->Copy ();
+  PppHeader pppHeader;
+  copy->RemoveHeader (pppHeader);
+  Ipv4Header ipHeader;
+  copy->PeekHeader (ipHeader);
+  if (!m_secondLinkIds.insert (ipHeader.GetIdentification ()).second)
+    {
+      m_secondLinkDuplicateIds++;
+    }
+}
+
+void
+Ns3TcpOffloadTestCase::RunTransfer (bool offload)
+{
+  m_firstLinkFrames = 0;
+  m_firstLinkMaxFrame = 0;
+  m_secondLinkMaxFrame = 0;
+  m_secondLinkIds.clear ();
+  m_secondLinkDuplicateIds = 0;
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentOffloadSize", UintegerValue (offload ? 65536 : 0));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper fastLink;
+  fastLink.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  fastLink.SetDeviceAttribute ("SegmentOffload", BooleanValue (offload));
+  fastLink.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer fastDevices = fastLink.Install (nodes.Get (0), nodes.Get (1));
+
+  PointToPointHelper slowLink;
+  slowLink.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  slowLink.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer slowDevices = slowLink.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (fastDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer slowInterfaces = address.Assign (slowDevices);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (slowInterfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (m_totalBytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (2));
+  sinkApps.Start (Seconds (0.0));
+
+  fastDevices.Get (0)->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&Ns3TcpOffloadTestCase::FirstLinkTx, this));
+  slowDevices.Get (0)->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&Ns3TcpOffloadTestCase::SecondLinkTx, this));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  m_rxBytes = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentOffloadSize", UintegerValue (0));
+}
+
+void
+Ns3TcpOffloadTestCase::DoRun (void)
+{
+  RunTransfer (false);
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_totalBytes, "All the data must be received without offload");
+  uint32_t regularFrames = m_firstLinkFrames;
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_firstLinkMaxFrame, 1502, "Frames must fit the MTU without offload");
+
+  RunTransfer (true);
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_totalBytes, "All the data must be received with offload");
+  NS_TEST_EXPECT_MSG_GT (m_firstLinkMaxFrame, 1502, "Super-segments must cross the offload-capable link");
+  NS_TEST_EXPECT_MSG_LT (m_firstLinkFrames, regularFrames / 4, "Offload must save most of the transmission events");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_secondLinkMaxFrame, 1502, "Super-segments must be split before a regular link");
+  // fewer datagrams than IPv4 identifications are sent
+  NS_TEST_EXPECT_MSG_EQ (m_secondLinkDuplicateIds, 0, "The segments of a split super-segment must have unique identifications");
+}
+
+class Ns3TcpOffloadTestSuite : public TestSuite
+{
+public:
+  Ns3TcpOffloadTestSuite ();
+};
+
+Ns3TcpOffloadTestSuite::Ns3TcpOffloadTestSuite ()
+  : TestSuite ("ns3-tcp-offload", SYSTEM)
+{
+  AddTestCase (new Ns3TcpOffloadTestCase, TestCase::QUICK);
+}
+
+static Ns3TcpOffloadTestSuite ns3TcpOffloadTestSuite;
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TrafficControlSystemTest");
+
+// ===========================================================================
+// Bulk transfer through a queueing discipline on the bottleneck
+//
+//   n0 ---------------------- n1 ---------------------- n2
+//       100 Mb/s, 1 ms             10 Mb/s, 5 ms, qdisc
+//
+// ===========================================================================
+class TrafficControlSystemTestCase : public TestCase
+{
+public:
+  TrafficControlSystemTestCase (std::string queueDisc);
+  virtual ~TrafficControlSystemTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  /// Record the occupancy of the bottleneck device queue and qdisc
+  void DeviceEnqueue (Ptr<const Packet> p);
+
+  std::string m_queueDisc;
+  uint32_t m_totalBytes;
+  Ptr<Queue> m_deviceQueue;
+  Ptr<QueueDisc> m_qDisc;
+  uint32_t m_maxDevicePackets;
+  uint32_t m_maxQueueDiscPackets;
+};
+
+TrafficControlSystemTestCase::TrafficControlSystemTestCase (std::string queueDisc)
+  : TestCase ("Check a bulk transfer through " + queueDisc + " on a point-to-point bottleneck"),
+    m_queueDisc (queueDisc),
+    m_totalBytes (2000000),
+    m_maxDevicePackets (0),
+    m_maxQueueDiscPackets (0)
+{
+}
+
+void
+TrafficControlSystemTestCase::DeviceEnqueue (Ptr<const Packet> p)
+{
+  m_maxDevicePackets = std::max (m_maxDevicePackets, m_deviceQueue->GetNPackets ());
+  m_maxQueueDiscPackets = std::max (m_maxQueueDiscPackets, m_qDisc->GetNPackets ());
+}
+
+void
+TrafficControlSystemTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper accessLink;
+  accessLink.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  accessLink.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer accessDevices = accessLink.Install (nodes.Get (0), nodes.Get (1));
+
+  PointToPointHelper bottleneckLink;
+  bottleneckLink.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  bottleneckLink.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  NetDeviceContainer bottleneckDevices = bottleneckLink.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  TrafficControlHelper tch;
+  tch.SetRootQueueDisc (m_queueDisc);
+  m_qDisc = tch.Install (bottleneckDevices.Get (0));
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (accessDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer bottleneckInterfaces = address.Assign (bottleneckDevices);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  m_deviceQueue = DynamicCast<PointToPointNetDevice> (bottleneckDevices.Get (0))->GetQueue ();
+  m_deviceQueue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&TrafficControlSystemTestCase::DeviceEnqueue, this));
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (bottleneckInterfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (m_totalBytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (2));
+  sinkApps.Start (Seconds (0.0));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+
+  uint32_t rxBytes = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  QueueDisc::Stats stats = m_qDisc->GetStats ();
+  uint32_t held = m_qDisc->GetNPackets ();
+  Simulator::Destroy ();
+  m_deviceQueue = 0;
+  m_qDisc = 0;
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+
+  NS_TEST_ASSERT_MSG_EQ (rxBytes, m_totalBytes, "All the data must be received");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_maxDevicePackets, 1, "At most one packet may wait in the device queue");
+  NS_TEST_EXPECT_MSG_GT (m_maxQueueDiscPackets, 1, "The backlog must build in the queueing discipline");
+  NS_TEST_EXPECT_MSG_EQ (stats.nTotalReceivedPackets,
+                         stats.nTotalSentPackets + stats.nTotalDroppedPackets + held,
+                         "Every packet received by the queueing discipline is sent, dropped or held");
+}
+
+class TrafficControlSystemTestSuite : public TestSuite
+{
+public:
+  TrafficControlSystemTestSuite ();
+};
+
+TrafficControlSystemTestSuite::TrafficControlSystemTestSuite ()
+  : TestSuite ("traffic-control-system", SYSTEM)
+{
+  AddTestCase (new TrafficControlSystemTestCase ("ns3::PrioQueueDisc"), TestCase::QUICK);
+  AddTestCase (new TrafficControlSystemTestCase ("ns3::FqCoDelQueueDisc"), TestCase::QUICK);
+  AddTestCase (new TrafficControlSystemTestCase ("ns3::PieQueueDisc"), TestCase::QUICK);
+}
+
+static TrafficControlSystemTestSuite trafficControlSystemTestSuite;
@@ -20,6 +20,7 @@
  * Author: Mirko Banchi <mk.banchi@gmail.com>
  */
 
+#include <algorithm>
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
@@ -102,33 +103,78 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       return;
     }
   Time now = Simulator::Now ();
+  if (m_queue.empty ())
+    {
+      m_oldest = now;
+    }
   m_queue.push_back (Item (packet, hdr, now));
+  if (hdr.IsQosData ())
+    {
+      m_subQueues[SubQueueKey (hdr.GetAddr1 (), hdr.GetQosTid ())].push_back (--m_queue.end ());
+    }
   m_size++;
 }
 
 void
 WifiMacQueue::Cleanup (void)
 {
-  if (m_queue.empty ())
+  Time now = Simulator::Now ();
+  if (m_queue.empty () || m_oldest + m_maxDelay > now)
     {
+      // No packet can have exceeded the maximum delay
       return;
     }
 
-  Time now = Simulator::Now ();
-  uint32_t n = 0;
+  Time oldest = now;
   for (PacketQueueI i = m_queue.begin (); i != m_queue.end ();)
     {
       if (i->tstamp + m_maxDelay > now)
         {
+          oldest = std::min (oldest, i->tstamp);
           i++;
         }
       else
         {
-          i = m_queue.erase (i);
-          n++;
+          i = Erase (i);
+        }
+    }
+  m_oldest = oldest;
+}
+
+WifiMacQueue::SubQueue*
+WifiMacQueue::GetSubQueue (uint8_t tid, Mac48Address addr)
+{
+  SubQueues::iterator it = m_subQueues.find (SubQueueKey (addr, tid));
+  if (it == m_subQueues.end ())
+    {
+      return 0;
+    }
+  return &it->second;
+}
+
+WifiMacQueue::PacketQueueI
+WifiMacQueue::Erase (PacketQueueI it)
+{
+  if (it->hdr.IsQosData ())
+    {
+      SubQueues::iterator subQueue = m_subQueues.find (SubQueueKey (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()));
+      NS_ASSERT (subQueue != m_subQueues.end ());
+      // Packets are mostly removed from the head of their sub-queue
+      if (subQueue->second.front () == it)
+        {
+          subQueue->second.pop_front ();
+        }
+      else
+        {
+          subQueue->second.erase (std::find (subQueue->second.begin (), subQueue->second.end (), it));
+        }
+      if (subQueue->second.empty ())
+        {
+          m_subQueues.erase (subQueue);
         }
     }
-  m_size -= n;
+  m_size--;
+  return m_queue.erase (it);
 }
 
 Ptr<const Packet>
@@ -138,8 +184,7 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   if (!m_queue.empty ())
     {
       Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
+      Erase (m_queue.begin ());
       *hdr = i.hdr;
       return i.packet;
     }
@@ -165,6 +210,18 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *subQueue = GetSubQueue (tid, dest);
+      if (subQueue != 0)
+        {
+          PacketQueueI it = subQueue->front ();
+          packet = it->packet;
+          *hdr = it->hdr;
+          Erase (it);
+        }
+      return packet;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -177,8 +234,7 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
+                  Erase (it);
                   break;
                 }
             }
@@ -192,6 +248,18 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest, Time *timestamp)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *subQueue = GetSubQueue (tid, dest);
+      if (subQueue != 0)
+        {
+          PacketQueueI it = subQueue->front ();
+          *hdr = it->hdr;
+          *timestamp = it->tstamp;
+          return it->packet;
+        }
+      return 0;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -229,6 +297,7 @@ void
 WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_subQueues.clear ();
   m_size = 0;
 }
 
@@ -253,13 +322,21 @@ WifiMacQueue::GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQ
 bool
 WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
+  // The packet is usually the head of its sub-queue, just peeked
+  for (SubQueues::iterator i = m_subQueues.begin (); i != m_subQueues.end (); i++)
+    {
+      if (i->second.front ()->packet == packet)
+        {
+          Erase (i->second.front ());
+          return true;
+        }
+    }
   PacketQueueI it = m_queue.begin ();
   for (; it != m_queue.end (); it++)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -275,7 +352,15 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       return;
     }
   Time now = Simulator::Now ();
+  if (m_queue.empty ())
+    {
+      m_oldest = now;
+    }
   m_queue.push_front (Item (packet, hdr, now));
+  if (hdr.IsQosData ())
+    {
+      m_subQueues[SubQueueKey (hdr.GetAddr1 (), hdr.GetQosTid ())].push_front (m_queue.begin ());
+    }
   m_size++;
 }
 
@@ -284,6 +369,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
                                           Mac48Address addr)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *subQueue = GetSubQueue (tid, addr);
+      return subQueue != 0 ? subQueue->size () : 0;
+    }
   uint32_t nPackets = 0;
   if (!m_queue.empty ())
     {
@@ -316,8 +406,7 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return packet;
         }
     }
@@ -23,6 +23,8 @@
 #define WIFI_MAC_QUEUE_H
 
 #include <list>
+#include <deque>
+#include <map>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
@@ -46,6 +48,11 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * QoS data packets are also indexed by receiver address (Address 1) and
+ * TID, so that the selective operations used for block ack, A-MSDU and
+ * A-MPDU construction with WifiMacHeader::ADDR1 take constant time
+ * rather than a scan of the queue.
  */
 class WifiMacQueue : public Object
 {
@@ -146,7 +153,9 @@ public:
   /**
    * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
    * takes no effects and return false. Deletion of the packet is
-   * performed in linear time (O(n)).
+   * performed in constant time if the packet is the first one of its
+   * receiver and TID (e.g., it has just been returned by
+   * PeekByTidAndAddress), in linear time (O(n)) otherwise.
    *
    * \param packet the packet to be removed
    * \return true if the packet was removed, false otherwise
@@ -256,7 +265,39 @@ protected:
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
 
+  /**
+   * Key of the sub-queue of the QoS data packets of a TID towards a
+   * receiver (Address 1).
+   */
+  typedef std::pair<Mac48Address, uint8_t> SubQueueKey;
+  /**
+   * The packets of a sub-queue, in the order of the queue.
+   */
+  typedef std::deque<PacketQueueI> SubQueue;
+  /**
+   * typedef for the sub-queues, by receiver and TID.
+   */
+  typedef std::map<SubQueueKey, SubQueue> SubQueues;
+
+  /**
+   * Return the sub-queue of the packets towards <i>addr</i> with TID <i>tid</i>.
+   *
+   * \param tid the given TID
+   * \param addr the given receiver
+   * \return the sub-queue, 0 if there is no such packet
+   */
+  SubQueue* GetSubQueue (uint8_t tid, Mac48Address addr);
+  /**
+   * Remove the given packet from the queue and from its sub-queue.
+   *
+   * \param it the packet
+   * \return the iterator following <i>it</i>
+   */
+  PacketQueueI Erase (PacketQueueI it);
+
   PacketQueue m_queue; //!< Packet (struct Item) queue
+  SubQueues m_subQueues; //!< QoS data packets, by receiver and TID
+  Time m_oldest; //!< Lower bound of the timestamps of the queued packets
   uint32_t m_size; //!< Current queue size
   uint32_t m_maxSize; //!< Queue capacity
   Time m_maxDelay; //!< Time to live for packets in the queue
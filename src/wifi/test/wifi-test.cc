@@ -41,6 +41,7 @@
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/wifi-mac-queue.h"
 
 using namespace ns3;
 
@@ -476,6 +477,91 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Selective operations of WifiMacQueue on the packets of a receiver and TID
+ */
+class WifiMacQueueByTidAndAddressTest : public TestCase
+{
+public:
+  WifiMacQueueByTidAndAddressTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param addr the receiver
+   * \param tid the TID
+   * \return a QoS data header
+   */
+  WifiMacHeader CreateHeader (Mac48Address addr, uint8_t tid);
+};
+
+WifiMacQueueByTidAndAddressTest::WifiMacQueueByTidAndAddressTest ()
+  : TestCase ("Check the per receiver and TID operations of WifiMacQueue")
+{
+}
+
+WifiMacHeader
+WifiMacQueueByTidAndAddressTest::CreateHeader (Mac48Address addr, uint8_t tid)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (addr);
+  hdr.SetQosTid (tid);
+  return hdr;
+}
+
+void
+WifiMacQueueByTidAndAddressTest::DoRun (void)
+{
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+  Mac48Address a ("00:00:00:00:00:01");
+  Mac48Address b ("00:00:00:00:00:02");
+  Ptr<Packet> a0First = Create<Packet> (100);
+  Ptr<Packet> a0Second = Create<Packet> (100);
+  Ptr<Packet> a0Retry = Create<Packet> (100);
+  Ptr<Packet> b0 = Create<Packet> (100);
+  Ptr<Packet> a5 = Create<Packet> (100);
+
+  queue->Enqueue (a0First, CreateHeader (a, 0));
+  queue->Enqueue (b0, CreateHeader (b, 0));
+  queue->Enqueue (a5, CreateHeader (a, 5));
+  queue->Enqueue (a0Second, CreateHeader (a, 0));
+  queue->PushFront (a0Retry, CreateHeader (a, 0));
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 5, "Five packets queued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 3, "Three packets for a, TID 0");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, a), 1, "One packet for a, TID 5");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, b), 0, "No packet for b, TID 5");
+
+  WifiMacHeader hdr;
+  Time tstamp;
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a, &tstamp), a0Retry,
+                         "The packet pushed at the front comes first");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (a0Retry), true, "Remove the peeked packet");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a), a0First,
+                         "Then the packets in their order");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (a5), true, "Remove the only packet of a, TID 5");
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (&hdr, 5, WifiMacHeader::ADDR1, a, &tstamp), 0,
+                         "No packet left for a, TID 5");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&hdr), b0, "The queue keeps the order of the other packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 1, "One packet left for a, TID 0");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&hdr), a0Second, "The last packet");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue is empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 0, "No packet left for a, TID 0");
+
+  // Packets which exceeded the maximum delay leave their sub-queue too
+  queue->SetMaxDelay (MilliSeconds (10));
+  queue->Enqueue (a0First, CreateHeader (a, 0));
+  Simulator::Schedule (MilliSeconds (5), &WifiMacQueue::Enqueue, queue, a0Second, CreateHeader (a, 0));
+  Simulator::Stop (MilliSeconds (12));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 1, "The first packet expired");
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a, &tstamp), a0Second,
+                         "The second packet is still there");
+  Simulator::Destroy ();
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -490,6 +576,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
+  AddTestCase (new WifiMacQueueByTidAndAddressTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/binary-trace-file.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input = "";
+  std::string output = "-";
+  std::string format = "text";
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file, as written by\n"
+             "AsciiTraceHelper::CreateBinaryFile, to text or CSV.\n"
+             "\n"
+             "The text format lists one event per line as\n"
+             "  <op> <seconds> /NodeList/<node>/DeviceList/<device> uid=<uid> size=<size>\n"
+             "where <op> is one of the ascii trace operations '+', '-', 'd', 'r'.");
+  cmd.AddValue ("input",  "binary trace file to read",                   input);
+  cmd.AddValue ("output", "file to write, or \"-\" for standard output", output);
+  cmd.AddValue ("format", "output format: text or csv (default text)",   format);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << cmd.GetName () << ": no --input file given" << std::endl;
+      return 1;
+    }
+  if (format != "text" && format != "csv")
+    {
+      std::cerr << cmd.GetName () << ": unknown format \"" << format << "\"" << std::endl;
+      return 1;
+    }
+
+  std::ofstream ofs;
+  std::ostream *os = &std::cout;
+  if (output != "-")
+    {
+      ofs.open (output.c_str ());
+      if (!ofs.good ())
+        {
+          std::cerr << cmd.GetName () << ": unable to open " << output << std::endl;
+          return 1;
+        }
+      os = &ofs;
+    }
+
+  bool ok = (format == "csv") ? BinaryTraceFile::ToCsv (input, *os) : BinaryTraceFile::ToText (input, *os);
+  if (!ok)
+    {
+      std::cerr << cmd.GetName () << ": unable to read binary trace file " << input << std::endl;
+      return 1;
+    }
+  return 0;
+}